@@ -2836,6 +2836,11 @@ Ouroboros.EventTypes =
     // <para> param1(uint16): retcode. // server_errors</para>
 	onLoginFailed : "onLoginFailed",
 
+	// Login is waiting in the loginapp queue.
+    // <para> param1(uint32): position, 1 is the next login.</para>
+    // <para> param2(uint32): estimated wait in seconds.</para>
+	onLoginQueuePosition : "onLoginQueuePosition",
+
 	// Login to baseapp.
 	onLoginBaseapp : "onLoginBaseapp",
 
@@ -4170,6 +4175,12 @@ Ouroboros.OuroborosApp = function(ouroborosArgs)
 		Ouroboros.ERROR_MSG("OuroborosApp::Client_onLoginFailed: failedcode=" + failedcode + "(" + Ouroboros.app.serverErrs[failedcode].name + "), datas(" + Ouroboros.app.serverdatas.length + ")!");
 		Ouroboros.Event.fire(Ouroboros.EventTypes.onLoginFailed, failedcode, Ouroboros.app.serverdatas);
 	}
+
+	this.Client_onLoginQueuePosition = function(position, waitSeconds)
+	{
+		Ouroboros.INFO_MSG("OuroborosApp::Client_onLoginQueuePosition: position=" + position + ", waitSeconds=" + waitSeconds);
+		Ouroboros.Event.fire(Ouroboros.EventTypes.onLoginQueuePosition, position, waitSeconds);
+	}
 	
 	this.Client_onLoginSuccessfully = function(args)
 	{
@@ -4278,13 +4289,18 @@ Ouroboros.OuroborosApp = function(ouroborosArgs)
 	this.getViewEntityIDFromStream = function(stream)
 	{
 		var id = 0;
-		if(Ouroboros.app.entityIDAliasIDList.Length > 255)
+		if(Ouroboros.app.entityIDAliasIDList.length > 65536)
 		{
 			id = stream.readInt32();
 		}
 		else
 		{
-			var aliasID = stream.readUint8();
+			// 1 byte while there are no more than 256 slots
+			var aliasID = 0;
+			if(Ouroboros.app.entityIDAliasIDList.length > 256)
+				aliasID = stream.readUint16();
+			else
+				aliasID = stream.readUint8();
 
 			// 如果为0且客户端上一步是?登陆或者?连?作并且?务端entity在断线期间一直处于在线状?
 			// 则?以忽略这个错误, 因为cellapp?能一直在?baseapp???步消?， 当客户端?连上时未等
@@ -4297,6 +4313,30 @@ Ouroboros.OuroborosApp = function(ouroborosArgs)
 		
 		return id;
 	}
+
+	// An entity entering the View takes the lowest free alias slot and frees it when it leaves,
+	// the free slots at the end are dropped. The server keeps the same slots.
+	this.addEntityAliasID = function(eid)
+	{
+		var idx = Ouroboros.app.entityIDAliasIDList.indexOf(0);
+		if(idx >= 0)
+			Ouroboros.app.entityIDAliasIDList[idx] = eid;
+		else
+			Ouroboros.app.entityIDAliasIDList.push(eid);
+	}
+
+	this.removeEntityAliasID = function(eid)
+	{
+		var idx = Ouroboros.app.entityIDAliasIDList.indexOf(eid);
+		if(idx < 0)
+			return;
+
+		Ouroboros.app.entityIDAliasIDList[idx] = 0;
+
+		while(Ouroboros.app.entityIDAliasIDList.length > 0 && 
+			Ouroboros.app.entityIDAliasIDList[Ouroboros.app.entityIDAliasIDList.length - 1] == 0)
+			Ouroboros.app.entityIDAliasIDList.pop();
+	}
 	
 	this.onUpdatePropertys_ = function(eid, stream)
 	{
@@ -4416,7 +4456,7 @@ Ouroboros.OuroborosApp = function(ouroborosArgs)
 	{
 		var eid = stream.readInt32();
 		if(Ouroboros.app.entity_id > 0 && eid != Ouroboros.app.entity_id)
-			Ouroboros.app.entityIDAliasIDList.push(eid)
+			Ouroboros.app.addEntityAliasID(eid);
 		
 		var entityType;
 		if(Ouroboros.moduledefs.Length > 255)
@@ -4543,16 +4583,7 @@ Ouroboros.OuroborosApp = function(ouroborosArgs)
 				
 			delete Ouroboros.app.entities[eid];
 			
-			var newArray = [];
-			for(var i=0; i<Ouroboros.app.entityIDAliasIDList.length; i++)
-			{
-				if(Ouroboros.app.entityIDAliasIDList[i] != eid)
-				{
-					newArray.push(Ouroboros.app.entityIDAliasIDList[i]);
-				}
-			}
-			
-			Ouroboros.app.entityIDAliasIDList = newArray
+			Ouroboros.app.removeEntityAliasID(eid);
 		}
 		else
 		{
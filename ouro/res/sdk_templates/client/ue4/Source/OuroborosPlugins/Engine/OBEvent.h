@@ -176,6 +176,19 @@ public:
 	TArray<uint8> serverdatas;
 };
 
+UCLASS(Blueprintable, BlueprintType)
+class OUROBOROSPLUGINS_API UOBEventData_onLoginQueuePosition : public UOBEventData
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ouroboros)
+	int32 position;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ouroboros)
+	int32 waitSeconds;
+};
+
 UCLASS(Blueprintable, BlueprintType)
 class OUROBOROSPLUGINS_API UOBEventData_onLoginBaseapp : public UOBEventData
 {
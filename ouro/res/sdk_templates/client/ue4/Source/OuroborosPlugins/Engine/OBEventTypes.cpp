@@ -21,6 +21,7 @@ const FString OBEventTypes::onCreateAccountResult = "onCreateAccountResult";
 const FString OBEventTypes::onVersionNotMatch = "onVersionNotMatch";
 const FString OBEventTypes::onScriptVersionNotMatch = "onScriptVersionNotMatch";
 const FString OBEventTypes::onLoginFailed = "onLoginFailed";
+const FString OBEventTypes::onLoginQueuePosition = "onLoginQueuePosition";
 const FString OBEventTypes::onLoginBaseapp = "onLoginBaseapp";
 const FString OBEventTypes::onLoginBaseappFailed = "onLoginBaseappFailed";
 const FString OBEventTypes::onReloginBaseapp = "onReloginBaseapp";
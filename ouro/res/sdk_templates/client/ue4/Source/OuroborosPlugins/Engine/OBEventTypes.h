@@ -72,6 +72,11 @@ struct OUROBOROSPLUGINS_API OBEventTypes
 	// <para> param1(uint16): retcode. // server_errors</para>
 	static const FString onLoginFailed;
 
+	// Login is waiting in the loginapp queue.
+	// <para> param1(uint32): position, 1 is the next login.</para>
+	// <para> param2(uint32): estimated wait in seconds.</para>
+	static const FString onLoginQueuePosition;
+
 	// Login to baseapp.
 	static const FString onLoginBaseapp;
 
@@ -744,6 +744,16 @@ void OuroborosApp::Client_onLoginFailed(MemoryStream& stream)
 	OUROBOROS_EVENT_FIRE(OBEventTypes::onLoginFailed, pEventData);
 }
 
+void OuroborosApp::Client_onLoginQueuePosition(uint32 position, uint32 waitSeconds)
+{
+	INFO_MSG("OuroborosApp::Client_onLoginQueuePosition(): position(%d), waitSeconds(%d)", position, waitSeconds);
+
+	UOBEventData_onLoginQueuePosition* pEventData = NewObject<UOBEventData_onLoginQueuePosition>();
+	pEventData->position = position;
+	pEventData->waitSeconds = waitSeconds;
+	OUROBOROS_EVENT_FIRE(OBEventTypes::onLoginQueuePosition, pEventData);
+}
+
 void OuroborosApp::Client_onLoginSuccessfully(MemoryStream& stream)
 {
 	FString accountName;
@@ -933,14 +943,24 @@ ENTITY_ID OuroborosApp::getViewEntityIDFromStream(MemoryStream& stream)
 		return id;
 	}
 
-	if (entityIDAliasIDList_.Num()> 255)
+	if (entityIDAliasIDList_.Num() > 65536)
 	{
 		stream >> id;
 	}
 	else
 	{
-		uint8 aliasID = 0;
-		stream >> aliasID;
+		// 1 byte while there are no more than 256 slots
+		uint16 aliasID = 0;
+		if (entityIDAliasIDList_.Num() > 256)
+		{
+			stream >> aliasID;
+		}
+		else
+		{
+			uint8 aliasID8 = 0;
+			stream >> aliasID8;
+			aliasID = aliasID8;
+		}
 
 		// If 0 and the client's previous step is to re-login or reconnect and the server entity is online during the disconnection
 		// This error can be ignored, because cellapp may always send synchronization messages to baseapp, not waiting when the client reconnects
@@ -954,6 +974,27 @@ ENTITY_ID OuroborosApp::getViewEntityIDFromStream(MemoryStream& stream)
 	return id;
 }
 
+void OuroborosApp::addEntityAliasID(ENTITY_ID eid)
+{
+	int32 idx = entityIDAliasIDList_.Find(0);
+	if (idx != INDEX_NONE)
+		entityIDAliasIDList_[idx] = eid;
+	else
+		entityIDAliasIDList_.Add(eid);
+}
+
+void OuroborosApp::removeEntityAliasID(ENTITY_ID eid)
+{
+	int32 idx = entityIDAliasIDList_.Find(eid);
+	if (idx == INDEX_NONE)
+		return;
+
+	entityIDAliasIDList_[idx] = 0;
+
+	while (entityIDAliasIDList_.Num() > 0 && entityIDAliasIDList_.Last() == 0)
+		entityIDAliasIDList_.Pop();
+}
+
 void OuroborosApp::Client_onUpdatePropertysOptimized(MemoryStream& stream)
 {
 	ENTITY_ID eid = getViewEntityIDFromStream(stream);
@@ -1427,7 +1468,7 @@ void OuroborosApp::Client_onEntityEnterWorld(MemoryStream& stream)
 	stream >> eid;
 
 	if (entity_id_ > 0 && entity_id_ != eid)
-		entityIDAliasIDList_.Add(eid);
+		addEntityAliasID(eid);
 
 	uint16 uEntityType;
 
@@ -1564,7 +1605,7 @@ void OuroborosApp::Client_onEntityLeaveWorld(ENTITY_ID eid)
 
 		entities_.Remove(eid);
 		pEntity->destroy();
-		entityIDAliasIDList_.Remove(eid);
+		removeEntityAliasID(eid);
 	}
 }
 
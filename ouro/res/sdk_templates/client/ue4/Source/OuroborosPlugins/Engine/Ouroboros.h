@@ -170,6 +170,11 @@ public:
 	*/
 	void Client_onLoginFailed(MemoryStream& stream);
 
+	/*
+		Login is waiting in the loginapp queue
+	*/
+	void Client_onLoginQueuePosition(uint32 position, uint32 waitSeconds);
+
 	/*
 		Login loginapp succeeded
 	*/
@@ -387,6 +392,13 @@ private:
 	*/
 	ENTITY_ID getViewEntityIDFromStream(MemoryStream& stream);
 
+	/*
+		An entity entering the View takes the lowest free alias slot and frees it when it leaves,
+		the free slots at the end are dropped. The server keeps the same slots.
+	*/
+	void addEntityAliasID(ENTITY_ID eid);
+	void removeEntityAliasID(ENTITY_ID eid);
+
 	/*
 	The server updates the entity attribute data.
 	*/
@@ -497,7 +509,8 @@ protected:
 	// https://github.com/ouroboros/ouroboros/tree/master/docs/api
 	ENTITIES_MAP entities_;
 
-	// When the player's View range is less than 256 entities, we can find the entity through a one-byte index.
+	// aliasID -> entityID, 0 if the slot is free
+	// The aliasIDs take one byte while there are no more than 256 slots, two bytes up to 65536.
 	TArray<ENTITY_ID> entityIDAliasIDList_;
 	TMap<ENTITY_ID, MemoryStream*> bufferedCreateEntityMessages_;
 
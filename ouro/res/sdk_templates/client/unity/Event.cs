@@ -57,6 +57,13 @@
         /// </summary>
         public const string onLoginFailed = "onLoginFailed";
 
+        /// <summary>
+        /// Login is waiting in the loginapp queue.
+        /// <para> param1(uint32): position, 1 is the next login.</para>
+        /// <para> param2(uint32): estimated wait in seconds.</para>
+        /// </summary>
+        public const string onLoginQueuePosition = "onLoginQueuePosition";
+
         /// <summary>
         /// Login to baseapp.
         /// </summary>
@@ -895,6 +895,15 @@
 			Dbg.ERROR_MSG("Ouroboros::Client_onLoginFailed: failedcode(" + failedcode + ":" + serverErr(failedcode) + "), datas(" + _serverdatas.Length + ")!");
 			Event.fireAll(EventOutTypes.onLoginFailed, failedcode, _serverdatas);
 		}
+
+		/*
+			Login is waiting in the loginapp queue
+		*/
+		public void Client_onLoginQueuePosition(UInt32 position, UInt32 waitSeconds)
+		{
+			Dbg.DEBUG_MSG("Ouroboros::Client_onLoginQueuePosition: position(" + position + "), waitSeconds(" + waitSeconds + ")");
+			Event.fireAll(EventOutTypes.onLoginQueuePosition, position, waitSeconds);
+		}
 		
 		/*
 			Login loginapp succeeded
@@ -1025,13 +1034,18 @@
 				return stream.readInt32();
 
 			Int32 id = 0;
-			if(_entityIDAliasIDList.Count > 255)
+			if(_entityIDAliasIDList.Count > 65536)
 			{
 				id = stream.readInt32();
 			}
 			else
 			{
-				byte aliasID = stream.readUint8();
+				// 1 byte while there are no more than 256 slots
+				int aliasID = 0;
+				if(_entityIDAliasIDList.Count > 256)
+					aliasID = stream.readUint16();
+				else
+					aliasID = stream.readUint8();
 				
 				// If 0 and the client's previous step is to re-login or reconnect and the server entity is online during the disconnection
 				// This error can be ignored, because cellapp may always send synchronization messages to baseapp, not waiting when the client reconnects
@@ -1044,6 +1058,31 @@
 			
 			return id;
 		}
+
+		/*
+			An entity entering the View takes the lowest free alias slot and frees it when it leaves,
+			the free slots at the end are dropped. The server keeps the same slots.
+		*/
+		void _addEntityAliasID(Int32 eid)
+		{
+			int idx = _entityIDAliasIDList.IndexOf(0);
+			if(idx >= 0)
+				_entityIDAliasIDList[idx] = eid;
+			else
+				_entityIDAliasIDList.Add(eid);
+		}
+
+		void _removeEntityAliasID(Int32 eid)
+		{
+			int idx = _entityIDAliasIDList.IndexOf(eid);
+			if(idx < 0)
+				return;
+
+			_entityIDAliasIDList[idx] = 0;
+
+			while(_entityIDAliasIDList.Count > 0 && _entityIDAliasIDList[_entityIDAliasIDList.Count - 1] == 0)
+				_entityIDAliasIDList.RemoveAt(_entityIDAliasIDList.Count - 1);
+		}
 		
 		/*
 			The server updates the entity attribute data in an optimized manner.
@@ -1125,7 +1164,7 @@
 		{
 			Int32 eid = stream.readInt32();
 			if(entity_id > 0 && entity_id != eid)
-				_entityIDAliasIDList.Add(eid);
+				_addEntityAliasID(eid);
 			
 			UInt16 uentityType;
 			if(EntityDef.idmoduledefs.Count > 255)
@@ -1250,7 +1289,7 @@
 
 				entities.Remove(eid);
 				entity.destroy();
-				_entityIDAliasIDList.Remove(eid);
+				_removeEntityAliasID(eid);
 			}
 		}
 
@@ -219,6 +219,11 @@ NETWORK_INTERFACE_DECLARE_BEGIN(ClientInterface)
 	// server heartbeat callback
 	CLIENT_MESSAGE_DECLARE_ARGS0(onAppActiveTickCB,							NETWORK_FIXED_MESSAGE)
 
+	// The login waits in the loginapp queue, position 1 is the next login forwarded to dbmgr
+	CLIENT_MESSAGE_DECLARE_ARGS2(onLoginQueuePosition,						NETWORK_FIXED_MESSAGE,
+									uint32,									position,
+									uint32,									waitSeconds)
+
 	NETWORK_INTERFACE_DECLARE_END()
 
 #ifdef DEFINE_IN_INTERFACE
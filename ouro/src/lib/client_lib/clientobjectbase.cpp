@@ -387,7 +387,8 @@ client::Entity* ClientObjectBase::createEntity(const char* entityType, PyObject*
 //-------------------------------------------------------------------------------------
 ENTITY_ID ClientObjectBase::getViewEntityID(ENTITY_ID id)
 {
-	if(id <= 255 && EntityDef::entityAliasID() && pEntityIDAliasIDList_.size() <= 255)
+	if(EntityDef::entityAliasID() && pEntityIDAliasIDList_.size() <= 65536 && id >= 0 && 
+		id < (ENTITY_ID)pEntityIDAliasIDList_.size())
 	{
 		return pEntityIDAliasIDList_[id];
 	}
@@ -406,14 +407,24 @@ ENTITY_ID ClientObjectBase::getViewEntityIDFromStream(MemoryStream& s)
 		return id;
 	}
 
-	if(pEntityIDAliasIDList_.size() > 255)
+	if(pEntityIDAliasIDList_.size() > 65536)
 	{
 		s >> id;
 	}
 	else
 	{
-		uint8 aliasID = 0;
-		s >> aliasID;
+		uint16 aliasID = 0;
+
+		if(pEntityIDAliasIDList_.size() > 256)
+		{
+			s >> aliasID;
+		}
+		else
+		{
+			uint8 aliasID8 = 0;
+			s >> aliasID8;
+			aliasID = aliasID8;
+		}
 
 		// If 0 and the client's previous step is to re-login or reconnect and the server entity is online during the disconnection
 		// This error can be ignored, because cellapp may always send synchronization messages to baseapp, not waiting when the client reconnects
@@ -428,11 +439,37 @@ ENTITY_ID ClientObjectBase::getViewEntityIDFromStream(MemoryStream& s)
 }
 
 //-------------------------------------------------------------------------------------
-ENTITY_ID ClientObjectBase::getViewEntityIDByAliasID(uint8 id)
+ENTITY_ID ClientObjectBase::getViewEntityIDByAliasID(uint16 id)
 {
+	if (id >= pEntityIDAliasIDList_.size())
+		return 0;
+
 	return pEntityIDAliasIDList_[id];
 }
 
+//-------------------------------------------------------------------------------------
+void ClientObjectBase::addViewEntityAliasID(ENTITY_ID eid)
+{
+	std::vector<ENTITY_ID>::iterator iter = std::find(pEntityIDAliasIDList_.begin(), pEntityIDAliasIDList_.end(), 0);
+	if (iter != pEntityIDAliasIDList_.end())
+		(*iter) = eid;
+	else
+		pEntityIDAliasIDList_.push_back(eid);
+}
+
+//-------------------------------------------------------------------------------------
+void ClientObjectBase::removeViewEntityAliasID(ENTITY_ID eid)
+{
+	std::vector<ENTITY_ID>::iterator iter = std::find(pEntityIDAliasIDList_.begin(), pEntityIDAliasIDList_.end(), eid);
+	if (iter == pEntityIDAliasIDList_.end())
+		return;
+
+	(*iter) = 0;
+
+	while (pEntityIDAliasIDList_.size() > 0 && pEntityIDAliasIDList_.back() == 0)
+		pEntityIDAliasIDList_.pop_back();
+}
+
 //-------------------------------------------------------------------------------------
 bool ClientObjectBase::registerEventHandle(EventHandle* pEventHandle)
 {
@@ -722,6 +759,17 @@ void ClientObjectBase::onLoginFailed(Network::Channel * pChannel, MemoryStream&
 	eventHandler_.fire(&eventdata);
 }
 
+//-------------------------------------------------------------------------------------	
+void ClientObjectBase::onLoginQueuePosition(Network::Channel * pChannel, uint32 position, uint32 waitSeconds)
+{
+	INFO_MSG(fmt::format("ClientObjectBase::onLoginQueuePosition: {} position={}, waitSeconds={}\n", name_, position, waitSeconds));
+
+	EventData_LoginQueuePosition eventdata;
+	eventdata.position = position;
+	eventdata.waitSeconds = waitSeconds;
+	eventHandler_.fire(&eventdata);
+}
+
 //-------------------------------------------------------------------------------------	
 void ClientObjectBase::onLoginBaseappFailed(Network::Channel * pChannel, SERVER_ERROR_CODE failedcode)
 {
@@ -844,7 +892,7 @@ void ClientObjectBase::onEntityEnterWorld(Network::Channel * pChannel, MemoryStr
 		s >> isOnGround;
 
 	if(eid != entityID_ && entityID_ > 0)
-		pEntityIDAliasIDList_.push_back(eid);
+		addViewEntityAliasID(eid);
 
 	client::Entity* entity = pEntities_->find(eid);
 	if(entity == NULL)
@@ -977,7 +1025,7 @@ void ClientObjectBase::onEntityLeaveWorld(Network::Channel * pChannel, ENTITY_ID
 	if(entityID_ != eid)
 	{
 		destroyEntity(eid, false);
-		pEntityIDAliasIDList_.erase(std::remove(pEntityIDAliasIDList_.begin(), pEntityIDAliasIDList_.end(), eid), pEntityIDAliasIDList_.end());
+		removeViewEntityAliasID(eid);
 	}
 	else
 	{
@@ -120,6 +120,14 @@ public:
 	*/
 	ENTITY_ID readEntityIDFromStream(MemoryStream& s);
 
+	/**
+		An entity entering the world takes the lowest free alias slot and frees it when it leaves,
+		the free slots at the end are dropped. The server's Witness keeps the same slots.
+		The aliasIDs are sent in 1 byte while there are no more than 256 slots, 2 bytes up to 65536
+	*/
+	void addViewEntityAliasID(ENTITY_ID eid);
+	void removeViewEntityAliasID(ENTITY_ID eid);
+
 	/**
 		Try to get an instance of channel by entityCall
 	*/
@@ -169,6 +177,13 @@ public:
 	virtual void onLoginFailed(Network::Channel * pChannel, MemoryStream& s);
 
 		/** Network Interface
+	   The login waits in the loginapp queue
+	   @position: 1 is the next login forwarded to dbmgr
+	   @waitSeconds: estimated by the loginapp from its current admission rate
+	*/
+	virtual void onLoginQueuePosition(Network::Channel * pChannel, uint32 position, uint32 waitSeconds);
+
+		/** Network Interface
 	   	   login successful
 	   @ip: Server ip address
 	   @port: server port
@@ -394,7 +409,7 @@ public:
 
 	ENTITY_ID getViewEntityID(ENTITY_ID id);
 	ENTITY_ID getViewEntityIDFromStream(MemoryStream& s);
-	ENTITY_ID getViewEntityIDByAliasID(uint8 id);
+	ENTITY_ID getViewEntityIDByAliasID(uint16 id);
 
 	/** 
 		Space related operation interface
@@ -448,6 +463,7 @@ protected:
 
 	// store all the containers of the entity
 	Entities<client::Entity>*								pEntities_;	
+	// aliasID -> entityID, 0 if the slot is free
 	std::vector<ENTITY_ID>									pEntityIDAliasIDList_;
 
 	PY_CALLBACKMGR											pyCallbackMgr_;
@@ -33,6 +33,7 @@ typedef int32 EventID;
 #define CLIENT_EVENT_ON_KICKED 19
 #define CLIENT_EVENT_LAST_ACCOUNT_INFO 20
 #define CLIENT_EVENT_SCRIPT_VERSION_NOT_MATCH 21
+#define CLIENT_EVENT_LOGIN_QUEUE_POSITION 22
 
 struct EventData
 {
@@ -95,6 +96,19 @@ struct EventData_LoginFailed : public EventData
 	int failedcode;
 };
 
+struct EventData_LoginQueuePosition : public EventData
+{
+	EventData_LoginQueuePosition():
+	EventData(CLIENT_EVENT_LOGIN_QUEUE_POSITION),
+	position(0),
+	waitSeconds(0)
+	{
+	}
+
+	uint32 position;
+	uint32 waitSeconds;
+};
+
 struct EventData_LoginBaseappSuccess : public EventData
 {
 	EventData_LoginBaseappSuccess():
@@ -366,6 +380,9 @@ inline EventData* newOuroborosEvent(EventID v)
 		case CLIENT_EVENT_LOGIN_FAILED:
 			return new EventData_LoginFailed();
 			break;
+		case CLIENT_EVENT_LOGIN_QUEUE_POSITION:
+			return new EventData_LoginQueuePosition();
+			break;
 		case CLIENT_EVENT_LOGIN_BASEAPP_SUCCESS:
 			return new EventData_LoginBaseappSuccess();
 			break;
@@ -448,6 +465,10 @@ inline EventData* copyOuroborosEvent(const Ouroboros::EventData* lpEventData)
 			peventdata = new EventData_LoginFailed();
 			(*static_cast<EventData_LoginFailed*>(peventdata)) = (*static_cast<const EventData_LoginFailed*>(lpEventData));
 			break;
+		case CLIENT_EVENT_LOGIN_QUEUE_POSITION:
+			peventdata = new EventData_LoginQueuePosition();
+			(*static_cast<EventData_LoginQueuePosition*>(peventdata)) = (*static_cast<const EventData_LoginQueuePosition*>(lpEventData));
+			break;
 		case CLIENT_EVENT_LOGIN_BASEAPP_SUCCESS:
 			peventdata = new EventData_LoginBaseappSuccess();
 			(*static_cast<EventData_LoginBaseappSuccess*>(peventdata)) = (*static_cast<const EventData_LoginBaseappSuccess*>(lpEventData));
@@ -0,0 +1,164 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "mapped_file.h"
+
+#if OURO_PLATFORM != PLATFORM_WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Ouroboros{
+
+//-------------------------------------------------------------------------------------
+MappedFile::MappedFile():
+data_(NULL),
+size_(0),
+copyOnWrite_(false)
+#if OURO_PLATFORM == PLATFORM_WIN32
+,hFile_(INVALID_HANDLE_VALUE),
+hMapping_(NULL)
+#endif
+{
+}
+
+//-------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+//-------------------------------------------------------------------------------------
+size_t MappedFile::pageSize()
+{
+#if OURO_PLATFORM == PLATFORM_WIN32
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return (size_t)si.dwPageSize;
+#else
+	long size = sysconf(_SC_PAGESIZE);
+	return size > 0 ? (size_t)size : 4096;
+#endif
+}
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+//-------------------------------------------------------------------------------------
+bool MappedFile::open(const std::string& path, bool copyOnWrite)
+{
+	close();
+
+	hFile_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile_ == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile_, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+
+	hMapping_ = CreateFileMappingA(hFile_, NULL, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+	if (hMapping_ == NULL)
+	{
+		close();
+		return false;
+	}
+
+	data_ = (uint8*)MapViewOfFile(hMapping_, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+	if (data_ == NULL)
+	{
+		close();
+		return false;
+	}
+
+	size_ = (size_t)fileSize.QuadPart;
+	copyOnWrite_ = copyOnWrite;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void MappedFile::close()
+{
+	if (data_)
+		UnmapViewOfFile(data_);
+
+	if (hMapping_)
+		CloseHandle(hMapping_);
+
+	if (hFile_ != INVALID_HANDLE_VALUE)
+		CloseHandle(hFile_);
+
+	data_ = NULL;
+	size_ = 0;
+	hMapping_ = NULL;
+	hFile_ = INVALID_HANDLE_VALUE;
+}
+
+//-------------------------------------------------------------------------------------
+bool MappedFile::discard(size_t offset, size_t length)
+{
+	// The private pages of a FILE_MAP_COPY view can not be handed back
+	return false;
+}
+
+#else
+//-------------------------------------------------------------------------------------
+bool MappedFile::open(const std::string& path, bool copyOnWrite)
+{
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* p = mmap(NULL, (size_t)st.st_size, copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping keeps the file referenced
+	::close(fd);
+
+	if (p == MAP_FAILED)
+		return false;
+
+	data_ = (uint8*)p;
+	size_ = (size_t)st.st_size;
+	copyOnWrite_ = copyOnWrite;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void MappedFile::close()
+{
+	if (data_)
+		munmap(data_, size_);
+
+	data_ = NULL;
+	size_ = 0;
+}
+
+//-------------------------------------------------------------------------------------
+bool MappedFile::discard(size_t offset, size_t length)
+{
+	if (!copyOnWrite_ || data_ == NULL || offset + length > size_)
+		return false;
+
+	size_t page = pageSize();
+	size_t begin = (offset + page - 1) / page * page;
+	size_t end = (offset + length) / page * page;
+
+	if (end <= begin)
+		return true;
+
+	// A private file mapping reads the file again after MADV_DONTNEED
+	return madvise(data_ + begin, end - begin, MADV_DONTNEED) == 0;
+}
+#endif
+
+//-------------------------------------------------------------------------------------
+}
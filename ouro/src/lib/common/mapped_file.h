@@ -0,0 +1,58 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_MAPPED_FILE_H
+#define OURO_MAPPED_FILE_H
+
+#include "common/platform.h"
+#include <string>
+
+namespace Ouroboros{
+
+/*
+	A file mapped into memory.
+	The pages are shared through the page cache by every process that maps the same file.
+	A copy-on-write mapping can be modified, modified pages become private to the process
+	and discard() hands them back so they are read from the file again.
+*/
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	/**
+		copyOnWrite: the mapping is writable, changes never reach the file
+	*/
+	bool open(const std::string& path, bool copyOnWrite = false);
+	void close();
+
+	bool isOpen() const { return data_ != NULL; }
+
+	uint8* data() const { return data_; }
+	size_t size() const { return size_; }
+
+	/**
+		Drops the private copies of the pages that lie completely inside the range,
+		returns false if the platform can not do that
+	*/
+	bool discard(size_t offset, size_t length);
+
+	static size_t pageSize();
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	uint8* data_;
+	size_t size_;
+	bool copyOnWrite_;
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	HANDLE hFile_;
+	HANDLE hMapping_;
+#endif
+};
+
+}
+
+#endif // OURO_MAPPED_FILE_H
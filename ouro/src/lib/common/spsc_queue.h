@@ -0,0 +1,128 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_SPSC_QUEUE_H
+#define OURO_SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+namespace Ouroboros{
+
+/*
+	Unbounded single producer single consumer queue.
+	Items are written into fixed blocks, the producer links a new block when the current one is full
+	and the consumer frees a block once it has read past its end, neither side ever takes a lock.
+
+	push() must only be called by the producer thread, pop()/empty() only by the consumer thread.
+*/
+template<typename T, size_t BLOCK_SIZE = 256>
+class SPSCQueue
+{
+public:
+	SPSCQueue():
+	pHead_(new BLOCK()),
+	pTail_(pHead_),
+	size_(0)
+	{
+	}
+
+	~SPSCQueue()
+	{
+		while(pHead_)
+		{
+			BLOCK* pNext = pHead_->pNext.load(std::memory_order_relaxed);
+			delete pHead_;
+			pHead_ = pNext;
+		}
+	}
+
+	void push(const T& item)
+	{
+		size_t wpos = pTail_->wpos.load(std::memory_order_relaxed);
+
+		if(wpos == BLOCK_SIZE)
+		{
+			BLOCK* pBlock = new BLOCK();
+			pTail_->pNext.store(pBlock, std::memory_order_release);
+			pTail_ = pBlock;
+			wpos = 0;
+		}
+
+		// Counted first so that size() never drops below zero
+		size_.fetch_add(1, std::memory_order_relaxed);
+		pTail_->items[wpos] = item;
+		pTail_->wpos.store(wpos + 1, std::memory_order_release);
+	}
+
+	bool pop(T& item)
+	{
+		while(true)
+		{
+			size_t rpos = pHead_->rpos;
+
+			if(rpos < pHead_->wpos.load(std::memory_order_acquire))
+			{
+				item = pHead_->items[rpos];
+				pHead_->rpos = rpos + 1;
+				size_.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			if(rpos < BLOCK_SIZE)
+				return false;
+
+			// The producer has moved on, the block is no longer referenced by it
+			BLOCK* pNext = pHead_->pNext.load(std::memory_order_acquire);
+			if(pNext == NULL)
+				return false;
+
+			delete pHead_;
+			pHead_ = pNext;
+		}
+	}
+
+	bool empty() const
+	{
+		return size_.load(std::memory_order_acquire) == 0;
+	}
+
+	/**
+		Approximate, may be read from any thread
+	*/
+	size_t size() const
+	{
+		return size_.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct BLOCK
+	{
+		BLOCK():
+		wpos(0),
+		rpos(0),
+		pNext(NULL)
+		{
+		}
+
+		T items[BLOCK_SIZE];
+		std::atomic<size_t> wpos;
+		size_t rpos;
+		std::atomic<BLOCK*> pNext;
+	};
+
+	// Owned by the consumer
+	BLOCK* pHead_;
+
+	// Owned by the producer
+	BLOCK* pTail_;
+
+	std::atomic<size_t> size_;
+
+private:
+	SPSCQueue(const SPSCQueue&);
+	SPSCQueue& operator=(const SPSCQueue&);
+};
+
+}
+
+#endif // OURO_SPSC_QUEUE_H
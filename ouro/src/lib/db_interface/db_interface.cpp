@@ -9,6 +9,7 @@
 #include "db_redis/db_interface_redis.h"
 #include "server/serverconfig.h"
 #include "thread/threadpool.h"
+#include "helper/metrics.h"
 
 namespace Ouroboros { 
 OURO_SINGLETON_INIT(DBUtil);
@@ -39,11 +40,31 @@ bool DBUtil::initializeWatcher()
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+bool DBUtil::initializeMetrics()
+{
+	if(DBTaskBase::pQueueLatencyHistogram == NULL)
+	{
+		DBTaskBase::pQueueLatencyHistogram = Metrics::root().addHistogram("ouro_db_task_queue_seconds", 
+			"Time a database task waited for a database thread");
+	}
+
+	if(DBTaskBase::pProcessLatencyHistogram == NULL)
+	{
+		DBTaskBase::pProcessLatencyHistogram = Metrics::root().addHistogram("ouro_db_task_seconds", 
+			"Time a database thread spent executing a task");
+	}
+
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 bool DBUtil::initThread(const std::string& dbinterfaceName)
 {
 	DBInterfaceInfo* pDBInfo = g_ouroSrvConfig.dbInterface(dbinterfaceName);
-	if (strcmp(pDBInfo->db_type, "mysql") == 0)
+
+	// The threads of redis also write behind to mysql
+	if (strcmp(pDBInfo->db_type, "mysql") == 0 || pDBInfo->writeBehind.size() > 0)
 	{
 		if (!mysql_thread_safe()) 
 		{
@@ -62,7 +83,7 @@ bool DBUtil::initThread(const std::string& dbinterfaceName)
 bool DBUtil::finiThread(const std::string& dbinterfaceName)
 {
 	DBInterfaceInfo* pDBInfo = g_ouroSrvConfig.dbInterface(dbinterfaceName);
-	if (strcmp(pDBInfo->db_type, "mysql") == 0)
+	if (strcmp(pDBInfo->db_type, "mysql") == 0 || pDBInfo->writeBehind.size() > 0)
 	{
 		mysql_thread_end();
 	}
@@ -118,6 +139,9 @@ void DBUtil::finalise()
 		SAFE_RELEASE(iter->second);
 	}
 
+	// What the threads have not written behind yet
+	DBInterfaceRedis::flushWriteBehind();
+
 	pThreadPoolMaps_.clear();
 }
 
@@ -127,6 +151,8 @@ void DBUtil::handleMainTick()
 	DBUtil::DBThreadPoolMap::iterator iter = pThreadPoolMaps_.begin();
 	for (; iter != pThreadPoolMaps_.end(); ++iter)
 		iter->second->onMainThreadTick();
+
+	DBInterfaceRedis::handleMainTick();
 }
 
 //-------------------------------------------------------------------------------------
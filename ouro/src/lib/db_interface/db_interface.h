@@ -164,6 +164,7 @@ public:
 	static bool initialize();
 	static void finalise();
 	static bool initializeWatcher();
+	static bool initializeMetrics();
 
 	static bool initThread(const std::string& dbinterfaceName);
 	static bool finiThread(const std::string& dbinterfaceName);
@@ -5,9 +5,13 @@
 #include "entity_table.h"
 #include "thread/threadpool.h"
 #include "common/memorystream.h"
+#include "helper/metrics.h"
 
 namespace Ouroboros{
 
+MetricsHistogram* DBTaskBase::pQueueLatencyHistogram = NULL;
+MetricsHistogram* DBTaskBase::pProcessLatencyHistogram = NULL;
+
 //-------------------------------------------------------------------------------------
 bool DBTaskBase::process()
 {
@@ -22,7 +26,14 @@ bool DBTaskBase::process()
 			(double(duration)/stampsPerSecondD()), pdbi_->lastquery()));
 	}
 
+	if(pQueueLatencyHistogram)
+		pQueueLatencyHistogram->observe(startTime - initTime_);
+
 	duration = timestamp() - startTime;
+
+	if(pProcessLatencyHistogram)
+		pProcessLatencyHistogram->observe(duration);
+
 	if (duration > stampsPerSecond() * 0.2f)
 	{
 		WARNING_MSG(fmt::format("DBTask::process(): took {:.2f} seconds\nsql:({})\n", 
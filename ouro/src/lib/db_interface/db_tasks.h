@@ -13,6 +13,7 @@ class MemoryStream;
 class DBInterface;
 class EntityTable;
 class EntityTables;
+class MetricsHistogram;
 
 /*
 	Database thread task base class
@@ -37,6 +38,10 @@ public:
 
 	uint64 initTime() const{ return initTime_; }
 
+	// Time waiting in the pool and time spent in db_thread_process, NULL while metrics are disabled
+	static MetricsHistogram* pQueueLatencyHistogram;
+	static MetricsHistogram* pProcessLatencyHistogram;
+
 protected:
 	DBInterface* pdbi_;
 	uint64 initTime_;
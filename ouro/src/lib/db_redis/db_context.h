@@ -11,28 +11,19 @@ namespace Ouroboros {
 namespace redis { 
 
 /**
-	It is used when reading and writing delete operations, and contains various information to be fetched or to be written.
+	It is used when reading and writing an entity, and contains the fields to be fetched or to be written.
 
-	Dbid: If the primary table is the dbid of the entity, the child table is the dbid of the current query.
+	An entity is kept in one hash(tbl_<entityType>:<dbid>), every persistent property is a field of the hash,
+	fixed dictionaries are flattened into the fields of their keys like the columns of MySQL, and an array or a
+	component is one field holding the persistent stream of its value.
 
-	Dbids: There is only one dbid in the dbids on the main table, which is the id of the entity. If the entity data exists in the array class, there will be a child table. When the data structure describes a child table,
-		Dbids is the sub-table index of this array. Each dbid represents the corresponding value on this sub-table and also represents the value of the corresponding position in the array in the order of arrangement.
-		dbids = {
-			123 : [xxx, xxx, ...], // 123 is a dbid on the parent table, and the array is the dbids associated with the parent table on the child table.
-			...
-		}
+	Items: The fields of the hash, if it is a write, the value of each field is in extraDatas.
 
-	Items: There is field information of this table. If it is a write library, there is also a corresponding value to be written in the field.
-
-	Optable: subtable structure
-
-	Results: The data that is queried during the read operation. The arrangement of the data corresponds to the number of strkeys in the items multiplied by the number of dbids.
-	readresultIdx: Because the number in results is dbids * items, when filling data in some recursive reads, the padding position is calculated based on this readresultIdx.
-
-	parentTableDBID: the dbid of the parent table
-	parentTableName: the name of the parent table
+	Results: The values of the fields of items read by HMGET, first is false if the field does not exist.
+	readresultIdx: The next result to be filled into the stream.
 
 	tableName: the name of the current table
+	dbid: the dbid of the entity
  */
 class DBContext
 {
@@ -42,15 +33,19 @@ public:
 	*/
 	struct DB_ITEM_DATA
 	{
-		char sqlval[MAX_BUF];
 		const char* sqlkey;
 		std::string extraDatas;
 	};
 
-	typedef std::vector< std::pair< std::string/*tableName*/, OUROShared_ptr< DBContext > > > DB_RW_CONTEXTS;
-	typedef std::vector< OUROShared_ptr<DB_ITEM_DATA>  > DB_ITEM_DATAS;
+	typedef std::vector< DB_ITEM_DATA > DB_ITEM_DATAS;
+	typedef std::vector< std::pair< bool, std::string > > DB_RESULTS;
 
-	DBContext()
+	DBContext():
+	items(),
+	tableName(),
+	dbid(0),
+	results(),
+	readresultIdx(0)
 	{
 	}
 
@@ -58,24 +53,31 @@ public:
 	{
 	}
 	
+	void addItem(const char* sqlkey, const std::string& value = "")
+	{
+		DB_ITEM_DATA item;
+		item.sqlkey = sqlkey;
+		item.extraDatas = value;
+		items.push_back(item);
+	}
+
+	/**
+		The next result, NULL if the field does not exist
+	*/
+	const std::string* readResult()
+	{
+		OURO_ASSERT(readresultIdx < results.size());
+		std::pair< bool, std::string >& result = results[readresultIdx++];
+		return result.first ? &result.second : NULL;
+	}
+
 	DB_ITEM_DATAS items;
 	
 	std::string tableName;
-	std::string parentTableName;
-	
-	DBID parentTableDBID;
 	DBID dbid;
 	
-	DB_RW_CONTEXTS optable;
-	
-	bool isEmpty;
-	
-	std::map<DBID, std::vector<DBID> > dbids;
-	std::vector< std::string >results;
-	std::vector< std::string >::size_type readresultIdx;
-
-private:
-
+	DB_RESULTS results;
+	DB_RESULTS::size_type readresultIdx;
 };
 
 }
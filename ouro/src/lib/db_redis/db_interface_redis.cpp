@@ -3,27 +3,59 @@
 
 #include "redis_helper.h"
 #include "ouro_table_redis.h"
+#include "entity_table_redis.h"
 #include "db_exception.h"
 #include "redis_watcher.h"
 #include "db_interface_redis.h"
 #include "thread/threadguard.h"
+#include "thread/threadpool.h"
 #include "helper/watcher.h"
 #include "server/serverconfig.h"
 
 namespace Ouroboros { 
 
+std::map<std::string, uint64> DBInterfaceRedis::writeBehindTimes_;
+
+//-------------------------------------------------------------------------------------
+static std::string argsToString(const std::vector<std::string>& args)
+{
+	std::string str;
+
+	std::vector<std::string>::const_iterator iter = args.begin();
+	for (; iter != args.end(); ++iter)
+	{
+		if (str.size() > 0)
+			str += " ";
+
+		// Values may be binary
+		if (iter->size() > 64 || std::find_if(iter->begin(), iter->end(), 
+			[](char c) { return !isprint((unsigned char)c); }) != iter->end())
+			str += fmt::format("<{} bytes>", iter->size());
+		else
+			str += (*iter);
+	}
+
+	return str;
+}
+
 //-------------------------------------------------------------------------------------
 DBInterfaceRedis::DBInterfaceRedis(const char* name) :
 DBInterface(name),
 pRedisContext_(NULL),
 hasLostConnection_(false),
-inTransaction_(false)
+inTransaction_(false),
+pWriteBehind_(NULL)
 {
 }
 
 //-------------------------------------------------------------------------------------
 DBInterfaceRedis::~DBInterfaceRedis()
 {
+	if (pWriteBehind_)
+	{
+		pWriteBehind_->detach();
+		SAFE_RELEASE(pWriteBehind_);
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -47,7 +79,11 @@ bool DBInterfaceRedis::checkEnvironment()
 //-------------------------------------------------------------------------------------
 bool DBInterfaceRedis::checkErrors()
 {
-	if (!RedisHelper::hasTable(this, fmt::format("{}:*", DBUtil::accountScriptName()), true))
+	// With a write-behind interface the accounts may only be in mysql until they are read
+	if (pWriteBehind_)
+		return true;
+
+	if (!RedisHelper::hasTable(this, fmt::format(ENTITY_TABLE_PERFIX "_{}:*", DBUtil::accountScriptName()), true))
 	{
 		WARNING_MSG(fmt::format("DBInterfaceRedis::checkErrors: not found {} table, reset " OURO_TABLE_PERFIX "_* table...\n", 
 			DBUtil::accountScriptName()));
@@ -185,7 +221,34 @@ bool DBInterfaceRedis::attach(const char* databaseName)
 	pRedisContext_ = c;  
               
 	DEBUG_MSG(fmt::format("DBInterfaceRedis::attach: successfully! addr: {}:{}\n", db_ip_, db_port_));
-	return ping();
+
+	if (!ping())
+		return false;
+
+	// The connection of the write-behind interface is kept when redis is reattached
+	DBInterfaceInfo* pDBInfo = g_ouroSrvConfig.dbInterface(name());
+	if (pDBInfo && pDBInfo->writeBehind.size() > 0 && pWriteBehind_ == NULL)
+	{
+		DBInterfaceInfo* pWriteBehindInfo = g_ouroSrvConfig.dbInterface(pDBInfo->writeBehind);
+		if (!pWriteBehindInfo || strcmp(pWriteBehindInfo->db_type, "mysql") != 0 || pWriteBehindInfo->isPure)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::attach: writeBehind({}) of {} must be a mysql interface that is not pure!\n",
+				pDBInfo->writeBehind, name()));
+
+			return false;
+		}
+
+		pWriteBehind_ = DBUtil::createInterface(pDBInfo->writeBehind, false);
+		if (pWriteBehind_ == NULL)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::attach: couldn't attach to writeBehind({}) of {}!\n",
+				pDBInfo->writeBehind, name()));
+
+			return false;
+		}
+	}
+
+	return true;
 }
 
 //-------------------------------------------------------------------------------------
@@ -399,6 +462,111 @@ bool DBInterfaceRedis::getQueryReply(redisReply **pRedisReply)
 	return redisGetReply(pRedisContext_, (void**)pRedisReply) == REDIS_OK;
 }
 
+//-------------------------------------------------------------------------------------
+bool DBInterfaceRedis::query(const std::vector<std::string>& args, redisReply** pRedisReply, bool printlog)
+{
+	*pRedisReply = NULL;
+
+	if (!queryAppend(args, printlog))
+		return false;
+
+	std::vector<redisReply*> replies;
+	bool ret = getQueryReplies(1, &replies);
+
+	*pRedisReply = replies[0];
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceRedis::queryAppend(const std::vector<std::string>& args, bool printlog)
+{
+	OURO_ASSERT(pRedisContext_ && args.size() > 0);
+
+	std::vector<const char*> argv(args.size());
+	std::vector<size_t> argvlen(args.size());
+
+	for (size_t i = 0; i < args.size(); ++i)
+	{
+		argv[i] = args[i].data();
+		argvlen[i] = args[i].size();
+	}
+
+	int ret = redisAppendCommandArgv(pRedisContext_, (int)args.size(), &argv[0], &argvlen[0]);
+
+	if(lastquery_.size() > 0 && lastquery_[lastquery_.size() - 1] != ';')
+		lastquery_ = "";
+
+	std::string cmd = argsToString(args);
+	lastquery_ += cmd;
+	lastquery_ += ";";
+	RedisWatcher::querystatistics(cmd.c_str(), (uint32)cmd.size());
+
+	if (ret == REDIS_ERR) 
+	{	
+		if(printlog)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::queryAppend: cmd={}, errno={}, error={}\n",
+				cmd, pRedisContext_->err, pRedisContext_->errstr));
+		}
+
+		this->throwError(NULL);
+		return false;
+	}  
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceRedis::getQueryReplies(size_t count, std::vector<redisReply*>* pRedisReplies)
+{
+	bool ret = true;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		redisReply* pRedisReply = NULL;
+
+		if (!getQueryReply(&pRedisReply))
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::getQueryReplies: cmd={}, errno={}, error={}\n",
+				lastquery_, pRedisContext_->err, pRedisContext_->errstr));
+
+			if (pRedisReplies)
+			{
+				std::vector<redisReply*>::iterator iter = pRedisReplies->begin();
+				for (; iter != pRedisReplies->end(); ++iter)
+				{
+					if (*iter)
+						freeReplyObject(*iter);
+				}
+
+				pRedisReplies->clear();
+			}
+
+			if (pRedisReply)
+				freeReplyObject(pRedisReply);
+
+			// The replies left are lost with the connection
+			this->throwError(NULL);
+			return false;
+		}
+
+		if (pRedisReply->type == REDIS_REPLY_ERROR)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::getQueryReplies: cmd={}, error={}\n",
+				lastquery_, pRedisReply->str));
+
+			ret = false;
+		}
+
+		if (pRedisReplies)
+			pRedisReplies->push_back(pRedisReply);
+		else
+			freeReplyObject(pRedisReply);
+	}
+
+	return ret;
+}
+
 //-------------------------------------------------------------------------------------
 void DBInterfaceRedis::write_query_result(redisReply* pRedisReply, MemoryStream * result)
 {
@@ -504,7 +672,7 @@ int DBInterfaceRedis::getlasterror()
 //-------------------------------------------------------------------------------------
 EntityTable* DBInterfaceRedis::createEntityTable(EntityTables* pEntityTables)
 {
-	return NULL;
+	return new EntityTableRedis(pEntityTables);
 }
 
 //-------------------------------------------------------------------------------------
@@ -613,5 +781,97 @@ bool DBInterfaceRedis::processException(std::exception & e)
 	return retry;
 }
 
+//-------------------------------------------------------------------------------------
+void DBInterfaceRedis::handleMainTick()
+{
+	ENGINE_COMPONENT_INFO& dbcfg = g_ouroSrvConfig.getDBMgr();
+	uint64 now = timestamp();
+
+	std::vector<DBInterfaceInfo>::iterator dbinfo_iter = dbcfg.dbInterfaceInfos.begin();
+	for (; dbinfo_iter != dbcfg.dbInterfaceInfos.end(); ++dbinfo_iter)
+	{
+		if ((*dbinfo_iter).writeBehind.size() == 0 || strcmp((*dbinfo_iter).db_type, "redis") != 0)
+			continue;
+
+		std::map<std::string, uint64>::iterator iter = writeBehindTimes_.find((*dbinfo_iter).name);
+		if (iter == writeBehindTimes_.end())
+		{
+			writeBehindTimes_[(*dbinfo_iter).name] = now + (*dbinfo_iter).writeBehind_flushInterval * stampsPerSecond();
+			continue;
+		}
+
+		// The last one is still running
+		if (iter->second == 0 || now < iter->second)
+			continue;
+
+		thread::ThreadPool* pThreadPool = DBUtil::pThreadPool((*dbinfo_iter).name);
+		if (!pThreadPool || !pThreadPool->isInitialize())
+			continue;
+
+		iter->second = 0;
+		pThreadPool->addTask(new DBTaskRedisWriteBehind((*dbinfo_iter).name, (*dbinfo_iter).writeBehind_batchSize));
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void DBInterfaceRedis::onWriteBehind(const std::string& dbInterfaceName)
+{
+	DBInterfaceInfo* pDBInfo = g_ouroSrvConfig.dbInterface(dbInterfaceName);
+	OURO_ASSERT(pDBInfo);
+
+	writeBehindTimes_[dbInterfaceName] = timestamp() + pDBInfo->writeBehind_flushInterval * stampsPerSecond();
+}
+
+//-------------------------------------------------------------------------------------
+void DBInterfaceRedis::flushWriteBehind()
+{
+	ENGINE_COMPONENT_INFO& dbcfg = g_ouroSrvConfig.getDBMgr();
+
+	std::vector<DBInterfaceInfo>::iterator dbinfo_iter = dbcfg.dbInterfaceInfos.begin();
+	for (; dbinfo_iter != dbcfg.dbInterfaceInfos.end(); ++dbinfo_iter)
+	{
+		if ((*dbinfo_iter).writeBehind.size() == 0 || strcmp((*dbinfo_iter).db_type, "redis") != 0)
+			continue;
+
+		DBInterface* pdbi = DBUtil::createInterface((*dbinfo_iter).name, false);
+		if (!pdbi)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::flushWriteBehind: couldn't flush {}, the entities are written "
+				"when the interface is started again!\n", (*dbinfo_iter).name));
+
+			continue;
+		}
+
+		try
+		{
+			EntityTables& entityTables = EntityTables::findByInterfaceName(pdbi->name());
+			EntityTables::TABLES_MAP::const_iterator iter = entityTables.tables().begin();
+
+			for (; iter != entityTables.tables().end(); ++iter)
+			{
+				if (iter->second->isChild())
+					continue;
+
+				EntityTableRedis* pTable = static_cast<EntityTableRedis*>(iter->second.get());
+
+				uint32 count = pTable->writeBehind(static_cast<DBInterfaceRedis*>(pdbi), (*dbinfo_iter).writeBehind_batchSize);
+
+				if (count > 0)
+				{
+					INFO_MSG(fmt::format("DBInterfaceRedis::flushWriteBehind: {} entities of {} written to {}.\n",
+						count, pTable->tableName(), (*dbinfo_iter).writeBehind));
+				}
+			}
+		}
+		catch (std::exception& e)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::flushWriteBehind: {}, {}\n", (*dbinfo_iter).name, e.what()));
+		}
+
+		pdbi->detach();
+		delete pdbi;
+	}
+}
+
 //-------------------------------------------------------------------------------------
 }
@@ -26,15 +26,14 @@ class DBException;
 /*
 	Database interface
 	tbl_Account_Auto_increment = uint64(1)
-	tbl_Account:1 = hashes(name, password, xxx)
-	tbl_Account:2 = hashes(name, password, xxx)
-	tbl_Account:3 = hashes(name, password, xxx(array))
-
-	// array of type
-	tbl_Account_xxx_values:3:size = uint64(3)
-	tbl_Account_xxx_values:3:1 = val
-	tbl_Account_xxx_values:3:2 = val
-	tbl_Account_xxx_values:3:3 = val	
+	tbl_Account:1 = hashes(id, sm_autoLoad, sm_name, sm_0_position, sm_1_position, sm_2_position, xxx)
+	tbl_Account:2 = hashes(id, sm_autoLoad, sm_name, xxx)
+	tbl_Account:3 = hashes(id, sm_name, sm_xxx(array, the persistent stream of the array))
+	tbl_Account_autoLoad = sets(1, 3)
+
+	// write-behind(databaseInterfaces->xxx->writeBehind), the entities are written to the MySQL interface by the 
+	// DBTaskRedisWriteBehind of every interface thread, a new entity gets its dbid from the MySQL interface
+	tbl_Account_dirty = hashes(dbid = version)
 */
 class DBInterfaceRedis : public DBInterface
 {
@@ -93,6 +92,18 @@ public:
 	bool query(bool printlog, const char* format, ...);
 	bool queryAppend(bool printlog, const char* format, ...);
 	bool getQueryReply(redisReply **pRedisReply);
+
+	/**
+		Binary safe commands, every argument is passed as it is
+	*/
+	bool query(const std::vector<std::string>& args, redisReply** pRedisReply, bool printlog = true);
+	bool queryAppend(const std::vector<std::string>& args, bool printlog = true);
+
+	/**
+		Get the replies of the commands appended, the replies are released if pRedisReplies is NULL.
+		false if one of the commands failed
+	*/
+	bool getQueryReplies(size_t count, std::vector<redisReply*>* pRedisReplies = NULL);
 	
 	void write_query_result(redisReply* pRedisReply, MemoryStream * result);
 	void write_query_result_element(redisReply* pRedisReply, MemoryStream * result);
@@ -139,11 +150,32 @@ public:
 		Handling exceptions
 	*/
 	virtual bool processException(std::exception & e);
+
+	/**
+		The interface the entities are written behind to, NULL if the entities are only in redis
+	*/
+	DBInterface* pWriteBehind() const { return pWriteBehind_; }
+
+	/**
+		Schedule the write-behind of the interfaces on their threads
+	*/
+	static void handleMainTick();
+	static void onWriteBehind(const std::string& dbInterfaceName);
+
+	/**
+		Write all the entities left behind in redis, called when the threads are finished
+	*/
+	static void flushWriteBehind();
 	
 protected:
 	redisContext* pRedisContext_;
 	bool hasLostConnection_;
 	bool inTransaction_;	
+
+	DBInterface* pWriteBehind_;
+
+	// The next time the write-behind of an interface is scheduled, 0 while it is running
+	static std::map<std::string, uint64> writeBehindTimes_;
 };
 
 
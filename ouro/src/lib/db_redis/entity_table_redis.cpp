@@ -4,9 +4,11 @@
 #include "ouro_table_redis.h"
 #include "entitydef/scriptdef_module.h"
 #include "entitydef/property.h"
+#include "entitydef/entitydef.h"
 #include "db_interface/db_interface.h"
 #include "db_interface/entity_table.h"
 #include "network/fixed_messages.h"
+#include "thread/threadguard.h"
 
 #ifndef CODE_INLINE
 #include "entity_table_redis.inl"
@@ -17,7 +19,8 @@ namespace Ouroboros {
 
 //-------------------------------------------------------------------------------------
 EntityTableRedis::EntityTableRedis(EntityTables* pEntityTables):
-EntityTable(pEntityTables)
+EntityTable(pEntityTables),
+writeBehindMutex_()
 {
 }
 
@@ -40,6 +43,13 @@ bool EntityTableRedis::initialize(ScriptDefModule* sm, std::string name)
 	{
 		PropertyDescription* pdescrs = iter->second;
 
+		// If an entity has no cell part and the component attribute has no base part, it is ignored
+		if (!sm->hasCell())
+		{
+			if (pdescrs->getDataType()->type() == DATA_TYPE_ENTITY_COMPONENT && !pdescrs->hasBase())
+				continue;
+		}
+
 		EntityTableItem* pETItem = this->createItem(pdescrs->getDataType()->getName(), pdescrs->getDefaultValStr());
 
 		pETItem->pParentTable(this);
@@ -194,12 +204,6 @@ bool EntityTableRedis::syncToDB(DBInterface* pdbi)
 	return true;
 }
 
-//-------------------------------------------------------------------------------------
-void EntityTableRedis::queryAutoLoadEntities(DBInterface* pdbi, ScriptDefModule* pModule, 
-		ENTITY_ID start, ENTITY_ID end, std::vector<DBID>& outs)
-{
-}
-
 //-------------------------------------------------------------------------------------
 EntityTableItem* EntityTableRedis::createItem(std::string type, std::string defaultVal)
 {
@@ -310,142 +314,777 @@ EntityTableItem* EntityTableRedis::createItem(std::string type, std::string defa
 	{
 		return new EntityTableItemRedis_ENTITYCALL("blob", 0, 0);
 	}
+	else if (type == "ENTITY_COMPONENT")
+	{
+		return new EntityTableItemRedis_Component("blob", 0, 0);
+	}
 
 	OURO_ASSERT(false && "not found type.\n");
 	return new EntityTableItemRedis_STRING("", 0, 0);
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableRedis::entityShouldAutoLoad(DBInterface* pdbi, DBID dbid, bool shouldAutoLoad)
+// The exceptions of the write-behind interface are not the ones of redis, they are handled here
+template<typename F>
+static bool callWriteBehind(DBInterface* pWriteBehind, F f)
 {
-	if(dbid == 0)
-		return;
-
+	while (true)
+	{
+		try
+		{
+			f();
+			return true;
+		}
+		catch (std::exception& e)
+		{
+			if (!pWriteBehind->processException(e))
+				return false;
+		}
+	}
 }
 
 //-------------------------------------------------------------------------------------
-DBID EntityTableRedis::writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad, MemoryStream* s, ScriptDefModule* pModule)
+std::string EntityTableRedis::entityKey(DBID dbid)
 {
-	return 0;
+	return fmt::format(ENTITY_TABLE_PERFIX "_{}:{}", tableName(), dbid);
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableRedis::removeEntity(DBInterface* pdbi, DBID dbid, ScriptDefModule* pModule)
+std::string EntityTableRedis::tableKey(const char* name)
 {
-	return true;
+	return fmt::format(ENTITY_TABLE_PERFIX "_{}_{}", tableName(), name);
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableRedis::queryTable(DBInterface* pdbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule)
+void EntityTableRedis::queryAutoLoadEntities(DBInterface* pdbi, ScriptDefModule* pModule, 
+		ENTITY_ID start, ENTITY_ID end, std::vector<DBID>& outs)
 {
-	return true;
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
+	DBInterface* pWriteBehind = pdbiRedis->pWriteBehind();
+
+	if (pWriteBehind)
+	{
+		// The autoLoad of the entities left behind in redis is written first
+		DBInterfaceInfo* pDBInfo = g_ouroSrvConfig.dbInterface(pdbi->name());
+		writeBehind(pdbiRedis, pDBInfo->writeBehind_batchSize);
+
+		EntityTables& entityTables = EntityTables::findByInterfaceName(pWriteBehind->name());
+
+		callWriteBehind(pWriteBehind, [&]() 
+		{
+			outs.clear();
+			entityTables.queryAutoLoadEntities(pWriteBehind, pModule, start, end, outs);
+		});
+
+		return;
+	}
+
+	redisReply* pRedisReply = NULL;
+
+	pdbiRedis->query(fmt::format("SORT {} LIMIT {} {}", tableKey(TABLE_AUTOLOAD_CONST_STR), start, end - start), 
+		&pRedisReply, false);
+
+	if (pRedisReply)
+	{
+		if (pRedisReply->type == REDIS_REPLY_ARRAY)
+		{
+			for (size_t j = 0; j < pRedisReply->elements; ++j)
+			{
+				if (pRedisReply->element[j]->type != REDIS_REPLY_STRING)
+					continue;
+
+				DBID dbid = 0;
+				StringConv::str2value(dbid, pRedisReply->element[j]->str);
+				outs.push_back(dbid);
+			}
+		}
+
+		freeReplyObject(pRedisReply);
+	}
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableRedis::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+void EntityTableRedis::entityShouldAutoLoad(DBInterface* pdbi, DBID dbid, bool shouldAutoLoad)
 {
+	if(dbid == 0)
+		return;
+
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
+
+	std::vector<std::string> args;
+	args.push_back("HSET");
+	args.push_back(entityKey(dbid));
+	args.push_back(TABLE_ITEM_PERFIX"_" TABLE_AUTOLOAD_CONST_STR);
+	args.push_back(shouldAutoLoad ? "1" : "0");
+	pdbiRedis->queryAppend(args, false);
+
+	size_t count = 1 + appendAutoLoadQuery(pdbiRedis, dbid, shouldAutoLoad);
+
+	if (pdbiRedis->pWriteBehind())
+		count += appendDirtyQuery(pdbiRedis, dbid);
+
+	pdbiRedis->getQueryReplies(count);
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableRedis::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+size_t EntityTableRedis::appendAutoLoadQuery(DBInterfaceRedis* pdbi, DBID dbid, bool shouldAutoLoad)
 {
+	std::vector<std::string> args;
+	args.push_back(shouldAutoLoad ? "SADD" : "SREM");
+	args.push_back(tableKey(TABLE_AUTOLOAD_CONST_STR));
+	args.push_back(fmt::format("{}", dbid));
+
+	pdbi->queryAppend(args, false);
+	return 1;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableRedis::getReadSqlItem(redis::DBContext& context)
+size_t EntityTableRedis::appendDirtyQuery(DBInterfaceRedis* pdbi, DBID dbid)
 {
+	// Every write gets a new version, the entity is no longer dirty once the version written behind is the last one
+	std::vector<std::string> args;
+	args.push_back("HINCRBY");
+	args.push_back(tableKey("dirty"));
+	args.push_back(fmt::format("{}", dbid));
+	args.push_back("1");
+
+	pdbi->queryAppend(args, false);
+	return 1;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedisBase::init_db_item_name(const char* exstrFlag)
+void EntityTableRedis::appendReadQuery(DBInterfaceRedis* pdbi, redis::DBContext& context)
 {
+	getReadSqlItem(context);
+
+	std::vector<std::string> args;
+	args.push_back("HMGET");
+	args.push_back(entityKey(context.dbid));
+	args.push_back(TABLE_ID_CONST_STR);
+	args.push_back(TABLE_ITEM_PERFIX"_" TABLE_AUTOLOAD_CONST_STR);
+
+	redis::DBContext::DB_ITEM_DATAS::iterator iter = context.items.begin();
+	for (; iter != context.items.end(); ++iter)
+		args.push_back(iter->sqlkey);
+
+	pdbi->queryAppend(args, false);
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR2::isSameKey(std::string key)
+bool EntityTableRedis::readQueryResults(redisReply* pRedisReply, redis::DBContext& context, int8& shouldAutoLoad)
 {
+	shouldAutoLoad = -1;
+
+	if (pRedisReply == NULL || pRedisReply->type != REDIS_REPLY_ARRAY || 
+		pRedisReply->elements != context.items.size() + 2)
+		return false;
+
+	// The entity does not exist
+	if (pRedisReply->element[0]->type != REDIS_REPLY_STRING)
+		return false;
+
+	if (pRedisReply->element[1]->type == REDIS_REPLY_STRING)
+		shouldAutoLoad = atoi(pRedisReply->element[1]->str) > 0 ? 1 : 0;
+
+	context.results.clear();
+	context.readresultIdx = 0;
+
+	for (size_t j = 2; j < pRedisReply->elements; ++j)
+	{
+		redisReply* r = pRedisReply->element[j];
+
+		if (r->type == REDIS_REPLY_STRING)
+			context.results.push_back(std::make_pair(true, std::string(r->str, r->len)));
+		else
+			context.results.push_back(std::make_pair(false, std::string()));
+	}
+
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR2::syncToDB(DBInterface* pdbi, void* pData)
+void EntityTableRedis::appendWriteQuery(DBInterfaceRedis* pdbi, redis::DBContext& context, int8 shouldAutoLoad)
 {
-	return true;
+	std::vector<std::string> args;
+	args.reserve(context.items.size() * 2 + 6);
+
+	args.push_back("HSET");
+	args.push_back(entityKey(context.dbid));
+	args.push_back(TABLE_ID_CONST_STR);
+	args.push_back(fmt::format("{}", context.dbid));
+
+	if (shouldAutoLoad > -1)
+	{
+		args.push_back(TABLE_ITEM_PERFIX"_" TABLE_AUTOLOAD_CONST_STR);
+		args.push_back(shouldAutoLoad > 0 ? "1" : "0");
+	}
+
+	redis::DBContext::DB_ITEM_DATAS::iterator iter = context.items.begin();
+	for (; iter != context.items.end(); ++iter)
+	{
+		args.push_back(iter->sqlkey);
+		args.push_back(iter->extraDatas);
+	}
+
+	pdbi->queryAppend(args, false);
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR2::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+DBID EntityTableRedis::writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad, MemoryStream* s, ScriptDefModule* pModule)
 {
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
+	DBInterface* pWriteBehind = pdbiRedis->pWriteBehind();
+	bool isNew = dbid == 0;
+
+	if (isNew)
+	{
+		if (pWriteBehind)
+		{
+			// A new entity is inserted into the write-behind interface which allocates its dbid, 
+			// the writes after it stay in redis until they are written behind
+			EntityTables& entityTables = EntityTables::findByInterfaceName(pWriteBehind->name());
+
+			callWriteBehind(pWriteBehind, [&]() 
+			{
+				MemoryStream stream;
+				stream.append(s->data() + s->rpos(), s->length());
+				dbid = entityTables.writeEntity(pWriteBehind, 0, shouldAutoLoad, &stream, pModule);
+			});
+		}
+		else
+		{
+			redisReply* pRedisReply = NULL;
+			pdbiRedis->query(fmt::format("INCR {}", tableKey("Auto_increment")), &pRedisReply, false);
+
+			if (pRedisReply)
+			{
+				if (pRedisReply->type == REDIS_REPLY_INTEGER)
+					dbid = pRedisReply->integer;
+
+				freeReplyObject(pRedisReply);
+			}
+		}
+
+		// If the dbid is 0 then the store fails to return
+		if (dbid <= 0)
+			return 0;
+	}
+
+	redis::DBContext context;
+	context.tableName = pModule->getName();
+	context.dbid = dbid;
+
+	while(s->length() > 0)
+	{
+		ENTITY_PROPERTY_UID pid;
+		ENTITY_PROPERTY_UID child_pid;
+		(*s) >> pid >> child_pid;
+		
+		EntityTableItem* pTableItem = this->findItem(child_pid);
+		if(pTableItem == NULL)
+		{
+			ERROR_MSG(fmt::format("EntityTableRedis::writeTable: not found item[{}].\n", child_pid));
+			return dbid;
+		}
+		
+		static_cast<EntityTableItemRedisBase*>(pTableItem)->getWriteSqlItem(pdbi, s, context);
+	};
+
+	bool written = false;
+
+	try
+	{
+		// All the commands of the entity are sent at once
+		appendWriteQuery(pdbiRedis, context, shouldAutoLoad);
+		size_t count = 1;
+
+		// Set whether the entity is automatically loaded
+		if (shouldAutoLoad > -1)
+			count += appendAutoLoadQuery(pdbiRedis, dbid, shouldAutoLoad > 0);
+
+		// A new entity is already in the write-behind interface
+		if (pWriteBehind && !isNew)
+			count += appendDirtyQuery(pdbiRedis, dbid);
+
+		written = pdbiRedis->getQueryReplies(count);
+	}
+	catch (...)
+	{
+		// The task may be run again and insert another row
+		if (isNew && pWriteBehind)
+			removeWriteBehindEntity(pWriteBehind, dbid, pModule);
+
+		throw;
+	}
+
+	if (!written)
+	{
+		if (isNew && pWriteBehind)
+			removeWriteBehindEntity(pWriteBehind, dbid, pModule);
+
+		return 0;
+	}
+
+	return dbid;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR2::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+bool EntityTableRedis::removeWriteBehindEntity(DBInterface* pWriteBehind, DBID dbid, ScriptDefModule* pModule)
 {
-	if(s == NULL)
-		return;
+	EntityTables& entityTables = EntityTables::findByInterfaceName(pWriteBehind->name());
+	bool ret = false;
+
+	callWriteBehind(pWriteBehind, [&]() 
+	{
+		ret = entityTables.removeEntity(pWriteBehind, dbid, pModule);
+	});
+
+	if (!ret)
+	{
+		ERROR_MSG(fmt::format("EntityTableRedis::removeWriteBehindEntity: couldn't remove {}({}) from {}.\n",
+			tableName(), dbid, pWriteBehind->name()));
+	}
+
+	return ret;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR2::getReadSqlItem(redis::DBContext& context)
+bool EntityTableRedis::removeEntity(DBInterface* pdbi, DBID dbid, ScriptDefModule* pModule)
 {
+	OURO_ASSERT(pModule && dbid > 0);
+
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
+	DBInterface* pWriteBehind = pdbiRedis->pWriteBehind();
+
+	// Removed from the write-behind interface first, a query in between would read it into redis again
+	if (pWriteBehind && !removeWriteBehindEntity(pWriteBehind, dbid, pModule))
+		return false;
+
+	std::string strdbid = fmt::format("{}", dbid);
+
+	std::vector<std::string> args;
+	args.push_back("DEL");
+	args.push_back(entityKey(dbid));
+	pdbiRedis->queryAppend(args, false);
+
+	size_t count = 1 + appendAutoLoadQuery(pdbiRedis, dbid, false);
+
+	if (pWriteBehind)
+	{
+		args.clear();
+		args.push_back("HDEL");
+		args.push_back(tableKey("dirty"));
+		args.push_back(strdbid);
+		pdbiRedis->queryAppend(args, false);
+		++count;
+	}
+
+	return pdbiRedis->getQueryReplies(count);
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR3::isSameKey(std::string key)
+bool EntityTableRedis::queryTable(DBInterface* pdbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule)
 {
+	OURO_ASSERT(pModule && s && dbid > 0);
+
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
+
+	redis::DBContext context;
+	context.tableName = pModule->getName();
+	context.dbid = dbid;
+
+	appendReadQuery(pdbiRedis, context);
+
+	std::vector<redisReply*> replies;
+	int8 shouldAutoLoad = -1;
+
+	bool found = pdbiRedis->getQueryReplies(1, &replies) && 
+		readQueryResults(replies[0], context, shouldAutoLoad);
+
+	if (replies.size() > 0)
+		freeReplyObject(replies[0]);
+
+	if (found)
+	{
+		addToStream(s, context, dbid);
+		return true;
+	}
+
+	DBInterface* pWriteBehind = pdbiRedis->pWriteBehind();
+	if (!pWriteBehind)
+		return false;
+
+	// Read through the write-behind interface and keep the entity in redis
+	EntityTables& entityTables = EntityTables::findByInterfaceName(pWriteBehind->name());
+	size_t wpos = s->wpos();
+
+	callWriteBehind(pWriteBehind, [&]() 
+	{
+		s->wpos((int)wpos);
+		found = entityTables.queryEntity(pWriteBehind, dbid, s, pModule);
+	});
+
+	if (!found)
+		return false;
+
+	MemoryStream stream;
+	stream.append(s->data() + wpos, s->wpos() - wpos);
+
+	redis::DBContext context1;
+	context1.tableName = pModule->getName();
+	context1.dbid = dbid;
+
+	std::vector<EntityTableItem*>::iterator iter = tableFixedOrderItems_.begin();
+	for(; iter != tableFixedOrderItems_.end(); ++iter)
+	{
+		static_cast<EntityTableItemRedisBase*>((*iter))->getQueriedSqlItem(pdbi, &stream, context1);
+	}
+
+	appendWriteQuery(pdbiRedis, context1, -1);
+	pdbiRedis->getQueryReplies(1);
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR3::syncToDB(DBInterface* pdbi, void* pData)
+uint32 EntityTableRedis::writeBehind(DBInterfaceRedis* pdbi, uint32 maxEntities)
 {
-	return true;
+	DBInterface* pWriteBehind = pdbi->pWriteBehind();
+	if (!pWriteBehind)
+		return 0;
+
+	ScriptDefModule* pModule = EntityDef::findScriptModule(tableName(), false);
+	if (!pModule)
+		return 0;
+
+	Ouroboros::thread::ThreadGuard tg(&writeBehindMutex_);
+
+	std::string dirtyKey = tableKey("dirty");
+	uint64 cursor = 0;
+	uint32 count = 0;
+
+	// A page of HSCAN may be empty while the next pages are not, the scan is done when the cursor is 0 again
+	do
+	{
+		redisReply* pRedisReply = NULL;
+		pdbi->query(fmt::format("HSCAN {} {} COUNT {}", dirtyKey, cursor, maxEntities), &pRedisReply, false);
+
+		cursor = 0;
+
+		// dbid, version
+		std::vector< std::pair<DBID, std::string> > entities;
+
+		if (pRedisReply)
+		{
+			if (pRedisReply->type == REDIS_REPLY_ARRAY && pRedisReply->elements == 2 && 
+				pRedisReply->element[1]->type == REDIS_REPLY_ARRAY)
+			{
+				StringConv::str2value(cursor, pRedisReply->element[0]->str);
+
+				redisReply* r0 = pRedisReply->element[1];
+
+				for (size_t j = 0; j + 1 < r0->elements; j += 2)
+				{
+					DBID dbid = 0;
+					StringConv::str2value(dbid, r0->element[j]->str);
+					entities.push_back(std::make_pair(dbid, std::string(r0->element[j + 1]->str, r0->element[j + 1]->len)));
+				}
+			}
+
+			freeReplyObject(pRedisReply);
+		}
+
+		if (entities.size() > 0)
+			count += writeBehindEntities(pdbi, pModule, entities);
+
+	} while (cursor != 0);
+
+	return count;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR3::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+uint32 EntityTableRedis::writeBehindEntities(DBInterfaceRedis* pdbi, ScriptDefModule* pModule, 
+	const std::vector< std::pair<DBID, std::string> >& entities)
 {
+	DBInterface* pWriteBehind = pdbi->pWriteBehind();
+	std::string dirtyKey = tableKey("dirty");
+	redisReply* pRedisReply = NULL;
+
+	// All the entities are read at once
+	std::vector<redis::DBContext> contexts(entities.size());
+
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		contexts[i].tableName = tableName();
+		contexts[i].dbid = entities[i].first;
+		appendReadQuery(pdbi, contexts[i]);
+	}
+
+	std::vector<redisReply*> replies;
+	pdbi->getQueryReplies(entities.size(), &replies);
+
+	EntityTables& entityTables = EntityTables::findByInterfaceName(pWriteBehind->name());
+
+	// Only the versions that were written are no longer dirty
+	std::vector<std::string> args;
+	args.push_back("EVAL");
+	args.push_back("for i = 1, #ARGV, 2 do "
+		"if redis.call('HGET', KEYS[1], ARGV[i]) == ARGV[i + 1] then redis.call('HDEL', KEYS[1], ARGV[i]) end "
+		"end return 0");
+	args.push_back("1");
+	args.push_back(dirtyKey);
+
+	uint32 count = 0;
+
+	for (size_t i = 0; i < replies.size(); ++i)
+	{
+		DBID dbid = entities[i].first;
+		int8 shouldAutoLoad = -1;
+
+		bool found = readQueryResults(replies[i], contexts[i], shouldAutoLoad);
+		freeReplyObject(replies[i]);
+
+		// Not found if the entity was removed
+		if (found)
+		{
+			DBID ret = 0;
+
+			callWriteBehind(pWriteBehind, [&]() 
+			{
+				MemoryStream stream;
+				contexts[i].readresultIdx = 0;
+
+				std::vector<EntityTableItem*>::iterator iter = tableFixedOrderItems_.begin();
+				for (; iter != tableFixedOrderItems_.end(); ++iter)
+				{
+					size_t wpos = stream.wpos();
+					stream << (ENTITY_PROPERTY_UID)0 << (ENTITY_PROPERTY_UID)(*iter)->utype();
+
+					if (!static_cast<EntityTableItemRedisBase*>((*iter))->addToWriteStream(&stream, contexts[i]))
+						stream.wpos((int)wpos);
+				}
+
+				ret = entityTables.writeEntity(pWriteBehind, dbid, shouldAutoLoad, &stream, pModule);
+			});
+
+			if (ret <= 0)
+			{
+				ERROR_MSG(fmt::format("EntityTableRedis::writeBehind: {}({}) couldn't be written to {}, retry later.\n",
+					tableName(), dbid, pWriteBehind->name()));
+
+				continue;
+			}
+		}
+
+		args.push_back(fmt::format("{}", dbid));
+		args.push_back(entities[i].second);
+		++count;
+	}
+
+	if (args.size() > 4)
+	{
+		pdbi->query(args, &pRedisReply, false);
+
+		if (pRedisReply)
+			freeReplyObject(pRedisReply);
+	}
+
+	return count;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR3::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+void EntityTableRedis::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
 {
-	if(s == NULL)
-		return;
+	std::vector<EntityTableItem*>::iterator iter = tableFixedOrderItems_.begin();
+	for(; iter != tableFixedOrderItems_.end(); ++iter)
+	{
+		static_cast<EntityTableItemRedisBase*>((*iter))->addToStream(s, context, resultDBID);
+	}
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR3::getReadSqlItem(redis::DBContext& context)
+void EntityTableRedis::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
 {
+	std::vector<EntityTableItem*>::iterator iter = tableFixedOrderItems_.begin();
+	for(; iter != tableFixedOrderItems_.end(); ++iter)
+	{
+		static_cast<EntityTableItemRedisBase*>((*iter))->getWriteSqlItem(pdbi, s, context);
+	}
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR4::isSameKey(std::string key)
+void EntityTableRedis::getReadSqlItem(redis::DBContext& context)
 {
-	return true;
+	std::vector<EntityTableItem*>::iterator iter = tableFixedOrderItems_.begin();
+	for(; iter != tableFixedOrderItems_.end(); ++iter)
+	{
+		static_cast<EntityTableItemRedisBase*>((*iter))->getReadSqlItem(context);
+	}
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR4::syncToDB(DBInterface* pdbi, void* pData)
+void EntityTableItemRedisBase::init_db_item_name(const char* exstrFlag)
 {
-	return true;
+	ouro_snprintf(db_item_name_, MAX_BUF, TABLE_ITEM_PERFIX"_%s%s", exstrFlag, itemName());
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR4::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+static bool isSameVectorKey(const std::string& key, char (*db_item_names)[MAX_BUF], int n)
 {
+	for (int i = 0; i < n; ++i)
+	{
+		if (key == db_item_names[i])
+			return true;
+	}
+
+	return false;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR4::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+static void addVectorToStream(MemoryStream* s, redis::DBContext& context, int n)
 {
-	if(s == NULL)
-		return;
+	for (int i = 0; i < n; ++i)
+	{
+		const std::string* pResult = context.readResult();
+
+#ifdef CLIENT_NO_FLOAT
+		int32 v = pResult ? atoi(pResult->c_str()) : 0;
+#else
+		float v = pResult ? (float)atof(pResult->c_str()) : 0.f;
+#endif
+
+		(*s) << v;
+	}
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR4::getReadSqlItem(redis::DBContext& context)
+static void getVectorWriteSqlItem(MemoryStream* s, redis::DBContext& context, char (*db_item_names)[MAX_BUF], int n)
 {
+#ifdef CLIENT_NO_FLOAT
+	int32 v;
+#else
+	float v;
+#endif
+
+	char sqlval[MAX_BUF];
+
+	for (int i = 0; i < n; ++i)
+	{
+		(*s) >> v;
+
+#ifdef CLIENT_NO_FLOAT
+		ouro_snprintf(sqlval, MAX_BUF, "%d", v);
+#else
+		ouro_snprintf(sqlval, MAX_BUF, "%.9g", v);
+#endif
+
+		context.addItem(db_item_names[i], sqlval);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+static void getVectorReadSqlItem(redis::DBContext& context, char (*db_item_names)[MAX_BUF], int n)
+{
+	for (int i = 0; i < n; ++i)
+		context.addItem(db_item_names[i]);
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_VECTOR2::isSameKey(std::string key)
+{
+	return isSameVectorKey(key, db_item_names_, 2);
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_VECTOR2::syncToDB(DBInterface* pdbi, void* pData)
+{
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR2::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+{
+	addVectorToStream(s, context, 2);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR2::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+{
+	if(s == NULL)
+		return;
+
+	getVectorWriteSqlItem(s, context, db_item_names_, 2);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR2::getReadSqlItem(redis::DBContext& context)
+{
+	getVectorReadSqlItem(context, db_item_names_, 2);
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_VECTOR3::isSameKey(std::string key)
+{
+	return isSameVectorKey(key, db_item_names_, 3);
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_VECTOR3::syncToDB(DBInterface* pdbi, void* pData)
+{
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR3::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+{
+	addVectorToStream(s, context, 3);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR3::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+{
+	if(s == NULL)
+		return;
+
+	getVectorWriteSqlItem(s, context, db_item_names_, 3);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR3::getReadSqlItem(redis::DBContext& context)
+{
+	getVectorReadSqlItem(context, db_item_names_, 3);
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_VECTOR4::isSameKey(std::string key)
+{
+	return isSameVectorKey(key, db_item_names_, 4);
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_VECTOR4::syncToDB(DBInterface* pdbi, void* pData)
+{
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR4::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+{
+	addVectorToStream(s, context, 4);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR4::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+{
+	if(s == NULL)
+		return;
+
+	getVectorWriteSqlItem(s, context, db_item_names_, 4);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_VECTOR4::getReadSqlItem(redis::DBContext& context)
+{
+	getVectorReadSqlItem(context, db_item_names_, 4);
 }
 
 //-------------------------------------------------------------------------------------
@@ -469,16 +1108,109 @@ void EntityTableItemRedis_ENTITYCALL::getReadSqlItem(redis::DBContext& context)
 {
 }
 
+//-------------------------------------------------------------------------------------
+// An array or a component is kept as the stream of its value, a stream stored with other defs is not read
+static bool isValidStream(EntityTable* pChildTable, const std::string& datas, bool isArray)
+{
+	MemoryStream stream;
+	stream.append(datas.data(), datas.size());
+
+	try
+	{
+		redis::DBContext context;
+		ArraySize size = 1;
+
+		if (isArray)
+			stream >> size;
+
+		for (ArraySize i = 0; i < size; ++i)
+			static_cast<EntityTableRedis*>(pChildTable)->getWriteSqlItem(NULL, &stream, context);
+	}
+	catch (MemoryStreamException&)
+	{
+		return false;
+	}
+
+	return stream.length() == 0;
+}
+
 //-------------------------------------------------------------------------------------
 bool EntityTableItemRedis_ARRAY::isSameKey(std::string key)
 {
-	return false;
+	return key == db_item_name();
 }
 
 //-------------------------------------------------------------------------------------
 bool EntityTableItemRedis_ARRAY::initialize(const PropertyDescription* pPropertyDescription, 
 											const DataType* pDataType, std::string name)
 {
+	bool ret = EntityTableItemRedisBase::initialize(pPropertyDescription, pDataType, name);
+	if(!ret)
+		return false;
+
+	// The child table only describes the elements, they are stored in the field of the array
+	EntityTableRedis* pTable = new EntityTableRedis(this->pParentTable()->pEntityTables());
+
+	std::string tname = this->pParentTable()->tableName();
+	std::vector<std::string> qname;
+	EntityTableItem* pparentItem = this->pParentTableItem();
+	while(pparentItem != NULL)
+	{
+		if(strlen(pparentItem->itemName()) > 0)
+			qname.push_back(pparentItem->itemName());
+		pparentItem = pparentItem->pParentTableItem();
+	}
+	
+	if(qname.size() > 0)
+	{
+		for(int i = (int)qname.size() - 1; i >= 0; i--)
+		{
+			tname += "_";
+			tname += qname[i];
+		}
+	}
+	
+	std::string tableName = tname + "_";
+	std::string itemName = "";
+
+	if(name.size() > 0)
+	{
+		tableName += name;
+	}
+	else
+	{
+		tableName += TABLE_ARRAY_ITEM_VALUES_CONST_STR;
+	}
+
+	if(itemName.size() == 0)
+	{
+		if(static_cast<FixedArrayType*>(const_cast<DataType*>(pDataType))->getDataType()->type() != DATA_TYPE_FIXEDDICT)
+			itemName = TABLE_ARRAY_ITEM_VALUE_CONST_STR;
+	}
+
+	pTable->tableName(tableName);
+	pTable->isChild(true);
+
+	EntityTableItem* pArrayTableItem;
+	pArrayTableItem = pParentTable_->createItem(static_cast<FixedArrayType*>(const_cast<DataType*>(pDataType))->getDataType()->getName(), pPropertyDescription->getDefaultValStr());
+	pArrayTableItem->utype(-pPropertyDescription->getUType());
+	pArrayTableItem->pParentTable(this->pParentTable());
+	pArrayTableItem->pParentTableItem(this);
+	pArrayTableItem->tableName(pTable->tableName());
+
+	ret = pArrayTableItem->initialize(pPropertyDescription, 
+		static_cast<FixedArrayType*>(const_cast<DataType*>(pDataType))->getDataType(), itemName.c_str());
+
+	if(!ret)
+	{
+		delete pTable;
+		return ret;
+	}
+
+	pTable->addItem(pArrayTableItem);
+	pChildTable_ = pTable;
+
+	pTable->pEntityTables()->addTable(pTable);
 	return true;
 }
 
@@ -491,61 +1223,318 @@ bool EntityTableItemRedis_ARRAY::syncToDB(DBInterface* pdbi, void* pData)
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_ARRAY::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
 {
+	const std::string* pResult = context.readResult();
+
+	if (pResult && pChildTable_)
+	{
+		if (isValidStream(pChildTable_, *pResult, true))
+		{
+			s->append(pResult->data(), pResult->size());
+			return;
+		}
+
+		WARNING_MSG(fmt::format("EntityTableItemRedis_ARRAY::addToStream: {}({}) of {} does not match the defs, it is not read.\n",
+			db_item_name(), context.dbid, context.tableName));
+	}
+
+	ArraySize size = 0;
+	(*s) << size;
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_ARRAY::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
 {
+	if(s == NULL)
+		return;
+
+	size_t rpos = s->rpos();
+
+	ArraySize size = 0;
+	(*s) >> size;
+
+	if(pChildTable_)
+	{
+		// The elements are only read through, the stream of the array is stored
+		redis::DBContext childContext;
+
+		for(ArraySize i=0; i<size; ++i)
+			static_cast<EntityTableRedis*>(pChildTable_)->getWriteSqlItem(pdbi, s, childContext);
+	}
+
+	context.addItem(db_item_name(), std::string((const char*)s->data() + rpos, s->rpos() - rpos));
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_ARRAY::getReadSqlItem(redis::DBContext& context)
 {
+	context.addItem(db_item_name());
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_ARRAY::init_db_item_name(const char* exstrFlag)
 {
+	EntityTableItemRedisBase::init_db_item_name(exstrFlag);
+
+	if(pChildTable_)
+	{
+		static_cast<EntityTableRedis*>(pChildTable_)->init_db_item_name();
+	}
 }
 
 //-------------------------------------------------------------------------------------
 bool EntityTableItemRedis_FIXED_DICT::isSameKey(std::string key)
 {
-	return true;
+	FIXEDDICT_KEYTYPES::iterator fditer = keyTypes_.begin();
+
+	for(; fditer != keyTypes_.end(); ++fditer)
+	{
+		if(fditer->second->isSameKey(key))
+			return true;
+	}
+	
+	return false;
 }
 
 //-------------------------------------------------------------------------------------
 bool EntityTableItemRedis_FIXED_DICT::initialize(const PropertyDescription* pPropertyDescription, 
 												 const DataType* pDataType, std::string name)
 {
+	bool ret = EntityTableItemRedisBase::initialize(pPropertyDescription, pDataType, name);
+	if(!ret)
+		return false;
+
+	Ouroboros::FixedDictType* fdatatype = static_cast<Ouroboros::FixedDictType*>(const_cast<DataType*>(pDataType));
+
+	FixedDictType::FIXEDDICT_KEYTYPE_MAP& keyTypes = fdatatype->getKeyTypes();
+	FixedDictType::FIXEDDICT_KEYTYPE_MAP::iterator iter = keyTypes.begin();
+
+	for(; iter != keyTypes.end(); ++iter)
+	{
+		if(!iter->second->persistent)
+			continue;
+
+		EntityTableItem* tableItem = pParentTable_->createItem(iter->second->dataType->getName(), pPropertyDescription->getDefaultValStr());
+
+		tableItem->pParentTable(this->pParentTable());
+		tableItem->pParentTableItem(this);
+		tableItem->utype(-pPropertyDescription->getUType());
+		tableItem->tableName(this->tableName());
+		if(!tableItem->initialize(pPropertyDescription, iter->second->dataType, iter->first))
+			return false;
+
+		std::pair< std::string, OUROShared_ptr<EntityTableItem> > itemVal;
+		itemVal.first = iter->first;
+		itemVal.second.reset(tableItem);
+
+		keyTypes_.push_back(itemVal);
+	}
+
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
 bool EntityTableItemRedis_FIXED_DICT::syncToDB(DBInterface* pdbi, void* pData)
 {
-
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_FIXED_DICT::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
 {
+	FIXEDDICT_KEYTYPES::iterator fditer = keyTypes_.begin();
+
+	for(; fditer != keyTypes_.end(); ++fditer)
+	{
+		static_cast<EntityTableItemRedisBase*>(fditer->second.get())->addToStream(s, context, resultDBID);
+	}
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_FIXED_DICT::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
 {
+	FIXEDDICT_KEYTYPES::iterator fditer = keyTypes_.begin();
+
+	for(; fditer != keyTypes_.end(); ++fditer)
+	{
+		static_cast<EntityTableItemRedisBase*>(fditer->second.get())->getWriteSqlItem(pdbi, s, context);
+	}
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_FIXED_DICT::getReadSqlItem(redis::DBContext& context)
 {
+	FIXEDDICT_KEYTYPES::iterator fditer = keyTypes_.begin();
+
+	for(; fditer != keyTypes_.end(); ++fditer)
+	{
+		static_cast<EntityTableItemRedisBase*>(fditer->second.get())->getReadSqlItem(context);
+	}
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_FIXED_DICT::init_db_item_name(const char* exstrFlag)
 {
+	FIXEDDICT_KEYTYPES::iterator fditer = keyTypes_.begin();
+
+	for(; fditer != keyTypes_.end(); ++fditer)
+	{
+		std::string new_exstrFlag = exstrFlag;
+		if(fditer->second->type()== TABLE_ITEM_TYPE_FIXEDDICT)
+			new_exstrFlag += fditer->first + "_";
+
+		static_cast<EntityTableItemRedisBase*>(fditer->second.get())->init_db_item_name(new_exstrFlag.c_str());
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_Component::isSameKey(std::string key)
+{
+	return key == db_item_name();
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_Component::initialize(const PropertyDescription* pPropertyDescription,
+	const DataType* pDataType, std::string name)
+{
+	bool ret = EntityTableItemRedisBase::initialize(pPropertyDescription, pDataType, name);
+	if (!ret)
+		return false;
+
+	EntityComponentType* pEntityComponentType = const_cast<EntityComponentType*>(static_cast<const EntityComponentType*>(pDataType));
+	ScriptDefModule* pEntityComponentScriptDefModule = pEntityComponentType->pScriptDefModule();
+
+	EntityTableRedis* pparentTable = static_cast<EntityTableRedis*>(this->pParentTable());
+	EntityTableRedis* pTable = new EntityTableRedis(pparentTable->pEntityTables());
+
+	std::string tableName = std::string(pparentTable->tableName()) + "_" + name;
+
+	pTable->tableName(tableName);
+	pTable->isChild(true);
+
+	ScriptDefModule* pScriptDefModule = EntityDef::findScriptModule(pparentTable->tableName(), false);
+
+	ScriptDefModule::PROPERTYDESCRIPTION_MAP& pdescrsMap = pEntityComponentScriptDefModule->getPersistentPropertyDescriptions();
+	ScriptDefModule::PROPERTYDESCRIPTION_MAP::const_iterator iter = pdescrsMap.begin();
+
+	for (; iter != pdescrsMap.end(); ++iter)
+	{
+		PropertyDescription* pdescrs = iter->second;
+
+		if (!pScriptDefModule->hasCell() && pdescrs->hasCell() && !pdescrs->hasBase())
+		{
+			continue;
+		}
+
+		EntityTableItem* pETItem = pparentTable->createItem(pdescrs->getDataType()->getName(), pdescrs->getDefaultValStr());
+
+		pETItem->pParentTable(pparentTable);
+		pETItem->utype(pdescrs->getUType());
+		pETItem->tableName(pTable->tableName());
+		pETItem->pParentTableItem(this);
+
+		bool ret = pETItem->initialize(pdescrs, pdescrs->getDataType(), pdescrs->getName());
+
+		if (!ret)
+		{
+			delete pETItem;
+			return false;
+		}
+
+		pTable->addItem(pETItem);
+	}
+
+	pChildTable_ = pTable;
+	pTable->pEntityTables()->addTable(pTable);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_Component::hasChildItems() const
+{
+	// Like MySQL, a component without persistent properties is neither written nor read
+	return pChildTable_ && pChildTable_->tableFixedOrderItems().size() > 0;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_Component::syncToDB(DBInterface* pdbi, void* pData)
+{
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_Component::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+{
+	if (!hasChildItems())
+		return;
+
+	const std::string* pResult = context.readResult();
+
+	// The component may have been added to the entity after it was stored, the entity then rewrites the default values
+	bool foundData = pResult && isValidStream(pChildTable_, *pResult, false);
+	(*s) << foundData;
+
+	if (foundData)
+		s->append(pResult->data(), pResult->size());
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableItemRedis_Component::addToWriteStream(MemoryStream* s, redis::DBContext& context)
+{
+	if (!hasChildItems())
+		return false;
+
+	const std::string* pResult = context.readResult();
+	if (!pResult || !isValidStream(pChildTable_, *pResult, false))
+		return false;
+
+	s->append(pResult->data(), pResult->size());
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_Component::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+{
+	if (s == NULL || !hasChildItems())
+		return;
+
+	size_t rpos = s->rpos();
+
+	// The properties are only read through, the stream of the component is stored
+	redis::DBContext childContext;
+	static_cast<EntityTableRedis*>(pChildTable_)->getWriteSqlItem(pdbi, s, childContext);
+
+	context.addItem(db_item_name(), std::string((const char*)s->data() + rpos, s->rpos() - rpos));
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_Component::getReadSqlItem(redis::DBContext& context)
+{
+	if (hasChildItems())
+		context.addItem(db_item_name());
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_Component::getQueriedSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+{
+	if (!hasChildItems())
+		return;
+
+	bool foundData = false;
+	(*s) >> foundData;
+
+	if (foundData)
+		getWriteSqlItem(pdbi, s, context);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemRedis_Component::init_db_item_name(const char* exstrFlag)
+{
+	EntityTableItemRedisBase::init_db_item_name(exstrFlag);
+
+	if (pChildTable_)
+	{
+		static_cast<EntityTableRedis*>(pChildTable_)->init_db_item_name();
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -569,6 +1558,73 @@ bool EntityTableItemRedis_DIGIT::syncToDB(DBInterface* pdbi, void* pData)
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_DIGIT::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
 {
+	std::stringstream stream;
+
+	const std::string* pResult = context.readResult();
+	stream << (pResult ? *pResult : std::string("0"));
+
+	if(dataSType_ == "INT8")
+	{
+		int32 v = 0;
+		stream >> v;
+		int8 vv = static_cast<int8>(v);
+		(*s) << vv;
+	}
+	else if(dataSType_ == "INT16")
+	{
+		int16 v = 0;
+		stream >> v;
+		(*s) << v;
+	}
+	else if(dataSType_ == "INT32")
+	{
+		int32 v = 0;
+		stream >> v;
+		(*s) << v;
+	}
+	else if(dataSType_ == "INT64")
+	{
+		int64 v = 0;
+		stream >> v;
+		(*s) << v;
+	}
+	else if(dataSType_ == "UINT8")
+	{
+		int32 v = 0;
+		stream >> v;
+		uint8 vv = static_cast<uint8>(v);
+		(*s) << vv;
+	}
+	else if(dataSType_ == "UINT16")
+	{
+		uint16 v = 0;
+		stream >> v;
+		(*s) << v;
+	}
+	else if(dataSType_ == "UINT32")
+	{
+		uint32 v = 0;
+		stream >> v;
+		(*s) << v;
+	}
+	else if(dataSType_ == "UINT64")
+	{
+		uint64 v = 0;
+		stream >> v;
+		(*s) << v;
+	}
+	else if(dataSType_ == "FLOAT")
+	{
+		float v = 0.f;
+		stream >> v;
+		(*s) << v;
+	}
+	else if(dataSType_ == "DOUBLE")
+	{
+		double v = 0.0;
+		stream >> v;
+		(*s) << v;
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -576,11 +1632,79 @@ void EntityTableItemRedis_DIGIT::getWriteSqlItem(DBInterface* pdbi, MemoryStream
 {
 	if(s == NULL)
 		return;
+
+	char sqlval[MAX_BUF];
+	sqlval[0] = '\0';
+
+	if(dataSType_ == "INT8")
+	{
+		int8 v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%d", v);
+	}
+	else if(dataSType_ == "INT16")
+	{
+		int16 v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%d", v);
+	}
+	else if(dataSType_ == "INT32")
+	{
+		int32 v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%d", v);
+	}
+	else if(dataSType_ == "INT64")
+	{
+		int64 v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%" PRI64, v);
+	}
+	else if(dataSType_ == "UINT8")
+	{
+		uint8 v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%u", v);
+	}
+	else if(dataSType_ == "UINT16")
+	{
+		uint16 v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%u", v);
+	}
+	else if(dataSType_ == "UINT32")
+	{
+		uint32 v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%u", v);
+	}
+	else if(dataSType_ == "UINT64")
+	{
+		uint64 v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%" PRIu64, v);
+	}
+	else if(dataSType_ == "FLOAT")
+	{
+		// Enough digits to read the same value back
+		float v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%.9g", v);
+	}
+	else if(dataSType_ == "DOUBLE")
+	{
+		double v;
+		(*s) >> v;
+		ouro_snprintf(sqlval, MAX_BUF, "%.17g", v);
+	}
+
+	context.addItem(db_item_name(), sqlval);
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_DIGIT::getReadSqlItem(redis::DBContext& context)
 {
+	context.addItem(db_item_name());
 }
 
 //-------------------------------------------------------------------------------------
@@ -593,6 +1717,8 @@ bool EntityTableItemRedis_STRING::syncToDB(DBInterface* pdbi, void* pData)
 void EntityTableItemRedis_STRING::addToStream(MemoryStream* s, 
 											  redis::DBContext& context, DBID resultDBID)
 {
+	const std::string* pResult = context.readResult();
+	(*s) << (pResult ? *pResult : std::string());
 }
 
 //-------------------------------------------------------------------------------------
@@ -601,11 +1727,37 @@ void EntityTableItemRedis_STRING::getWriteSqlItem(DBInterface* pdbi,
 {
 	if(s == NULL)
 		return;
+
+	std::string val;
+	(*s) >> val;
+
+	context.addItem(db_item_name(), val);
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_STRING::getReadSqlItem(redis::DBContext& context)
 {
+	context.addItem(db_item_name());
+}
+
+//-------------------------------------------------------------------------------------
+static void addBlobToStream(MemoryStream* s, redis::DBContext& context)
+{
+	const std::string* pResult = context.readResult();
+
+	if (pResult)
+		s->appendBlob(*pResult);
+	else
+		s->appendBlob(std::string());
+}
+
+//-------------------------------------------------------------------------------------
+static void getBlobWriteSqlItem(MemoryStream* s, redis::DBContext& context, const char* db_item_name)
+{
+	std::string val;
+	s->readBlob(val);
+
+	context.addItem(db_item_name, val);
 }
 
 //-------------------------------------------------------------------------------------
@@ -618,6 +1770,7 @@ bool EntityTableItemRedis_UNICODE::syncToDB(DBInterface* pdbi, void* pData)
 void EntityTableItemRedis_UNICODE::addToStream(MemoryStream* s, 
 											   redis::DBContext& context, DBID resultDBID)
 {
+	addBlobToStream(s, context);
 }
 
 //-------------------------------------------------------------------------------------
@@ -626,11 +1779,14 @@ void EntityTableItemRedis_UNICODE::getWriteSqlItem(DBInterface* pdbi, MemoryStre
 {
 	if(s == NULL)
 		return;
+
+	getBlobWriteSqlItem(s, context, db_item_name());
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_UNICODE::getReadSqlItem(redis::DBContext& context)
 {
+	context.addItem(db_item_name());
 }
 
 //-------------------------------------------------------------------------------------
@@ -642,6 +1798,7 @@ bool EntityTableItemRedis_BLOB::syncToDB(DBInterface* pdbi, void* pData)
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_BLOB::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
 {
+	addBlobToStream(s, context);
 }
 
 //-------------------------------------------------------------------------------------
@@ -649,11 +1806,14 @@ void EntityTableItemRedis_BLOB::getWriteSqlItem(DBInterface* pdbi, MemoryStream*
 {
 	if(s == NULL)
 		return;
+
+	getBlobWriteSqlItem(s, context, db_item_name());
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_BLOB::getReadSqlItem(redis::DBContext& context)
 {
+	context.addItem(db_item_name());
 }
 
 //-------------------------------------------------------------------------------------
@@ -665,6 +1825,7 @@ bool EntityTableItemRedis_PYTHON::syncToDB(DBInterface* pdbi, void* pData)
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_PYTHON::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
 {
+	addBlobToStream(s, context);
 }
 
 //-------------------------------------------------------------------------------------
@@ -672,11 +1833,61 @@ void EntityTableItemRedis_PYTHON::getWriteSqlItem(DBInterface* pdbi, MemoryStrea
 {
 	if(s == NULL)
 		return;
+
+	getBlobWriteSqlItem(s, context, db_item_name());
 }
 
 //-------------------------------------------------------------------------------------
 void EntityTableItemRedis_PYTHON::getReadSqlItem(redis::DBContext& context)
 {
+	context.addItem(db_item_name());
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskRedisWriteBehind::DBTaskRedisWriteBehind(const std::string& dbInterfaceName, uint32 maxEntities):
+DBTaskBase(),
+dbInterfaceName_(dbInterfaceName),
+maxEntities_(maxEntities),
+count_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskRedisWriteBehind::~DBTaskRedisWriteBehind()
+{
+}
+
+//-------------------------------------------------------------------------------------
+bool DBTaskRedisWriteBehind::db_thread_process()
+{
+	count_ = 0;
+
+	EntityTables& entityTables = EntityTables::findByInterfaceName(pdbi_->name());
+	EntityTables::TABLES_MAP::const_iterator iter = entityTables.tables().begin();
+
+	for (; iter != entityTables.tables().end(); ++iter)
+	{
+		if (iter->second->isChild())
+			continue;
+
+		count_ += static_cast<EntityTableRedis*>(iter->second.get())->writeBehind(
+			static_cast<DBInterfaceRedis*>(pdbi_), maxEntities_);
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState DBTaskRedisWriteBehind::presentMainThread()
+{
+	if (count_ > 0)
+	{
+		DEBUG_MSG(fmt::format("DBTaskRedisWriteBehind::presentMainThread: {} entities of {} written behind.\n", 
+			count_, dbInterfaceName_));
+	}
+
+	DBInterfaceRedis::onWriteBehind(dbInterfaceName_);
+	return thread::TPTask::TPTASK_STATE_COMPLETED;
 }
 
 //-------------------------------------------------------------------------------------
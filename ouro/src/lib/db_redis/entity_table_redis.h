@@ -8,6 +8,7 @@
 #include "common/singleton.h"
 #include "helper/debug_helper.h"
 #include "db_interface/entity_table.h"
+#include "db_interface/db_tasks.h"
 
 namespace Ouroboros { 
 
@@ -64,6 +65,23 @@ public:
 	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context) = 0;
 	virtual void getReadSqlItem(redis::DBContext& context) = 0;
 
+	/**
+		Get the fields from the data of a table queried from another interface
+	*/
+	virtual void getQueriedSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+	{ 
+		getWriteSqlItem(pdbi, s, context); 
+	}
+
+	/**
+		Get the data of the item into the stream in the form it is written, false if there is none
+	*/
+	virtual bool addToWriteStream(MemoryStream* s, redis::DBContext& context)
+	{ 
+		addToStream(s, context, context.dbid); 
+		return true; 
+	}
+
 	virtual void init_db_item_name(const char* exstrFlag = "");
 	const char* db_item_name(){ return db_item_name_; }
 
@@ -467,6 +485,54 @@ protected:
 	EntityTableItemRedis_FIXED_DICT::FIXEDDICT_KEYTYPES keyTypes_; // The type of each key in this fixed dictionary
 };
 
+class EntityTableItemRedis_Component : public EntityTableItemRedisBase
+{
+public:
+	EntityTableItemRedis_Component(std::string itemDBType,
+		uint32 datalength, uint32 flags) :
+		EntityTableItemRedisBase(itemDBType, datalength, flags),
+		pChildTable_(NULL)
+	{
+	}
+
+	virtual ~EntityTableItemRedis_Component() {};
+
+	virtual bool isSameKey(std::string key);
+
+	/**
+		Initialize
+	*/
+	virtual bool initialize(const PropertyDescription* pPropertyDescription,
+		const DataType* pDataType, std::string name);
+
+	uint8 type() const { return TABLE_ITEM_TYPE_COMPONENT; }
+
+	/**
+		Synchronize the entity table into the database
+	*/
+	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
+
+	/**
+		Get all the data of a table into the stream
+	*/
+	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
+	virtual bool addToWriteStream(MemoryStream* s, redis::DBContext& context);
+
+	/**
+		Get the name of the table to be stored, the name of the field and the string value when converting to sql storage
+	*/
+	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
+	virtual void getReadSqlItem(redis::DBContext& context);
+	virtual void getQueriedSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
+
+	virtual void init_db_item_name(const char* exstrFlag = "");
+
+protected:
+	bool hasChildItems() const;
+
+	EntityTable* pChildTable_;
+};
+
 
 /*
 	Maintain the table of the entity in the database
@@ -533,8 +599,65 @@ public:
 
 	void init_db_item_name();
 
+	/**
+		Write the entities changed in redis to the write-behind interface, maxEntities at once, 
+		returns the number of entities written. Only one thread writes behind a table at a time.
+	*/
+	uint32 writeBehind(DBInterfaceRedis* pdbi, uint32 maxEntities);
+
+	/**
+		The name of a key of the table, e.g. tbl_Account:1 or tbl_Account_autoLoad
+	*/
+	std::string entityKey(DBID dbid);
+	std::string tableKey(const char* name);
+
 protected:
-	
+	/**
+		HMGET of the fields of the items, the results are in context.results
+	*/
+	void appendReadQuery(DBInterfaceRedis* pdbi, redis::DBContext& context);
+	bool readQueryResults(redisReply* pRedisReply, redis::DBContext& context, int8& shouldAutoLoad);
+
+	void appendWriteQuery(DBInterfaceRedis* pdbi, redis::DBContext& context, int8 shouldAutoLoad);
+
+	/**
+		The commands of the autoLoad set and of the dirty versions, return the number of replies to get
+	*/
+	size_t appendAutoLoadQuery(DBInterfaceRedis* pdbi, DBID dbid, bool shouldAutoLoad);
+	size_t appendDirtyQuery(DBInterfaceRedis* pdbi, DBID dbid);
+
+	/**
+		Remove an entity from the write-behind interface
+	*/
+	bool removeWriteBehindEntity(DBInterface* pWriteBehind, DBID dbid, ScriptDefModule* pModule);
+
+	/**
+		Write a page of the dirty entities(dbid, version)
+	*/
+	uint32 writeBehindEntities(DBInterfaceRedis* pdbi, ScriptDefModule* pModule, 
+		const std::vector< std::pair<DBID, std::string> >& entities);
+
+protected:
+	// The DBTaskRedisWriteBehind, queryAutoLoadEntities and flushWriteBehind may write behind the same table
+	// on different threads, a flush that read an older version would overwrite the newer one in MySQL
+	Ouroboros::thread::ThreadMutex writeBehindMutex_;
+};
+
+/*
+	Write the entities changed in redis to the write-behind interface
+*/
+class DBTaskRedisWriteBehind : public DBTaskBase
+{
+public:
+	DBTaskRedisWriteBehind(const std::string& dbInterfaceName, uint32 maxEntities);
+	virtual ~DBTaskRedisWriteBehind();
+	virtual bool db_thread_process();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+protected:
+	std::string dbInterfaceName_;
+	uint32 maxEntities_;
+	uint32 count_;
 };
 
 
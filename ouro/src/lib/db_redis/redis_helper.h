@@ -45,22 +45,30 @@ public:
 	
 	static bool hasTable(DBInterfaceRedis* pdbi, const std::string& name, bool printlog = true)
 	{
-		redisReply* pRedisReply = NULL;
-		
-		if (!pdbi->query(fmt::format("scan 0 MATCH {}", name), &pRedisReply, printlog))
-			return false;
-		
+		uint64 index = 0;
 		size_t size = 0;
 		
-		if(pRedisReply)
+		// A page of SCAN may have no match while later pages have
+		do
 		{
-			if(pRedisReply->elements == 2 && pRedisReply->element[1]->type == REDIS_REPLY_ARRAY)
+			redisReply* pRedisReply = NULL;
+			
+			if (!pdbi->query(fmt::format("scan {} MATCH {} COUNT 1000", index, name), &pRedisReply, printlog))
+				return false;
+			
+			index = 0;
+			
+			if(pRedisReply)
 			{
-				size = pRedisReply->element[1]->elements;
+				if(pRedisReply->elements == 2 && pRedisReply->element[1]->type == REDIS_REPLY_ARRAY)
+				{
+					StringConv::str2value(index, pRedisReply->element[0]->str);
+					size = pRedisReply->element[1]->elements;
+				}
+				
+				freeReplyObject(pRedisReply); 
 			}
-			
-			freeReplyObject(pRedisReply); 
-		}
+		} while (size == 0 && index != 0);
 		
 		return size > 0;
 	}
@@ -2,6 +2,7 @@
 
 
 #include "datatypes.h"
+#include "entitydef_image.h"
 #include "resmgr/resmgr.h"
 
 namespace Ouroboros{
@@ -97,7 +98,8 @@ bool DataTypes::loadTypes(std::string& file)
 	if (access(file.c_str(), 0) != 0)
 		return true;
 
-	SmartPointer<XML> xml(new XML(Resmgr::getSingleton().matchRes(file).c_str()));
+	SmartPointer<XML> xml(new XML());
+	EntityDefImage::openSection(xml.get(), Resmgr::getSingleton().matchRes(file));
 	return loadTypes(xml);
 }
 
@@ -10,6 +10,7 @@
 #include "pyscript/scriptobject.h"
 #include "pyscript/pyobject_pointer.h"
 #include "entitydef/entity_garbages.h"
+#include "entitydef/entity_table.h"
 	
 namespace Ouroboros{
 
@@ -21,7 +22,7 @@ class Entities : public script::ScriptObject
 	*/
 	INSTANCE_SCRIPT_HREADER(Entities, ScriptObject)	
 public:
-	typedef OUROUnordered_map<ENTITY_ID, PyObjectPtr> ENTITYS_MAP;
+	typedef EntityTable ENTITYS_MAP;
 
 	Entities():
 	ScriptObject(getScriptType(), false),
@@ -68,7 +69,13 @@ public:
 	void clear(bool callScript, std::vector<ENTITY_ID> excludes);
 	PyObjectPtr erase(ENTITY_ID id);
 
-	T* find(ENTITY_ID id);
+	T* find(ENTITY_ID id) { return static_cast<T*>(_entities.get(id)); }
+
+	/**
+		NULL if the entity of the ID is not the one the generation was taken from
+	*/
+	T* find(ENTITY_ID id, uint32 generation);
+	uint32 generation(ENTITY_ID id) const { return _entities.generation(id); }
 
 	size_t size() const { return _entities.size(); }
 
@@ -144,13 +151,7 @@ PyObject * Entities<T>::mp_subscript(PyObject* self, PyObject* key /*entityID*/)
 	if (PyErr_Occurred())
 		return NULL;
 
-	PyObject * pyEntity = NULL;
-
-	ENTITYS_MAP& entities = lpEntities->getEntities();
-	ENTITYS_MAP::const_iterator iter = entities.find(entityID);
-	if (iter != entities.end())
-		pyEntity = iter->second.get();
-
+	PyObject * pyEntity = lpEntities->getEntities().get(entityID);
 	if(pyEntity == NULL)
 	{
 		PyErr_Format(PyExc_KeyError, "%d", entityID);
@@ -166,8 +167,7 @@ PyObject * Entities<T>::mp_subscript(PyObject* self, PyObject* key /*entityID*/)
 template<typename T>
 PyObject* Entities<T>::pyHas_key(ENTITY_ID entityID)
 {
-	ENTITYS_MAP& entities = getEntities();
-	return PyLong_FromLong((entities.find(entityID) != entities.end()));
+	return PyLong_FromLong((getEntities().get(entityID) != NULL));
 }
 
 //-------------------------------------------------------------------------------------
@@ -264,27 +264,34 @@ PyObject* Entities<T>::__py_pyGet(PyObject* self, PyObject * args, PyObject* kwd
 template<typename T>
 void Entities<T>::add(ENTITY_ID id, T* entity)
 { 
-	ENTITYS_MAP::const_iterator iter = _entities.find(id);
-	if(iter != _entities.end())
+	if(!_entities.insert(id, entity))
 	{
 		ERROR_MSG(fmt::format("Entities::add: entityID:{} has exist\n.", id));
 		return;
 	}
-
-	_entities[id] = entity; 
 }
 
 //-------------------------------------------------------------------------------------
 template<typename T>
 void Entities<T>::clear(bool callScript)
 {
+	// destroy runs scripts that may create or erase entities, which moves the entities of the table
+	std::vector<PyObjectPtr> entities;
+	entities.reserve(_entities.size());
+
 	ENTITYS_MAP::const_iterator iter = _entities.begin();
-	while (iter != _entities.end())
+	for (; iter != _entities.end(); ++iter)
+		entities.push_back(iter->second);
+
+	std::vector<PyObjectPtr>::iterator eiter = entities.begin();
+	for (; eiter != entities.end(); ++eiter)
 	{
-		T* entity = (T*)iter->second.get();
+		T* entity = (T*)(*eiter).get();
+		if (entity->isDestroyed())
+			continue;
+
 		_pGarbages->add(entity->id(), entity);
 		entity->destroy(callScript);
-		iter++;
 	}
 
 	_entities.clear();
@@ -294,19 +301,32 @@ void Entities<T>::clear(bool callScript)
 template<typename T>
 void Entities<T>::clear(bool callScript, std::vector<ENTITY_ID> excludes)
 {
+	// destroy runs scripts that may create or erase entities, which moves the entities of the table
+	std::vector<ENTITY_ID> ids;
+	ids.reserve(_entities.size());
+
 	ENTITYS_MAP::const_iterator iter = _entities.begin();
-	for (;iter != _entities.end();)
+	for (; iter != _entities.end(); ++iter)
 	{
-		if(std::find(excludes.begin(), excludes.end(), iter->first) != excludes.end())
-		{
-			++iter;
+		if(std::find(excludes.begin(), excludes.end(), iter->first) == excludes.end())
+			ids.push_back(iter->first);
+	}
+
+	std::vector<ENTITY_ID>::iterator iditer = ids.begin();
+	for (; iditer != ids.end(); ++iditer)
+	{
+		ENTITYS_MAP::iterator eiter = _entities.find(*iditer);
+		if (eiter == _entities.end())
 			continue;
-		}
 
-		T* entity = (T*)iter->second.get();
-		_pGarbages->add(entity->id(), entity);
-		entity->destroy(callScript);
-		_entities.erase(iter++);
+		PyObjectPtr entity = eiter->second;
+		_pGarbages->add((*iditer), static_cast<T*>(entity.get()));
+		static_cast<T*>(entity.get())->destroy(callScript);
+
+		// Looked up again, the scripts may have erased it meanwhile
+		eiter = _entities.find(*iditer);
+		if (eiter != _entities.end())
+			_entities.erase(eiter);
 	}
 	
 	// Cannot be emptied due to the presence of excludes
@@ -315,15 +335,12 @@ void Entities<T>::clear(bool callScript, std::vector<ENTITY_ID> excludes)
 
 //-------------------------------------------------------------------------------------
 template<typename T>
-T* Entities<T>::find(ENTITY_ID id)
+T* Entities<T>::find(ENTITY_ID id, uint32 generation)
 {
-	ENTITYS_MAP::const_iterator iter = _entities.find(id);
-	if(iter != _entities.end())
-	{
-		return static_cast<T*>(iter->second.get());
-	}
-	
-	return NULL;
+	if(_entities.generation(id) != generation)
+		return NULL;
+
+	return static_cast<T*>(_entities.get(id));
 }
 
 //-------------------------------------------------------------------------------------
@@ -333,8 +350,8 @@ PyObjectPtr Entities<T>::erase(ENTITY_ID id)
 	ENTITYS_MAP::iterator iter = _entities.find(id);
 	if(iter != _entities.end())
 	{
-		T* entity = static_cast<T*>(iter->second.get());
-		_pGarbages->add(id, entity);
+		PyObjectPtr entity = iter->second;
+		_pGarbages->add(id, static_cast<T*>(entity.get()));
 		_entities.erase(iter);
 		return entity;
 	}
@@ -288,7 +288,7 @@ public:																										\
 	void initializeScript()																					\
 	{																										\
 		removeFlags(ENTITY_FLAGS_INITING);																	\
-		SCOPED_PROFILE(SCRIPTCALL_PROFILE);																	\
+		SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());													\
 																											\
 		const ScriptDefModule::COMPONENTDESCRIPTION_MAP* pComponentDescrs =									\
 			&pScriptModule_->getComponentDescrs();															\
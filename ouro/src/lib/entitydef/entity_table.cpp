@@ -0,0 +1,115 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "entity_table.h"
+
+namespace Ouroboros{
+
+//-------------------------------------------------------------------------------------
+EntityTable::EntityTable():
+items_(),
+pages_(),
+overflow_(),
+lastGeneration_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+EntityTable::~EntityTable()
+{
+	clear();
+}
+
+//-------------------------------------------------------------------------------------
+EntityTable::Slot& EntityTable::createSlot_(ENTITY_ID id)
+{
+	uint32 uid = (uint32)id;
+
+	if (uid >= (uint32)MAX_PAGED_ID)
+		return overflow_[id];
+
+	uint32 page = uid >> PAGE_BITS;
+
+	if (page >= pages_.size())
+		pages_.resize(page + 1, NULL);
+
+	if (pages_[page] == NULL)
+		pages_[page] = new Page();
+
+	++pages_[page]->used;
+	return pages_[page]->slots[uid & PAGE_MASK];
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTable::releaseSlot_(ENTITY_ID id)
+{
+	uint32 uid = (uint32)id;
+
+	if (uid >= (uint32)MAX_PAGED_ID)
+	{
+		overflow_.erase(id);
+		return;
+	}
+
+	Page*& pPage = pages_[uid >> PAGE_BITS];
+	pPage->slots[uid & PAGE_MASK].index = 0;
+
+	if (--pPage->used == 0)
+	{
+		delete pPage;
+		pPage = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTable::insert(ENTITY_ID id, PyObject* pEntity)
+{
+	const Slot* pSlot = findSlot_(id);
+	if (pSlot && pSlot->index > 0)
+		return false;
+
+	Slot& slot = createSlot_(id);
+
+	items_.push_back(value_type(id, PyObjectPtr(pEntity)));
+	slot.index = (uint32)items_.size();
+
+	// 0 is left for IDs that are not used
+	if (++lastGeneration_ == 0)
+		++lastGeneration_;
+
+	slot.generation = lastGeneration_;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+EntityTable::iterator EntityTable::erase(iterator iter)
+{
+	size_t index = iter - items_.begin();
+
+	releaseSlot_(iter->first);
+
+	if (index + 1 < items_.size())
+	{
+		std::swap(items_[index], items_.back());
+		const_cast<Slot*>(findSlot_(items_[index].first))->index = (uint32)(index + 1);
+	}
+
+	items_.pop_back();
+	return items_.begin() + index;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTable::clear()
+{
+	std::vector<Page*>::iterator iter = pages_.begin();
+	for (; iter != pages_.end(); ++iter)
+		SAFE_RELEASE((*iter));
+
+	pages_.clear();
+	overflow_.clear();
+
+	// The entities may still refer to the table when they are released
+	ITEMS items;
+	items.swap(items_);
+}
+
+}
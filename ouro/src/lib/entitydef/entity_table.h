@@ -0,0 +1,132 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_ENTITY_TABLE_H
+#define OURO_ENTITY_TABLE_H
+
+#include "common/common.h"
+#include "pyscript/scriptobject.h"
+#include "pyscript/pyobject_pointer.h"
+
+namespace Ouroboros{
+
+/*
+	The entities of an app by ID(Entities::getEntities).
+
+	The IDs are handed out by the dbmgr in contiguous ranges(IDServer::allocRange), so the entities are kept
+	in one vector, iterated like the map it replaced(iter->first is the ID, iter->second the entity), and an
+	ID is mapped to its index in the vector by pages of PAGE_SIZE IDs. A page only exists while one of its
+	IDs is used, IDs from MAX_PAGED_ID on are mapped by a hash map.
+
+	Every entity added gets a new generation, an ID and the generation taken earlier tell whether the ID
+	still refers to the same entity(e.g. a ghost destroyed and created again with the same ID).
+*/
+class EntityTable
+{
+public:
+	typedef std::pair<ENTITY_ID, PyObjectPtr> value_type;
+	typedef std::vector<value_type> ITEMS;
+	typedef ITEMS::iterator iterator;
+	typedef ITEMS::const_iterator const_iterator;
+
+	enum
+	{
+		PAGE_BITS = 10,
+		PAGE_SIZE = 1 << PAGE_BITS,
+		PAGE_MASK = PAGE_SIZE - 1,
+
+		// At most 64K pages
+		MAX_PAGED_ID = 1 << 26
+	};
+
+	EntityTable();
+	~EntityTable();
+
+	iterator begin() { return items_.begin(); }
+	iterator end() { return items_.end(); }
+	const_iterator begin() const { return items_.begin(); }
+	const_iterator end() const { return items_.end(); }
+
+	size_t size() const { return items_.size(); }
+	bool empty() const { return items_.empty(); }
+
+	/**
+		The entity of the ID or NULL
+	*/
+	PyObject* get(ENTITY_ID id) const
+	{
+		const Slot* pSlot = findSlot_(id);
+		return (pSlot && pSlot->index > 0) ? items_[pSlot->index - 1].second.get() : NULL;
+	}
+
+	iterator find(ENTITY_ID id)
+	{
+		const Slot* pSlot = findSlot_(id);
+		return (pSlot && pSlot->index > 0) ? items_.begin() + (pSlot->index - 1) : items_.end();
+	}
+
+	/**
+		Generation of the entity of the ID, 0 if the ID is not used
+	*/
+	uint32 generation(ENTITY_ID id) const
+	{
+		const Slot* pSlot = findSlot_(id);
+		return (pSlot && pSlot->index > 0) ? pSlot->generation : 0;
+	}
+
+	/**
+		false if the ID is already used
+	*/
+	bool insert(ENTITY_ID id, PyObject* pEntity);
+
+	/**
+		The last entity takes the place of the removed one, the returned iterator points to it
+	*/
+	iterator erase(iterator iter);
+
+	void clear();
+
+private:
+	struct Slot
+	{
+		// Index in items_ + 1, 0 if the ID is not used
+		uint32 index;
+		uint32 generation;
+	};
+
+	struct Page
+	{
+		Slot slots[PAGE_SIZE];
+
+		// Used IDs of the page, the page is deleted when none is left
+		uint32 used;
+	};
+
+	const Slot* findSlot_(ENTITY_ID id) const
+	{
+		uint32 uid = (uint32)id;
+
+		if (uid < (uint32)MAX_PAGED_ID)
+		{
+			uint32 page = uid >> PAGE_BITS;
+			return (page < pages_.size() && pages_[page]) ? &pages_[page]->slots[uid & PAGE_MASK] : NULL;
+		}
+
+		OUROUnordered_map<ENTITY_ID, Slot>::const_iterator iter = overflow_.find(id);
+		return iter != overflow_.end() ? &iter->second : NULL;
+	}
+
+	Slot& createSlot_(ENTITY_ID id);
+	void releaseSlot_(ENTITY_ID id);
+
+private:
+	ITEMS items_;
+
+	std::vector<Page*> pages_;
+	OUROUnordered_map<ENTITY_ID, Slot> overflow_;
+
+	uint32 lastGeneration_;
+};
+
+}
+
+#endif // OURO_ENTITY_TABLE_H
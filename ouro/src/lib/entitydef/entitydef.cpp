@@ -2,6 +2,7 @@
 
 
 #include "entitydef.h"
+#include "entitydef_image.h"
 #include "scriptdef_module.h"
 #include "datatypes.h"
 #include "common.h"
@@ -13,6 +14,7 @@
 #include "entitydef/volatileinfo.h"
 #include "entitydef/entity_call.h"
 #include "entitydef/entity_component_call.h"
+#include "helper/eventhistory_stats.h"
 
 #ifndef CODE_INLINE
 #include "entitydef.inl"
@@ -69,6 +71,7 @@ bool EntityDef::finalise(bool isReload)
 {
 	PropertyDescription::resetDescriptionCount();
 	MethodDescription::resetDescriptionCount();
+	EventHistoryStats::resetEventIDs();
 
 	EntityDef::__md5.clear();
 	g_methodUtypeAuto = 1;
@@ -101,6 +104,7 @@ bool EntityDef::finalise(bool isReload)
 	g_methodCusUtypes.clear();
 	DataType::finalise();
 	DataTypes::finalise();
+	EntityDefImage::close();
 	return true;
 }
 
@@ -176,6 +180,9 @@ bool EntityDef::initialize(std::vector<PyTypeObject*>& scriptBaseTypes,
 	std::string entitiesFile = __entitiesPath + "entities.xml";
 	std::string defFilePath = __entitiesPath + "entity_defs/";
 	
+	// The documents come from the entitydef image if it was made from the current def files
+	EntityDefImage::open(__entitiesPath, defFilePath);
+
 	// Initialize the data category
 	// assets/scripts/entity_defs/types.xml
 	if(!DataTypes::initialize(defFilePath + "types.xml"))
@@ -186,7 +193,7 @@ bool EntityDef::initialize(std::vector<PyTypeObject*>& scriptBaseTypes,
 	if (access(entitiesFile.c_str(), 0) == 0)
 	{
 		SmartPointer<XML> xml(new XML());
-		if (!xml->openSection(entitiesFile.c_str()))
+		if (!EntityDefImage::openSection(xml.get(), entitiesFile))
 			return false;
 
 		// Get the entities.xml root node, if you do not define an entity then directly return true
@@ -204,7 +211,7 @@ bool EntityDef::initialize(std::vector<PyTypeObject*>& scriptBaseTypes,
 			std::string deffile = defFilePath + moduleName + ".def";
 			SmartPointer<XML> defxml(new XML());
 
-			if (!defxml->openSection(deffile.c_str()))
+			if (!EntityDefImage::openSection(defxml.get(), deffile))
 				return false;
 
 			TiXmlNode* defNode = defxml->getRootNode();
@@ -242,6 +249,9 @@ bool EntityDef::initialize(std::vector<PyTypeObject*>& scriptBaseTypes,
 
 	EntityDef::md5().final();
 
+	// The def files were parsed, their documents make the image of the next start
+	EntityDefImage::save();
+
 	if(loadComponentType == DBMGR_TYPE)
 		return true;
 
@@ -585,7 +595,7 @@ bool EntityDef::loadInterfaces(const std::string& defFilePath,
 		std::string interfaceName = defxml->getKey(interfaceNode);
 		std::string interfacefile = defFilePath + "interfaces/" + interfaceName + ".def";
 		SmartPointer<XML> interfaceXml(new XML());
-		if(!interfaceXml.get()->openSection(interfacefile.c_str()))
+		if(!EntityDefImage::openSection(interfaceXml.get(), interfacefile))
 			return false;
 
 		TiXmlNode* interfaceRootNode = interfaceXml->getRootNode();
@@ -680,7 +690,7 @@ bool EntityDef::loadComponents(const std::string& defFilePath,
 
 		std::string componentfile = defFilePath + "components/" + componentTypeName + ".def";
 		SmartPointer<XML> componentXml(new XML());
-		if (!componentXml.get()->openSection(componentfile.c_str()))
+		if (!EntityDefImage::openSection(componentXml.get(), componentfile))
 			return false;
 
 		// Generate an attribute description instance
@@ -901,7 +911,7 @@ bool EntityDef::loadParentClass(const std::string& defFilePath,
 	std::string parentClassfile = defFilePath + parentClassName + ".def";
 	
 	SmartPointer<XML> parentClassXml(new XML());
-	if(!parentClassXml->openSection(parentClassfile.c_str()))
+	if(!EntityDefImage::openSection(parentClassXml.get(), parentClassfile))
 		return false;
 	
 	TiXmlNode* parentClassdefNode = parentClassXml->getRootNode();
@@ -1993,7 +2003,7 @@ bool EntityDef::loadAllComponentScriptModules(std::string entitiesPath, std::vec
 	}
 
 	SmartPointer<XML> xml(new XML());
-	if (!xml->openSection(entitiesFile.c_str()))
+	if (!EntityDefImage::openSection(xml.get(), entitiesFile))
 		return false;
 
 	TiXmlNode* node = xml->getRootNode();
@@ -2265,7 +2275,7 @@ bool EntityDef::loadAllEntityScriptModules(std::string entitiesPath,
 		return false;
 
 	SmartPointer<XML> xml(new XML());
-	if(!xml->openSection(entitiesFile.c_str()))
+	if(!EntityDefImage::openSection(xml.get(), entitiesFile))
 		return false;
 
 	TiXmlNode* node = xml->getRootNode();
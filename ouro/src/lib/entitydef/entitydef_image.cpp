@@ -0,0 +1,464 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "entitydef_image.h"
+#include "common/md5.h"
+#include "common/memorystream.h"
+#include "resmgr/resmgr.h"
+
+namespace Ouroboros{
+
+MappedFile EntityDefImage::file_;
+EntityDefImage::FILES EntityDefImage::files_;
+std::map<std::string, std::string> EntityDefImage::parsed_;
+std::string EntityDefImage::scriptsPath_;
+std::string EntityDefImage::imagePath_;
+uint8 EntityDefImage::digest_[16];
+bool EntityDefImage::isOpen_ = false;
+bool EntityDefImage::isCurrent_ = false;
+
+// Node records of a document, the children of an element follow it up to a NODE_END
+enum
+{
+	NODE_END = 0,
+	NODE_ELEMENT = 1,		// name, number of attributes, (name, value)...
+	NODE_TEXT = 2,			// cdata, value
+	NODE_COMMENT = 3,		// value
+	NODE_UNKNOWN = 4		// value
+};
+
+//-------------------------------------------------------------------------------------
+static bool readUint8(const uint8*& p, const uint8* end, uint8& value)
+{
+	if (p >= end)
+		return false;
+
+	value = *p++;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static bool readUint32(const uint8*& p, const uint8* end, uint32& value)
+{
+	if (end - p < (ptrdiff_t)sizeof(uint32))
+		return false;
+
+	memcpy(&value, p, sizeof(uint32));
+	EndianConvert(value);
+	p += sizeof(uint32);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static bool readString(const uint8*& p, const uint8* end, const char*& str)
+{
+	const uint8* pEnd = p < end ? (const uint8*)memchr(p, 0, end - p) : NULL;
+	if (pEnd == NULL)
+		return false;
+
+	str = (const char*)p;
+	p = pEnd + 1;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static bool readFile(const std::string& path, std::string& data)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if (f == NULL)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	bool ret = size >= 0;
+	if (ret)
+	{
+		data.resize((size_t)size);
+		ret = size == 0 || fread(&data[0], 1, (size_t)size, f) == (size_t)size;
+	}
+
+	fclose(f);
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefImage::open(const std::string& scriptsPath, const std::string& defFilePath)
+{
+	close();
+
+	scriptsPath_ = scriptsPath;
+	std::replace(scriptsPath_.begin(), scriptsPath_.end(), '\\', '/');
+	imagePath_ = scriptsPath + "entitydef.image";
+
+	if (!hashSources_(defFilePath, digest_))
+	{
+		WARNING_MSG(fmt::format("EntityDefImage::open: couldn't read the def sources, {} is not used!\n",
+			imagePath_));
+
+		return false;
+	}
+
+	isOpen_ = true;
+	isCurrent_ = mapImage_(digest_);
+
+	if (isCurrent_)
+	{
+		INFO_MSG(fmt::format("EntityDefImage::open: {} is current({} files).\n",
+			imagePath_, files_.size()));
+	}
+	else
+	{
+		INFO_MSG(fmt::format("EntityDefImage::open: {} is stale or missing, parsing the def files.\n",
+			imagePath_));
+	}
+
+	return isCurrent_;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityDefImage::close()
+{
+	file_.close();
+	files_.clear();
+	parsed_.clear();
+	isOpen_ = false;
+	isCurrent_ = false;
+}
+
+//-------------------------------------------------------------------------------------
+std::string EntityDefImage::fileKey_(const std::string& file)
+{
+	std::string key = file;
+	std::replace(key.begin(), key.end(), '\\', '/');
+
+	// Only the files under the scripts are def sources
+	if (scriptsPath_.empty() || key.compare(0, scriptsPath_.size(), scriptsPath_) != 0)
+		return "";
+
+	return key.substr(scriptsPath_.size());
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefImage::hashSources_(const std::string& defFilePath, uint8* digest)
+{
+	std::vector<std::string> sources;
+
+	std::string entitiesFile = scriptsPath_ + "entities.xml";
+	if (access(entitiesFile.c_str(), 0) == 0)
+		sources.push_back(fileKey_(entitiesFile));
+
+	if (access(defFilePath.c_str(), 0) == 0)
+	{
+		wchar_t* wpath = strutil::char2wchar(defFilePath.c_str());
+		std::vector<std::wstring> results;
+		Resmgr::getSingleton().listPathRes(wpath, L"def|xml", results);
+		free(wpath);
+
+		std::vector<std::wstring>::iterator iter = results.begin();
+		for (; iter != results.end(); ++iter)
+		{
+			char* cpath = strutil::wchar2char((*iter).c_str());
+			std::string key = fileKey_(cpath);
+			free(cpath);
+
+			if (!key.empty())
+				sources.push_back(key);
+		}
+	}
+
+	// The order of listPathRes depends on the file system
+	std::sort(sources.begin(), sources.end());
+
+	OURO_MD5 md5;
+
+	uint32 version = IMAGE_VERSION;
+	md5.append((void*)&version, sizeof(uint32));
+
+	std::string data;
+	std::vector<std::string>::iterator iter = sources.begin();
+	for (; iter != sources.end(); ++iter)
+	{
+		if (!readFile(scriptsPath_ + (*iter), data))
+			return false;
+
+		uint32 size = (uint32)data.size();
+		md5.append((void*)(*iter).c_str(), (int)(*iter).size() + 1);
+		md5.append((void*)&size, sizeof(uint32));
+		md5.append((void*)data.data(), (int)data.size());
+	}
+
+	md5.final();
+	memcpy(digest, md5.getDigest(), 16);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefImage::mapImage_(const uint8* digest)
+{
+	if (access(imagePath_.c_str(), 0) != 0 || !file_.open(imagePath_))
+		return false;
+
+	const uint8* p = file_.data();
+	const uint8* end = p + file_.size();
+
+	uint32 magic = 0, version = 0, numFiles = 0, size = 0;
+
+	if (!readUint32(p, end, magic) || magic != IMAGE_MAGIC ||
+		!readUint32(p, end, version) || version != IMAGE_VERSION ||
+		end - p < 16 || memcmp(p, digest, 16) != 0)
+	{
+		file_.close();
+		return false;
+	}
+
+	p += 16;
+
+	if (!readUint32(p, end, size) || size != file_.size() || !readUint32(p, end, numFiles))
+	{
+		file_.close();
+		return false;
+	}
+
+	for (uint32 i = 0; i < numFiles; ++i)
+	{
+		const char* key = NULL;
+		FileEntry entry;
+
+		if (!readString(p, end, key) || !readUint32(p, end, entry.offset) || !readUint32(p, end, entry.size) ||
+			entry.offset > size || entry.size > size - entry.offset)
+		{
+			ERROR_MSG(fmt::format("EntityDefImage::mapImage_: {} is corrupted!\n", imagePath_));
+			files_.clear();
+			file_.close();
+			return false;
+		}
+
+		files_[key] = entry;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefImage::openSection(XML* pXml, const std::string& file)
+{
+	if (!isOpen_)
+		return pXml->openSection(file.c_str());
+
+	std::string key = fileKey_(file);
+
+	if (isCurrent_ && !key.empty())
+	{
+		FILES::iterator iter = files_.find(key);
+		if (iter != files_.end())
+		{
+			const uint8* p = file_.data() + iter->second.offset;
+			TiXmlDocument* pDoc = new TiXmlDocument(file.c_str());
+
+			if (readNodes_(p, p + iter->second.size, pDoc))
+				return pXml->openDocument(pDoc);
+
+			delete pDoc;
+
+			ERROR_MSG(fmt::format("EntityDefImage::openSection: {} is corrupted in {}, parsing the file!\n",
+				key, imagePath_));
+		}
+	}
+
+	if (!pXml->openSection(file.c_str()))
+		return false;
+
+	if (!isCurrent_ && !key.empty())
+	{
+		MemoryStream s;
+
+		const TiXmlNode* pNode = pXml->getTxdoc()->FirstChild();
+		for (; pNode != NULL; pNode = pNode->NextSibling())
+			writeNode_(s, pNode);
+
+		s << (uint8)NODE_END;
+		parsed_[key].assign((const char*)s.data(), s.wpos());
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefImage::save()
+{
+	if (!isOpen_ || isCurrent_ || parsed_.empty())
+		return true;
+
+	// Header: magic, version, digest of the sources, size of the image, number of files
+	uint32 tableSize = 4 + 4 + 16 + 4 + 4;
+
+	std::map<std::string, std::string>::iterator iter = parsed_.begin();
+	for (; iter != parsed_.end(); ++iter)
+		tableSize += (uint32)iter->first.size() + 1 + 4 + 4;
+
+	uint32 size = tableSize;
+	for (iter = parsed_.begin(); iter != parsed_.end(); ++iter)
+		size += (uint32)iter->second.size();
+
+	MemoryStream s(size);
+	s << (uint32)IMAGE_MAGIC << (uint32)IMAGE_VERSION;
+	s.append(digest_, 16);
+	s << size << (uint32)parsed_.size();
+
+	uint32 offset = tableSize;
+	for (iter = parsed_.begin(); iter != parsed_.end(); ++iter)
+	{
+		s << iter->first << offset << (uint32)iter->second.size();
+		offset += (uint32)iter->second.size();
+	}
+
+	for (iter = parsed_.begin(); iter != parsed_.end(); ++iter)
+		s.append(iter->second.data(), iter->second.size());
+
+	// Other processes may be writing the image at the same time, the image is replaced as a whole
+	std::string tmpPath = fmt::format("{}.{}", imagePath_, getProcessPID());
+
+	FILE* f = fopen(tmpPath.c_str(), "wb");
+	bool ret = f != NULL && fwrite(s.data(), 1, s.wpos(), f) == s.wpos();
+
+	if (f != NULL)
+		ret = (fclose(f) == 0) && ret;
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	ret = ret && MoveFileExA(tmpPath.c_str(), imagePath_.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	ret = ret && rename(tmpPath.c_str(), imagePath_.c_str()) == 0;
+#endif
+
+	if (!ret)
+	{
+		remove(tmpPath.c_str());
+
+		WARNING_MSG(fmt::format("EntityDefImage::save: couldn't write {}!\n", imagePath_));
+		return false;
+	}
+
+	INFO_MSG(fmt::format("EntityDefImage::save: wrote {}({} files, {} bytes).\n",
+		imagePath_, parsed_.size(), size));
+
+	parsed_.clear();
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityDefImage::writeNode_(MemoryStream& s, const TiXmlNode* pNode)
+{
+	switch (pNode->Type())
+	{
+	case TiXmlNode::TINYXML_ELEMENT:
+	{
+		const TiXmlElement* pElement = pNode->ToElement();
+
+		uint32 numAttributes = 0;
+		const TiXmlAttribute* pAttribute = pElement->FirstAttribute();
+		for (; pAttribute != NULL; pAttribute = pAttribute->Next())
+			++numAttributes;
+
+		s << (uint8)NODE_ELEMENT << pElement->Value() << numAttributes;
+
+		pAttribute = pElement->FirstAttribute();
+		for (; pAttribute != NULL; pAttribute = pAttribute->Next())
+			s << pAttribute->Name() << pAttribute->Value();
+
+		const TiXmlNode* pChild = pElement->FirstChild();
+		for (; pChild != NULL; pChild = pChild->NextSibling())
+			writeNode_(s, pChild);
+
+		s << (uint8)NODE_END;
+		break;
+	}
+	case TiXmlNode::TINYXML_TEXT:
+		s << (uint8)NODE_TEXT << (uint8)(pNode->ToText()->CDATA() ? 1 : 0) << pNode->Value();
+		break;
+	case TiXmlNode::TINYXML_COMMENT:
+		s << (uint8)NODE_COMMENT << pNode->Value();
+		break;
+	case TiXmlNode::TINYXML_UNKNOWN:
+		s << (uint8)NODE_UNKNOWN << pNode->Value();
+		break;
+	default:
+		// The declaration is not needed by the loaders
+		break;
+	};
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefImage::readNodes_(const uint8*& p, const uint8* end, TiXmlNode* pParent)
+{
+	while (true)
+	{
+		uint8 type = NODE_END;
+		if (!readUint8(p, end, type))
+			return false;
+
+		const char* value = NULL;
+
+		switch (type)
+		{
+		case NODE_END:
+			return true;
+		case NODE_ELEMENT:
+		{
+			uint32 numAttributes = 0;
+			if (!readString(p, end, value) || !readUint32(p, end, numAttributes))
+				return false;
+
+			TiXmlElement* pElement = new TiXmlElement(value);
+			pParent->LinkEndChild(pElement);
+
+			for (uint32 i = 0; i < numAttributes; ++i)
+			{
+				const char* name = NULL;
+				if (!readString(p, end, name) || !readString(p, end, value))
+					return false;
+
+				pElement->SetAttribute(name, value);
+			}
+
+			if (!readNodes_(p, end, pElement))
+				return false;
+
+			break;
+		}
+		case NODE_TEXT:
+		{
+			uint8 cdata = 0;
+			if (!readUint8(p, end, cdata) || !readString(p, end, value))
+				return false;
+
+			TiXmlText* pText = new TiXmlText(value);
+			pText->SetCDATA(cdata != 0);
+			pParent->LinkEndChild(pText);
+			break;
+		}
+		case NODE_COMMENT:
+		{
+			if (!readString(p, end, value))
+				return false;
+
+			pParent->LinkEndChild(new TiXmlComment(value));
+			break;
+		}
+		case NODE_UNKNOWN:
+		{
+			if (!readString(p, end, value))
+				return false;
+
+			TiXmlUnknown* pUnknown = new TiXmlUnknown();
+			pUnknown->SetValue(value);
+			pParent->LinkEndChild(pUnknown);
+			break;
+		}
+		default:
+			return false;
+		};
+	}
+}
+
+}
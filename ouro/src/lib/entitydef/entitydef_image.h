@@ -0,0 +1,84 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_ENTITYDEF_IMAGE_H
+#define OURO_ENTITYDEF_IMAGE_H
+
+#include "common/common.h"
+#include "common/mapped_file.h"
+#include "xml/xml.h"
+
+namespace Ouroboros{
+
+/*
+	The def documents(entities.xml and every .def/.xml under entity_defs) compiled into one binary file.
+
+	The image holds the documents as TinyXML left them after parsing, and is keyed by the MD5 of the
+	version, the names and the contents of all the def sources. EntityDef::initialize opens the image
+	first; if the key matches, the documents are built from the mapped image instead of being parsed,
+	otherwise the files are parsed as before and the parsed documents are written into a new image
+	when the initialization succeeded, for the next process or reload.
+*/
+class EntityDefImage
+{
+public:
+	enum
+	{
+		IMAGE_MAGIC = 0x4945444F,	// "ODEI"
+		IMAGE_VERSION = 1
+	};
+
+	/**
+		Hashes the def sources and maps the image if it was made from the same sources
+	*/
+	static bool open(const std::string& scriptsPath, const std::string& defFilePath);
+	static void close();
+
+	/**
+		The image was made from the current def sources
+	*/
+	static bool isCurrent() { return isCurrent_; }
+
+	/**
+		Opens a def file from the image, or parses it if it is not in the image
+	*/
+	static bool openSection(XML* pXml, const std::string& file);
+
+	/**
+		Writes the documents parsed since open() into a new image if the image was not current
+	*/
+	static bool save();
+
+private:
+	struct FileEntry
+	{
+		uint32 offset;
+		uint32 size;
+	};
+
+	typedef OUROUnordered_map<std::string, FileEntry> FILES;
+
+	static std::string fileKey_(const std::string& file);
+	static bool hashSources_(const std::string& defFilePath, uint8* digest);
+	static bool mapImage_(const uint8* digest);
+
+	static void writeNode_(MemoryStream& s, const TiXmlNode* pNode);
+	static bool readNodes_(const uint8*& p, const uint8* end, TiXmlNode* pParent);
+
+private:
+	static MappedFile file_;
+	static FILES files_;
+
+	// Documents parsed while the image is not current, by key
+	static std::map<std::string, std::string> parsed_;
+
+	static std::string scriptsPath_;
+	static std::string imagePath_;
+	static uint8 digest_[16];
+
+	static bool isOpen_;
+	static bool isCurrent_;
+};
+
+}
+
+#endif // OURO_ENTITYDEF_IMAGE_H
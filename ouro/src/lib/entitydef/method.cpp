@@ -3,6 +3,7 @@
 #include "method.h"
 #include "entitydef.h"
 #include "network/bundle.h"
+#include "helper/eventhistory_stats.h"
 
 #ifndef CODE_INLINE
 #include "method.inl"
@@ -21,7 +22,13 @@ name_(name),
 utype_(utype),
 argTypes_(),
 exposedType_(exposedType),
-aliasID_(-1)
+aliasID_(-1),
+fastCall_(-1),
+eventID_(EventHistoryStats::allocEventID()),
+pyName_(NULL),
+pyFuncType_(NULL),
+pyFuncVersionTag_(0),
+pyFunc_(NULL)
 {
 	MethodDescription::methodDescriptionCount_++;
 
@@ -38,6 +45,10 @@ MethodDescription::~MethodDescription()
 		(*iter)->decRef();
 
 	argTypes_.clear();
+
+	// pyFuncType_ and pyFunc_ are borrowed
+	if (pyName_ && Py_IsInitialized())
+		Py_DECREF(pyName_);
 }
 
 //-------------------------------------------------------------------------------------
@@ -61,6 +72,7 @@ bool MethodDescription::pushArgType(DataType* dataType)
 
 	dataType->incRef();
 	argTypes_.push_back(dataType);
+	fastCall_ = -1;
 
 	DATATYPE_UID uid = dataType->id();
 	EntityDef::md5().append((void*)&uid, sizeof(DATATYPE_UID));
@@ -239,18 +251,165 @@ PyObject* MethodDescription::call(PyObject* func, PyObject* args)
 	}
 
 	if (PyErr_Occurred())
+		onCallError_();
+
+	return pyResult;
+}
+
+//-------------------------------------------------------------------------------------
+void MethodDescription::onCallError_()
+{
+	if (isExposed() == EXPOSED_AND_CALLER_CHECK && PyErr_ExceptionMatches(PyExc_TypeError))
 	{
-		if (isExposed() == EXPOSED_AND_CALLER_CHECK && PyErr_ExceptionMatches(PyExc_TypeError))
+		WARNING_MSG(fmt::format("MethodDescription::call: {} is exposed of method, if there is a missing arguments error, "
+			"try adding callerEntityID, For example: \ndef func(msg): => def func(callerEntityID, msg):\n",
+			this->getName()));
+	}
+
+	PyErr_PrintEx(0);
+}
+
+//-------------------------------------------------------------------------------------
+bool MethodDescription::isFastCall()
+{
+	if (fastCall_ >= 0)
+		return fastCall_ > 0;
+
+	fastCall_ = argTypes_.size() <= (size_t)FASTCALL_MAX_ARGS ? 1 : 0;
+
+	std::vector<DataType*>::iterator iter = argTypes_.begin();
+	for (; fastCall_ > 0 && iter != argTypes_.end(); ++iter)
+	{
+		switch ((*iter)->type())
 		{
-			WARNING_MSG(fmt::format("MethodDescription::call: {} is exposed of method, if there is a missing arguments error, "
-				"try adding callerEntityID, For example: \ndef func(msg): => def func(callerEntityID, msg):\n",
-				this->getName()));
+		case DATA_TYPE_DIGIT:
+		case DATA_TYPE_VECTOR2:
+		case DATA_TYPE_VECTOR3:
+		case DATA_TYPE_VECTOR4:
+		case DATA_TYPE_STRING:
+		case DATA_TYPE_UNICODE:
+			break;
+		default:
+			fastCall_ = 0;
+			break;
+		};
+	}
+
+	return fastCall_ > 0;
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* MethodDescription::findFunction_(PyObject* pyCallObject)
+{
+	PyTypeObject* pyType = Py_TYPE(pyCallObject);
+
+	if (pyType != pyFuncType_ || !PyType_HasFeature(pyType, Py_TPFLAGS_VALID_VERSION_TAG) ||
+		pyType->tp_version_tag != pyFuncVersionTag_)
+	{
+		pyFuncType_ = NULL;
+		pyFunc_ = NULL;
+
+		if (pyName_ == NULL)
+		{
+			pyName_ = PyUnicode_InternFromString(getName());
+			if (pyName_ == NULL)
+			{
+				PyErr_Clear();
+				return NULL;
+			}
 		}
 
-		PyErr_PrintEx(0);
+		// The lookup gives the class a version tag, any change to the class dicts replaces it
+		PyObject* pyFunc = _PyType_Lookup(pyType, pyName_);
+		if (pyFunc == NULL || !PyFunction_Check(pyFunc) || !PyType_HasFeature(pyType, Py_TPFLAGS_VALID_VERSION_TAG))
+			return NULL;
+
+		pyFuncType_ = pyType;
+		pyFuncVersionTag_ = pyType->tp_version_tag;
+		pyFunc_ = pyFunc;
 	}
 
-	return pyResult;
+	// An attribute of the object itself hides the method of the class
+	PyObject** pyDictPtr = _PyObject_GetDictPtr(pyCallObject);
+	if (pyDictPtr && *pyDictPtr && PyDict_GetItem(*pyDictPtr, pyName_))
+		return NULL;
+
+	return pyFunc_;
+}
+
+//-------------------------------------------------------------------------------------
+bool MethodDescription::callFromStream(PyObject* pyCallObject, MemoryStream* mstream)
+{
+	OURO_ASSERT(isFastCall());
+
+	PyObject* stack[FASTCALL_MAX_ARGS + 2];
+	Py_ssize_t nargs = 0;
+
+	stack[nargs++] = pyCallObject;
+
+	if (isExposed() == EXPOSED_AND_CALLER_CHECK && g_componentType == CELLAPP_TYPE && isCell())
+	{
+		// Set a caller ID to the script to determine if the source is correct
+		OURO_ASSERT(EntityDef::context().currEntityID > 0);
+		stack[nargs++] = PyLong_FromLong(EntityDef::context().currEntityID);
+	}
+
+	bool ret = true;
+
+	for (size_t index = 0; index < argTypes_.size(); ++index)
+	{
+		PyObject* pyitem = argTypes_[index]->createFromStream(mstream);
+
+		if (pyitem == NULL)
+		{
+			WARNING_MSG(fmt::format("MethodDescription::callFromStream: {} arg[{}][{}] is NULL.\n", 
+				this->getName(), index, argTypes_[index]->getName()));
+
+			ret = false;
+			break;
+		}
+
+		stack[nargs++] = pyitem;
+	}
+
+	if (ret)
+	{
+		PyObject* pyResult = NULL;
+		PyObject* pyFunc = findFunction_(pyCallObject);
+
+		if (pyFunc)
+		{
+			// The cached function is borrowed from the class, the script may rebind the method during the call
+			Py_INCREF(pyFunc);
+			pyResult = _PyObject_FastCall(pyFunc, stack, nargs);
+			Py_DECREF(pyFunc);
+		}
+		else
+		{
+			PyObject* pyBound = PyObject_GetAttrString(pyCallObject, const_cast<char*>(getName()));
+			if (pyBound && PyCallable_Check(pyBound))
+			{
+				pyResult = _PyObject_FastCall(pyBound, stack + 1, nargs - 1);
+			}
+			else if (pyBound)
+			{
+				PyErr_Format(PyExc_TypeError, "MethodDescription::call: method[%s] call attempted on a error object!", 
+					getName());
+			}
+
+			Py_XDECREF(pyBound);
+		}
+
+		Py_XDECREF(pyResult);
+
+		if (PyErr_Occurred())
+			onCallError_();
+	}
+
+	for (Py_ssize_t i = 1; i < nargs; ++i)
+		Py_DECREF(stack[i]);
+
+	return ret;
 }
 
 //-------------------------------------------------------------------------------------
@@ -23,6 +23,9 @@ namespace Ouroboros{
 class MethodDescription
 {
 public:
+	// The most arguments a method may have to be called by callFromStream
+	static const int FASTCALL_MAX_ARGS = 16;
+
 	// type of exposure method
 	enum EXPOSED_TYPE
 	{
@@ -82,6 +85,19 @@ public:
 	*/
 	PyObject* call(PyObject* func, PyObject* args);	
 
+	/** 
+		Every argument is a number, a vector or a string and there are at most FASTCALL_MAX_ARGS of them
+	*/
+	bool isFastCall();
+
+	/** 
+		Unpacks a call stream onto the stack and calls the method of pyCallObject, only for isFastCall methods.
+		The arguments are checked by their types while they are unpacked, the method of the script class
+		is called with pyCallObject as its first argument, no args tuple or bound method is created.
+		Returns false if the stream could not be unpacked.
+	*/
+	bool callFromStream(PyObject* pyCallObject, MemoryStream* mstream);
+
 	INLINE COMPONENT_ID domain() const;
 
 	INLINE bool isClient() const;
@@ -95,6 +111,11 @@ public:
 	INLINE int16 aliasID() const;
 	INLINE uint8 aliasIDAsUint8() const;
 	INLINE void aliasID(int16 v);
+
+	/** 
+		The id of the events of this method in EventHistoryStats, given when the defs are loaded
+	*/
+	INLINE uint32 eventID() const;
 	
 protected:
 	static uint32 methodDescriptionCount_; // number of all attribute descriptions
@@ -109,6 +130,24 @@ protected:
 	EXPOSED_TYPE exposedType_; // Is it an exposure method?
 
 	int16 aliasID_; // alias id, when the total number of exposed methods or broadcast properties is less than 255, we do not use utype and use 1 byte aliasID to transmit
+
+	int8 fastCall_; // -1: not checked yet
+
+	uint32 eventID_; // The id of the events of this method in EventHistoryStats
+
+	// The function of the script class callFromStream calls, valid while the class keeps its version tag
+	PyObject* pyName_;
+	PyTypeObject* pyFuncType_;
+	unsigned int pyFuncVersionTag_;
+	PyObject* pyFunc_;
+
+private:
+	/** 
+		The plain function the method of pyCallObject is bound to, NULL if there is none or the object overrides it
+	*/
+	PyObject* findFunction_(PyObject* pyCallObject);
+
+	void onCallError_();
 };
 
 }
@@ -43,6 +43,11 @@ INLINE void MethodDescription::aliasID(int16 v)
 	aliasID_ = v; 
 }
 
+INLINE uint32 MethodDescription::eventID() const
+{ 
+	return eventID_; 
+}
+
 INLINE COMPONENT_ID MethodDescription::domain() const
 { 
 	return methodDomain_; 
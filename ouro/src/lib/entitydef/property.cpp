@@ -8,6 +8,7 @@
 #include "pyscript/vector3.h"
 #include "pyscript/vector4.h"
 #include "pyscript/copy.h"
+#include "helper/eventhistory_stats.h"
 
 #ifndef CODE_INLINE
 #include "property.inl"
@@ -40,7 +41,8 @@ PropertyDescription::PropertyDescription(ENTITY_PROPERTY_UID utype,
 	defaultValStr_(defaultStr),
 	detailLevel_(detailLevel),
 	aliasID_(-1),
-	indexType_(indexType)
+	indexType_(indexType),
+	eventID_(EventHistoryStats::allocEventID())
 {
 	dataType_->incRef();
 
@@ -92,6 +92,11 @@ public:
 	INLINE uint8 aliasIDAsUint8() const;
 	INLINE void aliasID(int16 v);
 
+	/** 
+		The id of the events of this attribute in EventHistoryStats, given when the defs are loaded
+	*/
+	INLINE uint32 eventID() const;
+
 	/** 
 		Set this property to index key
 	*/
@@ -162,6 +167,7 @@ protected:
 	DETAIL_TYPE detailLevel_; // The lod detail level of this attribute See the definition of the property's lod broadcast level range in common:
 	int16 aliasID_; // alias id, when the total number of exposed methods or broadcast properties is less than 255, we do not use utype and use 1 byte aliasID to transmit
 	std::string indexType_; // The index category of the attribute, UNIQUE, INDEX, corresponding to no setting, unique index, normal index
+	uint32 eventID_; // The id of the events of this attribute in EventHistoryStats
 };
 
 class FixedDictDescription : public PropertyDescription
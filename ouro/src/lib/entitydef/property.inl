@@ -78,6 +78,11 @@ INLINE uint8 PropertyDescription::aliasIDAsUint8() const
 	return (uint8)aliasID_; 
 }
 
+INLINE uint32 PropertyDescription::eventID() const 
+{ 
+	return eventID_; 
+}
+
 INLINE void PropertyDescription::aliasID(int16 v)
 { 
 	aliasID_ = v; 
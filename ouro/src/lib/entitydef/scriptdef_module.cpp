@@ -3,6 +3,7 @@
 
 #include "scriptdef_module.h"
 #include "entitydef.h"
+#include "entitydef_image.h"
 #include "py_entitydef.h"
 #include "datatypes.h"
 #include "common.h"
@@ -349,7 +350,7 @@ void ScriptDefModule::autoMatchCompOwn()
 	if (access(entitiesFile.c_str(), 0) == 0)
 	{
 		SmartPointer<XML> xml(new XML());
-		if (!xml->openSection(entitiesFile.c_str()) || !xml->isGood())
+		if (!EntityDefImage::openSection(xml.get(), entitiesFile) || !xml->isGood())
 			return;
 
 		// Get the entities.xml root node, if you do not define an entity then directly return true
@@ -0,0 +1,468 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+
+#include "async_log.h"
+#include "helper/debug_helper.h"
+
+namespace Ouroboros{
+
+// Every AsyncLogger has at most one instance per process(DebugHelper)
+static AsyncLogger* g_pAsyncLogger = NULL;
+static thread::ThreadMutex g_asyncLoggerMutex;
+
+// Ring of the calling thread, detached when the thread exits
+struct AsyncLogThreadRing
+{
+	AsyncLogThreadRing():
+	pRing(NULL)
+	{
+	}
+
+	~AsyncLogThreadRing()
+	{
+		if(pRing)
+			AsyncLogger::onThreadExit(pRing);
+	}
+
+	AsyncLogRing* pRing;
+};
+
+static thread_local AsyncLogThreadRing g_threadLogRing;
+
+//-------------------------------------------------------------------------------------
+AsyncLogRing::AsyncLogRing(uint32 capacity):
+buffer_(NULL),
+capacity_(0),
+head_(0),
+tail_(0),
+detached_(false)
+{
+	// Power of two so that positions can be masked
+	capacity_ = 4096;
+	while(capacity_ < capacity)
+		capacity_ <<= 1;
+
+	buffer_ = new char[capacity_];
+}
+
+//-------------------------------------------------------------------------------------
+AsyncLogRing::~AsyncLogRing()
+{
+	SAFE_RELEASE_ARRAY(buffer_);
+}
+
+//-------------------------------------------------------------------------------------
+bool AsyncLogRing::push(uint32 logType, int32 scriptMsgType, const char* str, uint32 length)
+{
+	uint32 size = (HEADER_SIZE + length + 3) & ~3U;
+	if(size > capacity_ / 2)
+		return false;
+
+	uint64 head = head_.load(std::memory_order_relaxed);
+	uint64 tail = tail_.load(std::memory_order_acquire);
+
+	uint32 pos = (uint32)(head & (capacity_ - 1));
+	uint32 padding = 0;
+
+	// Entries never wrap, skip the rest of the buffer if the entry does not fit
+	if(pos + size > capacity_)
+		padding = capacity_ - pos;
+
+	if(head + padding + size - tail > capacity_)
+		return false;
+
+	if(padding > 0)
+	{
+		// There is always room for a header at the end since every entry is 4 byte aligned and >= HEADER_SIZE,
+		// except when less than HEADER_SIZE bytes are left, then the consumer skips them by itself
+		if(padding >= HEADER_SIZE)
+		{
+			uint32 pad = PADDING;
+			memcpy(buffer_ + pos, &pad, sizeof(uint32));
+		}
+
+		head += padding;
+		pos = 0;
+	}
+
+	char* p = buffer_ + pos;
+	memcpy(p, &length, sizeof(uint32));
+	memcpy(p + 4, &logType, sizeof(uint32));
+	memcpy(p + 8, &scriptMsgType, sizeof(int32));
+	memcpy(p + HEADER_SIZE, str, length);
+
+	head_.store(head + size, std::memory_order_release);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool AsyncLogRing::pop(uint32& logType, int32& scriptMsgType, std::string& str)
+{
+	uint64 tail = tail_.load(std::memory_order_relaxed);
+	uint64 head = head_.load(std::memory_order_acquire);
+
+	while(tail != head)
+	{
+		uint32 pos = (uint32)(tail & (capacity_ - 1));
+
+		if(capacity_ - pos < HEADER_SIZE)
+		{
+			tail += capacity_ - pos;
+			continue;
+		}
+
+		uint32 length;
+		memcpy(&length, buffer_ + pos, sizeof(uint32));
+
+		if(length == PADDING)
+		{
+			tail += capacity_ - pos;
+			continue;
+		}
+
+		const char* p = buffer_ + pos;
+		memcpy(&logType, p + 4, sizeof(uint32));
+		memcpy(&scriptMsgType, p + 8, sizeof(int32));
+		str.assign(p + HEADER_SIZE, length);
+
+		tail_.store(tail + ((HEADER_SIZE + length + 3) & ~3U), std::memory_order_release);
+		return true;
+	}
+
+	tail_.store(tail, std::memory_order_release);
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+AsyncLogger::AsyncLogger(WRITE_FUNC writeFunc, uint32 ringSize, OVERFLOW_POLICY policy, uint32 blockTimeout):
+writeFunc_(writeFunc),
+ringSize_(ringSize),
+policy_(policy),
+blockTimeout_(blockTimeout),
+rings_(),
+ringsMutex_(),
+draining_(false),
+inFlight_(0),
+tid_(0),
+running_(false),
+dropped_(0),
+reportedDropped_(0),
+total_(0),
+written_(0)
+{
+	g_asyncLoggerMutex.lockMutex();
+	g_pAsyncLogger = this;
+	g_asyncLoggerMutex.unlockMutex();
+}
+
+//-------------------------------------------------------------------------------------
+AsyncLogger::~AsyncLogger()
+{
+	stop();
+
+	// Threads exiting from now on leave their ring alone
+	g_asyncLoggerMutex.lockMutex();
+	g_pAsyncLogger = NULL;
+	g_asyncLoggerMutex.unlockMutex();
+
+	// Threads that still reference their ring must not log anymore, DebugHelper is going away
+	std::vector<AsyncLogRing*>::iterator iter = rings_.begin();
+	for(; iter != rings_.end(); ++iter)
+		delete (*iter);
+
+	rings_.clear();
+	g_threadLogRing.pRing = NULL;
+}
+
+//-------------------------------------------------------------------------------------
+void AsyncLogger::onThreadExit(AsyncLogRing* pRing)
+{
+	// drain_ frees the ring once the rest of its messages are written
+	g_asyncLoggerMutex.lockMutex();
+
+	if(g_pAsyncLogger)
+		pRing->detach();
+
+	g_asyncLoggerMutex.unlockMutex();
+}
+
+//-------------------------------------------------------------------------------------
+bool AsyncLogger::start()
+{
+	if(isRunning())
+		return true;
+
+	running_.store(true, std::memory_order_release);
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	tid_ = (THREAD_ID)_beginthreadex(NULL, 0, &AsyncLogger::flushThreadFunc, (void*)this, 0, NULL);
+	if(tid_ == 0)
+	{
+		running_.store(false, std::memory_order_release);
+		return false;
+	}
+#else
+	if(pthread_create(&tid_, NULL, AsyncLogger::flushThreadFunc, (void*)this) != 0)
+	{
+		running_.store(false, std::memory_order_release);
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void AsyncLogger::stop()
+{
+	if(!isRunning())
+		return;
+
+	running_.store(false, std::memory_order_release);
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	if(WaitForSingleObject(tid_, INFINITE) == WAIT_OBJECT_0)
+		CloseHandle(tid_);
+#else
+	pthread_join(tid_, NULL);
+#endif
+
+	// The flush thread drains before exiting, anything pushed meanwhile is written here
+	while(drain_() > 0) {}
+	reportDropped_();
+}
+
+//-------------------------------------------------------------------------------------
+bool AsyncLogger::isFlushThread() const
+{
+	if(!isRunning())
+		return false;
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	return GetThreadId(tid_) == GetCurrentThreadId();
+#else
+	return pthread_equal(tid_, pthread_self()) != 0;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+AsyncLogRing* AsyncLogger::threadRing_()
+{
+	if(g_threadLogRing.pRing)
+		return g_threadLogRing.pRing;
+
+	AsyncLogRing* pRing = new AsyncLogRing(ringSize_);
+
+	ringsMutex_.lockMutex();
+	rings_.push_back(pRing);
+	ringsMutex_.unlockMutex();
+
+	g_threadLogRing.pRing = pRing;
+	return pRing;
+}
+
+//-------------------------------------------------------------------------------------
+bool AsyncLogger::push(uint32 logType, int32 scriptMsgType, const std::string& str, bool isMainThread)
+{
+	if(!isRunning() || isFlushThread())
+		return false;
+
+	AsyncLogRing* pRing = threadRing_();
+	if(str.size() > pRing->maxMessageSize())
+		return false;
+
+	total_.fetch_add(1, std::memory_order_relaxed);
+
+	if(pRing->push(logType, scriptMsgType, str.data(), (uint32)str.size()))
+		return true;
+
+	// The main thread must never wait on the log
+	if(policy_ == OVERFLOW_POLICY_BLOCK && !isMainThread)
+	{
+		uint64 startTime = timestamp();
+		uint64 maxWait = (uint64)blockTimeout_ * stampsPerSecond() / 1000;
+
+		while(isRunning() && timestamp() - startTime < maxWait)
+		{
+			Ouroboros::sleep(1);
+
+			if(pRing->push(logType, scriptMsgType, str.data(), (uint32)str.size()))
+				return true;
+		}
+	}
+
+	dropped_.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool AsyncLogger::empty_()
+{
+	bool ret = true;
+
+	ringsMutex_.lockMutex();
+
+	std::vector<AsyncLogRing*>::iterator iter = rings_.begin();
+	for(; iter != rings_.end(); ++iter)
+	{
+		if(!(*iter)->empty())
+		{
+			ret = false;
+			break;
+		}
+	}
+
+	ringsMutex_.unlockMutex();
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 AsyncLogger::drain_()
+{
+	uint32 count = 0;
+
+	// Only one consumer at a time, a crash-path flush never waits for a stuck flush thread here
+	bool expected = false;
+	if(!draining_.compare_exchange_strong(expected, true, std::memory_order_acquire))
+		return 0;
+
+	ringsMutex_.lockMutex();
+	std::vector<AsyncLogRing*> rings = rings_;
+	ringsMutex_.unlockMutex();
+
+	uint32 logType;
+	int32 scriptMsgType;
+	std::string str;
+
+	std::vector<AsyncLogRing*> deadRings;
+
+	std::vector<AsyncLogRing*>::iterator iter = rings.begin();
+	for(; iter != rings.end(); ++iter)
+	{
+		AsyncLogRing* pRing = (*iter);
+
+		// Read before draining, the last message of an exited thread is pushed before it is detached
+		bool detached = pRing->isDetached();
+
+		// Bounded per ring so that one busy thread cannot starve the others
+		for(uint32 i = 0; i < 1024; ++i)
+		{
+			// Counted before the pop so that flush never sees an empty ring and nothing in flight in between
+			inFlight_.fetch_add(1);
+
+			if(!pRing->pop(logType, scriptMsgType, str))
+			{
+				inFlight_.fetch_sub(1);
+				break;
+			}
+
+			writeFunc_(logType, scriptMsgType, str);
+			inFlight_.fetch_sub(1);
+			++count;
+		}
+
+		if(detached && pRing->empty())
+			deadRings.push_back(pRing);
+	}
+
+	if(deadRings.size() > 0)
+	{
+		ringsMutex_.lockMutex();
+
+		for(iter = deadRings.begin(); iter != deadRings.end(); ++iter)
+		{
+			rings_.erase(std::find(rings_.begin(), rings_.end(), (*iter)));
+			delete (*iter);
+		}
+
+		ringsMutex_.unlockMutex();
+	}
+
+	written_.fetch_add(count, std::memory_order_relaxed);
+	draining_.store(false, std::memory_order_release);
+	return count;
+}
+
+//-------------------------------------------------------------------------------------
+void AsyncLogger::reportDropped_()
+{
+	uint64 dropped = dropped_.load(std::memory_order_relaxed);
+	uint64 reported = reportedDropped_.exchange(dropped, std::memory_order_relaxed);
+
+	if(dropped == reported)
+		return;
+
+	writeFunc_(OUROLOG_WARNING, 0, fmt::format("AsyncLogger::reportDropped: {} logs were dropped, ring is full(ring_size={}KB)! total dropped={}\n",
+		dropped - reported, ringSize_ / 1024, dropped));
+}
+
+//-------------------------------------------------------------------------------------
+void AsyncLogger::flush(uint32 timeout)
+{
+	if(!isRunning() || isFlushThread())
+		return;
+
+	uint64 startTime = timestamp();
+	uint64 maxWait = (uint64)timeout * stampsPerSecond() / 1000;
+	uint64 lastWritten = written_.load(std::memory_order_relaxed);
+	uint64 lastProgress = startTime;
+
+	// The flush thread keeps writing, we only wait for it as long as it makes progress
+	while(!empty_() || inFlight_.load() > 0)
+	{
+		uint64 now = timestamp();
+		uint64 written = written_.load(std::memory_order_relaxed);
+
+		if(written != lastWritten)
+		{
+			lastWritten = written;
+			lastProgress = now;
+		}
+		else if(now - lastProgress >= maxWait)
+		{
+			// The flush thread is stuck(or died with the crash), write the rest ourselves.
+			// If it is stuck in the middle of a write there is nothing more we can do.
+			while(drain_() > 0) {}
+			break;
+		}
+
+		Ouroboros::sleep(1);
+	}
+
+	reportDropped_();
+}
+
+//-------------------------------------------------------------------------------------
+#if OURO_PLATFORM == PLATFORM_WIN32
+unsigned __stdcall AsyncLogger::flushThreadFunc(void* arg)
+#else
+void* AsyncLogger::flushThreadFunc(void* arg)
+#endif
+{
+	AsyncLogger* pAsyncLogger = static_cast<AsyncLogger*>(arg);
+	uint64 lastReportTime = timestamp();
+
+	while(pAsyncLogger->isRunning())
+	{
+		if(pAsyncLogger->drain_() == 0)
+			Ouroboros::sleep(1);
+
+		if(timestamp() - lastReportTime > stampsPerSecond())
+		{
+			lastReportTime = timestamp();
+			pAsyncLogger->reportDropped_();
+		}
+	}
+
+	while(pAsyncLogger->drain_() > 0) {}
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	return 0;
+#else
+	pthread_exit(NULL);
+	return NULL;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,162 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_ASYNC_LOG_H
+#define OURO_ASYNC_LOG_H
+
+#include "common/common.h"
+#include "thread/threadmutex.h"
+#include <atomic>
+
+namespace Ouroboros{
+
+/*
+	Single producer single consumer byte ring, one per logging thread.
+	The producer is the thread that logs, the consumer is the flush thread(or a crash-path flush).
+
+	Every entry is [uint32 length][uint32 logType][int32 scriptMsgType][bytes], entries never wrap,
+	when the tail of the buffer is too short a padding entry is written and the entry starts at 0.
+*/
+class AsyncLogRing
+{
+public:
+	AsyncLogRing(uint32 capacity);
+	~AsyncLogRing();
+
+	/**
+		Never blocks, returns false if the ring is full
+	*/
+	bool push(uint32 logType, int32 scriptMsgType, const char* str, uint32 length);
+
+	bool pop(uint32& logType, int32& scriptMsgType, std::string& str);
+
+	bool empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+	/**
+		The producer thread exited, the consumer frees the ring once it is drained
+	*/
+	void detach() { detached_.store(true, std::memory_order_release); }
+	bool isDetached() const { return detached_.load(std::memory_order_acquire); }
+
+	uint32 capacity() const { return capacity_; }
+
+	/**
+		The largest message that can ever fit
+	*/
+	uint32 maxMessageSize() const { return capacity_ / 2 - HEADER_SIZE; }
+
+private:
+	static const uint32 HEADER_SIZE = 12;
+	static const uint32 PADDING = 0xFFFFFFFF;
+
+	char* buffer_;
+	uint32 capacity_;
+
+	// Written by the producer only
+	std::atomic<uint64> head_;
+
+	// Written by the consumer only
+	std::atomic<uint64> tail_;
+
+	std::atomic<bool> detached_;
+};
+
+/*
+	Asynchronous front-end of DebugHelper.
+	Logging threads copy the formatted message into their own ring and return, a dedicated flush thread
+	drains all rings and performs the actual log4cxx/syslog/logger writes.
+
+	When a ring is full:
+		OVERFLOW_POLICY_DROP:	the message is dropped and counted.
+		OVERFLOW_POLICY_BLOCK:	worker threads wait for the flush thread up to blockTimeout milliseconds,
+								then drop. The main thread never waits, it always drops.
+*/
+class AsyncLogger
+{
+public:
+	enum OVERFLOW_POLICY
+	{
+		OVERFLOW_POLICY_DROP = 0,
+		OVERFLOW_POLICY_BLOCK = 1
+	};
+
+	/**
+		Called on the flush thread for every message
+	*/
+	typedef void (*WRITE_FUNC)(uint32 logType, int32 scriptMsgType, const std::string& str);
+
+	AsyncLogger(WRITE_FUNC writeFunc, uint32 ringSize, OVERFLOW_POLICY policy, uint32 blockTimeout);
+	~AsyncLogger();
+
+	bool start();
+
+	/**
+		Drain everything and stop the flush thread, later messages must be written synchronously
+	*/
+	void stop();
+
+	/**
+		Returns false if the message has to be written synchronously by the caller(flush thread, oversized message)
+	*/
+	bool push(uint32 logType, int32 scriptMsgType, const std::string& str, bool isMainThread);
+
+	/**
+		Crash-path flush, waits until the flush thread has written everything pushed so far.
+		If the flush thread does not make progress within timeout the caller drains the rings itself.
+	*/
+	void flush(uint32 timeout);
+
+	bool isRunning() const { return running_.load(std::memory_order_acquire); }
+	bool isFlushThread() const;
+
+	/**
+		Called when a logging thread exits
+	*/
+	static void onThreadExit(AsyncLogRing* pRing);
+
+	uint64 droppedLogs() const { return dropped_.load(std::memory_order_relaxed); }
+	uint64 totalLogs() const { return total_.load(std::memory_order_relaxed); }
+
+private:
+	AsyncLogRing* threadRing_();
+
+	/**
+		Drains all rings, returns the number of written messages
+	*/
+	uint32 drain_();
+
+	bool empty_();
+
+	void reportDropped_();
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	static unsigned __stdcall flushThreadFunc(void* arg);
+#else
+	static void* flushThreadFunc(void* arg);
+#endif
+
+private:
+	WRITE_FUNC writeFunc_;
+	uint32 ringSize_;
+	OVERFLOW_POLICY policy_;
+	uint32 blockTimeout_;
+
+	std::vector<AsyncLogRing*> rings_;
+	thread::ThreadMutex ringsMutex_;
+
+	// Only one consumer may drain at a time(flush thread or crash-path flush)
+	std::atomic<bool> draining_;
+
+	// Messages popped from a ring and not written yet, flush waits for them too
+	std::atomic<uint32> inFlight_;
+
+	THREAD_ID tid_;
+	std::atomic<bool> running_;
+	std::atomic<uint64> dropped_;
+	std::atomic<uint64> reportedDropped_;
+	std::atomic<uint64> total_;
+	std::atomic<uint64> written_;
+};
+
+}
+
+#endif // OURO_ASYNC_LOG_H
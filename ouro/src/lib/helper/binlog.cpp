@@ -0,0 +1,210 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+
+#include "binlog.h"
+#include "common/memorystream.h"
+
+namespace Ouroboros{
+namespace BinLog{
+
+//-------------------------------------------------------------------------------------
+uint32 formatID(const char* fmt)
+{
+	uint32 hash = 2166136261U;
+
+	while(*fmt)
+	{
+		hash ^= (uint8)(*fmt++);
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+//-------------------------------------------------------------------------------------
+void writeVarUInt(MemoryStream& s, uint64 v)
+{
+	while(v >= 0x80)
+	{
+		s << (uint8)((v & 0x7f) | 0x80);
+		v >>= 7;
+	}
+
+	s << (uint8)v;
+}
+
+//-------------------------------------------------------------------------------------
+bool readVarUInt(MemoryStream& s, uint64& v)
+{
+	v = 0;
+
+	for(int shift = 0; shift < 64; shift += 7)
+	{
+		if(s.length() == 0)
+			return false;
+
+		uint8 b;
+		s >> b;
+
+		v |= (uint64)(b & 0x7f) << shift;
+		if((b & 0x80) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+static bool readArg(MemoryStream& s, std::string* pOut)
+{
+	if(s.length() == 0)
+		return false;
+
+	uint8 type;
+	s >> type;
+
+	switch(type)
+	{
+	case BINLOG_ARG_INT:
+	{
+		uint64 v;
+		if(!readVarUInt(s, v))
+			return false;
+
+		if(pOut)
+			*pOut = fmt::format("{}", (int64)((v >> 1) ^ (~(v & 1) + 1)));
+		return true;
+	}
+	case BINLOG_ARG_UINT:
+	{
+		uint64 v;
+		if(!readVarUInt(s, v))
+			return false;
+
+		if(pOut)
+			*pOut = fmt::format("{}", v);
+		return true;
+	}
+	case BINLOG_ARG_DOUBLE:
+	{
+		if(s.length() < sizeof(double))
+			return false;
+
+		double v;
+		s >> v;
+
+		if(pOut)
+			*pOut = fmt::format("{}", v);
+		return true;
+	}
+	case BINLOG_ARG_STRING:
+	{
+		uint64 len;
+		if(!readVarUInt(s, len) || len > s.length())
+			return false;
+
+		if(pOut)
+			pOut->assign((const char*)s.data() + s.rpos(), (size_t)len);
+
+		s.read_skip((size_t)len);
+		return true;
+	}
+	case BINLOG_ARG_BOOL:
+	{
+		if(s.length() == 0)
+			return false;
+
+		uint8 v;
+		s >> v;
+
+		if(pOut)
+			*pOut = v ? "true" : "false";
+		return true;
+	}
+	default:
+		break;
+	};
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool skipArgs(MemoryStream& s, uint8 argc)
+{
+	for(uint8 i = 0; i < argc; ++i)
+	{
+		if(!readArg(s, NULL))
+			return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool readArgs(MemoryStream& s, uint8 argc, std::vector<std::string>& args)
+{
+	args.resize(argc);
+
+	for(uint8 i = 0; i < argc; ++i)
+	{
+		if(!readArg(s, &args[i]))
+			return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+std::string render(const std::string& fmt, const std::vector<std::string>& args)
+{
+	std::string out;
+	out.reserve(fmt.size() + args.size() * 8);
+
+	size_t nextArg = 0;
+
+	for(size_t i = 0; i < fmt.size(); ++i)
+	{
+		char c = fmt[i];
+
+		if(c == '{')
+		{
+			if(i + 1 < fmt.size() && fmt[i + 1] == '{')
+			{
+				out += '{';
+				++i;
+				continue;
+			}
+
+			size_t end = fmt.find('}', i);
+			if(end == std::string::npos)
+			{
+				out.append(fmt, i, std::string::npos);
+				break;
+			}
+
+			// {N} or {N:spec} selects an explicit argument, {} or {:spec} the next one
+			size_t argIdx = nextArg++;
+			if(i + 1 < end && fmt[i + 1] >= '0' && fmt[i + 1] <= '9')
+				argIdx = (size_t)atoi(fmt.c_str() + i + 1);
+
+			if(argIdx < args.size())
+				out += args[argIdx];
+			else
+				out.append(fmt, i, end - i + 1);
+
+			i = end;
+			continue;
+		}
+
+		if(c == '}' && i + 1 < fmt.size() && fmt[i + 1] == '}')
+			++i;
+
+		out += c;
+	}
+
+	return out;
+}
+
+//-------------------------------------------------------------------------------------
+}
+}
@@ -0,0 +1,179 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_BINLOG_H
+#define OURO_BINLOG_H
+
+#include "common/common.h"
+
+namespace Ouroboros{
+
+class MemoryStream;
+
+/*
+	Binary structured logs.
+
+	Instead of formatting every message to text on the calling component, a binlog record only carries
+	the ID of its format string and its raw arguments. Records are batched into one writeBinLogs message
+	per sync and the logger appends them to a segmented store (see binlog_store.h) without rendering them.
+
+	Layout of a writeBinLogs batch:
+		int32 uid, COMPONENT_TYPE, COMPONENT_ID, COMPONENT_ORDER globalOrder, COMPONENT_ORDER groupOrder
+		then any number of entries:
+			uint8 BINLOG_ENTRY_FORMAT, uint32 fmtID, std::string fmt
+			uint8 BINLOG_ENTRY_RECORD, uint32 logtype, int64 time(ms), uint32 fmtID, uint8 argc, args...
+
+	A format entry is sent once per logger connection, before the first record that uses it.
+	Batches filled by child threads carry the format entries of their own records again.
+
+	While binlog is enabled the text logs(DEBUG_MSG, INFO_MSG...) are also sent as records of
+	BINLOG_TEXT_FORMAT, the text being the only argument.
+*/
+#define BINLOG_ENTRY_FORMAT		1
+#define BINLOG_ENTRY_RECORD		2
+
+// A batch is closed and queued for sync once it grows past this size
+#define BINLOG_MAX_BATCH_SIZE	16384
+
+// The main thread takes the batch of a child thread once it is older than this many milliseconds
+#define BINLOG_THREAD_BATCH_TIMEOUT	100
+
+// Format of the records that carry a text log(DEBUG_MSG, INFO_MSG...), the text is the only argument
+#define BINLOG_TEXT_FORMAT		"{}"
+
+enum BINLOG_ARG_TYPE
+{
+	BINLOG_ARG_INT		= 1,	// zigzag varint
+	BINLOG_ARG_UINT		= 2,	// varint
+	BINLOG_ARG_DOUBLE	= 3,
+	BINLOG_ARG_STRING	= 4,	// varint length + bytes
+	BINLOG_ARG_BOOL		= 5
+};
+
+/*
+	A decoded record, used by the logger and the query tool
+*/
+struct BinLogRecord
+{
+	BinLogRecord():
+	uid(0),
+	logtype(0),
+	componentType(UNKNOWN_COMPONENT_TYPE),
+	componentID(0),
+	componentGlobalOrder(0),
+	componentGroupOrder(0),
+	t(0),
+	fmtID(0),
+	args()
+	{
+	}
+
+	int32 uid;
+	uint32 logtype;
+	COMPONENT_TYPE componentType;
+	COMPONENT_ID componentID;
+	COMPONENT_ORDER componentGlobalOrder;
+	COMPONENT_ORDER componentGroupOrder;
+	int64 t;
+	uint32 fmtID;
+	std::vector<std::string> args;
+};
+
+namespace BinLog{
+
+/**
+	Stable ID of a format string(FNV-1a), identical on every component and across restarts
+*/
+uint32 formatID(const char* fmt);
+
+void writeVarUInt(MemoryStream& s, uint64 v);
+bool readVarUInt(MemoryStream& s, uint64& v);
+
+/*
+	The writers are templates on the stream so that this header does not need memorystream.h,
+	debug_helper.h is included by memorystream.h itself.
+*/
+template<typename STREAM>
+inline void writeArg(STREAM& s, bool v)
+{
+	s << (uint8)BINLOG_ARG_BOOL << (uint8)(v ? 1 : 0);
+}
+
+template<typename STREAM>
+inline void writeStringArg(STREAM& s, const char* v, size_t len)
+{
+	s << (uint8)BINLOG_ARG_STRING;
+	writeVarUInt(s, len);
+	if(len > 0)
+		s.append(v, len);
+}
+
+template<typename STREAM>
+inline void writeArg(STREAM& s, const char* v)
+{
+	writeStringArg(s, v, v ? strlen(v) : 0);
+}
+
+template<typename STREAM>
+inline void writeArg(STREAM& s, const std::string& v)
+{
+	writeStringArg(s, v.data(), v.size());
+}
+
+template<typename STREAM, typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type writeArg(STREAM& s, T v)
+{
+	int64 iv = (int64)v;
+	s << (uint8)BINLOG_ARG_INT;
+	writeVarUInt(s, ((uint64)iv << 1) ^ (uint64)(iv >> 63));
+}
+
+template<typename STREAM, typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type writeArg(STREAM& s, T v)
+{
+	s << (uint8)BINLOG_ARG_UINT;
+	writeVarUInt(s, (uint64)v);
+}
+
+template<typename STREAM, typename T>
+inline typename std::enable_if<std::is_enum<T>::value>::type writeArg(STREAM& s, T v)
+{
+	writeArg(s, (int64)v);
+}
+
+template<typename STREAM, typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type writeArg(STREAM& s, T v)
+{
+	s << (uint8)BINLOG_ARG_DOUBLE << (double)v;
+}
+
+template<typename STREAM>
+inline void writeArgs(STREAM& s)
+{
+}
+
+template<typename STREAM, typename T, typename... Args>
+inline void writeArgs(STREAM& s, const T& v, const Args&... args)
+{
+	writeArg(s, v);
+	writeArgs(s, args...);
+}
+
+/**
+	Skip argc arguments, used to copy records without decoding them
+*/
+bool skipArgs(MemoryStream& s, uint8 argc);
+
+/**
+	Decode argc arguments into their text form
+*/
+bool readArgs(MemoryStream& s, uint8 argc, std::vector<std::string>& args);
+
+/**
+	Substitute {} and {N} placeholders of fmt with args, format specs are ignored
+*/
+std::string render(const std::string& fmt, const std::vector<std::string>& args);
+
+}
+}
+
+#endif // OURO_BINLOG_H
@@ -0,0 +1,456 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+
+#include "binlog_store.h"
+#include "helper/debug_helper.h"
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+#include <direct.h>
+#define OURO_BINLOG_MKDIR(a) _mkdir((a))
+#else
+#include <sys/stat.h>
+#define OURO_BINLOG_MKDIR(a) mkdir((a), 0755)
+#endif
+
+namespace Ouroboros{
+
+// Position of the record count in a block header(uid, componentType, componentID, globalOrder, groupOrder)
+#define BINLOG_BLOCK_COUNT_OFFSET (sizeof(int32) + sizeof(int32) + sizeof(COMPONENT_ID) + sizeof(COMPONENT_ORDER) * 2)
+
+//-------------------------------------------------------------------------------------
+static void makeDirs(const std::string& path)
+{
+	for(size_t i = 1; i <= path.size(); ++i)
+	{
+		if(i == path.size() || path[i] == '/' || path[i] == '\\')
+			OURO_BINLOG_MKDIR(path.substr(0, i).c_str());
+	}
+}
+
+//-------------------------------------------------------------------------------------
+static bool fileExists(const std::string& path)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if(f == NULL)
+		return false;
+
+	fclose(f);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static bool readFile(FILE* f, long offset, size_t size, MemoryStream& s)
+{
+	s.clear(false);
+
+	if(size == 0)
+		return true;
+
+	if(fseek(f, offset, SEEK_SET) != 0)
+		return false;
+
+	s.data_resize(size);
+	if(fread(s.data(), 1, size, f) != size)
+		return false;
+
+	s.wpos((int)size);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static bool readWholeFile(const std::string& path, MemoryStream& s)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if(f == NULL)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	bool ret = size >= 0 && readFile(f, 0, (size_t)size, s);
+	fclose(f);
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+BinLogStore::BinLogStore():
+path_(),
+segmentSize_(0),
+currSeq_(0),
+segmentOffset_(0),
+pSegmentFile_(NULL),
+pIndexFile_(NULL),
+pFormatsFile_(NULL),
+block_(),
+currBlock_(),
+totalBlocks_(0),
+formats_()
+{
+	memset(&currBlock_, 0, sizeof(currBlock_));
+}
+
+//-------------------------------------------------------------------------------------
+BinLogStore::~BinLogStore()
+{
+	close();
+}
+
+//-------------------------------------------------------------------------------------
+std::string BinLogStore::segmentPath_(uint32 seq, const char* ext) const
+{
+	char name[32];
+	ouro_snprintf(name, sizeof(name), "/%08u.%s", seq, ext);
+	return path_ + name;
+}
+
+//-------------------------------------------------------------------------------------
+bool BinLogStore::open(const std::string& path, uint32 segmentSize)
+{
+	close();
+
+	path_ = path;
+	segmentSize_ = segmentSize;
+	makeDirs(path_);
+
+	if(!loadFormats_())
+		return false;
+
+	pFormatsFile_ = fopen((path_ + "/formats.dat").c_str(), "ab");
+	if(pFormatsFile_ == NULL)
+	{
+		ERROR_MSG(fmt::format("BinLogStore::open: can't open {}/formats.dat!\n", path_));
+		return false;
+	}
+
+	// Old segments are never appended to, continue after the last one
+	uint32 seq = 1;
+	while(fileExists(segmentPath_(seq, "seg")))
+		++seq;
+
+	return openSegment_(seq);
+}
+
+//-------------------------------------------------------------------------------------
+bool BinLogStore::openReadOnly(const std::string& path)
+{
+	close();
+
+	path_ = path;
+	return loadFormats_();
+}
+
+//-------------------------------------------------------------------------------------
+void BinLogStore::close()
+{
+	closeSegment_();
+
+	if(pFormatsFile_)
+	{
+		fclose(pFormatsFile_);
+		pFormatsFile_ = NULL;
+	}
+
+	formats_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void BinLogStore::flush()
+{
+	if(pSegmentFile_)
+		fflush(pSegmentFile_);
+
+	if(pIndexFile_)
+		fflush(pIndexFile_);
+
+	if(pFormatsFile_)
+		fflush(pFormatsFile_);
+}
+
+//-------------------------------------------------------------------------------------
+bool BinLogStore::openSegment_(uint32 seq)
+{
+	closeSegment_();
+
+	pSegmentFile_ = fopen(segmentPath_(seq, "seg").c_str(), "wb");
+	pIndexFile_ = fopen(segmentPath_(seq, "idx").c_str(), "wb");
+
+	if(pSegmentFile_ == NULL || pIndexFile_ == NULL)
+	{
+		ERROR_MSG(fmt::format("BinLogStore::openSegment_: can't create segment {}!\n",
+			segmentPath_(seq, "seg")));
+
+		closeSegment_();
+		return false;
+	}
+
+	currSeq_ = seq;
+	segmentOffset_ = 0;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void BinLogStore::closeSegment_()
+{
+	if(pSegmentFile_)
+	{
+		fclose(pSegmentFile_);
+		pSegmentFile_ = NULL;
+	}
+
+	if(pIndexFile_)
+	{
+		fclose(pIndexFile_);
+		pIndexFile_ = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool BinLogStore::loadFormats_()
+{
+	formats_.clear();
+
+	MemoryStream s;
+	if(!readWholeFile(path_ + "/formats.dat", s))
+		return true;
+
+	try
+	{
+		while(s.length() > 0)
+		{
+			uint32 fmtID;
+			std::string fmt;
+			s >> fmtID >> fmt;
+			formats_[fmtID] = fmt;
+		}
+	}
+	catch(MemoryStreamException &)
+	{
+		// A truncated tail is left by a crash while writing, everything before it is intact
+		WARNING_MSG(fmt::format("BinLogStore::loadFormats_: {}/formats.dat is truncated!\n", path_));
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void BinLogStore::addFormat(uint32 fmtID, const std::string& fmt)
+{
+	std::map<uint32, std::string>::iterator iter = formats_.find(fmtID);
+	if(iter != formats_.end())
+		return;
+
+	formats_[fmtID] = fmt;
+
+	if(pFormatsFile_ == NULL)
+		return;
+
+	MemoryStream s;
+	s << fmtID << fmt;
+	fwrite(s.data(), 1, s.wpos(), pFormatsFile_);
+}
+
+//-------------------------------------------------------------------------------------
+const std::string* BinLogStore::findFormat(uint32 fmtID) const
+{
+	std::map<uint32, std::string>::const_iterator iter = formats_.find(fmtID);
+	if(iter == formats_.end())
+		return NULL;
+
+	return &iter->second;
+}
+
+//-------------------------------------------------------------------------------------
+void BinLogStore::beginBlock(int32 uid, COMPONENT_TYPE componentType, COMPONENT_ID componentID,
+	COMPONENT_ORDER componentGlobalOrder, COMPONENT_ORDER componentGroupOrder)
+{
+	block_.clear(false);
+	block_ << uid << componentType << componentID << componentGlobalOrder << componentGroupOrder;
+
+	// count, filled in by endBlock
+	block_ << (uint32)0;
+
+	currBlock_.beginTime = 0;
+	currBlock_.endTime = 0;
+	currBlock_.componentType = componentType;
+	currBlock_.componentID = componentID;
+	currBlock_.count = 0;
+}
+
+//-------------------------------------------------------------------------------------
+void BinLogStore::appendRecord(int64 t, const uint8* data, size_t size)
+{
+	if(currBlock_.count == 0 || t < currBlock_.beginTime)
+		currBlock_.beginTime = t;
+
+	if(currBlock_.count == 0 || t > currBlock_.endTime)
+		currBlock_.endTime = t;
+
+	++currBlock_.count;
+	block_.append(data, size);
+}
+
+//-------------------------------------------------------------------------------------
+void BinLogStore::endBlock()
+{
+	if(currBlock_.count == 0 || pSegmentFile_ == NULL)
+		return;
+
+	if(segmentOffset_ > 0 && segmentOffset_ + block_.wpos() > segmentSize_)
+	{
+		if(!openSegment_(currSeq_ + 1))
+			return;
+	}
+
+	block_.put(BINLOG_BLOCK_COUNT_OFFSET, currBlock_.count);
+
+	currBlock_.offset = segmentOffset_;
+	currBlock_.length = (uint32)block_.wpos();
+
+	if(fwrite(block_.data(), 1, block_.wpos(), pSegmentFile_) != block_.wpos())
+	{
+		ERROR_MSG(fmt::format("BinLogStore::endBlock: write {} failed!\n", segmentPath_(currSeq_, "seg")));
+		return;
+	}
+
+	segmentOffset_ += currBlock_.length;
+
+	MemoryStream s;
+	s << currBlock_.beginTime << currBlock_.endTime << currBlock_.componentType << currBlock_.componentID
+		<< currBlock_.offset << currBlock_.length << currBlock_.count;
+
+	fwrite(s.data(), 1, s.wpos(), pIndexFile_);
+	++totalBlocks_;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 BinLogStore::query(const BinLogQuery& q, Visitor& visitor)
+{
+	uint32 found = 0;
+
+	for(uint32 seq = 1; fileExists(segmentPath_(seq, "idx")); ++seq)
+	{
+		if(!querySegment_(seq, q, visitor, found))
+			break;
+	}
+
+	return found;
+}
+
+//-------------------------------------------------------------------------------------
+bool BinLogStore::querySegment_(uint32 seq, const BinLogQuery& q, Visitor& visitor, uint32& found)
+{
+	MemoryStream index;
+	if(!readWholeFile(segmentPath_(seq, "idx"), index))
+		return true;
+
+	FILE* f = fopen(segmentPath_(seq, "seg").c_str(), "rb");
+	if(f == NULL)
+		return true;
+
+	MemoryStream block;
+	BinLogRecord record;
+	bool ret = true;
+
+	while(ret && index.length() >= BINLOG_INDEX_ENTRY_SIZE)
+	{
+		BinLogIndexEntry entry;
+		index >> entry.beginTime >> entry.endTime >> entry.componentType >> entry.componentID
+			>> entry.offset >> entry.length >> entry.count;
+
+		// The index lets us skip whole blocks by time and component without touching the segment
+		if(q.beginTime > 0 && entry.endTime < q.beginTime)
+			continue;
+
+		if(q.endTime > 0 && entry.beginTime > q.endTime)
+			continue;
+
+		if(q.componentType != UNKNOWN_COMPONENT_TYPE && entry.componentType != q.componentType)
+			continue;
+
+		if(q.componentID > 0 && entry.componentID != q.componentID)
+			continue;
+
+		if(!readFile(f, (long)entry.offset, entry.length, block))
+			break;
+
+		try
+		{
+			uint32 count;
+			block >> record.uid >> record.componentType >> record.componentID
+				>> record.componentGlobalOrder >> record.componentGroupOrder >> count;
+
+			if(q.uid > 0 && record.uid != q.uid)
+				continue;
+
+			for(uint32 i = 0; i < count; ++i)
+			{
+				uint8 argc;
+				block >> record.logtype >> record.t >> record.fmtID >> argc;
+
+				if(!BinLog::readArgs(block, argc, record.args))
+					break;
+
+				if((q.beginTime > 0 && record.t < q.beginTime) || (q.endTime > 0 && record.t > q.endTime))
+					continue;
+
+				if(q.logtypes > 0 && (q.logtypes & record.logtype) == 0)
+					continue;
+
+				std::string text = renderLine(record);
+				if(q.keyStr.size() > 0 && text.find(q.keyStr) == std::string::npos)
+					continue;
+
+				++found;
+
+				if(!visitor.onLog(record, text))
+				{
+					ret = false;
+					break;
+				}
+			}
+		}
+		catch(MemoryStreamException &)
+		{
+			WARNING_MSG(fmt::format("BinLogStore::query: block(offset={}) of {} is corrupted!\n",
+				entry.offset, segmentPath_(seq, "seg")));
+		}
+	}
+
+	fclose(f);
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+std::string BinLogStore::renderMessage(const BinLogRecord& record) const
+{
+	const std::string* pFmt = findFormat(record.fmtID);
+	if(pFmt == NULL)
+		return fmt::format("<unknown format {}>\n", record.fmtID);
+
+	return BinLog::render(*pFmt, record.args);
+}
+
+//-------------------------------------------------------------------------------------
+std::string BinLogStore::renderLine(const BinLogRecord& record) const
+{
+	time_t tt = static_cast<time_t>(record.t / 1000);
+	tm* aTm = localtime(&tt);
+
+	char timebuf[MAX_BUF];
+
+	if(aTm == NULL)
+	{
+		timebuf[0] = '\0';
+	}
+	else
+	{
+		ouro_snprintf(timebuf, MAX_BUF, " [%-4d-%02d-%02d %02d:%02d:%02d %03d] ", aTm->tm_year+1900, aTm->tm_mon+1,
+			aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec, (int)(record.t % 1000));
+	}
+
+	return fmt::format("{} {}{:02} {} {} {}- {}", OUROLOG_TYPE_NAME_EX(record.logtype),
+		COMPONENT_NAME_EX_2(record.componentType), (int)record.componentGroupOrder, record.uid,
+		record.componentID, timebuf, renderMessage(record));
+}
+
+//-------------------------------------------------------------------------------------
+}
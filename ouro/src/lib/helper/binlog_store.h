@@ -0,0 +1,148 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_BINLOG_STORE_H
+#define OURO_BINLOG_STORE_H
+
+#include "common/common.h"
+#include "common/memorystream.h"
+#include "helper/binlog.h"
+
+namespace Ouroboros{
+
+/*
+	Append-only, segmented on-disk store for binlog records.
+
+	<path>/formats.dat			every format string ever seen, [uint32 fmtID][string fmt]...
+	<path>/NNNNNNNN.seg			blocks of records, one block per writeBinLogs batch
+	<path>/NNNNNNNN.idx			one fixed size BinLogIndexEntry per block of the segment
+
+	A block starts with the component header of the batch (uid, type, id, globalOrder, groupOrder, count)
+	followed by the records exactly as they were received (logtype, time, fmtID, argc, args).
+	The index entry of a block is only written after the block itself, so an index never points
+	at a partially written block.
+*/
+struct BinLogIndexEntry
+{
+	int64 beginTime;
+	int64 endTime;
+	COMPONENT_TYPE componentType;
+	COMPONENT_ID componentID;
+	uint32 offset;
+	uint32 length;
+	uint32 count;
+};
+
+#define BINLOG_INDEX_ENTRY_SIZE (8 + 8 + 4 + 8 + 4 + 4 + 4)
+
+/*
+	Query filter, a value of 0 means any
+*/
+struct BinLogQuery
+{
+	BinLogQuery():
+	beginTime(0),
+	endTime(0),
+	componentType(UNKNOWN_COMPONENT_TYPE),
+	componentID(0),
+	uid(0),
+	logtypes(0),
+	keyStr()
+	{
+	}
+
+	int64 beginTime;
+	int64 endTime;
+	COMPONENT_TYPE componentType;
+	COMPONENT_ID componentID;
+	int32 uid;
+	uint32 logtypes;
+	std::string keyStr;
+};
+
+class BinLogStore
+{
+public:
+	class Visitor
+	{
+	public:
+		virtual ~Visitor() {}
+
+		/**
+			Return false to stop the query
+		*/
+		virtual bool onLog(const BinLogRecord& record, const std::string& text) = 0;
+	};
+
+	BinLogStore();
+	~BinLogStore();
+
+	/**
+		Open the store for writing, a new segment is always started
+	*/
+	bool open(const std::string& path, uint32 segmentSize);
+
+	/**
+		Open the store for queries only
+	*/
+	bool openReadOnly(const std::string& path);
+
+	void close();
+	void flush();
+
+	bool isOpen() const { return pSegmentFile_ != NULL; }
+
+	void addFormat(uint32 fmtID, const std::string& fmt);
+	const std::string* findFormat(uint32 fmtID) const;
+
+	void beginBlock(int32 uid, COMPONENT_TYPE componentType, COMPONENT_ID componentID,
+		COMPONENT_ORDER componentGlobalOrder, COMPONENT_ORDER componentGroupOrder);
+
+	/**
+		Append one record(logtype, time, fmtID, argc, args) to the current block
+	*/
+	void appendRecord(int64 t, const uint8* data, size_t size);
+
+	void endBlock();
+
+	uint32 query(const BinLogQuery& q, Visitor& visitor);
+
+	/**
+		Render the message text of a record
+	*/
+	std::string renderMessage(const BinLogRecord& record) const;
+
+	/**
+		Render a record as a complete log line, identical to the text logs written by the logger
+	*/
+	std::string renderLine(const BinLogRecord& record) const;
+
+	uint32 currSegment() const { return currSeq_; }
+	uint64 totalBlocks() const { return totalBlocks_; }
+
+private:
+	std::string segmentPath_(uint32 seq, const char* ext) const;
+	bool openSegment_(uint32 seq);
+	void closeSegment_();
+	bool loadFormats_();
+	bool querySegment_(uint32 seq, const BinLogQuery& q, Visitor& visitor, uint32& found);
+
+private:
+	std::string path_;
+	uint32 segmentSize_;
+	uint32 currSeq_;
+	uint32 segmentOffset_;
+
+	FILE* pSegmentFile_;
+	FILE* pIndexFile_;
+	FILE* pFormatsFile_;
+
+	MemoryStream block_;
+	BinLogIndexEntry currBlock_;
+	uint64 totalBlocks_;
+
+	std::map<uint32, std::string> formats_;
+};
+
+}
+
+#endif // OURO_BINLOG_STORE_H
@@ -2,6 +2,7 @@
 
 
 #include "debug_helper.h"
+#include "async_log.h"
 #include "profile.h"
 #include "common/common.h"
 #include "common/timer.h"
@@ -124,6 +125,7 @@ void myassert(const char * exp, const char * func, const char * file, unsigned i
 	printf("%s%02d: %s", COMPONENT_NAME_EX_2(g_componentType), g_componentGroupOrder, (std::string("[ASSERT]: ") + s).c_str());
 
 	dbghelper.print_msg(s);
+	dbghelper.flushAsyncLog();
     abort();
 }
 #endif
@@ -220,6 +222,47 @@ private:
 
 DebugHelperSyncHandler* g_pDebugHelperSyncHandler = NULL;
 
+//-------------------------------------------------------------------------------------
+// Binlog batch of a child thread. The thread hands it to the main thread once it is full,
+// the main thread takes it once it is older than BINLOG_THREAD_BATCH_TIMEOUT(see collectThreadBinLogBatches).
+// Only the owning thread and the collecting main thread take its mutex, never for long.
+struct BinLogThreadBatch
+{
+	BinLogThreadBatch():
+	mutex(),
+	registered(false),
+	pBatch(NULL),
+	startTime(0),
+	formats()
+	{
+	}
+
+	~BinLogThreadBatch()
+	{
+		DebugHelper* pDebugHelper = DebugHelper::getSingletonPtr();
+		if(pDebugHelper)
+		{
+			if(registered)
+				pDebugHelper->unregisterThreadBinLogBatch(this);
+		}
+		else
+		{
+			delete pBatch;
+		}
+	}
+
+	Ouroboros::thread::ThreadMutex mutex;
+	bool registered;
+
+	MemoryStream* pBatch;
+	uint64 startTime;
+
+	// Every batch carries the formats of its own records, binlogSentFormats_ belongs to the main thread
+	std::set<uint32> formats;
+};
+
+static thread_local BinLogThreadBatch g_binlogThreadBatch;
+
 //-------------------------------------------------------------------------------------
 DebugHelper::DebugHelper() :
 _logfile(NULL),
@@ -242,7 +285,16 @@ mainThreadID_(GetCurrentThreadId()),
 #else
 mainThreadID_(pthread_self()),
 #endif
-memoryStreamPool_("DebugHelperMemoryStream")
+memoryStreamPool_("DebugHelperMemoryStream"),
+childThreadBufferedLogPackets_(),
+bufferedBinLogBatches_(),
+pBinLogBatch_(NULL),
+binlogMutex_(),
+childThreadBinLogBatches_(),
+threadBinLogBatches_(),
+binlogSentFormats_(),
+binlogFormats_(),
+pAsyncLogger_(NULL)
 {
 	g_pDebugHelperSyncHandler = new DebugHelperSyncHandler();
 	loseLoggerTime_ = timestamp();
@@ -252,6 +304,7 @@ memoryStreamPool_("DebugHelperMemoryStream")
 DebugHelper::~DebugHelper()
 {
 	finalise(true);
+	SAFE_RELEASE(pAsyncLogger_);
 }	
 
 //-------------------------------------------------------------------------------------
@@ -347,11 +400,20 @@ void DebugHelper::initialize(COMPONENT_TYPE componentType)
 #endif
 
 	ALERT_LOG_TO("", false);
+
+	if(componentType != CLIENT_TYPE && componentType != CONSOLE_TYPE && g_ouroSrvConfig.asyncLogEnable())
+	{
+		DebugHelper::getSingleton().startAsyncLog(g_ouroSrvConfig.asyncLogRingSize(), 
+			g_ouroSrvConfig.asyncLogOverflowPolicy(), g_ouroSrvConfig.asyncLogBlockTimeout());
+	}
 }
 
 //-------------------------------------------------------------------------------------
 void DebugHelper::finalise(bool destroy)
 {
+	// Everything still queued has to reach the buffered logs before they are synced
+	DebugHelper::getSingleton().stopAsyncLog();
+
 	if(!destroy)
 	{
 		while(DebugHelper::getSingleton().hasBufferedLogPackets() > 0)
@@ -393,6 +455,8 @@ Network::Channel* DebugHelper::pLoggerChannel()
 //-------------------------------------------------------------------------------------
 void DebugHelper::clearBufferedLog(bool destroy)
 {
+	collectThreadBinLogBatches(true);
+
 	int8 v = Network::g_trace_packet;
 	Network::g_trace_packet = 0;
 
@@ -411,13 +475,32 @@ void DebugHelper::clearBufferedLog(bool destroy)
 			childThreadBufferedLogPackets_.pop();
 			delete pMemoryStream;
 		}
+
+		while (!bufferedBinLogBatches_.empty())
+		{
+			MemoryStream* pMemoryStream = bufferedBinLogBatches_.front();
+			bufferedBinLogBatches_.pop();
+			delete pMemoryStream;
+		}
+
+		SAFE_RELEASE(pBinLogBatch_);
 	}
 	else
 	{
 		Network::Bundle::ObjPool().reclaimObject(bufferedLogPackets_);
 		memoryStreamPool_.reclaimObject(childThreadBufferedLogPackets_);
+		memoryStreamPool_.reclaimObject(bufferedBinLogBatches_);
+
+		if (pBinLogBatch_)
+		{
+			memoryStreamPool_.reclaimObject(pBinLogBatch_);
+			pBinLogBatch_ = NULL;
+		}
 	}
 
+	// Formats carried by discarded batches must be sent again
+	binlogSentFormats_.clear();
+
 	Network::g_trace_packet = v;
 
 	hasBufferedLogPackets_ = 0;
@@ -432,6 +515,7 @@ void DebugHelper::clearBufferedLog(bool destroy)
 void DebugHelper::sync()
 {
 	lockthread();
+	collectThreadBinLogBatches();
 
 	if(hasBufferedLogPackets_ == 0)
 	{
@@ -461,6 +545,31 @@ void DebugHelper::sync()
 		memoryStreamPool_.reclaimObject(pMemoryStream);
 	}
 
+	// Put the binlog batches into bufferedLogPackets_, each batch becomes one writeBinLogs message
+	if (pBinLogBatch_)
+	{
+		bufferedBinLogBatches_.push(pBinLogBatch_);
+		pBinLogBatch_ = NULL;
+	}
+
+	while (bufferedBinLogBatches_.size() > 0)
+	{
+		MemoryStream* pMemoryStream = bufferedBinLogBatches_.front();
+		bufferedBinLogBatches_.pop();
+
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		bufferedLogPackets_.push(pBundle);
+
+		pBundle->newMessage(LoggerInterface::writeBinLogs);
+		pBundle->finiCurrPacket();
+		pBundle->newPacket();
+
+		pBundle->pCurrPacket()->swap(*pMemoryStream);
+		pBundle->currMsgLength(pBundle->currMsgLength() + pBundle->pCurrPacket()->length());
+
+		memoryStreamPool_.reclaimObject(pMemoryStream);
+	}
+
 	if (Network::Address::NONE == loggerAddr_)
 	{
 		// Force the memory to be cleaned if the logger is not found for more than 300 seconds
@@ -605,6 +714,17 @@ void DebugHelper::onMessage(uint32 logType, const char * str, uint32 length)
 		g_componentType == CLIENT_TYPE)
 		return;
 
+	// Text logs join the binlog batches, the logger stores them along with the structured records
+	if (binlogEnabled())
+	{
+		static const uint32 textFmtID = BinLog::formatID(BINLOG_TEXT_FORMAT);
+
+		MemoryStream* pStream = beginBinLogRecord(logType, textFmtID, BINLOG_TEXT_FORMAT, 1);
+		BinLog::writeStringArg(*pStream, str, length);
+		endBinLogRecord(pStream);
+		return;
+	}
+
 	if (!isMainThread)
 	{
 		MemoryStream* pMemoryStream = memoryStreamPool_.createObject(OBJECTPOOL_POINT);
@@ -681,9 +801,279 @@ void DebugHelper::onMessage(uint32 logType, const char * str, uint32 length)
 	++hasBufferedLogPackets_;
 }
 
+//-------------------------------------------------------------------------------------
+bool DebugHelper::binlogEnabled() const
+{
+	// Before the first sync to logger the logs are still written locally as text
+	if(!g_ouroSrvConfig.binlogEnable() || canLogFile_ || noSyncLog_)
+		return false;
+
+	return g_componentType != MACHINE_TYPE && 
+		g_componentType != CONSOLE_TYPE && 
+		g_componentType != LOGGER_TYPE && 
+		g_componentType != CLIENT_TYPE;
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::binlog_text_msg(uint32 logType, const std::string& s)
+{
+	switch(logType)
+	{
+	case OUROLOG_DEBUG:
+		debug_msg(s);
+		break;
+	case OUROLOG_INFO:
+		info_msg(s);
+		break;
+	case OUROLOG_WARNING:
+		warning_msg(s);
+		break;
+	default:
+		print_msg(s);
+		break;
+	};
+}
+
+//-------------------------------------------------------------------------------------
+static void writeBinLogBatchHeader(MemoryStream& s)
+{
+	s << getUserUID();
+	s << g_componentType;
+	s << g_componentID;
+	s << g_componentGlobalOrder;
+	s << g_componentGroupOrder;
+}
+
+//-------------------------------------------------------------------------------------
+static void writeBinLogFormat(MemoryStream& s, uint32 fmtID, const char* fmtstr)
+{
+	s << (uint8)BINLOG_ENTRY_FORMAT;
+	s << fmtID;
+	s << fmtstr;
+}
+
+//-------------------------------------------------------------------------------------
+MemoryStream* DebugHelper::beginBinLogRecord(uint32 logType, uint32 fmtID, const char* fmtstr, uint8 argc)
+{
+	MemoryStream* pBatch = NULL;
+
+	if(isMainThread())
+	{
+		if(pBinLogBatch_ == NULL)
+		{
+			pBinLogBatch_ = memoryStreamPool_.createObject(OBJECTPOOL_POINT);
+			writeBinLogBatchHeader(*pBinLogBatch_);
+
+			++hasBufferedLogPackets_;
+			g_pDebugHelperSyncHandler->startActiveTick();
+		}
+
+		pBatch = pBinLogBatch_;
+
+		// The format string travels with the first record that uses it
+		if(binlogSentFormats_.insert(std::make_pair(fmtID, true)).second)
+		{
+			binlogFormats_[fmtID] = fmtstr;
+			writeBinLogFormat(*pBatch, fmtID, fmtstr);
+		}
+	}
+	else
+	{
+		BinLogThreadBatch& threadBatch = g_binlogThreadBatch;
+
+		if(!threadBatch.registered)
+		{
+			binlogMutex_.lockMutex();
+			threadBinLogBatches_.push_back(&threadBatch);
+			binlogMutex_.unlockMutex();
+
+			threadBatch.registered = true;
+		}
+
+		// Held until endBinLogRecord, the main thread may take the batch meanwhile otherwise
+		threadBatch.mutex.lockMutex();
+
+		if(threadBatch.pBatch == NULL)
+		{
+			// memoryStreamPool_ is not thread safe, the main thread reclaims the batch into it after sync
+			threadBatch.pBatch = new MemoryStream();
+			threadBatch.startTime = timestamp();
+			threadBatch.formats.clear();
+			writeBinLogBatchHeader(*threadBatch.pBatch);
+		}
+
+		pBatch = threadBatch.pBatch;
+
+		if(threadBatch.formats.insert(fmtID).second)
+			writeBinLogFormat(*pBatch, fmtID, fmtstr);
+	}
+
+	struct timeb tp;
+	ftime(&tp);
+
+	(*pBatch) << (uint8)BINLOG_ENTRY_RECORD;
+	(*pBatch) << logType;
+	(*pBatch) << (int64)tp.time * 1000 + tp.millitm;
+	(*pBatch) << fmtID;
+	(*pBatch) << argc;
+	return pBatch;
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::endBinLogRecord(MemoryStream* pBatch)
+{
+	if(isMainThread())
+	{
+		// Keep every batch within a single message
+		if(pBatch->wpos() >= BINLOG_MAX_BATCH_SIZE)
+		{
+			bufferedBinLogBatches_.push(pBatch);
+			pBinLogBatch_ = NULL;
+		}
+
+		return;
+	}
+
+	BinLogThreadBatch& threadBatch = g_binlogThreadBatch;
+
+	if(pBatch->wpos() < BINLOG_MAX_BATCH_SIZE)
+	{
+		threadBatch.mutex.unlockMutex();
+		return;
+	}
+
+	threadBatch.pBatch = NULL;
+	threadBatch.mutex.unlockMutex();
+
+	// Not under the batch mutex, collectThreadBinLogBatches takes binlogMutex_ first
+	binlogMutex_.lockMutex();
+	childThreadBinLogBatches_.push(pBatch);
+	binlogMutex_.unlockMutex();
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::unregisterThreadBinLogBatch(BinLogThreadBatch* pThreadBatch)
+{
+	binlogMutex_.lockMutex();
+
+	std::vector<BinLogThreadBatch*>::iterator iter = 
+		std::find(threadBinLogBatches_.begin(), threadBinLogBatches_.end(), pThreadBatch);
+
+	if(iter != threadBinLogBatches_.end())
+		threadBinLogBatches_.erase(iter);
+
+	// No longer registered, the main thread does not touch it anymore
+	if(pThreadBatch->pBatch)
+	{
+		childThreadBinLogBatches_.push(pThreadBatch->pBatch);
+		pThreadBatch->pBatch = NULL;
+	}
+
+	binlogMutex_.unlockMutex();
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::collectThreadBinLogBatches(bool all)
+{
+	// logMutex is held by the caller, the lock order is always logMutex, binlogMutex_, then the batch mutex
+	binlogMutex_.lockMutex();
+
+	while(!childThreadBinLogBatches_.empty())
+	{
+		bufferedBinLogBatches_.push(childThreadBinLogBatches_.front());
+		childThreadBinLogBatches_.pop();
+		++hasBufferedLogPackets_;
+	}
+
+	// Batches of threads that stopped logging, e.g. an idle worker or the async log flush thread
+	uint64 now = timestamp();
+	uint64 timeout = stampsPerSecond() * BINLOG_THREAD_BATCH_TIMEOUT / 1000;
+
+	std::vector<BinLogThreadBatch*>::iterator iter = threadBinLogBatches_.begin();
+	for(; iter != threadBinLogBatches_.end(); ++iter)
+	{
+		BinLogThreadBatch* pThreadBatch = (*iter);
+		pThreadBatch->mutex.lockMutex();
+
+		if(pThreadBatch->pBatch && (all || now - pThreadBatch->startTime >= timeout))
+		{
+			bufferedBinLogBatches_.push(pThreadBatch->pBatch);
+			pThreadBatch->pBatch = NULL;
+			++hasBufferedLogPackets_;
+		}
+
+		pThreadBatch->mutex.unlockMutex();
+	}
+
+	binlogMutex_.unlockMutex();
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::printBinLogBatch(MemoryStream& s)
+{
+	BinLogRecord record;
+
+	try
+	{
+		s >> record.uid;
+		s >> record.componentType;
+		s >> record.componentID;
+		s >> record.componentGlobalOrder;
+		s >> record.componentGroupOrder;
+
+		while(s.length() > 0)
+		{
+			uint8 entryType;
+			s >> entryType;
+
+			if(entryType == BINLOG_ENTRY_FORMAT)
+			{
+				// Batches of child threads carry formats the main thread has never seen
+				std::string fmtstr;
+				s >> record.fmtID >> fmtstr;
+				binlogFormats_[record.fmtID] = fmtstr;
+				continue;
+			}
+
+			uint8 argc;
+			s >> record.logtype >> record.t >> record.fmtID >> argc;
+
+			if(!BinLog::readArgs(s, argc, record.args))
+				break;
+
+			OUROUnordered_map< uint32, std::string >::iterator iter = binlogFormats_.find(record.fmtID);
+			if(iter == binlogFormats_.end())
+				continue;
+
+			std::string logstr = fmt::format("==>{}", BinLog::render(iter->second, record.args));
+
+#ifdef NO_USE_LOG4CXX
+#else
+			if(record.logtype == OUROLOG_ERROR || record.logtype == OUROLOG_CRITICAL)
+				OURO_LOG4CXX_ERROR(g_logger, logstr)
+			else if(record.logtype == OUROLOG_WARNING)
+				OURO_LOG4CXX_WARN(g_logger, logstr)
+			else if(record.logtype == OUROLOG_DEBUG)
+				OURO_LOG4CXX_DEBUG(g_logger, logstr)
+			else
+				OURO_LOG4CXX_INFO(g_logger, logstr)
+#endif
+		}
+	}
+	catch(MemoryStreamException &)
+	{
+	}
+
+	s.done();
+}
+
 //-------------------------------------------------------------------------------------
 void DebugHelper::registerLogger(Network::MessageID msgID, Network::Address* pAddr)
 {
+	lockthread();
+	binlogSentFormats_.clear();
+	unlockthread();
+
 	loggerAddr_ = *pAddr;
 	ALERT_LOG_TO("logger_", true);
 }
@@ -707,6 +1097,7 @@ void DebugHelper::DebugHelper::onNoLogger()
 void DebugHelper::printBufferedLogs()
 {
 	lockthread();
+	collectThreadBinLogBatches(true);
 
 	if(hasBufferedLogPackets_ == 0)
 	{
@@ -741,6 +1132,23 @@ void DebugHelper::printBufferedLogs()
 		memoryStreamPool_.reclaimObject(pMemoryStream);
 	}
 
+	if (pBinLogBatch_)
+	{
+		bufferedBinLogBatches_.push(pBinLogBatch_);
+		pBinLogBatch_ = NULL;
+	}
+
+	while (!bufferedBinLogBatches_.empty())
+	{
+		MemoryStream* pMemoryStream = bufferedBinLogBatches_.front();
+		bufferedBinLogBatches_.pop();
+
+		printBinLogBatch(*pMemoryStream);
+
+		--hasBufferedLogPackets_;
+		memoryStreamPool_.reclaimObject(pMemoryStream);
+	}
+
 	while(!bufferedLogPackets_.empty())
 	{		
 		Network::Bundle* pBundle = bufferedLogPackets_.front();
@@ -769,6 +1177,17 @@ void DebugHelper::printBufferedLogs()
 		if (msglen == 65535)
 			(*pBundle) >> msglen1;
 
+		if (msgID == LoggerInterface::writeBinLogs.msgID)
+		{
+			Network::Packet* pPacket = pBundle->pCurrPacket();
+			if (pPacket)
+				printBinLogBatch(*pPacket);
+
+			--hasBufferedLogPackets_;
+			Network::Bundle::ObjPool().reclaimObject(pBundle);
+			continue;
+		}
+
 		(*pBundle) >> uid;
 		(*pBundle) >> logtype;
 		(*pBundle) >> componentType;
@@ -855,9 +1274,102 @@ void DebugHelper::printBufferedLogs()
 	unlockthread();
 }
 
+//-------------------------------------------------------------------------------------
+bool DebugHelper::isMainThread() const
+{
+#if OURO_PLATFORM == PLATFORM_WIN32
+	return mainThreadID_ == GetCurrentThreadId();
+#else
+	return mainThreadID_ == pthread_self();
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+bool DebugHelper::startAsyncLog(uint32 ringSize, uint8 overflowPolicy, uint32 blockTimeout)
+{
+	if(pAsyncLogger_ == NULL)
+	{
+		pAsyncLogger_ = new AsyncLogger(&DebugHelper::onAsyncLog, ringSize, 
+			(AsyncLogger::OVERFLOW_POLICY)overflowPolicy, blockTimeout);
+	}
+
+	if(!pAsyncLogger_->start())
+	{
+		ERROR_MSG("DebugHelper::startAsyncLog: failed to create the flush thread, logs are written synchronously!\n");
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::stopAsyncLog()
+{
+	if(pAsyncLogger_)
+		pAsyncLogger_->stop();
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::flushAsyncLog()
+{
+	if(pAsyncLogger_)
+		pAsyncLogger_->flush(1000);
+}
+
+//-------------------------------------------------------------------------------------
+uint64 DebugHelper::asyncLogDropped() const
+{
+	return pAsyncLogger_ ? pAsyncLogger_->droppedLogs() : 0;
+}
+
+//-------------------------------------------------------------------------------------
+bool DebugHelper::pushAsyncLog(uint32 logType, const std::string& s)
+{
+	// Only a copy into the ring of the calling thread, no lock, no allocation after the first log of a thread
+	if(pAsyncLogger_ == NULL || !pAsyncLogger_->isRunning())
+		return false;
+
+	return pAsyncLogger_->push(logType, scriptMsgType_, s, isMainThread());
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::onAsyncLog(uint32 logType, int32 scriptMsgType, const std::string& s)
+{
+	// Flush thread, pushAsyncLog refuses this thread so every call below writes synchronously
+	DebugHelper& dbg = DebugHelper::getSingleton();
+
+	switch(logType)
+	{
+	case OUROLOG_PRINT:
+		dbg.print_msg(s);
+		break;
+	case OUROLOG_ERROR:
+		dbg.error_msg(s);
+		break;
+	case OUROLOG_WARNING:
+		dbg.warning_msg(s);
+		break;
+	case OUROLOG_DEBUG:
+		dbg.debug_msg(s);
+		break;
+	case OUROLOG_INFO:
+		dbg.info_msg(s);
+		break;
+	case OUROLOG_SCRIPT_ERROR:
+		dbg.script_msg(log4cxx::ScriptLevel::SCRIPT_ERR, s);
+		break;
+	default:
+		dbg.script_msg(scriptMsgType, s);
+		break;
+	};
+}
+
 //-------------------------------------------------------------------------------------
 void DebugHelper::print_msg(const std::string& s)
 {
+	if(pushAsyncLog(OUROLOG_PRINT, s))
+		return;
+
 	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
 
 #ifdef NO_USE_LOG4CXX
@@ -872,6 +1384,9 @@ void DebugHelper::print_msg(const std::string& s)
 //-------------------------------------------------------------------------------------
 void DebugHelper::error_msg(const std::string& s)
 {
+	if(pushAsyncLog(OUROLOG_ERROR, s))
+		return;
+
 	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
 
 #ifdef NO_USE_LOG4CXX
@@ -889,6 +1404,9 @@ void DebugHelper::error_msg(const std::string& s)
 //-------------------------------------------------------------------------------------
 void DebugHelper::info_msg(const std::string& s)
 {
+	if(pushAsyncLog(OUROLOG_INFO, s))
+		return;
+
 	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
 
 #ifdef NO_USE_LOG4CXX
@@ -926,19 +1444,29 @@ int OUROLOG_TYPE_MAPPING(int type)
 
 //-------------------------------------------------------------------------------------
 void DebugHelper::script_info_msg(const std::string& s)
+{
+	// The script message type is captured with the log, it changes before the flush thread writes it
+	if(pushAsyncLog(OUROLOG_SCRIPT_INFO, s))
+		return;
+
+	script_msg(scriptMsgType_, s);
+}
+
+//-------------------------------------------------------------------------------------
+void DebugHelper::script_msg(int scriptMsgType, const std::string& s)
 {
 	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
 
 #ifdef NO_USE_LOG4CXX
 #else
 	if(canLogFile_)
-		OURO_LOG4CXX_LOG(g_logger,  log4cxx::ScriptLevel::toLevel(scriptMsgType_), s);
+		OURO_LOG4CXX_LOG(g_logger,  log4cxx::ScriptLevel::toLevel(scriptMsgType), s);
 #endif
 
-	onMessage(OUROLOG_TYPE_MAPPING(scriptMsgType_), s.c_str(), (uint32)s.size());
+	onMessage(OUROLOG_TYPE_MAPPING(scriptMsgType), s.c_str(), (uint32)s.size());
 
 	// If the user manually set the output is also an error message
-	if(log4cxx::ScriptLevel::SCRIPT_ERR == scriptMsgType_)
+	if(log4cxx::ScriptLevel::SCRIPT_ERR == scriptMsgType)
 	{
 		set_errorcolor();
 		printf("%s%02d: [S_ERROR]: %s", COMPONENT_NAME_EX_2(g_componentType), g_componentGroupOrder, s.c_str());
@@ -949,14 +1477,17 @@ void DebugHelper::script_info_msg(const std::string& s)
 //-------------------------------------------------------------------------------------
 void DebugHelper::script_error_msg(const std::string& s)
 {
-	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
-
 	setScriptMsgType(log4cxx::ScriptLevel::SCRIPT_ERR);
 
+	if(pushAsyncLog(OUROLOG_SCRIPT_ERROR, s))
+		return;
+
+	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
+
 #ifdef NO_USE_LOG4CXX
 #else
 	if(canLogFile_)
-		OURO_LOG4CXX_LOG(g_logger,  log4cxx::ScriptLevel::toLevel(scriptMsgType_), s);
+		OURO_LOG4CXX_LOG(g_logger,  log4cxx::ScriptLevel::toLevel(log4cxx::ScriptLevel::SCRIPT_ERR), s);
 #endif
 
 	onMessage(OUROLOG_SCRIPT_ERROR, s.c_str(), (uint32)s.size());
@@ -981,6 +1512,9 @@ void DebugHelper::resetScriptMsgType()
 //-------------------------------------------------------------------------------------
 void DebugHelper::debug_msg(const std::string& s)
 {
+	if(pushAsyncLog(OUROLOG_DEBUG, s))
+		return;
+
 	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
 
 #ifdef NO_USE_LOG4CXX
@@ -995,6 +1529,9 @@ void DebugHelper::debug_msg(const std::string& s)
 //-------------------------------------------------------------------------------------
 void DebugHelper::warning_msg(const std::string& s)
 {
+	if(pushAsyncLog(OUROLOG_WARNING, s))
+		return;
+
 	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
 
 #ifdef NO_USE_LOG4CXX
@@ -1015,6 +1552,9 @@ void DebugHelper::warning_msg(const std::string& s)
 //-------------------------------------------------------------------------------------
 void DebugHelper::critical_msg(const std::string& s)
 {
+	// Crash path, everything logged before must be written first and this one is written synchronously
+	flushAsyncLog();
+
 	Ouroboros::thread::ThreadGuard tg(&this->logMutex); 
 
 	char buf[DBG_PT_SIZE];
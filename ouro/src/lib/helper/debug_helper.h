@@ -12,6 +12,7 @@
 #include "thread/threadmutex.h"
 #include "network/common.h"
 #include "network/address.h"
+#include "helper/binlog.h"
 
 namespace Ouroboros{
 
@@ -23,6 +24,9 @@ namespace Network{
 	class Packet;
 }
 
+class AsyncLogger;
+struct BinLogThreadBatch;
+
 /** 
 	Support uft-8 encoded string output
 */
@@ -139,6 +143,45 @@ public:
 	void script_error_msg(const std::string& s);
 	void backtrace_msg();
 
+	/** 
+		Binary structured log, only the format ID and the arguments are sent to logger.
+		Falls back to a formatted text log while binlog is disabled or no logger is connected.
+		No shared lock is taken, a child thread fills a batch of its own(see beginBinLogRecord).
+	*/
+	template<typename... Args>
+	void binlog_msg(uint32 logType, uint32 fmtID, const char* fmtstr, const Args&... args)
+	{
+		if(!binlogEnabled())
+		{
+			binlog_text_msg(logType, fmt::format(fmtstr, args...));
+			return;
+		}
+
+		MemoryStream* pStream = beginBinLogRecord(logType, fmtID, fmtstr, (uint8)sizeof...(args));
+		BinLog::writeArgs(*pStream, args...);
+		endBinLogRecord(pStream);
+	}
+
+	bool binlogEnabled() const;
+
+	/** 
+		A child thread exits, its binlog batch is handed over to the main thread
+	*/
+	void unregisterThreadBinLogBatch(BinLogThreadBatch* pThreadBatch);
+
+	/** 
+		Asynchronous logging, see async_log.h
+	*/
+	bool startAsyncLog(uint32 ringSize, uint8 overflowPolicy, uint32 blockTimeout);
+	void stopAsyncLog();
+
+	/** 
+		Wait until every log queued so far has been written, used before crashing
+	*/
+	void flushAsyncLog();
+
+	uint64 asyncLogDropped() const;
+
 	void onMessage(uint32 logType, const char * str, uint32 length);
 
 	void registerLogger(Network::MessageID msgID, Network::Address* pAddr);
@@ -171,6 +214,18 @@ public:
 
 	Network::Channel* pLoggerChannel();
 
+private:
+	void binlog_text_msg(uint32 logType, const std::string& s);
+	MemoryStream* beginBinLogRecord(uint32 logType, uint32 fmtID, const char* fmtstr, uint8 argc);
+	void endBinLogRecord(MemoryStream* pBatch);
+	void collectThreadBinLogBatches(bool all = false);
+	void printBinLogBatch(MemoryStream& s);
+
+	bool isMainThread() const;
+	bool pushAsyncLog(uint32 logType, const std::string& s);
+	static void onAsyncLog(uint32 logType, int32 scriptMsgType, const std::string& s);
+	void script_msg(int scriptMsgType, const std::string& s);
+
 private:
 	FILE* _logfile;
 	std::string _currFile, _currFuncName;
@@ -203,6 +258,23 @@ private:
 
 	ObjectPool<MemoryStream> memoryStreamPool_;
 	std::queue< MemoryStream* > childThreadBufferedLogPackets_;
+
+	// Binlog batches waiting for sync, the last one is still being filled
+	std::queue< MemoryStream* > bufferedBinLogBatches_;
+	MemoryStream* pBinLogBatch_;
+
+	// Batches handed over by child threads, only binlogMutex_ guards them so that logMutex is never taken per record
+	Ouroboros::thread::ThreadMutex binlogMutex_;
+	std::queue< MemoryStream* > childThreadBinLogBatches_;
+
+	// Batches of all child threads that logged, the main thread takes those that were not filled in time
+	std::vector< BinLogThreadBatch* > threadBinLogBatches_;
+
+	// Format IDs already sent to the current logger, and every format seen so far(for local printing)
+	OUROUnordered_map< uint32, bool > binlogSentFormats_;
+	OUROUnordered_map< uint32, std::string > binlogFormats_;
+
+	AsyncLogger* pAsyncLogger_;
 };
 
 /*---------------------------------------------------------------------------------
@@ -216,6 +288,20 @@ private:
 #define DEBUG_MSG(m) DebugHelper::getSingleton().debug_msg((m)) // Output a debug message
 #define INFO_MSG(m) DebugHelper::getSingleton().info_msg((m)) // Output an info message
 #define WARNING_MSG(m) DebugHelper::getSingleton().warning_msg((m)) // Output a warning message
+/*---------------------------------------------------------------------------------
+	Binary structured log output interface, FMT must be a string literal
+---------------------------------------------------------------------------------*/
+#define OURO_BINLOG_MSG(LOGTYPE, FMT, ...)															\
+	{																								\
+		static const uint32 _binlogFmtID = Ouroboros::BinLog::formatID(FMT);						\
+		DebugHelper::getSingleton().binlog_msg(LOGTYPE, _binlogFmtID, FMT, ##__VA_ARGS__);			\
+	}
+
+#define BINLOG_PRINT_MSG(FMT, ...)		OURO_BINLOG_MSG(OUROLOG_PRINT, FMT, ##__VA_ARGS__)
+#define BINLOG_DEBUG_MSG(FMT, ...)		OURO_BINLOG_MSG(OUROLOG_DEBUG, FMT, ##__VA_ARGS__)
+#define BINLOG_INFO_MSG(FMT, ...)		OURO_BINLOG_MSG(OUROLOG_INFO, FMT, ##__VA_ARGS__)
+#define BINLOG_WARNING_MSG(FMT, ...)	OURO_BINLOG_MSG(OUROLOG_WARNING, FMT, ##__VA_ARGS__)
+
 #define CRITICAL_MSG(m)					DebugHelper::getSingleton().setFile(__FUNCTION__, \
 										__FILE__, __LINE__); \
 										DebugHelper::getSingleton().critical_msg((m))
@@ -4,53 +4,121 @@
 #include "eventhistory_stats.h"
 #include "profile_handler.h"
 
-namespace Ouroboros { 
+namespace Ouroboros {
+
+uint32 EventHistoryStats::eventIDs_ = 0;
+
+//-------------------------------------------------------------------------------------
+std::vector<EventHistoryStats*>& EventHistoryStats::instances_()
+{
+	static std::vector<EventHistoryStats*> instances;
+	return instances;
+}
 
 //-------------------------------------------------------------------------------------
 EventHistoryStats::EventHistoryStats(std::string name):
 stats_(),
+names_(),
+index_(),
 name_(name)
 {
+	instances_().push_back(this);
 }
 
 //-------------------------------------------------------------------------------------
 EventHistoryStats::~EventHistoryStats()
 {
+	std::vector<EventHistoryStats*>& instances = instances_();
+	std::vector<EventHistoryStats*>::iterator iter = std::find(instances.begin(), instances.end(), this);
+	if (iter != instances.end())
+		instances.erase(iter);
+}
+
+//-------------------------------------------------------------------------------------
+uint32 EventHistoryStats::allocEventID()
+{
+	return eventIDs_++;
+}
+
+//-------------------------------------------------------------------------------------
+void EventHistoryStats::resetEventIDs()
+{
+	eventIDs_ = 0;
+
+	// The IDs are given to other events after a reload, the counters are kept by name
+	std::vector<EventHistoryStats*>& instances = instances_();
+	std::vector<EventHistoryStats*>::iterator iter = instances.begin();
+	for (; iter != instances.end(); ++iter)
+		(*iter)->index_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void EventHistoryStats::trackEvent(uint16 type, uint32 eventID, const char* typeName, const char* name,
+	uint32 size, const char* flags)
+{
+	if (type >= index_.size())
+		index_.resize(type + 1);
+
+	std::vector<uint32>& events = index_[type];
+	if (eventID >= events.size())
+		events.resize(eventID + 1, 0);
+
+	uint32& slot = events[eventID];
+	if (slot == 0)
+	{
+		std::string fullname = typeName;
+		fullname += flags;
+		fullname += name;
+
+		slot = findOrCreate_(fullname).id + 1;
+	}
+
+	onTrack_(stats_[slot - 1], size);
 }
 
 //-------------------------------------------------------------------------------------
 void EventHistoryStats::trackEvent(const std::string& type, const std::string& name, uint32 size, const char* flags)
 {
-	std::string fullname = type + flags + name;
-	
+	onTrack_(findOrCreate_(type + flags + name), size);
+}
+
+//-------------------------------------------------------------------------------------
+EventHistoryStats::Stats& EventHistoryStats::findOrCreate_(const std::string& fullname)
+{
+	OUROUnordered_map<std::string, uint32>::iterator iter = names_.find(fullname);
+	if (iter != names_.end())
+		return stats_[iter->second];
+
+	uint32 id = (uint32)stats_.size();
+	names_[fullname] = id;
+
+	stats_.push_back(Stats());
+	stats_.back().name = fullname;
+	stats_.back().id = id;
+	return stats_.back();
+}
+
+//-------------------------------------------------------------------------------------
+void EventHistoryStats::onTrack_(Stats& stats, uint32 size)
+{
 	if(size >= PACKET_MAX_SIZE_TCP)
 	{
 		if(size < NETWORK_MESSAGE_MAX_SIZE)
 		{
 			WARNING_MSG(fmt::format("EventHistoryStats::trackEvent[{}]: message size({}) >= PACKET_MAX_SIZE_TCP({}).\n",
-				fullname, size, PACKET_MAX_SIZE_TCP));
+				stats.name, size, PACKET_MAX_SIZE_TCP));
 		}
 		else
 		{
 			ERROR_MSG(fmt::format("EventHistoryStats::trackEvent[{}]: message size({}) > NETWORK_MESSAGE_MAX_SIZE({}).\n",
-				fullname, size, NETWORK_MESSAGE_MAX_SIZE));
+				stats.name, size, NETWORK_MESSAGE_MAX_SIZE));
 		}
 	}
 
-	STATS::iterator iter = stats_.find(fullname);
-	if(iter == stats_.end())
-	{
-		stats_[name].name = fullname;
-		stats_[name].size += size;
-		stats_[name].count++;
-		EventProfileHandler::triggerEvent(*this, stats_[name], size);
-		return;
-	}
+	stats.size += size;
+	stats.count++;
 
-	iter->second.size += size;
-	iter->second.count++;
-	
-	EventProfileHandler::triggerEvent(*this, iter->second, size);
+	EventProfileHandler::triggerEvent(*this, stats, size);
 }
 
 //-------------------------------------------------------------------------------------
@@ -5,10 +5,14 @@
 
 #include "common/common.h"
 
-namespace Ouroboros { 
+namespace Ouroboros {
 
 /*
-	¼event_history
+	Records the traffic of event_history
+
+	The events of entity properties and methods are tracked by the type of the entity and the eventID
+	the description got when the defs were loaded, the counters are kept in a flat array and the name
+	of an event is only built the first time it is seen.
 */
 class EventHistoryStats
 {
@@ -21,27 +25,56 @@ public:
 			name = "";
 			size = 0;
 			count = 0;
+			id = 0;
 		}
 
 		std::string name;
 		uint32 size;
 		uint32 count;
+
+		// Index in stats()
+		uint32 id;
 	};
 
-	typedef OUROUnordered_map<std::string, Stats> STATS;
+	typedef std::vector<Stats> STATS;
 
 	EventHistoryStats(std::string name);
 	~EventHistoryStats();
 
+	/**
+		Allocates the eventID of a property or method description, the IDs restart when the defs are reloaded
+	*/
+	static uint32 allocEventID();
+	static void resetEventIDs();
+
+	void trackEvent(uint16 type, uint32 eventID, const char* typeName, const char* name,
+		uint32 size, const char* flags = ".");
+
 	void trackEvent(const std::string& type, const std::string& name, uint32 size, const char* flags = ".");
 
 	EventHistoryStats::STATS& stats(){ return stats_; }
 
 	const char* name() const { return name_.c_str(); }
+
+private:
+	Stats& findOrCreate_(const std::string& fullname);
+	void onTrack_(Stats& stats, uint32 size);
+
+	// Every EventHistoryStats, they are globals of the apps and constructed before main
+	static std::vector<EventHistoryStats*>& instances_();
+
 private:
 	STATS stats_;
 
+	// fullname -> index in stats_, only looked up the first time an event is seen
+	OUROUnordered_map<std::string, uint32> names_;
+
+	// [type][eventID] -> index in stats_ + 1, 0 if not seen yet
+	std::vector< std::vector<uint32> > index_;
+
 	std::string name_;
+
+	static uint32 eventIDs_;
 };
 
 }
@@ -0,0 +1,230 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+
+#include "flight_recorder.h"
+#include "helper/debug_helper.h"
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+#include <direct.h>
+#define OURO_FLIGHT_RECORDER_MKDIR(a) _mkdir((a))
+#else
+#include <sys/stat.h>
+#define OURO_FLIGHT_RECORDER_MKDIR(a) mkdir((a), 0755)
+#endif
+
+namespace Ouroboros{
+
+FlightRecorder* g_pFlightRecorder = NULL;
+
+//-------------------------------------------------------------------------------------
+static void addJsonString(fmt::memory_buffer& buf, const char* str)
+{
+	buf.push_back('"');
+
+	for(; *str; ++str)
+	{
+		unsigned char c = (unsigned char)*str;
+
+		if(c == '"' || c == '\\')
+		{
+			buf.push_back('\\');
+			buf.push_back(c);
+		}
+		else if(c < 0x20)
+		{
+			fmt::format_to(buf, "\\u{:04x}", (int)c);
+		}
+		else
+		{
+			buf.push_back(c);
+		}
+	}
+
+	buf.push_back('"');
+}
+
+//-------------------------------------------------------------------------------------
+FlightRecorder::FlightRecorder(uint32 numEvents, uint32 numTicks, uint32 thresholdMs, uint32 dumpInterval,
+	const std::string& path, const std::string& componentName):
+events_(),
+eventMask_(0),
+eventPos_(0),
+ticks_(),
+tickPos_(0),
+tickBegin_(0),
+thresholdMs_(thresholdMs),
+threshold_(0),
+dumpInterval_(0),
+lastDumpTime_(0),
+path_(path),
+componentName_(componentName),
+numDumps_(0)
+{
+	// Power of two so that positions can be masked
+	uint64 capacity = 1024;
+	while(capacity < numEvents)
+		capacity <<= 1;
+
+	events_.resize((size_t)capacity);
+	eventMask_ = capacity - 1;
+
+	ticks_.resize(OURO_MAX(numTicks, 1U));
+
+	threshold_ = (uint64)thresholdMs * stampsPerSecond() / 1000;
+	dumpInterval_ = (uint64)dumpInterval * stampsPerSecond();
+
+	memset(&events_[0], 0, sizeof(EVENT) * events_.size());
+	memset(&ticks_[0], 0, sizeof(TICK) * ticks_.size());
+}
+
+//-------------------------------------------------------------------------------------
+FlightRecorder::~FlightRecorder()
+{
+}
+
+//-------------------------------------------------------------------------------------
+bool FlightRecorder::initialize(uint32 numEvents, uint32 numTicks, uint32 thresholdMs, uint32 dumpInterval,
+	const std::string& path, const std::string& componentName)
+{
+	finalise();
+
+	g_pFlightRecorder = new FlightRecorder(numEvents, numTicks, thresholdMs, dumpInterval, path, componentName);
+
+	INFO_MSG(fmt::format("FlightRecorder::initialize: events={}, ticks={}, threshold={}ms, path={}\n",
+		g_pFlightRecorder->events_.size(), g_pFlightRecorder->ticks_.size(), thresholdMs, path));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void FlightRecorder::finalise()
+{
+	SAFE_RELEASE(g_pFlightRecorder);
+}
+
+//-------------------------------------------------------------------------------------
+void FlightRecorder::onTickEnd()
+{
+	if(tickBegin_ == 0)
+		return;
+
+	TICK& tick = ticks_[(size_t)(tickPos_ % ticks_.size())];
+	tick.begin = tickBegin_;
+	tick.end = timestamp();
+	++tickPos_;
+
+	tickBegin_ = 0;
+
+	if(threshold_ == 0 || tick.end - tick.begin < threshold_)
+		return;
+
+	if(lastDumpTime_ > 0 && tick.end - lastDumpTime_ < dumpInterval_)
+		return;
+
+	std::string reason = fmt::format("slow tick {:.3f}ms > {}ms",
+		double(tick.end - tick.begin) * 1000.0 / stampsPerSecondD(), thresholdMs_);
+
+	std::string file = dump(reason.c_str());
+
+	if(file.size() > 0)
+	{
+		WARNING_MSG(fmt::format("FlightRecorder::onTickEnd: {}, last {} ticks written to {}\n",
+			reason, OURO_MIN(tickPos_, (uint64)ticks_.size()), file));
+	}
+}
+
+//-------------------------------------------------------------------------------------
+std::string FlightRecorder::dump(const char* reason)
+{
+	lastDumpTime_ = timestamp();
+
+	for(size_t i = 1; i <= path_.size(); ++i)
+	{
+		if(i == path_.size() || path_[i] == '/' || path_[i] == '\\')
+			OURO_FLIGHT_RECORDER_MKDIR(path_.substr(0, i).c_str());
+	}
+
+	time_t now = time(NULL);
+	char timebuf[64];
+	strftime(timebuf, sizeof(timebuf), "%Y%m%d_%H%M%S", localtime(&now));
+
+	std::string file = fmt::format("{}/{}_{}_{}.json", path_, componentName_, timebuf, numDumps_ + 1);
+
+	FILE* f = fopen(file.c_str(), "wb");
+	if(f == NULL)
+	{
+		ERROR_MSG(fmt::format("FlightRecorder::dump: couldn't open {}! {}\n", file, ouro_strerror()));
+		return "";
+	}
+
+	fmt::memory_buffer buf;
+	addToJson_(buf, reason);
+
+	bool ok = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+	fclose(f);
+
+	if(!ok)
+	{
+		ERROR_MSG(fmt::format("FlightRecorder::dump: write {} is failed! {}\n", file, ouro_strerror()));
+		return "";
+	}
+
+	++numDumps_;
+	return file;
+}
+
+//-------------------------------------------------------------------------------------
+void FlightRecorder::addToJson_(fmt::memory_buffer& buf, const char* reason)
+{
+	uint64 numTicks = OURO_MIN(tickPos_, (uint64)ticks_.size());
+	uint64 numEvents = OURO_MIN(eventPos_, (uint64)events_.size());
+
+	// Only events of the recorded ticks, the tick in progress(dump from telnet) is included as well
+	uint64 origin = tickBegin_ > 0 ? tickBegin_ : timestamp();
+	for(uint64 i = tickPos_ - numTicks; i < tickPos_; ++i)
+		origin = OURO_MIN(origin, ticks_[(size_t)(i % ticks_.size())].begin);
+
+	double usPerStamp = 1000000.0 / stampsPerSecondD();
+
+	buf.reserve(256 + (size_t)(numTicks + numEvents) * 128);
+
+	fmt::format_to(buf, "{{\"displayTimeUnit\":\"ms\",\"otherData\":{{\"component\":");
+	addJsonString(buf, componentName_.c_str());
+	fmt::format_to(buf, ",\"reason\":");
+	addJsonString(buf, reason);
+	fmt::format_to(buf, "}},\"traceEvents\":[\n");
+
+	fmt::format_to(buf, "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{{\"name\":");
+	addJsonString(buf, componentName_.c_str());
+	fmt::format_to(buf, "}}}}");
+
+	for(uint64 i = tickPos_ - numTicks; i < tickPos_; ++i)
+	{
+		const TICK& tick = ticks_[(size_t)(i % ticks_.size())];
+
+		fmt::format_to(buf, ",\n{{\"name\":\"tick\",\"cat\":\"tick\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":{:.3f},\"dur\":{:.3f}}}",
+			double(tick.begin - origin) * usPerStamp, double(tick.end - tick.begin) * usPerStamp);
+	}
+
+	for(uint64 i = eventPos_ - numEvents; i < eventPos_; ++i)
+	{
+		const EVENT& event = events_[(size_t)(i & eventMask_)];
+		if(event.begin < origin || event.name == NULL)
+			continue;
+
+		fmt::format_to(buf, ",\n{{\"name\":");
+		addJsonString(buf, event.name);
+		fmt::format_to(buf, ",\"cat\":\"profile\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":{:.3f},\"dur\":{:.3f}",
+			double(event.begin - origin) * usPerStamp, double(event.end - event.begin) * usPerStamp);
+
+		if(event.entityID > 0)
+			fmt::format_to(buf, ",\"args\":{{\"entityID\":{}}}", event.entityID);
+
+		buf.push_back('}');
+	}
+
+	fmt::format_to(buf, "\n]}}\n");
+}
+
+//-------------------------------------------------------------------------------------
+}
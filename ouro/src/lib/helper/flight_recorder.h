@@ -0,0 +1,153 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_HELPER_FLIGHT_RECORDER_H
+#define OURO_HELPER_FLIGHT_RECORDER_H
+
+#include "common/common.h"
+#include "common/timestamp.h"
+
+namespace Ouroboros
+{
+
+class FlightRecorder;
+
+/*
+	NULL while the recorder is disabled, the hooks only test this pointer
+*/
+extern FlightRecorder* g_pFlightRecorder;
+
+/*
+	Always-on recorder of the main thread, keeps the scoped profiles(ScopedProfile, message handlers)
+	of the last ticks in a fixed ring. When a tick is slower than the threshold the last ticks are
+	written as Chrome trace-event JSON(chrome://tracing, Perfetto).
+
+	Events are recorded when their scope ends, recording is a store into the ring and never allocates.
+*/
+class FlightRecorder
+{
+public:
+	struct EVENT
+	{
+		// Must outlive the recorder(static ProfileVal names, message handler names)
+		const char* name;
+		uint64 begin;
+		uint64 end;
+
+		// 0 if the event does not belong to an entity
+		ENTITY_ID entityID;
+	};
+
+	struct TICK
+	{
+		uint64 begin;
+		uint64 end;
+	};
+
+	FlightRecorder(uint32 numEvents, uint32 numTicks, uint32 thresholdMs, uint32 dumpInterval,
+		const std::string& path, const std::string& componentName);
+
+	~FlightRecorder();
+
+	static bool initialize(uint32 numEvents, uint32 numTicks, uint32 thresholdMs, uint32 dumpInterval,
+		const std::string& path, const std::string& componentName);
+
+	static void finalise();
+
+	void addEvent(const char* name, uint64 begin, uint64 end, ENTITY_ID entityID)
+	{
+		EVENT& event = events_[eventPos_ & eventMask_];
+		event.name = name;
+		event.begin = begin;
+		event.end = end;
+		event.entityID = entityID;
+		++eventPos_;
+	}
+
+	void onTickBegin()
+	{
+		tickBegin_ = timestamp();
+	}
+
+	void onTickEnd();
+
+	/**
+		Write the recorded ticks to a new file, returns the file name or an empty string on failure
+	*/
+	std::string dump(const char* reason);
+
+	uint32 numDumps() const { return numDumps_; }
+	uint32 thresholdMs() const { return thresholdMs_; }
+
+private:
+	void addToJson_(fmt::memory_buffer& buf, const char* reason);
+
+private:
+	std::vector<EVENT> events_;
+	uint64 eventMask_;
+	uint64 eventPos_;
+
+	std::vector<TICK> ticks_;
+	uint64 tickPos_;
+	uint64 tickBegin_;
+
+	uint32 thresholdMs_;
+	uint64 threshold_;
+
+	// Minimum stamps between two automatic dumps, a server that is slow every tick must not fill the disk
+	uint64 dumpInterval_;
+	uint64 lastDumpTime_;
+
+	std::string path_;
+	std::string componentName_;
+
+	uint32 numDumps_;
+};
+
+/*
+	Marks the main tick of a component
+*/
+class ScopedFlightTick
+{
+public:
+	ScopedFlightTick()
+	{
+		if(g_pFlightRecorder)
+			g_pFlightRecorder->onTickBegin();
+	}
+
+	~ScopedFlightTick()
+	{
+		if(g_pFlightRecorder)
+			g_pFlightRecorder->onTickEnd();
+	}
+};
+
+/*
+	Records a scope that is not a ProfileVal, e.g. a message handler
+*/
+class ScopedFlightEvent
+{
+public:
+	ScopedFlightEvent(const char* name, ENTITY_ID entityID = 0):
+	name_(name),
+	entityID_(entityID),
+	begin_(g_pFlightRecorder ? timestamp() : 0)
+	{
+	}
+
+	~ScopedFlightEvent()
+	{
+		// begin_ is 0 if the recorder was started inside the scope
+		if(g_pFlightRecorder && begin_ > 0)
+			g_pFlightRecorder->addEvent(name_, begin_, timestamp(), entityID_);
+	}
+
+private:
+	const char* name_;
+	ENTITY_ID entityID_;
+	uint64 begin_;
+};
+
+}
+
+#endif // OURO_HELPER_FLIGHT_RECORDER_H
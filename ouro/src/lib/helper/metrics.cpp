@@ -0,0 +1,132 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "metrics.h"
+
+namespace Ouroboros{
+
+Metrics* pMetrics = NULL;
+
+static const double METRICS_BUCKET_BOUNDS[METRICS_HISTOGRAM_BUCKETS] = {
+	0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0
+};
+
+static const char* METRICS_BUCKET_NAMES[METRICS_HISTOGRAM_BUCKETS + 1] = {
+	"0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005", "0.01", "0.025", "0.05", "0.1", "0.25", "0.5", "1", "2.5", "5", "+Inf"
+};
+
+//-------------------------------------------------------------------------------------
+MetricsHistogram::MetricsHistogram(const std::string& name, const std::string& help, const std::string& labels):
+name_(name),
+help_(help),
+labels_(labels),
+count_(0),
+sum_(0)
+{
+	for(int i = 0; i < METRICS_HISTOGRAM_BUCKETS; ++i)
+		bounds_[i] = (uint64)(METRICS_BUCKET_BOUNDS[i] * stampsPerSecondD());
+
+	for(int i = 0; i < METRICS_HISTOGRAM_BUCKETS + 1; ++i)
+		buckets_[i].store(0, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------
+MetricsHistogram::~MetricsHistogram()
+{
+}
+
+//-------------------------------------------------------------------------------------
+void MetricsHistogram::observe(uint64 stamps)
+{
+	int i = 0;
+	while(i < METRICS_HISTOGRAM_BUCKETS && stamps > bounds_[i])
+		++i;
+
+	buckets_[i].fetch_add(1, std::memory_order_relaxed);
+	sum_.fetch_add(stamps, std::memory_order_relaxed);
+	count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------
+void MetricsHistogram::addToText(fmt::memory_buffer& buf) const
+{
+	const char* sep = labels_.size() > 0 ? "," : "";
+
+	// Prometheus buckets are cumulative
+	uint64 cumulative = 0;
+	for(int i = 0; i < METRICS_HISTOGRAM_BUCKETS + 1; ++i)
+	{
+		cumulative += buckets_[i].load(std::memory_order_relaxed);
+		fmt::format_to(buf, "{}_bucket{{{}{}le=\"{}\"}} {}\n", name_, labels_, sep, METRICS_BUCKET_NAMES[i], cumulative);
+	}
+
+	if(labels_.size() > 0)
+	{
+		fmt::format_to(buf, "{}_sum{{{}}} {:.6f}\n", name_, labels_, double(sum_.load(std::memory_order_relaxed)) / stampsPerSecondD());
+		fmt::format_to(buf, "{}_count{{{}}} {}\n", name_, labels_, cumulative);
+	}
+	else
+	{
+		fmt::format_to(buf, "{}_sum {:.6f}\n", name_, double(sum_.load(std::memory_order_relaxed)) / stampsPerSecondD());
+		fmt::format_to(buf, "{}_count {}\n", name_, cumulative);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+Metrics::Metrics():
+histograms_()
+{
+}
+
+//-------------------------------------------------------------------------------------
+Metrics::~Metrics()
+{
+	std::vector<MetricsHistogram*>::iterator iter = histograms_.begin();
+	for(; iter != histograms_.end(); ++iter)
+		delete (*iter);
+
+	histograms_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+Metrics& Metrics::root()
+{
+	if(pMetrics == NULL)
+		pMetrics = new Metrics();
+
+	return *pMetrics;
+}
+
+//-------------------------------------------------------------------------------------
+void Metrics::finalise()
+{
+	SAFE_RELEASE(pMetrics);
+}
+
+//-------------------------------------------------------------------------------------
+MetricsHistogram* Metrics::addHistogram(const std::string& name, const std::string& help, const std::string& labels)
+{
+	MetricsHistogram* pHistogram = new MetricsHistogram(name, help, labels);
+	histograms_.push_back(pHistogram);
+	return pHistogram;
+}
+
+//-------------------------------------------------------------------------------------
+void Metrics::addToText(fmt::memory_buffer& buf) const
+{
+	const std::string* pLastName = NULL;
+
+	std::vector<MetricsHistogram*>::const_iterator iter = histograms_.begin();
+	for(; iter != histograms_.end(); ++iter)
+	{
+		if(pLastName == NULL || *pLastName != (*iter)->name())
+		{
+			pLastName = &(*iter)->name();
+			fmt::format_to(buf, "# HELP {} {}\n# TYPE {} histogram\n", (*iter)->name(), (*iter)->help(), (*iter)->name());
+		}
+
+		(*iter)->addToText(buf);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+}
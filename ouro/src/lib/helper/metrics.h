@@ -0,0 +1,105 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_HELPER_METRICS_H
+#define OURO_HELPER_METRICS_H
+
+#include "common/common.h"
+#include "common/timestamp.h"
+#include <atomic>
+
+namespace Ouroboros
+{
+
+/*
+	Latency buckets(seconds) shared by all histograms, le="+Inf" is implicit
+*/
+#define METRICS_HISTOGRAM_BUCKETS 15
+
+/*
+	Fixed bucket latency histogram in Prometheus format.
+	observe() is lock-free and never allocates, it may be called from any thread.
+*/
+class MetricsHistogram
+{
+public:
+	MetricsHistogram(const std::string& name, const std::string& help, const std::string& labels);
+	~MetricsHistogram();
+
+	void observe(uint64 stamps);
+
+	/**
+		Write the _bucket, _sum and _count lines of this histogram
+	*/
+	void addToText(fmt::memory_buffer& buf) const;
+
+	const std::string& name() const { return name_; }
+	const std::string& help() const { return help_; }
+	const std::string& labels() const { return labels_; }
+
+	uint64 count() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+	std::string name_;
+	std::string help_;
+	std::string labels_;
+
+	// Upper bounds of the buckets in stamps
+	uint64 bounds_[METRICS_HISTOGRAM_BUCKETS];
+
+	std::atomic<uint64> buckets_[METRICS_HISTOGRAM_BUCKETS + 1];
+	std::atomic<uint64> count_;
+	std::atomic<uint64> sum_;
+};
+
+/*
+	Registry of all histograms of the process, histograms are created during initialization
+	and live until finalise.
+*/
+class Metrics
+{
+public:
+	Metrics();
+	~Metrics();
+
+	static Metrics& root();
+	static void finalise();
+
+	/**
+		Histograms of the same name must be added one after another, they are written as one metric family
+	*/
+	MetricsHistogram* addHistogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+	void addToText(fmt::memory_buffer& buf) const;
+
+	const std::vector<MetricsHistogram*>& histograms() const { return histograms_; }
+
+private:
+	std::vector<MetricsHistogram*> histograms_;
+};
+
+/*
+	Observe the duration of a scope, does nothing if the histogram is NULL(metrics disabled)
+*/
+class ScopedMetricsTimer
+{
+public:
+	ScopedMetricsTimer(MetricsHistogram* pHistogram):
+	pHistogram_(pHistogram),
+	startTime_(pHistogram ? timestamp() : 0)
+	{
+	}
+
+	~ScopedMetricsTimer()
+	{
+		if(pHistogram_)
+			pHistogram_->observe(timestamp() - startTime_);
+	}
+
+private:
+	MetricsHistogram* pHistogram_;
+	uint64 startTime_;
+};
+
+}
+
+#endif // OURO_HELPER_METRICS_H
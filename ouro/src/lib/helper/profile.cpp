@@ -11,6 +11,8 @@
 namespace Ouroboros
 {
 
+thread_local bool g_profileDisabledThread = false;
+
 ProfileGroup* g_pDefaultGroup = NULL;
 TimeStamp ProfileVal::warningPeriod_;
 
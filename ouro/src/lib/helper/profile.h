@@ -7,10 +7,17 @@
 #include "common/common.h"
 #include "common/timer.h"
 #include "common/timestamp.h"
+#include "helper/flight_recorder.h"
 
 namespace Ouroboros
 {
 
+/*
+	Set by threads other than the main thread(network I/O threads), profiles are not thread safe and
+	the scoped profiles on such a thread are skipped
+*/
+extern thread_local bool g_profileDisabledThread;
+
 #if ENABLE_WATCHERS
 
 class ProfileVal;
@@ -177,17 +184,27 @@ private:
 class ScopedProfile
 {
 public:
-	ScopedProfile(ProfileVal & profile, const char * filename, int lineNum) :
+	ScopedProfile(ProfileVal & profile, const char * filename, int lineNum, ENTITY_ID entityID = 0) :
 		profile_(profile),
 		filename_(filename),
-		lineNum_(lineNum)
+		lineNum_(lineNum),
+		entityID_(entityID),
+		enabled_(!g_profileDisabledThread),
+		flightBegin_((g_pFlightRecorder && enabled_) ? timestamp() : 0)
 	{
-		profile_.start();
+		if(enabled_)
+			profile_.start();
 	}
 
 	~ScopedProfile()
 	{
+		if(!enabled_)
+			return;
+
 		profile_.stop(filename_, lineNum_);
+
+		if(g_pFlightRecorder && flightBegin_ > 0)
+			g_pFlightRecorder->addEvent(profile_.c_str(), flightBegin_, timestamp(), entityID_);
 	}
 
 private:
@@ -195,6 +212,11 @@ private:
 	const char* filename_;
 	int lineNum_;
 
+	// Entity the scope runs for and its start time for the FlightRecorder
+	ENTITY_ID entityID_;
+	bool enabled_;
+	uint64 flightBegin_;
+
 };
 
 #define START_PROFILE( PROFILE ) PROFILE.start();
@@ -208,6 +230,9 @@ private:
 #define SCOPED_PROFILE(PROFILE)													\
 	ScopedProfile PROFILE##_scopedProfile(PROFILE, __FILE__, __LINE__);
 
+#define SCOPED_PROFILE_ENTITY(PROFILE, ENTITYID)									\
+	ScopedProfile PROFILE##_scopedProfile(PROFILE, __FILE__, __LINE__, ENTITYID);
+
 #define STOP_PROFILE_WITH_CHECK( PROFILE )										\
 	if (PROFILE.stop( __FILE__, __LINE__ ))
 
@@ -223,6 +248,7 @@ uint64 runningTime();
 #define STOP_PROFILE_WITH_DATA( PROFILE, DATA )
 #define STOP_PROFILE_WITH_CHECK( PROFILE )
 #define SCOPED_PROFILE(PROFILE)
+#define SCOPED_PROFILE_ENTITY(PROFILE, ENTITYID)
 #define STOP_PROFILE( PROFILE )
 #define START_PROFILE( PROFILE )
 
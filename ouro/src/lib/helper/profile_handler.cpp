@@ -224,18 +224,27 @@ void EventProfileHandler::timeout()
 	EventProfileHandler::PROFILEVALMAP::iterator iter = profileMaps_.begin();
 	for(; iter != profileMaps_.end(); ++iter)
 	{
-		std::string type_name = iter->first;
+		std::string type_name = iter->first->name();
 		PROFILEVALS& vals = iter->second;
 		
 		s << type_name;
 
-		size = (ArraySize)vals.size();
+		size = 0;
+		EventProfileHandler::PROFILEVALS::iterator iter1 = vals.begin();
+		for(; iter1 != vals.end(); ++iter1)
+		{
+			if(iter1->count > 0)
+				++size;
+		}
+
 		s << size;
 
-		EventProfileHandler::PROFILEVALS::iterator iter1 = vals.begin();
+		iter1 = vals.begin();
 		for(; iter1 != vals.end(); ++iter1)
 		{
-			ProfileVal& val = iter1->second;
+			ProfileVal& val = *iter1;
+			if(val.count == 0)
+				continue;
 
 			s << val.name;
 			s << val.count;
@@ -272,30 +281,13 @@ void EventProfileHandler::sendStream(MemoryStream* s)
 void EventProfileHandler::onTriggerEvent(const EventHistoryStats& eventHistory, const EventHistoryStats::Stats& stats, 
 										 uint32 size)
 {
-	EventProfileHandler::PROFILEVALMAP::iterator iter = profileMaps_.find(eventHistory.name());
+	PROFILEVALS& vals = profileMaps_[&eventHistory];
+	if(stats.id >= vals.size())
+		vals.resize(stats.id + 1);
 
-	ProfileVal* pval = NULL;
-	if(iter == profileMaps_.end())
-	{
-		PROFILEVALS& vals = profileMaps_[eventHistory.name()];
-		pval = &vals[stats.name];
+	ProfileVal* pval = &vals[stats.id];
+	if(pval->count == 0)
 		pval->name = stats.name;
-	}	
-	else
-	{
-		PROFILEVALS& vals = iter->second;
-
-		EventProfileHandler::PROFILEVALS::iterator iter1 = vals.find(stats.name);
-		if(iter1 == vals.end())
-		{
-			pval = &vals[stats.name];
-			pval->name = stats.name;
-		}
-		else
-		{
-			pval = &iter1->second;
-		}
-	}
 
 	pval->count++;
 	pval->size += size;
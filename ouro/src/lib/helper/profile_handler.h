@@ -125,9 +125,10 @@ private:
 
 	// This ProfileVal only records the initial value of default.profiles at the beginning of the timer
 	// Take the difference at the end to get the result
-	typedef OUROUnordered_map<std::string,  ProfileVal> PROFILEVALS;
+	// Indexed by EventHistoryStats::Stats::id
+	typedef std::vector<ProfileVal> PROFILEVALS;
 
-	typedef OUROUnordered_map< std::string,  PROFILEVALS > PROFILEVALMAP;
+	typedef std::map< const EventHistoryStats*,  PROFILEVALS > PROFILEVALMAP;
 	PROFILEVALMAP profileMaps_;
 	
 	static std::vector<EventProfileHandler*> eventProfileHandlers_;
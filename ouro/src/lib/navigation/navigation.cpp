@@ -6,6 +6,7 @@
 
 #include "navigation_tile_handle.h"
 #include "navigation_mesh_handle.h"
+#include "navigation_mesh_cache_handle.h"
 
 namespace Ouroboros{
 
@@ -69,6 +70,13 @@ NavigationHandlePtr Navigation::findNavigation(std::string resPath)
 			DEBUG_MSG(fmt::format("Navigation::findNavigation: copy NavTileHandle({:p})!\n", (void*)pNavTileHandle));
 			return NavigationHandlePtr(pNavTileHandle);
 		}
+		else if (iter->second->type() == NavigationHandle::NAV_MESH_CACHE)
+		{
+			// Obstacles belong to a space, each space builds its own navmesh from the shared tile cache layers.
+			NavMeshCacheHandle* pNavMeshCacheHandle = new NavMeshCacheHandle(*(Ouroboros::NavMeshCacheHandle*)iter->second.get());
+			DEBUG_MSG(fmt::format("Navigation::findNavigation: copy NavMeshCacheHandle({:p})!\n", (void*)pNavMeshCacheHandle));
+			return NavigationHandlePtr(pNavMeshCacheHandle);
+		}
 
 		return iter->second;
 	}
@@ -117,14 +125,23 @@ NavigationHandlePtr Navigation::loadNavigation(std::string resPath, const std::m
 	else 	
 	{
 		results.clear();
-		Resmgr::getSingleton().listPathRes(wspath, L"navmesh", results);
+		Resmgr::getSingleton().listPathRes(wspath, L"tilecache", results);
 
-		if(results.size() == 0)
+		if(results.size() > 0)
 		{
-			return NULL;
+			pNavigationHandle_ = NavMeshCacheHandle::create(resPath, params);
 		}
+		else
+		{
+			Resmgr::getSingleton().listPathRes(wspath, L"navmesh", results);
+
+			if(results.size() == 0)
+			{
+				return NULL;
+			}
 
-		pNavigationHandle_ = NavMeshHandle::create(resPath, params);
+			pNavigationHandle_ = NavMeshHandle::create(resPath, params);
+		}
 	}
 
 
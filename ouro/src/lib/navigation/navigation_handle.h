@@ -21,7 +21,8 @@ public:
 	{
 		NAV_UNKNOWN = 0,
 		NAV_MESH = 1,
-		NAV_TILE = 2
+		NAV_TILE = 2,
+		NAV_MESH_CACHE = 3
 	};
 
 	enum NAV_OBJECT_STATE
@@ -48,6 +49,20 @@ public:
 
 	virtual int raycast(int layer, const Position3D& start, const Position3D& end, std::vector<Position3D>& hitPointVec) = 0;
 
+	/* Dynamic obstacles, only navmeshes built from tile caches(xxx.tilecache) support them.
+		Every layer is affected, the returned id is > 0 or NAV_ERROR.
+	*/
+	virtual int addObstacle(const Position3D& pos, float radius, float height) { return NAV_ERROR; }
+	virtual int addBoxObstacle(const Position3D& center, const Position3D& halfExtents, float yaw) { return NAV_ERROR; }
+	virtual bool removeObstacle(int obstacleID) { return false; }
+	virtual uint32 numObstacles() const { return 0; }
+
+	/**
+		Rebuilds the tiles changed by obstacles until endTime(at least one tile per layer), 
+		returns true if the navmesh is up to date
+	*/
+	virtual bool updateObstacles(uint64 endTime) { return true; }
+
 	std::string resPath;
 };
 
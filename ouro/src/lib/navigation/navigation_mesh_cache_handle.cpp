@@ -0,0 +1,594 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "navigation_mesh_cache_handle.h"
+#include "navigation/navigation.h"
+#include "resmgr/resmgr.h"
+#include "common/timestamp.h"
+
+namespace Ouroboros{
+
+/*
+	Reads the layers of RecastDemo's tile cache files, they are compressed with FastLZ(level 1 or 2 by the first byte).
+	Layers are only compressed by tools, compress writes literal runs that any FastLZ decompressor reads.
+*/
+class NavTileCacheCompressor : public dtTileCacheCompressor
+{
+public:
+	static const int MAX_DISTANCE = 8191;
+
+	virtual int maxCompressedSize(const int bufferSize)
+	{
+		return bufferSize + bufferSize / 32 + 1;
+	}
+
+	virtual dtStatus compress(const unsigned char* buffer, const int bufferSize,
+		unsigned char* compressed, const int maxCompressedSize, int* compressedSize)
+	{
+		int op = 0;
+
+		for (int ip = 0; ip < bufferSize; )
+		{
+			int run = std::min(bufferSize - ip, 32);
+			if (op + run + 1 > maxCompressedSize)
+				return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+
+			compressed[op++] = (unsigned char)(run - 1);
+			memcpy(compressed + op, buffer + ip, run);
+			op += run;
+			ip += run;
+		}
+
+		*compressedSize = op;
+		return DT_SUCCESS;
+	}
+
+	virtual dtStatus decompress(const unsigned char* compressed, const int compressedSize,
+		unsigned char* buffer, const int maxBufferSize, int* bufferSize)
+	{
+		*bufferSize = 0;
+
+		if (compressedSize <= 0)
+			return DT_FAILURE;
+
+		const unsigned char* ip = compressed;
+		const unsigned char* ipEnd = compressed + compressedSize;
+		unsigned char* op = buffer;
+		unsigned char* opEnd = buffer + maxBufferSize;
+
+		const int level = ((*ip) >> 5) + 1;
+		if (level != 1 && level != 2)
+			return DT_FAILURE;
+
+		uint32 ctrl = (*ip++) & 31;
+
+		while (true)
+		{
+			if (ctrl >= 32)
+			{
+				uint32 len = (ctrl >> 5) - 1;
+				uint32 ofs = (ctrl & 31) << 8;
+
+				if (len == 7 - 1)
+				{
+					if (level == 1)
+					{
+						if (ip >= ipEnd)
+							return DT_FAILURE;
+
+						len += *ip++;
+					}
+					else
+					{
+						uint32 code = 0;
+
+						do
+						{
+							if (ip >= ipEnd)
+								return DT_FAILURE;
+
+							code = *ip++;
+							len += code;
+						} while (code == 255);
+					}
+				}
+
+				if (ip >= ipEnd)
+					return DT_FAILURE;
+
+				uint32 code = *ip++;
+				size_t distance = ofs + code;
+
+				// Level 2 escapes distances beyond 8191 with 16 bits
+				if (level == 2 && code == 255 && ofs == (31 << 8))
+				{
+					if (ip + 2 > ipEnd)
+						return DT_FAILURE;
+
+					distance = (((uint32)ip[0] << 8) | ip[1]) + MAX_DISTANCE;
+					ip += 2;
+				}
+
+				const unsigned char* ref = op - distance - 1;
+				if (ref < buffer || op + len + 3 > opEnd)
+					return DT_FAILURE;
+
+				// The match may overlap the bytes it writes
+				for (uint32 i = 0; i < len + 3; ++i)
+					*op++ = *ref++;
+			}
+			else
+			{
+				uint32 run = ctrl + 1;
+				if (op + run > opEnd || ip + run > ipEnd)
+					return DT_FAILURE;
+
+				memcpy(op, ip, run);
+				op += run;
+				ip += run;
+			}
+
+			if (ip >= ipEnd)
+				break;
+
+			ctrl = *ip++;
+		}
+
+		*bufferSize = (int)(op - buffer);
+		return DT_SUCCESS;
+	}
+};
+
+/*
+	Every polygon gets the flags the queries include(dtQueryFilter includes all of them),
+	the walkable area the layers were built with becomes area 0 as in the navmeshes.
+*/
+class NavTileCacheMeshProcess : public dtTileCacheMeshProcess
+{
+public:
+	virtual void process(struct dtNavMeshCreateParams* params, unsigned char* polyAreas, unsigned short* polyFlags)
+	{
+		for (int i = 0; i < params->polyCount; ++i)
+		{
+			if (polyAreas[i] == DT_TILECACHE_WALKABLE_AREA)
+				polyAreas[i] = 0;
+
+			polyFlags[i] = 0x01;
+		}
+	}
+};
+
+static dtTileCacheAlloc s_tileCacheAlloc;
+static NavTileCacheCompressor s_tileCacheCompressor;
+static NavTileCacheMeshProcess s_tileCacheMeshProcess;
+
+//-------------------------------------------------------------------------------------
+NavMeshCacheHandle::LayerData::LayerData():
+RefCountable(),
+meshParams(),
+cacheParams(),
+compressedTiles(),
+meshTiles()
+{
+}
+
+//-------------------------------------------------------------------------------------
+NavMeshCacheHandle::LayerData::~LayerData()
+{
+	for (size_t i = 0; i < compressedTiles.size(); ++i)
+		dtFree(compressedTiles[i].first);
+
+	for (size_t i = 0; i < meshTiles.size(); ++i)
+		dtFree(meshTiles[i].first);
+}
+
+//-------------------------------------------------------------------------------------
+NavMeshCacheHandle::NavMeshCacheHandle():
+NavMeshHandle(),
+cacheLayers_(),
+obstacles_(),
+lastObstacleID_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+NavMeshCacheHandle::NavMeshCacheHandle(const NavMeshCacheHandle& navMeshCacheHandle):
+NavMeshHandle(),
+cacheLayers_(),
+obstacles_(),
+lastObstacleID_(0)
+{
+	resPath = navMeshCacheHandle.resPath;
+
+	std::map<int, CacheLayer>::const_iterator iter = navMeshCacheHandle.cacheLayers_.begin();
+	for (; iter != navMeshCacheHandle.cacheLayers_.end(); ++iter)
+		initLayer_(iter->first, iter->second.pData);
+}
+
+//-------------------------------------------------------------------------------------
+NavMeshCacheHandle::~NavMeshCacheHandle()
+{
+	// The navmeshes and queries are freed by NavMeshHandle
+	std::map<int, CacheLayer>::iterator iter = cacheLayers_.begin();
+	for (; iter != cacheLayers_.end(); ++iter)
+	{
+		if (iter->second.pTileCache)
+			dtFreeTileCache(iter->second.pTileCache);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshCacheHandle::initLayer_(int layer, LayerDataPtr pData)
+{
+	dtNavMesh* pNavmesh = dtAllocNavMesh();
+	if (!pNavmesh || dtStatusFailed(pNavmesh->init(&pData->meshParams)))
+	{
+		ERROR_MSG(fmt::format("NavMeshCacheHandle::initLayer_: ({}), layer={}, init navmesh error!\n", resPath, layer));
+		dtFreeNavMesh(pNavmesh);
+		return false;
+	}
+
+	// Starts without obstacles, the tiles are copies the navmesh owns
+	for (size_t i = 0; i < pData->meshTiles.size(); ++i)
+	{
+		int dataSize = pData->meshTiles[i].second;
+		unsigned char* data = (unsigned char*)dtAlloc(dataSize, DT_ALLOC_PERM);
+		if (!data)
+			continue;
+
+		memcpy(data, pData->meshTiles[i].first, dataSize);
+
+		if (dtStatusFailed(pNavmesh->addTile(data, dataSize, DT_TILE_FREE_DATA, 0, 0)))
+			dtFree(data);
+	}
+
+	dtTileCache* pTileCache = dtAllocTileCache();
+	if (!pTileCache || dtStatusFailed(pTileCache->init(&pData->cacheParams, &s_tileCacheAlloc,
+		&s_tileCacheCompressor, &s_tileCacheMeshProcess)))
+	{
+		ERROR_MSG(fmt::format("NavMeshCacheHandle::initLayer_: ({}), layer={}, init tilecache error!\n", resPath, layer));
+		dtFreeTileCache(pTileCache);
+		dtFreeNavMesh(pNavmesh);
+		return false;
+	}
+
+	// The layers are shared by every space, the tile cache only reads them
+	for (size_t i = 0; i < pData->compressedTiles.size(); ++i)
+	{
+		pTileCache->addTile(pData->compressedTiles[i].first, pData->compressedTiles[i].second, 0, 0);
+	}
+
+	dtNavMeshQuery* pMavmeshQuery = new dtNavMeshQuery();
+	pMavmeshQuery->init(pNavmesh, 1024);
+
+	navmeshLayer[layer].pNavmesh = pNavmesh;
+	navmeshLayer[layer].pNavmeshQuery = pMavmeshQuery;
+
+	cacheLayers_[layer].pTileCache = pTileCache;
+	cacheLayers_[layer].pData = pData;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+NavigationHandle* NavMeshCacheHandle::create(std::string resPath, const std::map< int, std::string >& params)
+{
+	if(resPath == "")
+		return NULL;
+
+	std::string path = resPath;
+	path = Resmgr::getSingleton().matchPath(path);
+
+	std::map< int, std::string > layers;
+
+	if(params.size() == 0)
+	{
+		wchar_t* wpath = strutil::char2wchar(path.c_str());
+		std::wstring wspath = wpath;
+		free(wpath);
+
+		std::vector<std::wstring> results;
+		Resmgr::getSingleton().listPathRes(wspath, L"tilecache", results);
+
+		if(results.size() == 0)
+		{
+			ERROR_MSG(fmt::format("NavMeshCacheHandle::create: path({}) not found tilecache.!\n",
+				Resmgr::getSingleton().matchRes(path)));
+
+			return NULL;
+		}
+
+		int layer = 0;
+		std::vector<std::wstring>::iterator iter = results.begin();
+		for(; iter != results.end(); ++iter)
+		{
+			char* cpath = strutil::wchar2char((*iter).c_str());
+			layers[layer++] = cpath;
+			free(cpath);
+		}
+	}
+	else
+	{
+		std::map< int, std::string >::const_iterator iter = params.begin();
+		for(; iter != params.end(); ++iter)
+			layers[iter->first] = path + "/" + iter->second;
+	}
+
+	NavMeshCacheHandle* pNavMeshCacheHandle = new NavMeshCacheHandle();
+	pNavMeshCacheHandle->resPath = resPath;
+
+	std::map< int, std::string >::iterator iter = layers.begin();
+	for(; iter != layers.end(); ++iter)
+	{
+		LayerDataPtr pData = load_(iter->second);
+		if (!pData)
+			continue;
+
+		// Navigation keeps the layers only, every space builds its navmesh from them
+		pNavMeshCacheHandle->cacheLayers_[iter->first].pData = pData;
+
+		DEBUG_MSG(fmt::format("NavMeshCacheHandle::create: ({}), layer={}, {} tiles, {} navmesh tiles\n",
+			iter->second, iter->first, pData->compressedTiles.size(), pData->meshTiles.size()));
+	}
+
+	return pNavMeshCacheHandle;
+}
+
+//-------------------------------------------------------------------------------------
+NavMeshCacheHandle::LayerDataPtr NavMeshCacheHandle::load_(const std::string& res)
+{
+	FILE* fp = fopen(res.c_str(), "rb");
+	if (!fp)
+	{
+		ERROR_MSG(fmt::format("NavMeshCacheHandle::load_: open({}) error!\n",
+			Resmgr::getSingleton().matchRes(res)));
+
+		return NULL;
+	}
+
+	TileCacheSetHeader header;
+	if (fread(&header, sizeof(TileCacheSetHeader), 1, fp) != 1 || header.magic != TILECACHESET_MAGIC ||
+		header.version != TILECACHESET_VERSION)
+	{
+		ERROR_MSG(fmt::format("NavMeshCacheHandle::load_: open({}), TileCacheSetHeader error!\n",
+			Resmgr::getSingleton().matchRes(res)));
+
+		fclose(fp);
+		return NULL;
+	}
+
+	LayerDataPtr pData(new LayerData());
+	pData->meshParams = header.meshParams;
+	pData->cacheParams = header.cacheParams;
+
+	for (int i = 0; i < header.numTiles; ++i)
+	{
+		TileCacheTileHeader tileHeader;
+		if (fread(&tileHeader, sizeof(TileCacheTileHeader), 1, fp) != 1)
+		{
+			ERROR_MSG(fmt::format("NavMeshCacheHandle::load_: open({}), read tile({}) error!\n",
+				Resmgr::getSingleton().matchRes(res), i));
+
+			fclose(fp);
+			return NULL;
+		}
+
+		if (!tileHeader.tileRef || tileHeader.dataSize <= 0)
+			break;
+
+		unsigned char* data = (unsigned char*)dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM);
+		if (!data)
+			break;
+
+		if (fread(data, tileHeader.dataSize, 1, fp) != 1)
+		{
+			ERROR_MSG(fmt::format("NavMeshCacheHandle::load_: open({}), read tile({}) error!\n",
+				Resmgr::getSingleton().matchRes(res), i));
+
+			dtFree(data);
+			fclose(fp);
+			return NULL;
+		}
+
+		pData->compressedTiles.push_back(std::make_pair(data, tileHeader.dataSize));
+	}
+
+	fclose(fp);
+
+	// Builds the tiles without obstacles once, the spaces start from copies of them
+	dtNavMesh* pNavmesh = dtAllocNavMesh();
+	dtTileCache* pTileCache = dtAllocTileCache();
+
+	bool ok = pNavmesh && pTileCache &&
+		dtStatusSucceed(pNavmesh->init(&pData->meshParams)) &&
+		dtStatusSucceed(pTileCache->init(&pData->cacheParams, &s_tileCacheAlloc, &s_tileCacheCompressor, &s_tileCacheMeshProcess));
+
+	if (ok)
+	{
+		for (size_t i = 0; i < pData->compressedTiles.size(); ++i)
+		{
+			dtCompressedTileRef ref = 0;
+			if (dtStatusFailed(pTileCache->addTile(pData->compressedTiles[i].first, pData->compressedTiles[i].second, 0, &ref)) ||
+				dtStatusFailed(pTileCache->buildNavMeshTile(ref, pNavmesh)))
+			{
+				ERROR_MSG(fmt::format("NavMeshCacheHandle::load_: open({}), build tile({}) error!\n",
+					Resmgr::getSingleton().matchRes(res), i));
+
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	if (ok)
+	{
+		const dtNavMesh* navmesh = pNavmesh;
+		for (int i = 0; i < navmesh->getMaxTiles(); ++i)
+		{
+			const dtMeshTile* tile = navmesh->getTile(i);
+			if (!tile || !tile->header || !tile->dataSize)
+				continue;
+
+			unsigned char* data = (unsigned char*)dtAlloc(tile->dataSize, DT_ALLOC_PERM);
+			if (!data)
+			{
+				ok = false;
+				break;
+			}
+
+			memcpy(data, tile->data, tile->dataSize);
+			pData->meshTiles.push_back(std::make_pair(data, tile->dataSize));
+		}
+	}
+
+	dtFreeTileCache(pTileCache);
+	dtFreeNavMesh(pNavmesh);
+
+	if (!ok)
+	{
+		ERROR_MSG(fmt::format("NavMeshCacheHandle::load_: open({}), init error!\n",
+			Resmgr::getSingleton().matchRes(res)));
+
+		return NULL;
+	}
+
+	return pData;
+}
+
+//-------------------------------------------------------------------------------------
+void NavMeshCacheHandle::removeRefs_(std::vector< std::pair<int, dtObstacleRef> >& refs)
+{
+	for (size_t i = 0; i < refs.size(); ++i)
+		cacheLayers_[refs[i].first].pTileCache->removeObstacle(refs[i].second);
+
+	refs.clear();
+}
+
+//-------------------------------------------------------------------------------------
+int NavMeshCacheHandle::addObstacle(const Position3D& pos, float radius, float height)
+{
+	std::vector< std::pair<int, dtObstacleRef> > refs;
+	float p[3] = { pos.x, pos.y, pos.z };
+
+	std::map<int, CacheLayer>::iterator iter = cacheLayers_.begin();
+	for (; iter != cacheLayers_.end(); ++iter)
+	{
+		if (!iter->second.pTileCache)
+			continue;
+
+		dtObstacleRef ref = 0;
+		dtStatus status = iter->second.pTileCache->addObstacle(p, radius, height, &ref);
+		if (dtStatusFailed(status))
+		{
+			ERROR_MSG(fmt::format("NavMeshCacheHandle::addObstacle: ({}), layer={}, error({})!\n",
+				resPath, iter->first, status));
+
+			removeRefs_(refs);
+			return NAV_ERROR;
+		}
+
+		refs.push_back(std::make_pair(iter->first, ref));
+	}
+
+	if (refs.size() == 0)
+		return NAV_ERROR;
+
+	int obstacleID = ++lastObstacleID_;
+	obstacles_[obstacleID].swap(refs);
+	return obstacleID;
+}
+
+//-------------------------------------------------------------------------------------
+int NavMeshCacheHandle::addBoxObstacle(const Position3D& center, const Position3D& halfExtents, float yaw)
+{
+	std::vector< std::pair<int, dtObstacleRef> > refs;
+	float c[3] = { center.x, center.y, center.z };
+	float h[3] = { halfExtents.x, halfExtents.y, halfExtents.z };
+	float bmin[3], bmax[3];
+	dtVsub(bmin, c, h);
+	dtVadd(bmax, c, h);
+
+	std::map<int, CacheLayer>::iterator iter = cacheLayers_.begin();
+	for (; iter != cacheLayers_.end(); ++iter)
+	{
+		if (!iter->second.pTileCache)
+			continue;
+
+		dtObstacleRef ref = 0;
+		dtStatus status = (yaw == 0.f) ? iter->second.pTileCache->addBoxObstacle(bmin, bmax, &ref) :
+			iter->second.pTileCache->addBoxObstacle(c, h, yaw, &ref);
+
+		if (dtStatusFailed(status))
+		{
+			ERROR_MSG(fmt::format("NavMeshCacheHandle::addBoxObstacle: ({}), layer={}, error({})!\n",
+				resPath, iter->first, status));
+
+			removeRefs_(refs);
+			return NAV_ERROR;
+		}
+
+		refs.push_back(std::make_pair(iter->first, ref));
+	}
+
+	if (refs.size() == 0)
+		return NAV_ERROR;
+
+	int obstacleID = ++lastObstacleID_;
+	obstacles_[obstacleID].swap(refs);
+	return obstacleID;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshCacheHandle::removeObstacle(int obstacleID)
+{
+	std::map<int, std::vector< std::pair<int, dtObstacleRef> > >::iterator iter = obstacles_.find(obstacleID);
+	if (iter == obstacles_.end())
+		return false;
+
+	// Keeps the refs the request queue had no room for, removing again later finishes them
+	std::vector< std::pair<int, dtObstacleRef> > failed;
+	for (size_t i = 0; i < iter->second.size(); ++i)
+	{
+		if (dtStatusFailed(cacheLayers_[iter->second[i].first].pTileCache->removeObstacle(iter->second[i].second)))
+			failed.push_back(iter->second[i]);
+	}
+
+	if (failed.size() > 0)
+	{
+		iter->second.swap(failed);
+		return false;
+	}
+
+	obstacles_.erase(iter);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshCacheHandle::updateObstacles(uint64 endTime)
+{
+	bool allUpToDate = true;
+
+	std::map<int, CacheLayer>::iterator iter = cacheLayers_.begin();
+	for (; iter != cacheLayers_.end(); ++iter)
+	{
+		dtTileCache* pTileCache = iter->second.pTileCache;
+		if (!pTileCache)
+			continue;
+
+		dtNavMesh* pNavmesh = navmeshLayer[iter->first].pNavmesh;
+
+		// Every call handles the pending obstacle requests and rebuilds one tile
+		bool upToDate = false;
+		do
+		{
+			if (dtStatusFailed(pTileCache->update(0.f, pNavmesh, &upToDate)))
+				break;
+		} while (!upToDate && timestamp() < endTime);
+
+		if (!upToDate)
+			allUpToDate = false;
+	}
+
+	return allUpToDate;
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,109 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_NAVIGATEMESHCACHEHANDLE_H
+#define OURO_NAVIGATEMESHCACHEHANDLE_H
+
+#include "navigation/navigation_mesh_handle.h"
+
+#include "DetourTileCache.h"
+#include "DetourTileCacheBuilder.h"
+
+namespace Ouroboros {
+
+	struct TileCacheSetHeader
+	{
+		int magic;
+		int version;
+		int numTiles;
+		dtNavMeshParams meshParams;
+		dtTileCacheParams cacheParams;
+	};
+
+	struct TileCacheTileHeader
+	{
+		dtCompressedTileRef tileRef;
+		int dataSize;
+	};
+
+	/*
+		A navmesh built from tile cache layers(xxx.tilecache, as saved by RecastDemo's temp obstacles sample),
+		obstacles can be added and removed at runtime.
+
+		Navigation keeps one handle per navmesh with the layers as loaded, every space gets its own copy(findNavigation)
+		because the obstacles belong to the space. A copy starts from the navmesh tiles built without obstacles,
+		only the tiles an obstacle touches are rebuilt from their layers, spread over the ticks by updateObstacles.
+	*/
+	class NavMeshCacheHandle : public NavMeshHandle
+	{
+	public:
+		static const int TILECACHESET_MAGIC = ('T' << 24) | ('S' << 16) | ('E' << 8) | 'T';
+		static const int TILECACHESET_VERSION = 1;
+
+		/* The tiles of a layer, shared by the copies of every space */
+		struct LayerData : public RefCountable
+		{
+			LayerData();
+			virtual ~LayerData();
+
+			dtNavMeshParams meshParams;
+			dtTileCacheParams cacheParams;
+
+			std::vector< std::pair<unsigned char*, int> > compressedTiles;
+
+			// The navmesh tiles built without obstacles
+			std::vector< std::pair<unsigned char*, int> > meshTiles;
+		};
+
+		typedef SmartPointer<LayerData> LayerDataPtr;
+
+		struct CacheLayer
+		{
+			CacheLayer():
+			pTileCache(NULL),
+			pData()
+			{
+			}
+
+			// NULL in the handle Navigation keeps
+			dtTileCache* pTileCache;
+			LayerDataPtr pData;
+		};
+
+	public:
+		NavMeshCacheHandle();
+		NavMeshCacheHandle(const NavMeshCacheHandle& navMeshCacheHandle);
+		virtual ~NavMeshCacheHandle();
+
+		virtual NavigationHandle::NAV_TYPE type() const { return NAV_MESH_CACHE; }
+
+		static NavigationHandle* create(std::string resPath, const std::map< int, std::string >& params);
+
+		/* pos is the bottom center of the cylinder */
+		virtual int addObstacle(const Position3D& pos, float radius, float height);
+
+		/* Rotated by yaw around the y axis */
+		virtual int addBoxObstacle(const Position3D& center, const Position3D& halfExtents, float yaw);
+
+		virtual bool removeObstacle(int obstacleID);
+		virtual uint32 numObstacles() const { return (uint32)obstacles_.size(); }
+
+		virtual bool updateObstacles(uint64 endTime);
+
+	private:
+		static LayerDataPtr load_(const std::string& res);
+
+		bool initLayer_(int layer, LayerDataPtr pData);
+
+		/* Removes the obstacles of a failed add */
+		void removeRefs_(std::vector< std::pair<int, dtObstacleRef> >& refs);
+
+	private:
+		std::map<int, CacheLayer> cacheLayers_;
+
+		// obstacleID -> the obstacle in every layer
+		std::map<int, std::vector< std::pair<int, dtObstacleRef> > > obstacles_;
+		int lastObstacleID_;
+	};
+}
+
+#endif // OURO_NAVIGATEMESHCACHEHANDLE_H
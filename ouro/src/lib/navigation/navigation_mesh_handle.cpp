@@ -1,6 +1,7 @@
 ﻿// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
 
 #include "navigation_mesh_handle.h"	
+#include "navigation_mesh_tiles.h"
 #include "navigation/navigation.h"
 #include "resmgr/resmgr.h"
 #include "thread/threadguard.h"
@@ -28,13 +29,40 @@ NavMeshHandle::~NavMeshHandle()
 	std::map<int, NavmeshLayer>::iterator iter = navmeshLayer.begin();
 	for(; iter != navmeshLayer.end(); ++iter)
 	{
-		dtFreeNavMesh(iter->second.pNavmesh);
 		dtFreeNavMeshQuery(iter->second.pNavmeshQuery);
+
+		// The tiles own their navmesh
+		if (iter->second.pTiles)
+			delete iter->second.pTiles;
+		else
+			dtFreeNavMesh(iter->second.pNavmesh);
 	}
 	
 	DEBUG_MSG(fmt::format("NavMeshHandle::~NavMeshHandle(): ({}) is destroyed!\n", resPath));
 }
 
+//-------------------------------------------------------------------------------------
+bool NavMeshHandle::touchTiles(NavmeshLayer& layer, const float* a, const float* b, float margin)
+{
+	if (!layer.pTiles)
+		return true;
+
+	layer.pTiles->evict();
+
+	float bmin[3], bmax[3];
+	dtVcopy(bmin, a);
+	dtVcopy(bmax, a);
+	dtVmin(bmin, b);
+	dtVmax(bmax, b);
+
+	bmin[0] -= margin;
+	bmin[2] -= margin;
+	bmax[0] += margin;
+	bmax[2] += margin;
+
+	return layer.pTiles->touch(bmin, bmax);
+}
+
 //-------------------------------------------------------------------------------------
 int NavMeshHandle::findStraightPath(int layer, const Position3D& start, const Position3D& end, std::vector<Position3D>& paths)
 {
@@ -64,6 +92,13 @@ int NavMeshHandle::findStraightPath(int layer, const Position3D& start, const Po
 
 	const float extents[3] = {2.f, 4.f, 2.f};
 
+	// Mapped tiles: the tiles between start and end with a margin of one tile, widened while the path ends at unloaded tiles
+	float margin = 0.f;
+	if (iter->second.pTiles)
+		margin = iter->second.pNavmesh->getParams()->tileWidth;
+
+	bool allTiles = touchTiles(iter->second, spos, epos, margin);
+
 	dtPolyRef startRef = INVALID_NAVMESH_POLYREF;
 	dtPolyRef endRef = INVALID_NAVMESH_POLYREF;
 
@@ -86,7 +121,15 @@ int NavMeshHandle::findStraightPath(int layer, const Position3D& start, const Po
 	int nstraightPath;
 	int pos = 0;
 
-	navmeshQuery->findPath(startRef, endRef, startNearestPt, endNearestPt, &filter, polys, &npolys, MAX_POLYS);
+	dtStatus status = navmeshQuery->findPath(startRef, endRef, startNearestPt, endNearestPt, &filter, polys, &npolys, MAX_POLYS);
+
+	while (!allTiles && dtStatusDetail(status, DT_PARTIAL_RESULT))
+	{
+		margin *= 2.f;
+		allTiles = touchTiles(iter->second, spos, epos, margin);
+		status = navmeshQuery->findPath(startRef, endRef, startNearestPt, endNearestPt, &filter, polys, &npolys, MAX_POLYS);
+	}
+
 	nstraightPath = 0;
 
 	if (npolys)
@@ -134,6 +177,10 @@ int NavMeshHandle::findRandomPointAroundCircle(int layer, const Position3D& cent
 
 	if (maxRadius <= 0.0001f)
 	{
+		// Anywhere on the navmesh
+		if (iter->second.pTiles)
+			iter->second.pTiles->touchAll();
+
 		Position3D currpos;
 
 		for (uint32 i = 0; i < max_points; i++)
@@ -164,6 +211,8 @@ int NavMeshHandle::findRandomPointAroundCircle(int layer, const Position3D& cent
 	spos[1] = centerPos.y;
 	spos[2] = centerPos.z;
 
+	touchTiles(iter->second, spos, spos, maxRadius + extents[0]);
+
 	float startNearestPt[3];
 	navmeshQuery->findNearestPoly(spos, extents, &filter, &startRef, startNearestPt);
 
@@ -361,6 +410,8 @@ int NavMeshHandle::raycast(int layer, const Position3D& start, const Position3D&
 
 	const float extents[3] = {2.f, 4.f, 2.f};
 
+	touchTiles(iter->second, spos, epos, extents[0]);
+
 	dtPolyRef startRef = INVALID_NAVMESH_POLYREF;
 
 	float nearestPt[3];
@@ -577,6 +628,27 @@ dtNavMesh* tryReadNavmesh(uint8* data, size_t readsize, const std::string& res,
 bool NavMeshHandle::_create(int layer, const std::string& resPath, const std::string& res, NavMeshHandle* pNavMeshHandle)
 {
 	OURO_ASSERT(pNavMeshHandle);
+
+	if (NavMeshTiles::enabled)
+	{
+		NavMeshTiles* pTiles = NavMeshTiles::create(res);
+		if (pTiles)
+		{
+			dtNavMeshQuery* pMavmeshQuery = new dtNavMeshQuery();
+			pMavmeshQuery->init(pTiles->navmesh(), 1024);
+
+			pNavMeshHandle->resPath = resPath;
+			pNavMeshHandle->navmeshLayer[layer].pNavmeshQuery = pMavmeshQuery;
+			pNavMeshHandle->navmeshLayer[layer].pNavmesh = pTiles->navmesh();
+			pNavMeshHandle->navmeshLayer[layer].pTiles = pTiles;
+
+			DEBUG_MSG(fmt::format("NavMeshHandle::create: ({}), layer={}, {} tiles mapped({:.2f} MB), loaded on demand\n", 
+				res, layer, pTiles->numTiles(), ((float)pTiles->mappedSize() / 1048576)));
+
+			return true;
+		}
+	}
+
 	FILE* fp = fopen(res.c_str(), "rb");
 	if (!fp)
 	{
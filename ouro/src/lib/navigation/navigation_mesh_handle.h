@@ -12,6 +12,8 @@
 
 namespace Ouroboros {
 
+	class NavMeshTiles;
+
 	struct NavMeshSetHeader
 	{
 		int version;
@@ -44,8 +46,18 @@ namespace Ouroboros {
 
 		struct NavmeshLayer
 		{
+			NavmeshLayer():
+			pNavmesh(NULL),
+			pNavmeshQuery(NULL),
+			pTiles(NULL)
+			{
+			}
+
 			dtNavMesh* pNavmesh;
 			dtNavMeshQuery* pNavmeshQuery;
+
+			// The mapped tiles the navmesh loads on demand, NULL if every tile was loaded into memory
+			NavMeshTiles* pTiles;
 		};
 
 	public:
@@ -67,6 +79,11 @@ namespace Ouroboros {
 		std::map<int, NavmeshLayer> navmeshLayer;
 
 	private:
+		/* Adds the mapped tiles around the box of two points to the navmesh of the layer, evicts the unused ones.
+			Returns true if every tile is loaded.
+		*/
+		static bool touchTiles(NavmeshLayer& layer, const float* a, const float* b, float margin);
+
 		/* Derives overlap polygon of two polygon on the xz-plane.
 			@param[in]		polyVertsA		Vertices of polygon A.
 			@param[in]		nPolyVertsA		Vertices number of polygon A.
@@ -0,0 +1,451 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "navigation_mesh_tiles.h"
+#include "navigation_mesh_handle.h"
+#include "resmgr/resmgr.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace Ouroboros{
+
+bool NavMeshTiles::enabled = false;
+float NavMeshTiles::evictTime = 300.f;
+
+//-------------------------------------------------------------------------------------
+static inline uint64 alignOffset(uint64 offset)
+{
+	return (offset + NavMeshTiles::ALIGNMENT - 1) / NavMeshTiles::ALIGNMENT * NavMeshTiles::ALIGNMENT;
+}
+
+//-------------------------------------------------------------------------------------
+static bool statSource(const std::string& res, uint64& size, uint64& time)
+{
+	struct stat st;
+	if (stat(res.c_str(), &st) != 0)
+		return false;
+
+	size = (uint64)st.st_size;
+	time = (uint64)st.st_mtime;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static bool writeZeros(FILE* fp, uint64 count)
+{
+	static const char zeros[NavMeshTiles::ALIGNMENT] = { 0 };
+
+	while (count > 0)
+	{
+		size_t n = (size_t)OURO_MIN(count, (uint64)sizeof(zeros));
+		if (fwrite(zeros, 1, n, fp) != n)
+			return false;
+
+		count -= n;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+NavMeshTiles::NavMeshTiles():
+file_(),
+pNavmesh_(NULL),
+tiles_(),
+grid_(),
+minx_(0),
+miny_(0),
+maxx_(0),
+maxy_(0),
+numLoaded_(0),
+lastEvictTime_(timestamp())
+{
+}
+
+//-------------------------------------------------------------------------------------
+NavMeshTiles::~NavMeshTiles()
+{
+	// The tiles are added without DT_TILE_FREE_DATA, the mapping owns their data
+	if (pNavmesh_)
+		dtFreeNavMesh(pNavmesh_);
+
+	pNavmesh_ = NULL;
+	file_.close();
+}
+
+//-------------------------------------------------------------------------------------
+NavMeshTiles* NavMeshTiles::create(const std::string& res)
+{
+	std::string path = res + ".tiles";
+
+	if (!isBaked_(res, path))
+	{
+		if (!bake(res, path))
+		{
+			WARNING_MSG(fmt::format("NavMeshTiles::create: can not bake({}), the navmesh is loaded into memory.\n",
+				Resmgr::getSingleton().matchRes(path)));
+
+			return NULL;
+		}
+	}
+
+	NavMeshTiles* pNavMeshTiles = new NavMeshTiles();
+	if (!pNavMeshTiles->init_(path))
+	{
+		delete pNavMeshTiles;
+		return NULL;
+	}
+
+	return pNavMeshTiles;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshTiles::isBaked_(const std::string& res, const std::string& path)
+{
+	uint64 sourceSize = 0, sourceTime = 0;
+	if (!statSource(res, sourceSize, sourceTime))
+		return false;
+
+	FILE* fp = fopen(path.c_str(), "rb");
+	if (!fp)
+		return false;
+
+	NavMeshTilesHeader header;
+	size_t readsize = fread(&header, 1, sizeof(header), fp);
+	fclose(fp);
+
+	return readsize == sizeof(header) && header.magic == MAGIC && header.version == VERSION &&
+		header.alignment == ALIGNMENT && header.sourceSize == sourceSize && header.sourceTime == sourceTime;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshTiles::bake(const std::string& res, const std::string& dst)
+{
+	uint64 sourceSize = 0, sourceTime = 0;
+	if (!statSource(res, sourceSize, sourceTime))
+		return false;
+
+	FILE* fp = fopen(res.c_str(), "rb");
+	if (!fp)
+		return false;
+
+	std::vector<uint8> data((size_t)sourceSize);
+	size_t readsize = data.size() > 0 ? fread(&data[0], 1, data.size(), fp) : 0;
+	fclose(fp);
+
+	if (readsize != data.size())
+		return false;
+
+	NavMeshTilesHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.alignment = ALIGNMENT;
+	header.sourceSize = sourceSize;
+	header.sourceTime = sourceTime;
+
+	// The two formats NavMeshHandle reads
+	size_t pos = 0;
+	NavMeshSetHeader setHeader;
+	NavMeshSetHeaderEx setHeaderEx;
+	memset(&setHeader, 0, sizeof(setHeader));
+	memset(&setHeaderEx, 0, sizeof(setHeaderEx));
+
+	if (readsize >= sizeof(setHeader))
+		memcpy(&setHeader, &data[0], sizeof(setHeader));
+
+	if (readsize >= sizeof(setHeaderEx))
+		memcpy(&setHeaderEx, &data[0], sizeof(setHeaderEx));
+
+	if (readsize >= sizeof(setHeader) && setHeader.version == NavMeshHandle::RCN_NAVMESH_VERSION)
+	{
+		header.tileCount = setHeader.tileCount;
+		header.params = setHeader.params;
+		pos = sizeof(setHeader);
+	}
+	else if (readsize >= sizeof(setHeaderEx) && setHeaderEx.version == NavMeshHandle::RCN_NAVMESH_VERSION)
+	{
+		header.tileCount = setHeaderEx.tileCount;
+		header.params = setHeaderEx.params;
+		pos = sizeof(setHeaderEx);
+	}
+	else
+	{
+		ERROR_MSG(fmt::format("NavMeshTiles::bake: {} is not a navmesh!\n",
+			Resmgr::getSingleton().matchRes(res)));
+
+		return false;
+	}
+
+	if (header.tileCount < 0)
+		return false;
+
+	std::vector<NavMeshTilesEntry> entries;
+	std::vector<size_t> sources;
+
+	uint64 offset = alignOffset(sizeof(header) + sizeof(NavMeshTilesEntry) * header.tileCount);
+
+	for (int i = 0; i < header.tileCount; ++i)
+	{
+		NavMeshTileHeader tileHeader;
+		if (pos + sizeof(tileHeader) > readsize)
+			return false;
+
+		memcpy(&tileHeader, &data[pos], sizeof(tileHeader));
+		pos += sizeof(tileHeader);
+
+		if (!tileHeader.tileRef || tileHeader.dataSize < (int)sizeof(dtMeshHeader) || pos + tileHeader.dataSize > readsize)
+		{
+			ERROR_MSG(fmt::format("NavMeshTiles::bake: {}, tile({}) is broken!\n",
+				Resmgr::getSingleton().matchRes(res), i));
+
+			return false;
+		}
+
+		dtMeshHeader meshHeader;
+		memcpy(&meshHeader, &data[pos], sizeof(meshHeader));
+
+		if (meshHeader.magic != DT_NAVMESH_MAGIC || meshHeader.version != DT_NAVMESH_VERSION)
+		{
+			ERROR_MSG(fmt::format("NavMeshTiles::bake: {}, tile({}) version({}) is not match({})!\n",
+				Resmgr::getSingleton().matchRes(res), i, meshHeader.version, DT_NAVMESH_VERSION));
+
+			return false;
+		}
+
+		NavMeshTilesEntry entry;
+		memset(&entry, 0, sizeof(entry));
+		entry.tileRef = tileHeader.tileRef;
+		entry.offset = offset;
+		entry.dataSize = tileHeader.dataSize;
+		entry.x = meshHeader.x;
+		entry.y = meshHeader.y;
+		entry.layer = meshHeader.layer;
+
+		entries.push_back(entry);
+		sources.push_back(pos);
+
+		pos += tileHeader.dataSize;
+		offset = alignOffset(offset + tileHeader.dataSize);
+	}
+
+	// Other processes may map dst at any time, the file is replaced once it is complete
+	std::string tmp = fmt::format("{}.{}", dst, getProcessPID());
+
+	fp = fopen(tmp.c_str(), "wb");
+	if (!fp)
+		return false;
+
+	bool success = fwrite(&header, 1, sizeof(header), fp) == sizeof(header);
+
+	if (success && entries.size() > 0)
+		success = fwrite(&entries[0], sizeof(NavMeshTilesEntry), entries.size(), fp) == entries.size();
+
+	uint64 written = sizeof(header) + sizeof(NavMeshTilesEntry) * entries.size();
+
+	for (size_t i = 0; success && i < entries.size(); ++i)
+	{
+		success = writeZeros(fp, entries[i].offset - written) &&
+			fwrite(&data[sources[i]], 1, entries[i].dataSize, fp) == (size_t)entries[i].dataSize;
+
+		written = entries[i].offset + entries[i].dataSize;
+	}
+
+	if (success)
+		success = writeZeros(fp, alignOffset(written) - written);
+
+	fclose(fp);
+
+	if (success && rename(tmp.c_str(), dst.c_str()) != 0)
+	{
+		// Windows does not replace an existing file
+		remove(dst.c_str());
+		success = rename(tmp.c_str(), dst.c_str()) == 0;
+	}
+
+	if (!success)
+	{
+		remove(tmp.c_str());
+		return false;
+	}
+
+	INFO_MSG(fmt::format("NavMeshTiles::bake: {}, {} tiles, {:.2f} MB.\n",
+		Resmgr::getSingleton().matchRes(dst), entries.size(), double(alignOffset(written)) / 1048576.0));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshTiles::init_(const std::string& path)
+{
+	if (!file_.open(path, true))
+	{
+		ERROR_MSG(fmt::format("NavMeshTiles::init_: can not map({})!\n",
+			Resmgr::getSingleton().matchRes(path)));
+
+		return false;
+	}
+
+	if (file_.size() < sizeof(NavMeshTilesHeader))
+		return false;
+
+	const NavMeshTilesHeader* pHeader = (const NavMeshTilesHeader*)file_.data();
+	if (pHeader->magic != MAGIC || pHeader->version != VERSION || pHeader->tileCount < 0 ||
+		file_.size() < sizeof(NavMeshTilesHeader) + sizeof(NavMeshTilesEntry) * pHeader->tileCount)
+	{
+		ERROR_MSG(fmt::format("NavMeshTiles::init_: {} is broken!\n",
+			Resmgr::getSingleton().matchRes(path)));
+
+		return false;
+	}
+
+	pNavmesh_ = dtAllocNavMesh();
+	if (!pNavmesh_)
+		return false;
+
+	dtStatus status = pNavmesh_->init(&pHeader->params);
+	if (dtStatusFailed(status))
+	{
+		ERROR_MSG(fmt::format("NavMeshTiles::init_: mesh init error({})!\n", status));
+		return false;
+	}
+
+	const NavMeshTilesEntry* pEntries = (const NavMeshTilesEntry*)(file_.data() + sizeof(NavMeshTilesHeader));
+	tiles_.resize(pHeader->tileCount);
+
+	for (int i = 0; i < pHeader->tileCount; ++i)
+	{
+		const NavMeshTilesEntry& entry = pEntries[i];
+		if (entry.offset % ALIGNMENT != 0 || entry.offset + entry.dataSize > file_.size())
+		{
+			ERROR_MSG(fmt::format("NavMeshTiles::init_: {}, tile({}) is broken!\n",
+				Resmgr::getSingleton().matchRes(path), i));
+
+			return false;
+		}
+
+		TILE& tile = tiles_[i];
+		tile.pEntry = &entry;
+		tile.ref = 0;
+		tile.lastUsed = 0;
+
+		grid_[std::make_pair(entry.x, entry.y)].push_back((uint32)i);
+
+		if (i == 0)
+		{
+			minx_ = maxx_ = entry.x;
+			miny_ = maxy_ = entry.y;
+		}
+		else
+		{
+			minx_ = OURO_MIN(minx_, entry.x);
+			maxx_ = OURO_MAX(maxx_, entry.x);
+			miny_ = OURO_MIN(miny_, entry.y);
+			maxy_ = OURO_MAX(maxy_, entry.y);
+		}
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshTiles::load_(TILE& tile, TimeStamp now)
+{
+	tile.lastUsed = now;
+
+	if (tile.ref)
+		return true;
+
+	const NavMeshTilesEntry* pEntry = tile.pEntry;
+
+	// Not the baked ref, a reloaded tile gets a new salt so refs into the evicted tile stay invalid
+	dtStatus status = pNavmesh_->addTile(file_.data() + pEntry->offset, pEntry->dataSize, 0, 0, &tile.ref);
+	if (dtStatusFailed(status))
+	{
+		ERROR_MSG(fmt::format("NavMeshTiles::load_: addTile({}, {}, {}) error({})!\n",
+			pEntry->x, pEntry->y, pEntry->layer, status));
+
+		tile.ref = 0;
+		return false;
+	}
+
+	++numLoaded_;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void NavMeshTiles::unload_(TILE& tile)
+{
+	if (!tile.ref)
+		return;
+
+	pNavmesh_->removeTile(tile.ref, NULL, NULL);
+	file_.discard((size_t)tile.pEntry->offset, (size_t)tile.pEntry->dataSize);
+
+	tile.ref = 0;
+	--numLoaded_;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshTiles::touch(const float* bmin, const float* bmax)
+{
+	if (tiles_.size() == 0)
+		return true;
+
+	int x0, y0, x1, y1;
+	pNavmesh_->calcTileLoc(bmin, &x0, &y0);
+	pNavmesh_->calcTileLoc(bmax, &x1, &y1);
+
+	TimeStamp now = timestamp();
+
+	for (int y = OURO_MAX(y0, miny_); y <= OURO_MIN(y1, maxy_); ++y)
+	{
+		for (int x = OURO_MAX(x0, minx_); x <= OURO_MIN(x1, maxx_); ++x)
+		{
+			std::map<std::pair<int, int>, std::vector<uint32> >::iterator iter = grid_.find(std::make_pair(x, y));
+			if (iter == grid_.end())
+				continue;
+
+			std::vector<uint32>::iterator titer = iter->second.begin();
+			for (; titer != iter->second.end(); ++titer)
+				load_(tiles_[(*titer)], now);
+		}
+	}
+
+	return x0 <= minx_ && y0 <= miny_ && x1 >= maxx_ && y1 >= maxy_;
+}
+
+//-------------------------------------------------------------------------------------
+void NavMeshTiles::touchAll()
+{
+	TimeStamp now = timestamp();
+
+	std::vector<TILE>::iterator iter = tiles_.begin();
+	for (; iter != tiles_.end(); ++iter)
+		load_((*iter), now);
+}
+
+//-------------------------------------------------------------------------------------
+void NavMeshTiles::evict()
+{
+	if (evictTime <= 0.f || numLoaded_ == 0)
+		return;
+
+	TimeStamp now = timestamp();
+	if (now - lastEvictTime_ < stampsPerSecond())
+		return;
+
+	lastEvictTime_ = now;
+
+	TimeStamp timeout = TimeStamp(evictTime * stampsPerSecondD());
+
+	std::vector<TILE>::iterator iter = tiles_.begin();
+	for (; iter != tiles_.end(); ++iter)
+	{
+		if ((*iter).ref && now - (*iter).lastUsed >= timeout)
+			unload_((*iter));
+	}
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,124 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_NAVIGATEMESHTILES_H
+#define OURO_NAVIGATEMESHTILES_H
+
+#include "common/common.h"
+#include "common/timestamp.h"
+#include "common/mapped_file.h"
+#include "helper/debug_helper.h"
+
+#include "DetourNavMesh.h"
+
+namespace Ouroboros {
+
+	struct NavMeshTilesHeader
+	{
+		int magic;
+		int version;
+		int tileCount;
+		int alignment;
+
+		// The navmesh the tiles were baked from, a changed navmesh is baked again
+		uint64 sourceSize;
+		uint64 sourceTime;
+
+		dtNavMeshParams params;
+	};
+
+	struct NavMeshTilesEntry
+	{
+		dtTileRef tileRef;
+		uint64 offset;
+		int dataSize;
+		int x;
+		int y;
+		int layer;
+	};
+
+	/*
+		The tiles of a navmesh baked into a file(xxx.navmesh.tiles) and mapped into memory.
+
+		Every tile starts on a page boundary, so the cellapps of a machine share the pages of the file through the page cache.
+		The mapping is copy-on-write, adding a tile to the dtNavMesh writes its links(polys, links) into the mapped pages,
+		those pages become private while the vertices, detail meshes and BV trees stay shared.
+		Tiles are added to the dtNavMesh the first time a query touches them and removed again once no query used
+		them for evictTime seconds, their private pages are handed back to the file.
+	*/
+	class NavMeshTiles
+	{
+	public:
+		static const int MAGIC = ('O' << 24) | ('N' << 16) | ('M' << 8) | 'T';
+		static const int VERSION = 1;
+		static const int ALIGNMENT = 4096;
+
+		// Set by the cellapp from its config
+		static bool enabled;
+		static float evictTime;
+
+		~NavMeshTiles();
+
+		/**
+			Maps the baked tiles of the navmesh res, bakes them first if there are none or the navmesh has changed.
+			Returns NULL on failure, the navmesh is then loaded the usual way.
+		*/
+		static NavMeshTiles* create(const std::string& res);
+
+		/**
+			Writes the tiles of the navmesh res page aligned into dst
+		*/
+		static bool bake(const std::string& res, const std::string& dst);
+
+		dtNavMesh* navmesh() const { return pNavmesh_; }
+
+		/**
+			Adds the tiles overlapping the box(xz-plane) to the navmesh and marks them as used.
+			Returns true if the box covers every tile.
+		*/
+		bool touch(const float* bmin, const float* bmax);
+		void touchAll();
+
+		/**
+			Removes the tiles that were not used for evictTime seconds
+		*/
+		void evict();
+
+		uint32 numTiles() const { return (uint32)tiles_.size(); }
+		uint32 numLoaded() const { return numLoaded_; }
+		size_t mappedSize() const { return file_.size(); }
+
+	private:
+		struct TILE
+		{
+			const NavMeshTilesEntry* pEntry;
+
+			// The ref in the navmesh, 0 if the tile is not loaded
+			dtTileRef ref;
+			TimeStamp lastUsed;
+		};
+
+		NavMeshTiles();
+
+		bool init_(const std::string& path);
+
+		bool load_(TILE& tile, TimeStamp now);
+		void unload_(TILE& tile);
+
+		static bool isBaked_(const std::string& res, const std::string& path);
+
+	private:
+		MappedFile file_;
+		dtNavMesh* pNavmesh_;
+
+		std::vector<TILE> tiles_;
+
+		// Tiles by grid position, several layers may share a position
+		std::map<std::pair<int, int>, std::vector<uint32> > grid_;
+		int minx_, miny_, maxx_, maxy_;
+
+		uint32 numLoaded_;
+		TimeStamp lastEvictTime_;
+	};
+}
+
+#endif // OURO_NAVIGATEMESHTILES_H
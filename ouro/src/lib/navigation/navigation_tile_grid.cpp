@@ -0,0 +1,448 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "navigation_tile_grid.h"
+
+#include <algorithm>
+#include <functional>
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+#include <intrin.h>
+#endif
+
+namespace Ouroboros{
+
+static const float SQRT2 = 1.41421356f;
+
+//-------------------------------------------------------------------------------------
+static inline int countTrailingZeros(uint64 v)
+{
+#if OURO_PLATFORM == PLATFORM_WIN32
+	unsigned long i = 0;
+	_BitScanForward64(&i, v);
+	return (int)i;
+#else
+	return __builtin_ctzll(v);
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+static inline float octileDistance(int ax, int ay, int bx, int by)
+{
+	int dx = abs(ax - bx);
+	int dy = abs(ay - by);
+	return (float)(dx + dy) + (SQRT2 - 2.f) * (float)std::min(dx, dy);
+}
+
+/*
+	The state of a search, kept between searches so that nothing is allocated once it has grown to the largest map.
+	Nodes belong to the current search only if their stamp matches, starting a search does not clear them.
+	Searches run in the main thread only, as the generic A* does.
+*/
+struct TileSearch
+{
+	struct NODE
+	{
+		float g;
+		int32 parent;
+		uint32 stamp;
+		bool closed;
+	};
+
+	typedef std::pair<float, int32> OPEN_ENTRY;
+
+	TileSearch():
+	nodes(),
+	open(),
+	stamp(0)
+	{
+	}
+
+	void reset(size_t size)
+	{
+		if (nodes.size() < size)
+		{
+			NODE node = { 0.f, -1, 0, false };
+			nodes.resize(size, node);
+		}
+
+		if (++stamp == 0)
+		{
+			for (size_t i = 0; i < nodes.size(); ++i)
+				nodes[i].stamp = 0;
+
+			stamp = 1;
+		}
+
+		open.clear();
+	}
+
+	/* Returns false if the node was reached before at a lower cost or is closed */
+	bool reach(int32 idx, float g, float h, int32 parent)
+	{
+		NODE& node = nodes[idx];
+
+		if (node.stamp == stamp)
+		{
+			if (node.closed || node.g <= g)
+				return false;
+		}
+		else
+		{
+			node.stamp = stamp;
+			node.closed = false;
+		}
+
+		node.g = g;
+		node.parent = parent;
+
+		open.push_back(OPEN_ENTRY(g + h, idx));
+		std::push_heap(open.begin(), open.end(), std::greater<OPEN_ENTRY>());
+		return true;
+	}
+
+	/* The open node with the lowest cost, -1 if there is none */
+	int32 pop()
+	{
+		while (open.size() > 0)
+		{
+			std::pop_heap(open.begin(), open.end(), std::greater<OPEN_ENTRY>());
+			int32 idx = open.back().second;
+			open.pop_back();
+
+			// Entries left behind by a cheaper path to the same node
+			if (nodes[idx].closed)
+				continue;
+
+			nodes[idx].closed = true;
+			return idx;
+		}
+
+		return -1;
+	}
+
+	std::vector<NODE> nodes;
+	std::vector<OPEN_ENTRY> open;
+	uint32 stamp;
+};
+
+static TileSearch s_tileSearch;
+
+//-------------------------------------------------------------------------------------
+NavTileGrid::NavTileGrid(int width, int height):
+RefCountable(),
+width_(width),
+height_(height),
+uniformCost_(true)
+{
+	for (int grid = 0; grid < GRID_MAX; ++grid)
+	{
+		bool transposed = (grid == SOUTH || grid == NORTH);
+		rowCount_[grid] = transposed ? width : height;
+		colCount_[grid] = transposed ? height : width;
+
+		// Two more words, reading 64 tiles from the last column never leaves the row
+		stride_[grid] = (colCount_[grid] >> 6) + 2;
+		rows_[grid].resize((size_t)rowCount_[grid] * stride_[grid], 0);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+NavTileGrid::~NavTileGrid()
+{
+}
+
+//-------------------------------------------------------------------------------------
+void NavTileGrid::setWalkable(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= width_ || y >= height_)
+		return;
+
+	int row[GRID_MAX] = { y, y, x, x };
+	int col[GRID_MAX] = { x, width_ - 1 - x, y, height_ - 1 - y };
+
+	for (int grid = 0; grid < GRID_MAX; ++grid)
+		rows_[grid][row[grid] * stride_[grid] + (col[grid] >> 6)] |= (uint64)1 << (col[grid] & 63);
+}
+
+//-------------------------------------------------------------------------------------
+size_t NavTileGrid::memorySize() const
+{
+	size_t size = 0;
+
+	for (int grid = 0; grid < GRID_MAX; ++grid)
+		size += rows_[grid].size() * sizeof(uint64);
+
+	return size;
+}
+
+//-------------------------------------------------------------------------------------
+uint64 NavTileGrid::bits_(int grid, int row, int col) const
+{
+	if (row < 0 || row >= rowCount_[grid])
+		return 0;
+
+	const uint64* words = &rows_[grid][row * stride_[grid] + (col >> 6)];
+	int shift = col & 63;
+
+	if (shift == 0)
+		return words[0];
+
+	return (words[0] >> shift) | (words[1] << (64 - shift));
+}
+
+//-------------------------------------------------------------------------------------
+int NavTileGrid::scan_(int grid, int row, int col, int goalCol) const
+{
+	for (int start = col + 1; start < colCount_[grid]; start += 64)
+	{
+		uint64 blocked = ~bits_(grid, row, start);
+
+		// A neighbour row opens up behind a wall: blocked at the tile, walkable at the next one
+		uint64 forced = (~bits_(grid, row - 1, start) & bits_(grid, row - 1, start + 1)) |
+			(~bits_(grid, row + 1, start) & bits_(grid, row + 1, start + 1));
+
+		int firstBlocked = blocked ? countTrailingZeros(blocked) : 64;
+		int firstForced = forced ? countTrailingZeros(forced) : 64;
+
+		if (goalCol >= start && goalCol - start < firstBlocked)
+			firstForced = std::min(firstForced, goalCol - start);
+
+		if (firstForced < firstBlocked)
+			return start + firstForced;
+
+		if (firstBlocked < 64)
+			return -1;
+	}
+
+	return -1;
+}
+
+//-------------------------------------------------------------------------------------
+int NavTileGrid::jumpStraight_(int x, int y, int dx, int dy, int gx, int gy) const
+{
+	int col = -1;
+
+	if (dx > 0)
+	{
+		col = scan_(EAST, y, x, gy == y ? gx : -1);
+		return col < 0 ? -1 : y * width_ + col;
+	}
+	else if (dx < 0)
+	{
+		col = scan_(WEST, y, width_ - 1 - x, gy == y ? width_ - 1 - gx : -1);
+		return col < 0 ? -1 : y * width_ + (width_ - 1 - col);
+	}
+	else if (dy > 0)
+	{
+		col = scan_(SOUTH, x, y, gx == x ? gy : -1);
+		return col < 0 ? -1 : col * width_ + x;
+	}
+
+	col = scan_(NORTH, x, height_ - 1 - y, gx == x ? height_ - 1 - gy : -1);
+	return col < 0 ? -1 : (height_ - 1 - col) * width_ + x;
+}
+
+//-------------------------------------------------------------------------------------
+int NavTileGrid::jump_(int x, int y, int dx, int dy, int gx, int gy) const
+{
+	if (dx == 0 || dy == 0)
+		return jumpStraight_(x, y, dx, dy, gx, gy);
+
+	while (true)
+	{
+		x += dx;
+		y += dy;
+
+		if (!walkable(x, y))
+			return -1;
+
+		int idx = y * width_ + x;
+		if (x == gx && y == gy)
+			return idx;
+
+		if ((walkable(x - dx, y + dy) && !walkable(x - dx, y)) ||
+			(walkable(x + dx, y - dy) && !walkable(x, y - dy)))
+			return idx;
+
+		if (jumpStraight_(x, y, dx, 0, gx, gy) >= 0 || jumpStraight_(x, y, 0, dy, gx, gy) >= 0)
+			return idx;
+	}
+
+	return -1;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavTileGrid::findPathJPS_(int sx, int sy, int gx, int gy) const
+{
+	static const int DIRECTIONS[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+	int32 goal = gy * width_ + gx;
+	int32 start = sy * width_ + sx;
+	s_tileSearch.reach(start, 0.f, octileDistance(sx, sy, gx, gy), -1);
+
+	int32 idx = -1;
+	while ((idx = s_tileSearch.pop()) >= 0)
+	{
+		if (idx == goal)
+			return true;
+
+		int x = idx % width_;
+		int y = idx / width_;
+		int32 parent = s_tileSearch.nodes[idx].parent;
+
+		int dirs[8][2];
+		int ndirs = 0;
+
+		if (parent < 0)
+		{
+			for (int i = 0; i < 8; ++i)
+			{
+				dirs[ndirs][0] = DIRECTIONS[i][0];
+				dirs[ndirs][1] = DIRECTIONS[i][1];
+				++ndirs;
+			}
+		}
+		else
+		{
+			int px = parent % width_;
+			int py = parent / width_;
+			int dx = (x > px) - (x < px);
+			int dy = (y > py) - (y < py);
+
+			dirs[ndirs][0] = dx; dirs[ndirs][1] = dy; ++ndirs;
+
+			if (dx != 0 && dy != 0)
+			{
+				dirs[ndirs][0] = dx; dirs[ndirs][1] = 0; ++ndirs;
+				dirs[ndirs][0] = 0; dirs[ndirs][1] = dy; ++ndirs;
+
+				if (!walkable(x - dx, y))
+				{
+					dirs[ndirs][0] = -dx; dirs[ndirs][1] = dy; ++ndirs;
+				}
+
+				if (!walkable(x, y - dy))
+				{
+					dirs[ndirs][0] = dx; dirs[ndirs][1] = -dy; ++ndirs;
+				}
+			}
+			else if (dx != 0)
+			{
+				if (!walkable(x, y + 1))
+				{
+					dirs[ndirs][0] = dx; dirs[ndirs][1] = 1; ++ndirs;
+				}
+
+				if (!walkable(x, y - 1))
+				{
+					dirs[ndirs][0] = dx; dirs[ndirs][1] = -1; ++ndirs;
+				}
+			}
+			else
+			{
+				if (!walkable(x + 1, y))
+				{
+					dirs[ndirs][0] = 1; dirs[ndirs][1] = dy; ++ndirs;
+				}
+
+				if (!walkable(x - 1, y))
+				{
+					dirs[ndirs][0] = -1; dirs[ndirs][1] = dy; ++ndirs;
+				}
+			}
+		}
+
+		float g = s_tileSearch.nodes[idx].g;
+
+		for (int i = 0; i < ndirs; ++i)
+		{
+			int32 jp = jump_(x, y, dirs[i][0], dirs[i][1], gx, gy);
+			if (jp < 0)
+				continue;
+
+			int jx = jp % width_;
+			int jy = jp / width_;
+			s_tileSearch.reach(jp, g + octileDistance(x, y, jx, jy), octileDistance(jx, jy, gx, gy), idx);
+		}
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavTileGrid::findPath4_(int sx, int sy, int gx, int gy) const
+{
+	static const int DIRECTIONS[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+	int32 goal = gy * width_ + gx;
+	int32 start = sy * width_ + sx;
+	s_tileSearch.reach(start, 0.f, (float)(abs(sx - gx) + abs(sy - gy)), -1);
+
+	int32 idx = -1;
+	while ((idx = s_tileSearch.pop()) >= 0)
+	{
+		if (idx == goal)
+			return true;
+
+		int x = idx % width_;
+		int y = idx / width_;
+		float g = s_tileSearch.nodes[idx].g + 1.f;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			int nx = x + DIRECTIONS[i][0];
+			int ny = y + DIRECTIONS[i][1];
+
+			if (!walkable(nx, ny))
+				continue;
+
+			s_tileSearch.reach(ny * width_ + nx, g, (float)(abs(nx - gx) + abs(ny - gy)), idx);
+		}
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavTileGrid::findPath(int sx, int sy, int gx, int gy, bool direction8, std::vector<POINT>& paths) const
+{
+	if (!walkable(gx, gy) || sx < 0 || sy < 0 || sx >= width_ || sy >= height_)
+		return false;
+
+	if (sx == gx && sy == gy)
+		return true;
+
+	s_tileSearch.reset((size_t)width_ * height_);
+
+	if (!(direction8 ? findPathJPS_(sx, sy, gx, gy) : findPath4_(sx, sy, gx, gy)))
+		return false;
+
+	// Jump points are joined by straight or diagonal lines, they are walked tile by tile as the generic A* did
+	std::vector<POINT> jumpPoints;
+	for (int32 idx = gy * width_ + gx; idx >= 0; idx = s_tileSearch.nodes[idx].parent)
+		jumpPoints.push_back(POINT(idx % width_, idx / width_));
+
+	size_t first = paths.size();
+
+	for (size_t i = jumpPoints.size() - 1; i > 0; --i)
+	{
+		int x = jumpPoints[i].first;
+		int y = jumpPoints[i].second;
+		int tx = jumpPoints[i - 1].first;
+		int ty = jumpPoints[i - 1].second;
+		int dx = (tx > x) - (tx < x);
+		int dy = (ty > y) - (ty < y);
+
+		while (x != tx || y != ty)
+		{
+			x += dx;
+			y += dy;
+			paths.push_back(POINT(x, y));
+		}
+	}
+
+	return paths.size() > first;
+}
+
+//-------------------------------------------------------------------------------------
+}
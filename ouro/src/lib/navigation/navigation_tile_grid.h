@@ -0,0 +1,89 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_NAVIGATETILEGRID_H
+#define OURO_NAVIGATETILEGRID_H
+
+#include "common/common.h"
+#include "common/smartpointer.h"
+
+namespace Ouroboros{
+
+/*
+	The walkable tiles of a tile map layer packed into bits, built once when the map is loaded.
+
+	Layers whose walkable tiles all cost the same are searched with Jump Point Search(8 directions) or
+	a plain grid A*(4 directions) on the bits, layers with different tile costs keep using the generic A*.
+	Straight jumps scan 64 tiles per step, the grid is kept four times(as is, mirrored, transposed and
+	transposed mirrored) so that every straight direction is a scan to the right along a row.
+*/
+class NavTileGrid : public RefCountable
+{
+public:
+	typedef std::pair<int, int> POINT;
+
+	NavTileGrid(int width, int height);
+	virtual ~NavTileGrid();
+
+	int width() const { return width_; }
+	int height() const { return height_; }
+
+	void setWalkable(int x, int y);
+
+	bool walkable(int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= width_ || y >= height_)
+			return false;
+
+		return (rows_[EAST][y * stride_[EAST] + (x >> 6)] >> (x & 63)) & 1;
+	}
+
+	/* Every walkable tile costs the same, only then the grid can be searched */
+	bool uniformCost() const { return uniformCost_; }
+	void uniformCost(bool v) { uniformCost_ = v; }
+
+	/**
+		Finds the tiles from start to goal, the start is not included.
+		Returns false if there is no path.
+	*/
+	bool findPath(int sx, int sy, int gx, int gy, bool direction8, std::vector<POINT>& paths) const;
+
+	size_t memorySize() const;
+
+private:
+	enum GRID
+	{
+		EAST = 0,	// rows y, columns x
+		WEST = 1,	// rows y, columns mirrored x
+		SOUTH = 2,	// rows x, columns y
+		NORTH = 3,	// rows x, columns mirrored y
+		GRID_MAX = 4
+	};
+
+	/* 64 tiles of a row from col on, tiles outside the grid are blocked */
+	uint64 bits_(int grid, int row, int col) const;
+
+	/* The first jump point of a straight move from col(not included) to the right, -1 if there is none */
+	int scan_(int grid, int row, int col, int goalCol) const;
+
+	int jumpStraight_(int x, int y, int dx, int dy, int gx, int gy) const;
+	int jump_(int x, int y, int dx, int dy, int gx, int gy) const;
+
+	bool findPathJPS_(int sx, int sy, int gx, int gy) const;
+	bool findPath4_(int sx, int sy, int gx, int gy) const;
+
+private:
+	int width_;
+	int height_;
+
+	int rowCount_[GRID_MAX];
+	int colCount_[GRID_MAX];
+	int stride_[GRID_MAX];
+	std::vector<uint64> rows_[GRID_MAX];
+
+	bool uniformCost_;
+};
+
+typedef SmartPointer<NavTileGrid> NavTileGridPtr;
+
+}
+#endif // OURO_NAVIGATETILEGRID_H
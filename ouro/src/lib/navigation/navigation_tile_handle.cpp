@@ -28,7 +28,8 @@ static float frand()
 NavTileHandle::NavTileHandle(bool dir):
 NavigationHandle(),
 pTilemap(0),
-direction8_(dir)
+direction8_(dir),
+grids_()
 {
 }
 
@@ -36,7 +37,8 @@ direction8_(dir)
 NavTileHandle::NavTileHandle(const Ouroboros::NavTileHandle & navTileHandle):
 NavigationHandle(),
 pTilemap(0),
-direction8_(navTileHandle.direction8_)
+direction8_(navTileHandle.direction8_),
+grids_(navTileHandle.grids_)
 {
 	pTilemap = new Tmx::Map(*navTileHandle.pTilemap);
 }
@@ -73,6 +75,22 @@ int NavTileHandle::findStraightPath(int layer, const Position3D& start, const Po
 	//DEBUG_MSG(fmt::format("NavTileHandle::findStraightPath: start({}, {}), end({}, {})\n", 
 	//	nodeStart.x, nodeStart.y, nodeGoal.x, nodeGoal.y));
 
+	if (layer < (int)grids_.size() && grids_[layer] && grids_[layer]->uniformCost())
+	{
+		std::vector<NavTileGrid::POINT> points;
+		if (!grids_[layer]->findPath(nodeStart.x, nodeStart.y, nodeGoal.x, nodeGoal.y, direction8_, points))
+		{
+			ERROR_MSG("NavTileHandle::findStraightPath: Search terminated. Did not find goal state\n");
+			return 0;
+		}
+
+		std::vector<NavTileGrid::POINT>::iterator iter = points.begin();
+		for (; iter != points.end(); ++iter)
+			paths.push_back(Position3D((float)iter->first * pTilemap->GetTileWidth(), 0, (float)iter->second * pTilemap->GetTileWidth()));
+
+		return 0;
+	}
+
 	// Set Start and goal states
 	astarsearch.SetStartAndGoalStates(nodeStart, nodeGoal);
 
@@ -382,9 +400,51 @@ NavTileHandle* NavTileHandle::_create(const std::string& res)
 	
 	NavTileHandle* pNavTileHandle = new NavTileHandle(mapdir);
 	pNavTileHandle->pTilemap = map;
+	pNavTileHandle->buildGrids();
 	return pNavTileHandle;
 }
 
+//-------------------------------------------------------------------------------------
+void NavTileHandle::buildGrids()
+{
+	grids_.clear();
+
+	int width = pTilemap->GetWidth();
+	int height = pTilemap->GetHeight();
+
+	for (int layer = 0; layer < pTilemap->GetNumLayers(); ++layer)
+	{
+		Tmx::Layer* pLayer = pTilemap->GetLayer(layer);
+		NavTileGridPtr pGrid(new NavTileGrid(width, height));
+
+		int cost = TILE_STATE_CLOSED;
+		int walkables = 0;
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				int tile = (int)pLayer->GetTile(x, y).id;
+				if (tile >= TILE_STATE_CLOSED)
+					continue;
+
+				// Tiles that cost differently need the generic A*
+				if (walkables++ == 0)
+					cost = tile;
+				else if (tile != cost)
+					pGrid->uniformCost(false);
+
+				pGrid->setWalkable(x, y);
+			}
+		}
+
+		DEBUG_MSG(fmt::format("\t==> layer {} : {} walkable tiles, {}\n", layer, walkables,
+			(pGrid->uniformCost() ? fmt::format("grid search({} bytes)", pGrid->memorySize()) : std::string("tile costs differ, A*"))));
+
+		grids_.push_back(pGrid->uniformCost() ? pGrid : NavTileGridPtr());
+	}
+}
+
 //-------------------------------------------------------------------------------------
 bool NavTileHandle::validTile(int x, int y) const
 {
@@ -4,6 +4,7 @@
 #define OURO_NAVIGATETILEHANDLE_H
 
 #include "navigation/navigation_handle.h"
+#include "navigation/navigation_tile_grid.h"
 
 #include "stlastar.h"
 #include "tmxparser/Tmx.h"
@@ -81,9 +82,17 @@ public:
 	
 	bool validTile(int x, int y) const;
 
+	/**
+		Builds the walkable grids of the layers, the layers with a uniform cost are searched on them
+	*/
+	void buildGrids();
+
 public:
 	Tmx::Map *pTilemap;
 	bool direction8_;
+
+	// Grids by layer, shared by the copies of the map
+	std::vector<NavTileGridPtr> grids_;
 	std::map< int, std::string > params_;
 };
 
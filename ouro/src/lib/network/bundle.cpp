@@ -7,6 +7,7 @@
 #include "network/channel.h"
 #include "helper/profile.h"
 #include "network/packet_sender.h"
+#include "network/websocket_protocol.h"
 
 #ifndef CODE_INLINE
 #include "bundle.inl"
@@ -177,7 +178,8 @@ int32 Bundle::onPacketAppend(int32 addsize, bool inseparable)
 		newPacket();
 	}
 
-	int32 totalsize = (int32)pCurrPacket_->length();
+	// Positions in the buffer, a packet of a websocket channel starts after the room for the frame header
+	int32 totalsize = (int32)pCurrPacket_->wpos();
 	int32 fwpos = (int32)pCurrPacket_->wpos();
 
 	if(inseparable)
@@ -189,7 +191,7 @@ int32 Bundle::onPacketAppend(int32 addsize, bool inseparable)
 		packets_.push_back(pCurrPacket_);
 		currMsgPacketCount_++;
 		newPacket();
-		totalsize = 0;
+		totalsize = (int32)pCurrPacket_->wpos();
 	}
 
 	int32 remainsize = packetMaxSize_ - totalsize;
@@ -208,9 +210,32 @@ Packet* Bundle::newPacket()
 {
 	MALLOC_PACKET(pCurrPacket_, isTCPPacket_);
 	pCurrPacket_->pBundle(this);
+	_reserveFrameHeader(pCurrPacket_);
 	return pCurrPacket_;
 }
 
+//-------------------------------------------------------------------------------------
+void Bundle::_reserveFrameHeader(Packet* pPacket)
+{
+	if (!isTCPPacket_ || pChannel_ == NULL || pChannel_->type() != Channel::CHANNEL_WEB)
+		return;
+
+	if (pPacket->wpos() != 0)
+		return;
+
+	pPacket->wpos(websocket::WebSocketProtocol::SEND_HEADER_RESERVE);
+	pPacket->rpos(websocket::WebSocketProtocol::SEND_HEADER_RESERVE);
+}
+
+//-------------------------------------------------------------------------------------
+void Bundle::pChannel(Channel* p)
+{
+	pChannel_ = p;
+
+	if (pCurrPacket_ && packets_.empty())
+		_reserveFrameHeader(pCurrPacket_);
+}
+
 //-------------------------------------------------------------------------------------
 void Bundle::clear(bool isRecl)
 {
@@ -496,9 +521,9 @@ bool Bundle::revokeMessage(int32 size)
 {
 	if(pCurrPacket_)
 	{
-		if(size >= (int32)pCurrPacket_->wpos())
+		if(size >= (int32)pCurrPacket_->length())
 		{
-			size -= pCurrPacket_->wpos();
+			size -= pCurrPacket_->length();
 			RECLAIM_PACKET(isTCPPacket_, pCurrPacket_);
 			pCurrPacket_ = NULL;
 		}
@@ -512,7 +537,7 @@ bool Bundle::revokeMessage(int32 size)
 	while(size > 0 && packets_.size() > 0)
 	{
 		Network::Packet* pPacket = packets_.back();
-		if(pPacket->wpos() > (size_t)size)
+		if(pPacket->length() > (size_t)size)
 		{
 			pPacket->wpos(pPacket->wpos() - size);
 			size = 0;
@@ -520,7 +545,7 @@ bool Bundle::revokeMessage(int32 size)
 		}
 		else
 		{
-			size -= pPacket->wpos();
+			size -= pPacket->length();
 			RECLAIM_PACKET(isTCPPacket_, pPacket);
 			packets_.pop_back();
 		}
@@ -128,7 +128,10 @@ public:
 
 	Packet* newPacket();
 	
-	INLINE void pChannel(Channel* p);
+	/**
+		If the bundle is still empty, its packet gets the room for the frame header of a websocket channel
+	*/
+	void pChannel(Channel* p);
 	INLINE Channel* pChannel();
 	
 	INLINE MessageID messageID() const;
@@ -151,6 +154,12 @@ public:
 	
 protected:
 	void _calcPacketMaxSize();
+
+	/**
+		Keeps room for the frame header in front of an empty packet of a websocket channel,
+		WebSocketPacketFilter writes the header there instead of copying the packet
+	*/
+	void _reserveFrameHeader(Packet* pPacket);
 	int32 onPacketAppend(int32 addsize, bool inseparable = true);
 
 public:
@@ -98,11 +98,6 @@ INLINE int32 Bundle::numMessages() const
 	return numMessages_; 
 }
 
-INLINE void Bundle::pChannel(Channel* p)
-{
-	pChannel_= p;
-}
-
 INLINE Channel* Bundle::pChannel()
 {
 	return pChannel_;
@@ -22,7 +22,10 @@
 #include "network/udp_packet.h"
 #include "network/message_handler.h"
 #include "network/network_stats.h"
+#include "network/io_thread.h"
 #include "helper/profile.h"
+#include "helper/metrics.h"
+#include "helper/flight_recorder.h"
 #include "common/ssl.h"
 
 namespace Ouroboros { 
@@ -66,7 +69,8 @@ size_t Channel::getPoolObjectBytes()
 		+ sizeof(flags_) + sizeof(numPacketsSent_) + sizeof(numPacketsReceived_) + sizeof(numBytesSent_) + sizeof(numBytesReceived_)
 		+ sizeof(lastTickBytesReceived_) + sizeof(lastTickBytesSent_) + sizeof(pFilter_) + sizeof(pEndPoint_) + sizeof(pPacketReceiver_) + sizeof(pPacketSender_)
 		+ sizeof(proxyID_) + strextra_.size() + sizeof(channelType_)
-		+ sizeof(componentID_) + sizeof(pMsgHandlers_) + condemnReason_.size() + sizeof(kcpUpdateTimerHandle_) + sizeof(pKCP_) + sizeof(hasSetNextKcpUpdate_);
+		+ sizeof(componentID_) + sizeof(pMsgHandlers_) + condemnReason_.size() + sizeof(kcpUpdateTimerHandle_) + sizeof(pKCP_) + sizeof(hasSetNextKcpUpdate_)
+		+ sizeof(pChannelIO_);
 
 	return bytes;
 }
@@ -123,7 +127,11 @@ Channel::Channel(NetworkInterface & networkInterface,
 	pKCP_(NULL),
 	kcpUpdateTimerHandle_(),
 	hasSetNextKcpUpdate_(false),
-	condemnReason_()
+	condemnReason_(),
+	pChannelIO_(NULL),
+	rateBuckets_(),
+	rateLimitDrops_(0),
+	rateLimitDropsTime_(0)
 {
 	this->clearBundle();
 	initialize(networkInterface, pEndPoint, traits, pt, spt, pFilter, id);
@@ -162,7 +170,11 @@ Channel::Channel():
 	pKCP_(NULL),
 	kcpUpdateTimerHandle_(),
 	hasSetNextKcpUpdate_(false),
-	condemnReason_()
+	condemnReason_(),
+	pChannelIO_(NULL),
+	rateBuckets_(),
+	rateLimitDrops_(0),
+	rateLimitDropsTime_(0)
 {
 	this->clearBundle();
 }
@@ -556,8 +568,17 @@ void Channel::clearState( bool warnOnDiscard /*=false*/ )
 	strextra_ = "";
 	channelType_ = CHANNEL_NORMAL;
 	condemnReason_ = "";
+	rateBuckets_.clear();
+	rateLimitDrops_ = 0;
+	rateLimitDropsTime_ = 0;
 
-	if(pEndPoint_ && protocoltype_ == PROTOCOL_TCP && !this->isDestroyed())
+	if (pChannelIO_)
+	{
+		// The I/O thread owns the socket registration, it is taken back before the socket is closed
+		pChannelIO_->ioThread().pool().detach(pChannelIO_);
+		OURO_ASSERT(pChannelIO_ == NULL);
+	}
+	else if(pEndPoint_ && protocoltype_ == PROTOCOL_TCP && !this->isDestroyed())
 	{
 		this->stopSend();
 
@@ -616,6 +637,9 @@ int32 Channel::bundlesLength()
 		len += (*iter)->packetsLength();
 	}
 
+	if (pChannelIO_)
+		len += pChannelIO_->pendingBytes();
+
 	return len;
 }
 
@@ -628,7 +652,8 @@ void Channel::delayedSend()
 //-------------------------------------------------------------------------------------
 const char * Channel::c_str() const
 {
-	static char dodgyString[MAX_BUF * 2] = { "None" };
+	// Also used by the filters on the I/O threads
+	static thread_local char dodgyString[MAX_BUF * 2] = { "None" };
 	char tdodgyString[MAX_BUF] = { 0 };
 
 	if (pEndPoint_ && !pEndPoint_->addr().isNone())
@@ -785,6 +810,17 @@ void Channel::send(Bundle* pBundle)
 	if (bundleSize == 0)
 		return;
 
+	if (pChannelIO_)
+	{
+		Bundles::iterator iter = bundles_.begin();
+		for (; iter != bundles_.end(); ++iter)
+			pChannelIO_->send((*iter));
+
+		bundles_.clear();
+		sendCheck(pChannelIO_->numPendingBundles());
+		return;
+	}
+
 	if (!sending())
 	{
 		if (pPacketSender_ == NULL)
@@ -894,6 +930,9 @@ void Channel::stopSend()
 //-------------------------------------------------------------------------------------
 bool Channel::sending() const 
 {
+	if (pChannelIO_)
+		return pChannelIO_->sending();
+
 	if (pKCP())
 	{
 		return ikcp_waitsnd(pKCP()) > 0;
@@ -948,11 +987,11 @@ void Channel::onPacketSent(int bytes, bool sentCompleted)
 }
 
 //-------------------------------------------------------------------------------------
-void Channel::onPacketReceived(int bytes)
+void Channel::onPacketReceived(int bytes, uint32 numPackets)
 {
 	lastReceivedTime_ = timestamp();
-	++numPacketsReceived_;
-	++g_numPacketsReceived;
+	numPacketsReceived_ += numPackets;
+	g_numPacketsReceived += numPackets;
 
 	if (bytes > 0)
 	{
@@ -987,7 +1026,19 @@ void Channel::onPacketReceived(int bytes)
 void Channel::addReceiveWindow(Packet* pPacket)
 {
 	++lastTickBufferedReceives_; 
+	checkReceiveWindow_();
+
+	OURO_ASSERT(Ouroboros::Network::MessageHandlers::pMainMessageHandlers);
+
+	{
+		AUTO_SCOPED_PROFILE("processRecvMessages");
+		processPackets(Ouroboros::Network::MessageHandlers::pMainMessageHandlers, pPacket);
+	}
+}
 
+//-------------------------------------------------------------------------------------
+void Channel::checkReceiveWindow_()
+{
 	if(Network::g_receiveWindowMessagesOverflowCritical > 0 && lastTickBufferedReceives_ > Network::g_receiveWindowMessagesOverflowCritical)
 	{
 		if(this->isExternal())
@@ -1016,24 +1067,92 @@ void Channel::addReceiveWindow(Packet* pPacket)
 			}
 		}
 	}
-
-	OURO_ASSERT(Ouroboros::Network::MessageHandlers::pMainMessageHandlers);
-
-	{
-		AUTO_SCOPED_PROFILE("processRecvMessages");
-		processPackets(Ouroboros::Network::MessageHandlers::pMainMessageHandlers, pPacket);
-	}
 }
 
 //-------------------------------------------------------------------------------------
 void Channel::condemn(const std::string& reason, bool waitSendCompletedDestroy)
 {
+	// Filters on an I/O thread, the main thread condemns the channel when it takes the error
+	if (pChannelIO_ && IOThreadPool::isIOThread())
+	{
+		pChannelIO_->onError(reason);
+		return;
+	}
+
 	if (condemnReason_.size() == 0)
 		condemnReason_ = reason;
 
 	flags_ |= (waitSendCompletedDestroy ? FLAG_CONDEMN_AND_WAIT_DESTROY : FLAG_CONDEMN);
 }
 
+//-------------------------------------------------------------------------------------
+bool Channel::admitMessage(MessageHandler* pMsgHandler)
+{
+	if (!isExternal() || !g_extRateLimit || 
+		g_componentType == BOTS_TYPE || g_componentType == CLIENT_TYPE)
+		return true;
+
+	// The rest of the batch of a client condemned by its drops is dropped too
+	if (this->condemn() > 0)
+		return false;
+
+	float rate = pMsgHandler->rateLimit;
+	float burst = pMsgHandler->rateBurst;
+
+	if (rate <= 0.f)
+	{
+		if (!pMsgHandler->exposed || g_extRateLimitDefaultRate <= 0.f)
+			return true;
+
+		rate = g_extRateLimitDefaultRate;
+		burst = g_extRateLimitDefaultBurst;
+	}
+
+	if (burst < 1.f)
+		burst = 1.f;
+
+	uint64 now = timestamp();
+
+	std::map<MessageID, RateBucket>::iterator iter = rateBuckets_.find(pMsgHandler->msgID);
+	if (iter == rateBuckets_.end())
+	{
+		RateBucket& bucket = rateBuckets_[pMsgHandler->msgID];
+		bucket.tokens = burst - 1.f;
+		bucket.lastTime = now;
+		return true;
+	}
+
+	RateBucket& bucket = iter->second;
+	bucket.tokens = std::min(burst, bucket.tokens + float((now - bucket.lastTime) / stampsPerSecondD()) * rate);
+	bucket.lastTime = now;
+
+	if (bucket.tokens >= 1.f)
+	{
+		bucket.tokens -= 1.f;
+		return true;
+	}
+
+	++pMsgHandler->dropped_count;
+	++g_numRateLimitDrops;
+
+	if (now - rateLimitDropsTime_ >= stampsPerSecond())
+	{
+		WARNING_MSG(fmt::format("Channel::admitMessage({}): {} exceeds the rate limit({}/s, burst={}), dropped.\n",
+			this->c_str(), pMsgHandler->name, rate, burst));
+
+		rateLimitDrops_ = 0;
+		rateLimitDropsTime_ = now;
+	}
+
+	if (++rateLimitDrops_ > g_extRateLimitCondemnDrops && g_extRateLimitCondemnDrops > 0)
+	{
+		this->condemn(fmt::format("Channel::admitMessage: dropped more than {} messages within a second!", 
+			g_extRateLimitCondemnDrops));
+	}
+
+	return false;
+}
+
 //-------------------------------------------------------------------------------------
 bool Channel::handshake(Packet* pPacket)
 {
@@ -1068,7 +1187,9 @@ bool Channel::handshake(Packet* pPacket)
 		if (websocket::WebSocketProtocol::isWebSocketProtocol(pPacket))
 		{
 			channelType_ = CHANNEL_WEB;
-			if (websocket::WebSocketProtocol::handshake(this, pPacket))
+
+			int deflateWindowBits = 0;
+			if (websocket::WebSocketProtocol::handshake(this, pPacket, deflateWindowBits))
 			{
 				if (!pPacketReader_ || pPacketReader_->type() != PacketReader::PACKET_READER_TYPE_WEBSOCKET)
 				{
@@ -1076,7 +1197,7 @@ bool Channel::handshake(Packet* pPacket)
 					pPacketReader_ = new WebSocketPacketReader(this);
 				}
 
-				pFilter_ = new WebSocketPacketFilter(this);
+				pFilter_ = new WebSocketPacketFilter(this, deflateWindowBits);
 				DEBUG_MSG(fmt::format("Channel::handshake: websocket({}) successfully!\n", this->c_str()));
 
 				// return true anyway, until the handshake is successful
@@ -1136,6 +1257,9 @@ bool Channel::handshake(Packet* pPacket)
 //-------------------------------------------------------------------------------------
 void Channel::updateTick(Ouroboros::Network::MessageHandlers* pMsgHandlers)
 {
+	if (pChannelIO_)
+		updateIOStats_();
+
 	lastTickBytesReceived_ = 0;
 	lastTickBytesSent_ = 0;
 	lastTickBufferedReceives_ = 0;
@@ -1197,6 +1321,95 @@ void Channel::processPackets(Ouroboros::Network::MessageHandlers* pMsgHandlers,
 	RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
 }
 
+//-------------------------------------------------------------------------------------
+void Channel::updateIOStats_()
+{
+	uint32 recvPackets = 0, recvBytes = 0, sentPackets = 0, sentBytes = 0;
+	pChannelIO_->takeStats(recvPackets, recvBytes, sentPackets, sentBytes);
+
+	if (recvPackets > 0)
+	{
+		onPacketReceived((int)recvBytes, recvPackets);
+
+		lastTickBufferedReceives_ += recvPackets;
+		checkReceiveWindow_();
+	}
+
+	if (sentBytes > 0)
+		onPacketSent((int)sentBytes, false);
+
+	numPacketsSent_ += sentPackets;
+	g_numPacketsSent += sentPackets;
+}
+
+//-------------------------------------------------------------------------------------
+void Channel::processIOMessages()
+{
+	ChannelIO* pChannelIO = pChannelIO_;
+	if (pChannelIO == NULL)
+		return;
+
+	updateIOStats_();
+
+	Ouroboros::Network::MessageHandlers* pMsgHandlers = pMsgHandlers_ != NULL ? 
+		pMsgHandlers_ : Ouroboros::Network::MessageHandlers::pMainMessageHandlers;
+
+	AUTO_SCOPED_PROFILE("processRecvMessages");
+
+	ChannelIO::MESSAGE msg;
+
+	// A handler may condemn or destroy the channel, the rest of the messages are dropped then
+	while (pChannelIO_ == pChannelIO && !isDestroyed() && condemn() == 0 && pChannelIO->popMessage(msg))
+	{
+		// Framed with the handlers the channel had when it was attached
+		Network::MessageHandler* pMsgHandler = pMsgHandlers->find(msg.msgID);
+		if (pMsgHandler == NULL)
+		{
+			MemoryStream::reclaimPoolObject(msg.pStream);
+			condemn(fmt::format("Channel::processIOMessages: not found msgID={}", msg.msgID));
+			break;
+		}
+
+		NetworkStats::getSingleton().trackMessage(NetworkStats::RECV, *pMsgHandler, 
+			(uint32)msg.pStream->length() + msg.headerSize);
+
+		TRACE_MESSAGE_PACKET(true, msg.pStream, pMsgHandler, msg.pStream->length(), this->c_str(), false);
+
+		try
+		{
+			if (admitMessage(pMsgHandler))
+			{
+				ScopedMessageHandleTimer handleTimer(*pMsgHandler);
+				ScopedFlightEvent flightEvent(pMsgHandler->name.c_str());
+				pMsgHandler->handle(this, *msg.pStream);
+			}
+		}
+		catch(MemoryStreamException &)
+		{
+			WARNING_MSG(fmt::format("Channel::processIOMessages({}): packet invalid. currMsg=({}, id={}, len={}), currMsgLen={}\n",
+				this->c_str(), pMsgHandler->name, msg.msgID, pMsgHandler->msgLen, msg.pStream->length()));
+
+			condemn("Channel::processIOMessages: packet invalid!");
+		}
+
+		MemoryStream::reclaimPoolObject(msg.pStream);
+	}
+
+	std::string reason;
+	if (pChannelIO_ == pChannelIO && pChannelIO->takeError(reason))
+		condemn(reason);
+}
+
+//-------------------------------------------------------------------------------------
+void Channel::pFilter(PacketFilterPtr pFilter)
+{
+	pFilter_ = pFilter;
+
+	// Bundles already queued keep the filter they were queued with
+	if (pChannelIO_)
+		pChannelIO_->pFilter(pFilter);
+}
+
 //-------------------------------------------------------------------------------------
 bool Channel::waitSend()
 {
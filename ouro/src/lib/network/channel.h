@@ -26,8 +26,10 @@ namespace Network
 class Bundle;
 class NetworkInterface;
 class MessageHandlers;
+class MessageHandler;
 class PacketReader;
 class PacketSender;
+class ChannelIO;
 
 class Channel : public TimerHandler, public PoolObject
 {
@@ -95,7 +97,7 @@ public:
 	void stopInactivityDetection();
 
 	PacketFilterPtr pFilter() const { return pFilter_; }
-	void pFilter(PacketFilterPtr pFilter) { pFilter_ = pFilter; }
+	void pFilter(PacketFilterPtr pFilter);
 
 	void destroy();
 	bool isDestroyed() const { return (flags_ & FLAG_DESTROYED) > 0; }
@@ -147,7 +149,7 @@ public:
 	bool isExternal() const { return traits_ == EXTERNAL; }
 	bool isInternal() const { return traits_ == INTERNAL; }
 		
-	void onPacketReceived(int bytes);
+	void onPacketReceived(int bytes, uint32 numPackets = 1);
 	void onPacketSent(int bytes, bool sentCompleted);
 	void onSendCompleted();
 
@@ -170,6 +172,17 @@ public:
 	void updateTick(Ouroboros::Network::MessageHandlers* pMsgHandlers);
 	void processPackets(Ouroboros::Network::MessageHandlers* pMsgHandlers, Packet* pPacket);
 
+	/**
+		Runs the handlers of the messages an I/O thread has framed for this channel
+	*/
+	void processIOMessages();
+
+	/**
+		Not NULL while the socket is served by an I/O thread(channelCommon->ioThreads)
+	*/
+	ChannelIO* pChannelIO() const { return pChannelIO_; }
+	void pChannelIO(ChannelIO* pChannelIO) { pChannelIO_ = pChannelIO; }
+
 	uint32 condemn() const
 	{
 		if ((flags_ & FLAG_CONDEMN_AND_DESTROY) > 0)
@@ -205,6 +218,12 @@ public:
 
 	bool handshake(Packet* pPacket);
 
+	/**
+		Takes a token of the message's bucket before the message is handled, false if the message has to be dropped.
+		Only the messages of clients are limited, a client that keeps exceeding the limits is condemned.
+	*/
+	bool admitMessage(MessageHandler* pMsgHandler);
+
 	Ouroboros::Network::MessageHandlers* pMsgHandlers() const { return pMsgHandlers_; }
 	void pMsgHandlers(Ouroboros::Network::MessageHandlers* pMsgHandlers) { pMsgHandlers_ = pMsgHandlers; }
 
@@ -254,6 +273,9 @@ private:
 	void clearState( bool warnOnDiscard = false );
 	EventDispatcher & dispatcher();
 
+	void checkReceiveWindow_();
+	void updateIOStats_();
+
 private:
 	NetworkInterface * 			pNetworkInterface_;
 
@@ -310,6 +332,21 @@ private:
 	bool						hasSetNextKcpUpdate_;
 
 	std::string					condemnReason_;
+
+	ChannelIO*					pChannelIO_;
+
+	struct RateBucket
+	{
+		float tokens;
+		uint64 lastTime;
+	};
+
+	// Token buckets of the rate limited messages
+	std::map<MessageID, RateBucket> rateBuckets_;
+
+	// Messages dropped within the current second
+	uint32						rateLimitDrops_;
+	uint64						rateLimitDropsTime_;
 };
 
 }
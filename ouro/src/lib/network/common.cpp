@@ -45,6 +45,7 @@ uint64						g_numPacketsSent = 0;
 uint64						g_numPacketsReceived = 0;
 uint64						g_numBytesSent = 0;
 uint64						g_numBytesReceived = 0;
+uint64						g_numRateLimitDrops = 0;
 
 uint32						g_receiveWindowMessagesOverflowCritical = 32;
 uint32						g_intReceiveWindowMessagesOverflow = 65535;
@@ -70,12 +71,33 @@ uint32						g_extReSendRetries = 3;
 std::string					g_sslCertificate = "";
 std::string					g_sslPrivateKey = "";
 
+uint32						g_ioThreads = 0;
+
+bool						g_extRateLimit = false;
+float						g_extRateLimitDefaultRate = 0.f;
+float						g_extRateLimitDefaultBurst = 0.f;
+uint32						g_extRateLimitCondemnDrops = 100;
+std::map< std::string, std::pair<float, float> > g_extRateLimits;
+
+uint32						g_httpMaxHostConnections = 8;
+uint32						g_httpMaxConnections = 64;
+uint32						g_httpMaxCachedConnections = 32;
+bool						g_httpPipelining = true;
+uint32						g_httpTimeout = 0;
+
+bool						g_websocketDeflate = false;
+uint32						g_websocketDeflateMinSize = 128;
+
 bool initializeWatcher()
 {
 	WATCH_OBJECT("network/numPacketsSent", g_numPacketsSent);
 	WATCH_OBJECT("network/numPacketsReceived", g_numPacketsReceived);
 	WATCH_OBJECT("network/numBytesSent", g_numBytesSent);
 	WATCH_OBJECT("network/numBytesReceived", g_numBytesReceived);
+	WATCH_OBJECT("network/numRateLimitDrops", g_numRateLimitDrops);
+
+	if(!Http::initializeWatcher())
+		return false;
 	
 	std::vector<MessageHandlers*>::iterator iter = MessageHandlers::messageHandlers().begin();
 	for(; iter != MessageHandlers::messageHandlers().end(); ++iter)
@@ -87,6 +109,18 @@ bool initializeWatcher()
 	return true;
 }
 
+bool initializeMetrics()
+{
+	std::vector<MessageHandlers*>::iterator iter = MessageHandlers::messageHandlers().begin();
+	for(; iter != MessageHandlers::messageHandlers().end(); ++iter)
+	{
+		if(!(*iter)->initializeMetrics())
+			return false;
+	}
+
+	return true;
+}
+
 void destroyObjPool()
 {
 	Bundle::destroyObjPool();
@@ -60,6 +60,29 @@ extern bool g_rudp_nodelay;
 extern std::string g_sslCertificate;
 extern std::string g_sslPrivateKey;
 
+// Number of threads that serve the sockets of external tcp channels, 0 keeps them on the main thread
+extern uint32 g_ioThreads;
+
+// Rate limits of the messages of external channels
+extern bool g_extRateLimit;
+extern float g_extRateLimitDefaultRate;
+extern float g_extRateLimitDefaultBurst;
+extern uint32 g_extRateLimitCondemnDrops;
+
+// Messages per second and burst by message name(e.g. Baseapp::login), they replace the declared ones
+extern std::map< std::string, std::pair<float, float> > g_extRateLimits;
+
+// The http client of the app(Http::perform, Ouroboros.urlopen), 0: no limit
+extern uint32 g_httpMaxHostConnections;
+extern uint32 g_httpMaxConnections;
+extern uint32 g_httpMaxCachedConnections;
+extern bool g_httpPipelining;
+extern uint32 g_httpTimeout;
+
+// permessage-deflate of websocket channels, packets shorter than g_websocketDeflateMinSize are sent as they are
+extern bool g_websocketDeflate;
+extern uint32 g_websocketDeflateMinSize;
+
 // Do not do channel timeout check
 #define CLOSE_CHANNEL_INACTIVITIY_DETECTION()										\
 {																					\
@@ -296,7 +319,7 @@ const char * reasonToString(Reason reason)
 #define SEND_BUNDLE(ENDPOINT, BUNDLE)																		\
 {																											\
 	EndPoint& ep = ENDPOINT;																				\
-	SEND_BUNDLE_COMMON(ENDPOINT.send(pPacket->data() + pPacket->sentSize,									\
+	SEND_BUNDLE_COMMON(ENDPOINT.send(pPacket->data() + pPacket->rpos() + pPacket->sentSize,				\
 	pPacket->length() - pPacket->sentSize), BUNDLE);														\
 }																											\
 
@@ -304,7 +327,7 @@ const char * reasonToString(Reason reason)
 #define SENDTO_BUNDLE(ENDPOINT, ADDR, PORT, BUNDLE)															\
 {																											\
 	EndPoint& ep = ENDPOINT;																				\
-	SEND_BUNDLE_COMMON(ENDPOINT.sendto(pPacket->data() + pPacket->sentSize,									\
+	SEND_BUNDLE_COMMON(ENDPOINT.sendto(pPacket->data() + pPacket->rpos() + pPacket->sentSize,				\
 	pPacket->length() - pPacket->sentSize, PORT, ADDR), BUNDLE);											\
 }																											\
 
@@ -404,6 +427,7 @@ extern uint64						g_numPacketsSent;
 extern uint64						g_numPacketsReceived;
 extern uint64						g_numBytesSent;
 extern uint64						g_numBytesReceived;
+extern uint64						g_numRateLimitDrops;
 
 // packet receiving window overflow
 extern uint32						g_receiveWindowMessagesOverflowCritical;
@@ -421,6 +445,7 @@ extern uint32						g_intSentWindowBytesOverflow;
 extern uint32						g_extSentWindowBytesOverflow;
 
 bool initializeWatcher();
+bool initializeMetrics();
 bool initialize();
 void finalise(void);
 
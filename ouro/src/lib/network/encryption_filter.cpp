@@ -14,6 +14,12 @@ namespace Ouroboros {
 namespace Network
 {
 
+#if ENABLE_WATCHERS
+// Created at startup on the main thread, the filters also run on the network I/O threads
+static ProfileVal g_encryptSendProfile("encryptSend");
+static ProfileVal g_encryptRecvProfile("encryptRecv");
+#endif
+
 //-------------------------------------------------------------------------------------
 BlowfishFilter::BlowfishFilter(const Key & key):
 OUROBlowfish(key),
@@ -47,7 +53,7 @@ Reason BlowfishFilter::send(Channel * pChannel, PacketSender& sender, Packet * p
 {
 	if(!pPacket->encrypted())
 	{
-		AUTO_SCOPED_PROFILE("encryptSend")
+		SCOPED_PROFILE(g_encryptSendProfile)
 		
 		if (!isGood_)
 		{
@@ -111,7 +117,7 @@ Reason BlowfishFilter::recv(Channel * pChannel, PacketReceiver & receiver, Packe
 {
 	while(pPacket || pPacket_)
 	{
-		AUTO_SCOPED_PROFILE("encryptRecv")
+		SCOPED_PROFILE(g_encryptRecvProfile)
 
 		if (!isGood_)
 		{
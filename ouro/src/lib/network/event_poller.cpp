@@ -18,7 +18,8 @@ namespace Network
 EventPoller::EventPoller() : 
 	fdReadHandlers_(), 
 	fdWriteHandlers_(), 
-	spareTime_(0)
+	spareTime_(0),
+	isMainThread_(true)
 {
 }
 
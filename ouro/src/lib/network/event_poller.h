@@ -39,6 +39,12 @@ public:
 
 	static EventPoller * create();
 
+	/**
+		Pollers of other threads(network I/O threads) must not touch the idle profile of the main thread
+	*/
+	bool isMainThread() const	{ return isMainThread_; }
+	void isMainThread(bool v)	{ isMainThread_ = v; }
+
 	InputNotificationHandler* findForRead(int fd);
 	OutputNotificationHandler* findForWrite(int fd);
 
@@ -63,6 +69,7 @@ private:
 
 protected:
 	uint64 spareTime_;
+	bool isMainThread_;
 };
 
 }
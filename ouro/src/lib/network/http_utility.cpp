@@ -4,7 +4,9 @@
 #include "http_utility.h"
 #include "curl/curl.h"
 #include "helper/debug_helper.h"
+#include "helper/watcher.h"
 #include "common/memorystream.h"
+#include "network/common.h"
 #include "network/event_dispatcher.h"
 #include "network/network_interface.h"
 
@@ -49,6 +51,21 @@ void finalise()
 		curl_global_cleanup();
 }
 
+//-------------------------------------------------------------------------------------
+bool initializeWatcher()
+{
+	if (!g_pRequests)
+		return true;
+
+	WATCH_OBJECT("network/http/numRunning", g_pRequests, &Requests::numRunning);
+	WATCH_OBJECT("network/http/numRequests", g_pRequests, &Requests::numRequests);
+	WATCH_OBJECT("network/http/numFailed", g_pRequests, &Requests::numFailed);
+	WATCH_OBJECT("network/http/lastLatency", g_pRequests, &Requests::lastLatency);
+	WATCH_OBJECT("network/http/avgLatency", g_pRequests, &Requests::avgLatency);
+	WATCH_OBJECT("network/http/maxLatency", g_pRequests, &Requests::maxLatency);
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 Request::Request():
 	pContext_(NULL),
@@ -81,6 +98,16 @@ Request::Request():
 
 	curl_easy_setopt((CURL*)pContext_, CURLOPT_CONNECTTIMEOUT_MS, 0);
 
+	// The connection stays in the cache of the client after the request and is reused by the next one to the host
+	curl_easy_setopt((CURL*)pContext_, CURLOPT_TCP_KEEPALIVE, 1L);
+
+	// Waits for a connection that can take one more request rather than opening a new one
+	if (g_httpPipelining)
+		curl_easy_setopt((CURL*)pContext_, CURLOPT_PIPEWAIT, 1L);
+
+	if (g_httpTimeout > 0)
+		curl_easy_setopt((CURL*)pContext_, CURLOPT_TIMEOUT, (long)g_httpTimeout);
+
 	OURO_ASSERT(sizeof(error_) >= CURL_ERROR_SIZE);
 	curl_easy_setopt((CURL*)pContext_, CURLOPT_ERRORBUFFER, error_);
 
@@ -486,35 +513,20 @@ size_t Request::receiveContentFunction(char *ptr, size_t size, size_t nmemb, voi
 //-------------------------------------------------------------------------------------
 Request::Status Request::perform()
 {
-	CURLcode curlCode = CURLE_OK;
-
 	if (!hasSetRedirect_)
 	{
 		Request::Status status = setFollowURL(5);
 		if (OK != status)
+		{
+			delete this;
 			return status;
+		}
 	}
 
 	receivedContent_.clear();
 	receivedHeader_.clear();
 
-	int retryTimes = retryTimes_;
-	do
-	{
-		curlCode = curl_easy_perform((CURL*)pContext_);
-
-		if (curlCode != CURLE_OPERATION_TIMEDOUT)
-			break;
-
-	} while (retryTimes-- > 0);
-
-	callCallback(true);
-
-	if (headers_)
-		curl_slist_free_all((curl_slist *)headers_);
-
-	headers_ = NULL;
-	return OK;
+	return Http::perform(this);
 }
 
 //-------------------------------------------------------------------------------------
@@ -597,6 +609,10 @@ static void check_multi_info(Requests *g)
 
 			//DEBUG_MSG(fmt::format("check_multi_info: DONE: {} => ({}) {}\n", eff_url, msg->data.result, pRequest->getError()));
 
+			double totalTime = 0.0;
+			curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME, &totalTime);
+			g->onRequestDone(msg->data.result == CURLE_OK, float(totalTime * 1000.0));
+
 			curl_multi_remove_handle((CURLM*)g->pContext(), easy);
 			pRequest->callCallback(true);
 			delete pRequest;
@@ -801,7 +817,13 @@ Requests::Requests() :
 	still_running(0),
 	pRequest(NULL),
 	timerHandle(),
-	pContext_(NULL)
+	pContext_(NULL),
+	numRunning_(0),
+	numRequests_(0),
+	numFailed_(0),
+	lastLatency_(0.f),
+	avgLatency_(0.f),
+	maxLatency_(0.f)
 {
 	pContext_ = (void*)curl_multi_init();
 
@@ -809,6 +831,16 @@ Requests::Requests() :
 	curl_multi_setopt((CURLM*)pContext_, CURLMOPT_SOCKETDATA, this);
 	curl_multi_setopt((CURLM*)pContext_, CURLMOPT_TIMERFUNCTION, multi_timer_cb);
 	curl_multi_setopt((CURLM*)pContext_, CURLMOPT_TIMERDATA, this);
+
+	// Requests over the limits are queued by curl until a connection is free
+	curl_multi_setopt((CURLM*)pContext_, CURLMOPT_MAX_HOST_CONNECTIONS, (long)g_httpMaxHostConnections);
+	curl_multi_setopt((CURLM*)pContext_, CURLMOPT_MAX_TOTAL_CONNECTIONS, (long)g_httpMaxConnections);
+
+	if (g_httpMaxCachedConnections > 0)
+		curl_multi_setopt((CURLM*)pContext_, CURLMOPT_MAXCONNECTS, (long)g_httpMaxCachedConnections);
+
+	if (g_httpPipelining)
+		curl_multi_setopt((CURLM*)pContext_, CURLMOPT_PIPELINING, CURLPIPE_HTTP1 | CURLPIPE_MULTIPLEX);
 }
 
 //-------------------------------------------------------------------------------------
@@ -833,9 +865,27 @@ Request::Status Requests::perform(Request* pRequest)
 		return Request::INVALID_OPT;
 	}
 
+	++numRunning_;
 	return Request::OK;
 }
 
+//-------------------------------------------------------------------------------------
+void Requests::onRequestDone(bool success, float latency)
+{
+	OURO_ASSERT(numRunning_ > 0);
+	--numRunning_;
+
+	++numRequests_;
+	if (!success)
+		++numFailed_;
+
+	lastLatency_ = latency;
+	avgLatency_ = numRequests_ == 1 ? latency : (avgLatency_ * 0.9f + latency * 0.1f);
+
+	if (latency > maxLatency_)
+		maxLatency_ = latency;
+}
+
 //-------------------------------------------------------------------------------------
 Request::Status Requests::perform(const std::string& url, const Request::Callback& resultCallback, 
 	const std::map<std::string, std::string>& headers)
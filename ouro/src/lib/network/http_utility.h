@@ -135,6 +135,10 @@ namespace Http
 
 		void callCallback(bool success);
 
+		/**
+			Hands the request to the shared client(see Requests) instead of blocking the thread,
+			the callback is called on the main thread and the request is deleted afterwards
+		*/
 		Status perform();
 
 		int getHttpCode() const { return httpCode_; }
@@ -184,12 +188,31 @@ namespace Http
 		std::string url_;
 	};
 
+	/*
+		The http client shared by the app, all requests run on one curl multi handle driven by the event dispatcher.
+		Connections are kept alive and reused by later requests to the same host, requests over the
+		per-host or total connection limits wait in the client until a connection is free.
+	*/
 	class Requests : public TimerHandler
 	{
 	public:
 		Requests();
 		~Requests();
 
+		/**
+			Called when a request is done, success is false if the transfer failed(not the http code)
+		*/
+		void onRequestDone(bool success, float latency);
+
+		uint32 numRunning() const { return numRunning_; }
+		uint64 numRequests() const { return numRequests_; }
+		uint64 numFailed() const { return numFailed_; }
+
+		// milliseconds
+		float lastLatency() const { return lastLatency_; }
+		float avgLatency() const { return avgLatency_; }
+		float maxLatency() const { return maxLatency_; }
+
 		/*
 			http async-request
 		*/
@@ -213,8 +236,19 @@ namespace Http
 	private:
 		void* pContext_;
 
+		// Added and not done yet, including the requests waiting for a connection
+		uint32 numRunning_;
+
+		uint64 numRequests_;
+		uint64 numFailed_;
+
+		float lastLatency_;
+		float avgLatency_;
+		float maxLatency_;
 	};
 
+	bool initializeWatcher();
+
 	Request::Status perform(Request* pRequest);
 	Request::Status perform(const std::string& url, const Request::Callback& resultCallback, 
 		const std::map<std::string, std::string>& headers = std::map<std::string, std::string>());
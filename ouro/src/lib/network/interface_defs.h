@@ -49,6 +49,7 @@ namespace Network
 
 	#undef NETWORK_MESSAGE_HANDLER
 	#undef NETWORK_MESSAGE_EXPOSED
+	#undef NETWORK_MESSAGE_RATE_LIMIT
 	#undef NETWORK_INTERFACE_DECLARE_END
 	
 	#undef MESSAGE_STREAM
@@ -92,12 +93,18 @@ namespace Network
 	#define NETWORK_MESSAGE_EXPOSED(DOMAIN, NAME);														\
 		bool p##DOMAIN##NAME##_exposed = messageHandlers.pushExposedMessage(#DOMAIN"::"#NAME);			\
 
+	#define NETWORK_MESSAGE_RATE_LIMIT(DOMAIN, NAME, RATE, BURST)										\
+		bool p##DOMAIN##NAME##_rateLimit = messageHandlers.pushMessageRateLimit(#DOMAIN"::"#NAME,		\
+						RATE, BURST);																	\
+
 #else
 	#define NETWORK_MESSAGE_HANDLER(DOMAIN, NAME, HANDLER_TYPE, MSG_LENGTH, ARG_N)						\
 		extern const HANDLER_TYPE& NAME;																\
 
 	#define NETWORK_MESSAGE_EXPOSED(DOMAIN, NAME)														\
 	
+	#define NETWORK_MESSAGE_RATE_LIMIT(DOMAIN, NAME, RATE, BURST)										\
+	
 #endif
 
 // Define the interface domain name
@@ -0,0 +1,1085 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+
+#include "io_thread.h"
+#include "network/bundle.h"
+#include "network/channel.h"
+#include "network/event_dispatcher.h"
+#include "network/event_poller.h"
+#include "network/message_handler.h"
+#include "network/network_interface.h"
+#include "network/packet_reader.h"
+#include "network/tcp_packet.h"
+#include "network/udp_packet.h"
+#include "helper/profile.h"
+#include "thread/threadmutex.h"
+#include <algorithm>
+
+namespace Ouroboros {
+namespace Network
+{
+
+static thread_local bool g_isIOThread = false;
+
+//-------------------------------------------------------------------------------------
+IOWakeup::IOWakeup(IOThreadPool* pPool):
+pPool_(pPool),
+endpoint_(),
+port_(0),
+addr_(0),
+pending_(false)
+{
+}
+
+//-------------------------------------------------------------------------------------
+IOWakeup::~IOWakeup()
+{
+	finalise();
+}
+
+//-------------------------------------------------------------------------------------
+bool IOWakeup::initialize()
+{
+	endpoint_.socket(SOCK_DGRAM);
+	if (!endpoint_.good())
+	{
+		ERROR_MSG(fmt::format("IOWakeup::initialize: couldn't create a socket! {}\n", ouro_strerror()));
+		return false;
+	}
+
+	endpoint_.setnonblocking(true);
+
+	if (endpoint_.bind(0, htonl(INADDR_LOOPBACK)) == -1 ||
+		endpoint_.getlocaladdress(&port_, &addr_) == -1)
+	{
+		ERROR_MSG(fmt::format("IOWakeup::initialize: bind is failed! {}\n", ouro_strerror()));
+		endpoint_.close();
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOWakeup::finalise()
+{
+	if (endpoint_.good())
+		endpoint_.close();
+}
+
+//-------------------------------------------------------------------------------------
+void IOWakeup::wake()
+{
+	if (pending_.exchange(true))
+		return;
+
+	char c = 0;
+	endpoint_.sendto(&c, 1, port_, addr_);
+}
+
+//-------------------------------------------------------------------------------------
+int IOWakeup::handleInputNotification(int fd)
+{
+	// Cleared first, a wake() from now on sends a new datagram
+	pending_.store(false);
+
+	char buffer[64];
+	while (endpoint_.recvfrom(buffer, sizeof(buffer), NULL, NULL) > 0)
+	{
+	}
+
+	if (pPool_)
+		pPool_->processReady();
+
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------
+IOPacketReceiver::IOPacketReceiver(ChannelIO& channelIO, EndPoint& endpoint, NetworkInterface& networkInterface):
+PacketReceiver(endpoint, networkInterface),
+channelIO_(channelIO)
+{
+}
+
+//-------------------------------------------------------------------------------------
+IOPacketReceiver::~IOPacketReceiver()
+{
+}
+
+//-------------------------------------------------------------------------------------
+Reason IOPacketReceiver::processPacket(Channel* pChannel, Packet* pPacket)
+{
+	// Channel::onPacketReceived belongs to the main thread, ChannelIO counts the bytes instead
+	return PacketReceiver::processPacket(NULL, pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+Reason IOPacketReceiver::processFilteredPacket(Channel* pChannel, Packet* pPacket)
+{
+	if (pPacket)
+		channelIO_.processFilteredPacket(pPacket);
+
+	return REASON_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------
+Channel* IOPacketReceiver::getChannel()
+{
+	return channelIO_.pChannel();
+}
+
+//-------------------------------------------------------------------------------------
+bool IOPacketReceiver::processRecv(bool expectingPacket)
+{
+	return channelIO_.processRecv(expectingPacket);
+}
+
+//-------------------------------------------------------------------------------------
+PacketReceiver::RecvState IOPacketReceiver::checkSocketErrors(int len, bool expectingPacket)
+{
+#if OURO_PLATFORM == PLATFORM_WIN32
+	DWORD wsaErr = WSAGetLastError();
+
+	if (wsaErr == WSAEWOULDBLOCK)
+		return RECV_STATE_BREAK;
+
+	if (wsaErr == WSAEINTR)
+		return RECV_STATE_CONTINUE;
+#else
+	if (errno == EAGAIN || errno == EWOULDBLOCK)
+		return RECV_STATE_BREAK;
+
+	if (errno == EINTR)
+		return RECV_STATE_CONTINUE;
+#endif
+
+	return RECV_STATE_INTERRUPT;
+}
+
+//-------------------------------------------------------------------------------------
+IOPacketSender::IOPacketSender(ChannelIO& channelIO, EndPoint& endpoint, NetworkInterface& networkInterface):
+PacketSender(endpoint, networkInterface),
+channelIO_(channelIO)
+{
+}
+
+//-------------------------------------------------------------------------------------
+IOPacketSender::~IOPacketSender()
+{
+}
+
+//-------------------------------------------------------------------------------------
+Reason IOPacketSender::processFilterPacket(Channel* pChannel, Packet* pPacket, int userarg)
+{
+	return channelIO_.processFilterPacket(pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+bool IOPacketSender::processSend(Channel* pChannel, int userarg)
+{
+	return channelIO_.processSend();
+}
+
+//-------------------------------------------------------------------------------------
+Channel* IOPacketSender::getChannel()
+{
+	return channelIO_.pChannel();
+}
+
+//-------------------------------------------------------------------------------------
+ChannelIO::ChannelIO(IOThread& ioThread, Channel* pChannel, PacketFilterPtr pFilter, MessageHandlers* pMsgHandlers):
+ioThread_(ioThread),
+pChannel_(pChannel),
+pEndPoint_(pChannel->pEndPoint()),
+pMsgHandlers_(pMsgHandlers),
+state_(STATE_ATTACHING),
+messages_(),
+queued_(false),
+recvPackets_(0),
+recvBytes_(0),
+sentPackets_(0),
+sentBytes_(0),
+hasError_(false),
+errorReason_(),
+errorTaken_(false),
+outbound_(),
+sendQueued_(false),
+numPendingBundles_(0),
+pendingBytes_(0),
+retiredFilters_(),
+pFilter_(pFilter.get()),
+receiver_(*this, *pChannel->pEndPoint(), pChannel->networkInterface()),
+sender_(*this, *pChannel->pEndPoint(), pChannel->networkInterface()),
+pPoller_(NULL),
+readRegistered_(false),
+writeRegistered_(false),
+frameBuffer_(),
+frameState_(FRAME_MESSAGE_ID),
+pCurrMsgHandler_(NULL),
+currMsgID_(0),
+currMsgLen_(0),
+currHeaderSize_(0),
+sendingBundles_(),
+sendfailCount_(0)
+{
+	// The channel keeps the filter alive, the I/O thread only uses the pointer
+	retiredFilters_.push_back(pFilter);
+}
+
+//-------------------------------------------------------------------------------------
+ChannelIO::~ChannelIO()
+{
+	clearMessages();
+	releaseOutbound_();
+	retiredFilters_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+bool ChannelIO::popMessage(MESSAGE& msg)
+{
+	return messages_.pop(msg);
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::clearMessages()
+{
+	MESSAGE msg;
+	while (messages_.pop(msg))
+		MemoryStream::reclaimPoolObject(msg.pStream);
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::send(Bundle* pBundle)
+{
+	OUTBOUND outbound;
+	outbound.pBundle = pBundle;
+	outbound.pFilter = NULL;
+	outbound.length = (uint32)pBundle->packetsLength();
+
+	pendingBytes_.fetch_add(outbound.length, std::memory_order_relaxed);
+	numPendingBundles_.fetch_add(1, std::memory_order_release);
+	outbound_.push(outbound);
+
+	if (!sendQueued_.exchange(true))
+		ioThread_.pushCommand(IOThread::COMMAND_SEND, this);
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::pFilter(PacketFilterPtr pFilter)
+{
+	// Queued with the bundles, bundles sent before the change(e.g. onHelloCB) keep the old filter
+	OUTBOUND outbound;
+	outbound.pBundle = NULL;
+	outbound.pFilter = pFilter.get();
+	outbound.length = 0;
+
+	retiredFilters_.push_back(pFilter);
+	outbound_.push(outbound);
+
+	if (!sendQueued_.exchange(true))
+		ioThread_.pushCommand(IOThread::COMMAND_SEND, this);
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::takeStats(uint32& recvPackets, uint32& recvBytes, uint32& sentPackets, uint32& sentBytes)
+{
+	recvPackets = recvPackets_.exchange(0, std::memory_order_relaxed);
+	recvBytes = recvBytes_.exchange(0, std::memory_order_relaxed);
+	sentPackets = sentPackets_.exchange(0, std::memory_order_relaxed);
+	sentBytes = sentBytes_.exchange(0, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------
+bool ChannelIO::takeError(std::string& reason)
+{
+	if (errorTaken_ || !hasError_.load(std::memory_order_acquire))
+		return false;
+
+	errorTaken_ = true;
+	reason = errorReason_;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::onAttach(EventPoller& poller)
+{
+	pPoller_ = &poller;
+	readRegistered_ = poller.registerForRead(*pEndPoint_, &receiver_);
+
+	if (!readRegistered_)
+		onError("ChannelIO::onAttach: registerForRead is failed!");
+
+	state_.store(STATE_ATTACHED, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::onDetach(EventPoller& poller)
+{
+	if (readRegistered_)
+	{
+		poller.deregisterForRead(*pEndPoint_);
+		readRegistered_ = false;
+	}
+
+	if (writeRegistered_)
+	{
+		poller.deregisterForWrite(*pEndPoint_);
+		writeRegistered_ = false;
+	}
+
+	releaseOutbound_();
+
+	frameBuffer_.clear(false);
+	pFilter_ = NULL;
+	pPoller_ = NULL;
+
+	// After this the I/O thread never touches the object again
+	state_.store(STATE_DETACHED, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::onError(const std::string& reason)
+{
+	if (hasError_.load(std::memory_order_relaxed))
+		return;
+
+	if (pPoller_)
+	{
+		if (readRegistered_)
+		{
+			pPoller_->deregisterForRead(*pEndPoint_);
+			readRegistered_ = false;
+		}
+
+		if (writeRegistered_)
+		{
+			pPoller_->deregisterForWrite(*pEndPoint_);
+			writeRegistered_ = false;
+		}
+	}
+
+	// Nothing will be written any more, the channel must not wait for it before it is destroyed
+	releaseOutbound_();
+
+	errorReason_ = reason;
+	hasError_.store(true, std::memory_order_release);
+
+	pushReady_();
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::releaseOutbound_()
+{
+	OUTBOUND outbound;
+	while (outbound_.pop(outbound))
+		sendingBundles_.push_back(outbound);
+
+	std::deque<OUTBOUND>::iterator iter = sendingBundles_.begin();
+	for (; iter != sendingBundles_.end(); ++iter)
+	{
+		if ((*iter).pBundle == NULL)
+			continue;
+
+		Bundle::reclaimPoolObject((*iter).pBundle);
+		pendingBytes_.fetch_sub((*iter).length, std::memory_order_relaxed);
+		numPendingBundles_.fetch_sub(1, std::memory_order_release);
+	}
+
+	sendingBundles_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::pushReady_()
+{
+	if (!queued_.exchange(true))
+		ioThread_.pushReady(this);
+}
+
+//-------------------------------------------------------------------------------------
+bool ChannelIO::processRecv(bool expectingPacket)
+{
+	if (hasError_.load(std::memory_order_relaxed))
+		return false;
+
+	TCPPacket* pReceiveWindow = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+	int len = pReceiveWindow->recvFromEndPoint(*pEndPoint_);
+
+	if (len < 0)
+	{
+		TCPPacket::reclaimPoolObject(pReceiveWindow);
+
+		PacketReceiver::RecvState rstate = receiver_.checkSocketErrors(len, expectingPacket);
+
+		if (rstate == PacketReceiver::RECV_STATE_INTERRUPT)
+		{
+			onError(fmt::format("ChannelIO::processRecv(): error={}\n", ouro_lasterror()));
+			return false;
+		}
+
+		return rstate == PacketReceiver::RECV_STATE_CONTINUE;
+	}
+	else if (len == 0) // The client exits normally
+	{
+		TCPPacket::reclaimPoolObject(pReceiveWindow);
+		onError("disconnected");
+		return false;
+	}
+
+	recvPackets_.fetch_add(1, std::memory_order_relaxed);
+	recvBytes_.fetch_add(len, std::memory_order_relaxed);
+
+	size_t numMessages = messages_.size();
+
+	Reason ret = pFilter_ ? pFilter_->recv(pChannel_, receiver_, pReceiveWindow) :
+		receiver_.processFilteredPacket(pChannel_, pReceiveWindow);
+
+	if (ret != REASON_SUCCESS)
+	{
+		onError(fmt::format("ChannelIO::processRecv(): {}", reasonToString(ret)));
+		return false;
+	}
+
+	if (messages_.size() != numMessages)
+		pushReady_();
+
+	return !hasError_.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------
+void ChannelIO::processFilteredPacket(Packet* pPacket)
+{
+	if (frameBuffer_.length() == 0)
+	{
+		// Usual case, the packet holds whole messages and is framed in place
+		size_t consumed = frame_(pPacket->data() + pPacket->rpos(), pPacket->length());
+
+		if (consumed < pPacket->length() && !hasError_.load(std::memory_order_relaxed))
+		{
+			frameBuffer_.clear(false);
+			frameBuffer_.append(pPacket->data() + pPacket->rpos() + consumed, pPacket->length() - consumed);
+		}
+	}
+	else
+	{
+		frameBuffer_.append(pPacket->data() + pPacket->rpos(), pPacket->length());
+
+		size_t consumed = frame_(frameBuffer_.data() + frameBuffer_.rpos(), frameBuffer_.length());
+		frameBuffer_.read_skip(consumed);
+
+		if (frameBuffer_.length() == 0)
+		{
+			frameBuffer_.clear(false);
+		}
+		else if (frameBuffer_.rpos() > 0)
+		{
+			size_t remain = frameBuffer_.length();
+			memmove(frameBuffer_.data(), frameBuffer_.data() + frameBuffer_.rpos(), remain);
+			frameBuffer_.rpos(0);
+			frameBuffer_.wpos(remain);
+		}
+	}
+
+	RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+size_t ChannelIO::frame_(const uint8* data, size_t size)
+{
+	size_t pos = 0;
+
+	while (!hasError_.load(std::memory_order_relaxed))
+	{
+		size_t remain = size - pos;
+
+		switch (frameState_)
+		{
+		case FRAME_MESSAGE_ID:
+			{
+				if (remain < NETWORK_MESSAGE_ID_SIZE)
+					return pos;
+
+				memcpy(&currMsgID_, data + pos, NETWORK_MESSAGE_ID_SIZE);
+				EndianConvert(currMsgID_);
+				pos += NETWORK_MESSAGE_ID_SIZE;
+				currHeaderSize_ = NETWORK_MESSAGE_ID_SIZE;
+
+				// Handlers are registered at startup, find() only reads the map
+				pCurrMsgHandler_ = pMsgHandlers_->find(currMsgID_);
+				if (pCurrMsgHandler_ == NULL)
+				{
+					onError(fmt::format("ChannelIO::frame_: not found msgID={}", currMsgID_));
+					return size;
+				}
+
+				if (pCurrMsgHandler_->msgLen == NETWORK_VARIABLE_MESSAGE)
+				{
+					frameState_ = FRAME_MESSAGE_LENGTH;
+				}
+				else
+				{
+					currMsgLen_ = pCurrMsgHandler_->msgLen;
+					frameState_ = FRAME_MESSAGE_BODY;
+				}
+			}
+			break;
+
+		case FRAME_MESSAGE_LENGTH:
+			{
+				if (remain < NETWORK_MESSAGE_LENGTH_SIZE)
+					return pos;
+
+				MessageLength len;
+				memcpy(&len, data + pos, NETWORK_MESSAGE_LENGTH_SIZE);
+				EndianConvert(len);
+				pos += NETWORK_MESSAGE_LENGTH_SIZE;
+				currHeaderSize_ += NETWORK_MESSAGE_LENGTH_SIZE;
+
+				currMsgLen_ = len;
+				frameState_ = (len == NETWORK_MESSAGE_MAX_SIZE) ? FRAME_MESSAGE_LENGTH1 : FRAME_MESSAGE_BODY;
+			}
+			break;
+
+		case FRAME_MESSAGE_LENGTH1:
+			{
+				if (remain < NETWORK_MESSAGE_LENGTH1_SIZE)
+					return pos;
+
+				memcpy(&currMsgLen_, data + pos, NETWORK_MESSAGE_LENGTH1_SIZE);
+				EndianConvert(currMsgLen_);
+				pos += NETWORK_MESSAGE_LENGTH1_SIZE;
+				currHeaderSize_ += NETWORK_MESSAGE_LENGTH1_SIZE;
+
+				frameState_ = FRAME_MESSAGE_BODY;
+			}
+			break;
+
+		case FRAME_MESSAGE_BODY:
+			{
+				// Only external channels are offloaded
+				if (currMsgLen_ > NETWORK_MESSAGE_MAX_SIZE)
+				{
+					onError(fmt::format("ChannelIO::frame_({}): msglen exceeds the limit! msgID={}, msglen={}, maxlen={}",
+						pCurrMsgHandler_->name, currMsgID_, currMsgLen_, NETWORK_MESSAGE_MAX_SIZE));
+
+					return size;
+				}
+
+				if (remain < currMsgLen_)
+					return pos;
+
+				MESSAGE msg;
+				msg.msgID = currMsgID_;
+				msg.headerSize = currHeaderSize_;
+				msg.pStream = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+
+				if (currMsgLen_ > 0)
+					msg.pStream->append(data + pos, currMsgLen_);
+
+				pos += currMsgLen_;
+				messages_.push(msg);
+
+				frameState_ = FRAME_MESSAGE_ID;
+				pCurrMsgHandler_ = NULL;
+				currMsgID_ = 0;
+				currMsgLen_ = 0;
+				currHeaderSize_ = 0;
+			}
+			break;
+
+		default:
+			return size;
+		};
+	}
+
+	return size;
+}
+
+//-------------------------------------------------------------------------------------
+bool ChannelIO::processSend()
+{
+	OUTBOUND outbound;
+	while (outbound_.pop(outbound))
+		sendingBundles_.push_back(outbound);
+
+	if (hasError_.load(std::memory_order_relaxed))
+	{
+		releaseOutbound_();
+		return false;
+	}
+
+	while (!sendingBundles_.empty())
+	{
+		OUTBOUND& front = sendingBundles_.front();
+
+		if (front.pBundle == NULL)
+		{
+			pFilter_ = front.pFilter;
+			sendingBundles_.pop_front();
+			continue;
+		}
+
+		Bundle::Packets& packets = front.pBundle->packets();
+		Reason reason = REASON_SUCCESS;
+
+		Bundle::Packets::iterator iter = packets.begin();
+		for (; iter != packets.end(); ++iter)
+		{
+			reason = pFilter_ ? pFilter_->send(pChannel_, sender_, (*iter), 0) : processFilterPacket((*iter));
+			if (reason != REASON_SUCCESS)
+				break;
+
+			RECLAIM_PACKET(front.pBundle->isTCPPacket(), (*iter));
+		}
+
+		packets.erase(packets.begin(), iter);
+
+		if (reason == REASON_SUCCESS)
+		{
+			Bundle::reclaimPoolObject(front.pBundle);
+			pendingBytes_.fetch_sub(front.length, std::memory_order_relaxed);
+			numPendingBundles_.fetch_sub(1, std::memory_order_release);
+			sendingBundles_.pop_front();
+			sendfailCount_ = 0;
+			continue;
+		}
+
+		if (reason == REASON_RESOURCE_UNAVAILABLE)
+		{
+			if (++sendfailCount_ >= 10)
+			{
+				onError("ChannelIO::processSend: sendfailCount >= 10");
+				return false;
+			}
+
+			// The rest goes out when the socket becomes writable
+			if (!writeRegistered_ && pPoller_)
+				writeRegistered_ = pPoller_->registerForWrite(*pEndPoint_, &sender_);
+
+			return false;
+		}
+
+		onError(fmt::format("ChannelIO::processSend: {}, errno={}", reasonToString(reason), ouro_lasterror()));
+		return false;
+	}
+
+	if (writeRegistered_)
+	{
+		pPoller_->deregisterForWrite(*pEndPoint_);
+		writeRegistered_ = false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+Reason ChannelIO::processFilterPacket(Packet* pPacket)
+{
+	int len = pEndPoint_->send(pPacket->data() + pPacket->rpos() + pPacket->sentSize, pPacket->length() - pPacket->sentSize);
+
+	if (len > 0)
+	{
+		pPacket->sentSize += len;
+		sentBytes_.fetch_add(len, std::memory_order_relaxed);
+	}
+
+	if (pPacket->sentSize == pPacket->length())
+	{
+		sentPackets_.fetch_add(1, std::memory_order_relaxed);
+		return REASON_SUCCESS;
+	}
+
+	// If only a part of the data is sent, it is considered REASON_RESOURCE_UNAVAILABLE
+	if (len > 0)
+		return REASON_RESOURCE_UNAVAILABLE;
+
+	return PacketSender::checkSocketErrors(pEndPoint_);
+}
+
+//-------------------------------------------------------------------------------------
+IOThread::IOThread(IOThreadPool& pool, uint32 index):
+pool_(pool),
+index_(index),
+pPoller_(NULL),
+wakeup_(),
+commands_(),
+ready_(),
+hasReady_(false),
+running_(false),
+tid_(),
+numChannels_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+IOThread::~IOThread()
+{
+	stop();
+
+	if (pPoller_ && wakeup_.endpoint().good())
+		pPoller_->deregisterForRead(wakeup_.endpoint());
+
+	wakeup_.finalise();
+	SAFE_RELEASE(pPoller_);
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThread::start()
+{
+	if (isRunning())
+		return true;
+
+	if (pPoller_ == NULL)
+	{
+		pPoller_ = EventPoller::create();
+
+		// Idle time and the main thread idle callbacks belong to the main thread's poller
+		pPoller_->isMainThread(false);
+
+		if (!wakeup_.initialize() || !pPoller_->registerForRead(wakeup_.endpoint(), &wakeup_))
+		{
+			ERROR_MSG(fmt::format("IOThread::start: thread({}) couldn't create the wakeup socket!\n", index_));
+			return false;
+		}
+	}
+
+	running_.store(true, std::memory_order_release);
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	tid_ = (THREAD_ID)_beginthreadex(NULL, 0, &IOThread::threadFunc, (void*)this, 0, NULL);
+	if (tid_ == 0)
+	{
+		running_.store(false, std::memory_order_release);
+		return false;
+	}
+#else
+	if (pthread_create(&tid_, NULL, IOThread::threadFunc, (void*)this) != 0)
+	{
+		running_.store(false, std::memory_order_release);
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOThread::stop()
+{
+	if (!isRunning())
+		return;
+
+	running_.store(false, std::memory_order_release);
+	wakeup_.wake();
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	if (WaitForSingleObject(tid_, INFINITE) == WAIT_OBJECT_0)
+		CloseHandle(tid_);
+#else
+	pthread_join(tid_, NULL);
+#endif
+
+	// Commands queued before the thread noticed the stop
+	processCommands();
+}
+
+//-------------------------------------------------------------------------------------
+void IOThread::pushCommand(COMMAND_TYPE type, ChannelIO* pChannelIO)
+{
+	COMMAND command;
+	command.type = type;
+	command.pChannelIO = pChannelIO;
+	commands_.push(command);
+
+	if (isRunning())
+		wakeup_.wake();
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThread::popReady(ChannelIO*& pChannelIO)
+{
+	return ready_.pop(pChannelIO);
+}
+
+//-------------------------------------------------------------------------------------
+void IOThread::pushReady(ChannelIO* pChannelIO)
+{
+	ready_.push(pChannelIO);
+	hasReady_ = true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOThread::processCommands()
+{
+	COMMAND command;
+	while (commands_.pop(command))
+	{
+		switch (command.type)
+		{
+		case COMMAND_ATTACH:
+			command.pChannelIO->onAttach(*pPoller_);
+			break;
+		case COMMAND_SEND:
+			command.pChannelIO->sendQueued_.store(false);
+			command.pChannelIO->processSend();
+			break;
+		case COMMAND_DETACH:
+			command.pChannelIO->onDetach(*pPoller_);
+			break;
+		default:
+			break;
+		};
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void IOThread::run_()
+{
+	g_isIOThread = true;
+	g_profileDisabledThread = true;
+
+	while (isRunning())
+	{
+		pPoller_->processPendingEvents(0.1);
+		processCommands();
+
+		if (hasReady_)
+		{
+			hasReady_ = false;
+			pool_.wakeMain();
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------
+#if OURO_PLATFORM == PLATFORM_WIN32
+unsigned __stdcall IOThread::threadFunc(void* arg)
+#else
+void* IOThread::threadFunc(void* arg)
+#endif
+{
+	IOThread* pIOThread = static_cast<IOThread*>(arg);
+	pIOThread->run_();
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	return 0;
+#else
+	pthread_exit(NULL);
+	return NULL;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+IOThreadPool::IOThreadPool(NetworkInterface& networkInterface, uint32 numThreads):
+networkInterface_(networkInterface),
+numThreads_(numThreads),
+threads_(),
+wakeup_(this),
+ready_(),
+pProcessingChannelIO_(NULL),
+processingDetached_(false),
+processing_(false),
+numChannels_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+IOThreadPool::~IOThreadPool()
+{
+	finalise();
+
+	OURO_ASSERT(numChannels_ == 0);
+
+	std::vector<IOThread*>::iterator iter = threads_.begin();
+	for (; iter != threads_.end(); ++iter)
+		delete (*iter);
+
+	threads_.clear();
+
+	if (wakeup_.endpoint().good())
+		networkInterface_.dispatcher().deregisterReadFileDescriptor(wakeup_.endpoint());
+
+	wakeup_.finalise();
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::initialize()
+{
+	if (!wakeup_.initialize() ||
+		!networkInterface_.dispatcher().registerReadFileDescriptor(wakeup_.endpoint(), &wakeup_))
+	{
+		ERROR_MSG("IOThreadPool::initialize: couldn't create the wakeup socket!\n");
+		return false;
+	}
+
+	// Packets, bundles and message bodies are now created and reclaimed by several threads
+	Bundle::ObjPool().pMutex(new thread::ThreadMutex());
+	TCPPacket::ObjPool().pMutex(new thread::ThreadMutex());
+	MemoryStream::ObjPool().pMutex(new thread::ThreadMutex());
+
+	for (uint32 i = 0; i < numThreads_; ++i)
+	{
+		IOThread* pIOThread = new IOThread(*this, i);
+		threads_.push_back(pIOThread);
+
+		if (!pIOThread->start())
+		{
+			ERROR_MSG(fmt::format("IOThreadPool::initialize: couldn't start thread({})!\n", i));
+			return false;
+		}
+	}
+
+	INFO_MSG(fmt::format("IOThreadPool::initialize: {} network I/O threads.\n", numThreads_));
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::finalise()
+{
+	std::vector<IOThread*>::iterator iter = threads_.begin();
+	for (; iter != threads_.end(); ++iter)
+		(*iter)->stop();
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::isIOThread()
+{
+	return g_isIOThread;
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::canAttach_(Channel* pChannel) const
+{
+	if (threads_.empty() || pChannel->pChannelIO() != NULL)
+		return false;
+
+	if (pChannel->protocoltype() != PROTOCOL_TCP || !pChannel->isExternal())
+		return false;
+
+	if (!pChannel->hasHandshake() || pChannel->isDestroyed() || pChannel->condemn() > 0)
+		return false;
+
+	// ssl sessions are not shared between threads
+	if (pChannel->pEndPoint() == NULL || pChannel->pEndPoint()->isSSL())
+		return false;
+
+	// Only at a message boundary with nothing left to send, the I/O thread starts from a clean state
+	if (pChannel->sending() || pChannel->bundles().size() > 0)
+		return false;
+
+	return pChannel->pPacketReader() != NULL && pChannel->pPacketReader()->idle();
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::attach(Channel* pChannel)
+{
+	if (!canAttach_(pChannel))
+		return false;
+
+	IOThread* pIOThread = threads_[0];
+
+	std::vector<IOThread*>::iterator iter = threads_.begin();
+	for (; iter != threads_.end(); ++iter)
+	{
+		if ((*iter)->numChannels() < pIOThread->numChannels())
+			pIOThread = (*iter);
+	}
+
+	if (!pIOThread->isRunning())
+		return false;
+
+	MessageHandlers* pMsgHandlers = pChannel->pMsgHandlers() != NULL ?
+		pChannel->pMsgHandlers() : MessageHandlers::pMainMessageHandlers;
+
+	ChannelIO* pChannelIO = new ChannelIO(*pIOThread, pChannel, pChannel->pFilter(), pMsgHandlers);
+
+	networkInterface_.dispatcher().deregisterReadFileDescriptor(*pChannel->pEndPoint());
+	pChannel->pChannelIO(pChannelIO);
+
+	pIOThread->numChannels(pIOThread->numChannels() + 1);
+	++numChannels_;
+
+	pIOThread->pushCommand(IOThread::COMMAND_ATTACH, pChannelIO);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::detach(ChannelIO* pChannelIO)
+{
+	IOThread& ioThread = pChannelIO->ioThread();
+	ioThread.pushCommand(IOThread::COMMAND_DETACH, pChannelIO);
+
+	// Only the main thread stops the threads, a stopped thread can not pick the command up any more
+	if (!ioThread.isRunning())
+		ioThread.processCommands();
+
+	int spins = 0;
+	while (pChannelIO->state() != ChannelIO::STATE_DETACHED)
+		Ouroboros::sleep((++spins < 100) ? 0 : 1);
+
+	// The channel may still be queued, it must not be handed to processReady once it is freed
+	ChannelIO* pReadyChannelIO = NULL;
+	while (ioThread.popReady(pReadyChannelIO))
+		ready_.push_back(pReadyChannelIO);
+
+	std::replace(ready_.begin(), ready_.end(), pChannelIO, (ChannelIO*)NULL);
+
+	pChannelIO->clearMessages();
+	pChannelIO->pChannel()->pChannelIO(NULL);
+
+	ioThread.numChannels(ioThread.numChannels() - 1);
+	--numChannels_;
+
+	// Detached by one of its own handlers, processReady frees it once the handler has returned
+	if (pChannelIO == pProcessingChannelIO_)
+		processingDetached_ = true;
+	else
+		delete pChannelIO;
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::processReady()
+{
+	if (processing_)
+		return;
+
+	processing_ = true;
+
+	std::vector<IOThread*>::iterator iter = threads_.begin();
+	for (; iter != threads_.end(); ++iter)
+	{
+		ChannelIO* pChannelIO = NULL;
+		while ((*iter)->popReady(pChannelIO))
+			ready_.push_back(pChannelIO);
+	}
+
+	// Handlers may destroy channels, detach() clears their entries
+	for (size_t i = 0; i < ready_.size(); ++i)
+	{
+		ChannelIO* pChannelIO = ready_[i];
+		if (pChannelIO == NULL)
+			continue;
+
+		ready_[i] = NULL;
+
+		// Cleared before the messages are taken, messages framed from now on queue the channel again
+		pChannelIO->queued_.store(false);
+
+		pProcessingChannelIO_ = pChannelIO;
+		processingDetached_ = false;
+
+		pChannelIO->pChannel()->processIOMessages();
+
+		if (processingDetached_)
+			delete pChannelIO;
+
+		pProcessingChannelIO_ = NULL;
+		processingDetached_ = false;
+	}
+
+	ready_.clear();
+	processing_ = false;
+}
+
+//-------------------------------------------------------------------------------------
+}
+}
@@ -0,0 +1,382 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_IO_THREAD_H
+#define OURO_IO_THREAD_H
+
+#include "common/common.h"
+#include "common/memorystream.h"
+#include "common/spsc_queue.h"
+#include "helper/debug_helper.h"
+#include "network/common.h"
+#include "network/endpoint.h"
+#include "network/interfaces.h"
+#include "network/packet_filter.h"
+#include "network/packet_receiver.h"
+#include "network/packet_sender.h"
+#include <atomic>
+#include <deque>
+
+namespace Ouroboros {
+namespace Network
+{
+
+class Bundle;
+class Channel;
+class ChannelIO;
+class EventPoller;
+class IOThread;
+class IOThreadPool;
+class MessageHandler;
+class MessageHandlers;
+class NetworkInterface;
+
+/*
+	Wakes a thread that waits in a poller through a loopback udp socket.
+	Wakeups are coalesced, only the first wake() after the receiver has run sends a datagram.
+*/
+class IOWakeup : public InputNotificationHandler
+{
+public:
+	IOWakeup(IOThreadPool* pPool = NULL);
+	virtual ~IOWakeup();
+
+	bool initialize();
+	void finalise();
+
+	void wake();
+
+	EndPoint& endpoint() { return endpoint_; }
+
+private:
+	virtual int handleInputNotification(int fd);
+
+private:
+	// The main thread's wakeup hands the ready channels to the pool, the I/O threads' only interrupt the poller
+	IOThreadPool* pPool_;
+
+	EndPoint endpoint_;
+	u_int16_t port_;
+	u_int32_t addr_;
+
+	std::atomic<bool> pending_;
+};
+
+/*
+	Receiver and sender that the filters of an offloaded channel call on the I/O thread
+*/
+class IOPacketReceiver : public PacketReceiver
+{
+public:
+	IOPacketReceiver(ChannelIO& channelIO, EndPoint& endpoint, NetworkInterface& networkInterface);
+	virtual ~IOPacketReceiver();
+
+	virtual Reason processPacket(Channel* pChannel, Packet* pPacket);
+	virtual Reason processFilteredPacket(Channel* pChannel, Packet* pPacket);
+
+	virtual Channel* getChannel();
+
+	virtual bool processRecv(bool expectingPacket);
+	virtual RecvState checkSocketErrors(int len, bool expectingPacket);
+
+private:
+	ChannelIO& channelIO_;
+};
+
+class IOPacketSender : public PacketSender
+{
+public:
+	IOPacketSender(ChannelIO& channelIO, EndPoint& endpoint, NetworkInterface& networkInterface);
+	virtual ~IOPacketSender();
+
+	virtual Reason processFilterPacket(Channel* pChannel, Packet* pPacket, int userarg);
+	virtual bool processSend(Channel* pChannel, int userarg);
+
+	virtual Channel* getChannel();
+
+private:
+	ChannelIO& channelIO_;
+};
+
+/*
+	The part of a channel that lives on an I/O thread once the channel has been handed over.
+	The I/O thread receives, runs the filter(decrypt, websocket frames) and splits the stream into messages,
+	the main thread takes the messages and only runs the handlers. Bundles go the other way,
+	the main thread queues them and the I/O thread encrypts and writes them.
+
+	Members are owned by one side, the queues and the atomics are the only shared state.
+*/
+class ChannelIO
+{
+public:
+	struct MESSAGE
+	{
+		MessageID msgID;
+
+		// Header bytes in front of the body(id and length fields), for the network stats
+		uint16 headerSize;
+
+		// Message body, reclaimed by the consumer
+		MemoryStream* pStream;
+	};
+
+	enum STATE
+	{
+		STATE_ATTACHING = 0,
+		STATE_ATTACHED = 1,
+		STATE_DETACHED = 2
+	};
+
+	ChannelIO(IOThread& ioThread, Channel* pChannel, PacketFilterPtr pFilter, MessageHandlers* pMsgHandlers);
+	~ChannelIO();
+
+	IOThread& ioThread() { return ioThread_; }
+	Channel* pChannel() const { return pChannel_; }
+
+	STATE state() const { return (STATE)state_.load(std::memory_order_acquire); }
+
+	/* Main thread */
+	bool popMessage(MESSAGE& msg);
+	void send(Bundle* pBundle);
+	void pFilter(PacketFilterPtr pFilter);
+
+	bool sending() const { return numPendingBundles_.load(std::memory_order_acquire) > 0; }
+	uint32 numPendingBundles() const { return numPendingBundles_.load(std::memory_order_relaxed); }
+	uint32 pendingBytes() const { return pendingBytes_.load(std::memory_order_relaxed); }
+
+	void takeStats(uint32& recvPackets, uint32& recvBytes, uint32& sentPackets, uint32& sentBytes);
+
+	/**
+		Returns true once when the I/O thread has given up on the socket
+	*/
+	bool takeError(std::string& reason);
+
+	/**
+		Reclaims the messages that were not handled, called after the I/O thread has detached
+	*/
+	void clearMessages();
+
+	/* I/O thread */
+	void onAttach(EventPoller& poller);
+	void onDetach(EventPoller& poller);
+	void onError(const std::string& reason);
+
+	bool processRecv(bool expectingPacket);
+	void processFilteredPacket(Packet* pPacket);
+	bool processSend();
+	Reason processFilterPacket(Packet* pPacket);
+
+private:
+	struct OUTBOUND
+	{
+		// NULL if the entry replaces the filter
+		Bundle* pBundle;
+		PacketFilter* pFilter;
+		uint32 length;
+	};
+
+	enum FRAME_STATE
+	{
+		FRAME_MESSAGE_ID = 0,
+		FRAME_MESSAGE_LENGTH = 1,
+		FRAME_MESSAGE_LENGTH1 = 2,
+		FRAME_MESSAGE_BODY = 3
+	};
+
+	/**
+		Splits data into messages, returns the number of bytes consumed
+	*/
+	size_t frame_(const uint8* data, size_t size);
+
+	void pushReady_();
+	void releaseOutbound_();
+
+private:
+	IOThread& ioThread_;
+	Channel* pChannel_;
+	EndPoint* pEndPoint_;
+	MessageHandlers* pMsgHandlers_;
+
+	std::atomic<int> state_;
+
+	// I/O thread -> main thread
+	SPSCQueue<MESSAGE> messages_;
+	std::atomic<bool> queued_;
+
+	std::atomic<uint32> recvPackets_;
+	std::atomic<uint32> recvBytes_;
+	std::atomic<uint32> sentPackets_;
+	std::atomic<uint32> sentBytes_;
+
+	std::atomic<bool> hasError_;
+	std::string errorReason_;
+
+	// Main thread
+	bool errorTaken_;
+
+	// Main thread -> I/O thread
+	SPSCQueue<OUTBOUND> outbound_;
+	std::atomic<bool> sendQueued_;
+	std::atomic<uint32> numPendingBundles_;
+	std::atomic<uint32> pendingBytes_;
+
+	// Filters replaced while the I/O thread may still use them, main thread
+	std::vector<PacketFilterPtr> retiredFilters_;
+
+	// I/O thread
+	PacketFilter* pFilter_;
+	IOPacketReceiver receiver_;
+	IOPacketSender sender_;
+	EventPoller* pPoller_;
+	bool readRegistered_;
+	bool writeRegistered_;
+
+	// Bytes of an incomplete message, only used when a message is split across reads
+	MemoryStream frameBuffer_;
+	FRAME_STATE frameState_;
+	MessageHandler* pCurrMsgHandler_;
+	MessageID currMsgID_;
+	MessageLength1 currMsgLen_;
+	uint16 currHeaderSize_;
+
+	std::deque<OUTBOUND> sendingBundles_;
+	uint8 sendfailCount_;
+
+	friend class IOThread;
+	friend class IOThreadPool;
+};
+
+/*
+	One I/O thread, owns a poller with the sockets of its channels
+*/
+class IOThread
+{
+public:
+	enum COMMAND_TYPE
+	{
+		COMMAND_ATTACH = 0,
+		COMMAND_SEND = 1,
+		COMMAND_DETACH = 2
+	};
+
+	IOThread(IOThreadPool& pool, uint32 index);
+	~IOThread();
+
+	bool start();
+	void stop();
+
+	bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+	uint32 index() const { return index_; }
+	uint32 numChannels() const { return numChannels_; }
+	void numChannels(uint32 v) { numChannels_ = v; }
+
+	IOThreadPool& pool() { return pool_; }
+
+	/* Main thread */
+	void pushCommand(COMMAND_TYPE type, ChannelIO* pChannelIO);
+	bool popReady(ChannelIO*& pChannelIO);
+
+	/**
+		Runs the commands on the calling thread, only once the thread has stopped
+	*/
+	void processCommands();
+
+	/* I/O thread */
+	void pushReady(ChannelIO* pChannelIO);
+
+private:
+	struct COMMAND
+	{
+		COMMAND_TYPE type;
+		ChannelIO* pChannelIO;
+	};
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	static unsigned __stdcall threadFunc(void* arg);
+#else
+	static void* threadFunc(void* arg);
+#endif
+
+	void run_();
+
+private:
+	IOThreadPool& pool_;
+	uint32 index_;
+
+	EventPoller* pPoller_;
+	IOWakeup wakeup_;
+
+	SPSCQueue<COMMAND> commands_;
+	SPSCQueue<ChannelIO*> ready_;
+	bool hasReady_;
+
+	std::atomic<bool> running_;
+	THREAD_ID tid_;
+
+	// Main thread
+	uint32 numChannels_;
+};
+
+/*
+	Optional pool of network I/O threads(channelCommon->ioThreads), only external tcp channels are
+	handed over and only once they have shaken hands. ssl channels and reliable udp stay on the main thread.
+*/
+class IOThreadPool
+{
+public:
+	IOThreadPool(NetworkInterface& networkInterface, uint32 numThreads);
+	~IOThreadPool();
+
+	bool initialize();
+
+	/**
+		Stops the threads, channels that are detached afterwards are cleaned up on the main thread
+	*/
+	void finalise();
+
+	static bool isIOThread();
+
+	NetworkInterface& networkInterface() { return networkInterface_; }
+
+	/**
+		Hands the socket of the channel to an I/O thread if the channel is at a clean message boundary
+	*/
+	bool attach(Channel* pChannel);
+
+	/**
+		Takes the socket back, waits until the I/O thread has let go of it
+	*/
+	void detach(ChannelIO* pChannelIO);
+
+	/**
+		Runs the handlers of the messages the I/O threads have framed since the last call
+	*/
+	void processReady();
+
+	void wakeMain() { wakeup_.wake(); }
+
+	uint32 numThreads() const { return (uint32)threads_.size(); }
+	uint32 numChannels() const { return numChannels_; }
+
+private:
+	bool canAttach_(Channel* pChannel) const;
+
+private:
+	NetworkInterface& networkInterface_;
+	uint32 numThreads_;
+
+	std::vector<IOThread*> threads_;
+	IOWakeup wakeup_;
+
+	std::vector<ChannelIO*> ready_;
+	ChannelIO* pProcessingChannelIO_;
+	bool processingDetached_;
+	bool processing_;
+
+	uint32 numChannels_;
+};
+
+}
+}
+
+#endif // OURO_IO_THREAD_H
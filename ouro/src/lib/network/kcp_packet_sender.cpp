@@ -90,7 +90,7 @@ Reason KCPPacketSender::processFilterPacket(Channel* pChannel, Packet * pPacket,
 
 
 				if (ikcp_waitsnd(pChannel->pKCP()) > (int)(pChannel->pKCP()->snd_wnd * 2)/* if the send queue exceeds the send window by 2 times, the resource is insufficient.*/ || 
-			ikcp_send(pChannel->pKCP(), (const char*)pPacket->data(), pPacket->length()) < 0)
+			ikcp_send(pChannel->pKCP(), (const char*)(pPacket->data() + pPacket->rpos()), pPacket->length()) < 0)
 		{
 			ERROR_MSG(fmt::format("KCPPacketSender::ikcp_send: send error! currPacketSize={}, ikcp_waitsnd={}, snd_wndsize={}\n", 
 				pPacket->length(), ikcp_waitsnd(pChannel->pKCP()), pChannel->pKCP()->snd_wnd));
@@ -103,7 +103,7 @@ Reason KCPPacketSender::processFilterPacket(Channel* pChannel, Packet * pPacket,
 	else
 	{
 		EndPoint* pEndpoint = pChannel->pEndPoint();
-		int retlen = pEndpoint->sendto((void*)(pPacket->data()), pPacket->length());
+		int retlen = pEndpoint->sendto((void*)(pPacket->data() + pPacket->rpos()), pPacket->length());
 		bool sentCompleted = (retlen == (int)pPacket->length());
 
 		if (retlen > 0)
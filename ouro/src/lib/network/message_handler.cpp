@@ -8,6 +8,7 @@
 #include "network/packet_receiver.h"
 #include "network/fixed_messages.h"
 #include "helper/watcher.h"
+#include "helper/metrics.h"
 #include "xml/xml.h"
 #include "resmgr/resmgr.h"	
 
@@ -24,6 +25,7 @@ MessageHandlers::MessageHandlers(const std::string& name):
 msgHandlers_(),
 msgID_(1),
 exposedMessages_(),
+rateLimits_(),
 name_(name)
 {
 	g_fm = Network::FixedMessages::getSingletonPtr();
@@ -50,10 +52,15 @@ MessageHandlers::~MessageHandlers()
 MessageHandler::MessageHandler():
 pArgs(NULL),
 pMessageHandlers(NULL),
+pLatencyHistogram(NULL),
+rateLimit(0.f),
+rateBurst(0.f),
 send_size(0),
 send_count(0),
 recv_size(0),
-recv_count(0)
+recv_count(0),
+handle_time(0),
+dropped_count(0)
 {
 }
 
@@ -63,6 +70,31 @@ MessageHandler::~MessageHandler()
 	SAFE_RELEASE(pArgs);
 }
 
+//-------------------------------------------------------------------------------------
+uint64 MessageHandler::handletime() const
+{
+	return handle_time * 1000 / stampsPerSecond();
+}
+
+//-------------------------------------------------------------------------------------
+uint32 MessageHandler::handleavgtime() const
+{
+	if (recv_count <= 0)
+		return 0;
+
+	return (uint32)(handle_time * 1000000 / stampsPerSecond() / recv_count);
+}
+
+//-------------------------------------------------------------------------------------
+ScopedMessageHandleTimer::~ScopedMessageHandleTimer()
+{
+	uint64 elapsed = timestamp() - startTime_;
+	msgHandler_.handle_time += elapsed;
+
+	if (msgHandler_.pLatencyHistogram)
+		msgHandler_.pLatencyHistogram->observe(elapsed);
+}
+
 //-------------------------------------------------------------------------------------
 const char* MessageHandler::c_str()
 {
@@ -87,6 +119,27 @@ bool MessageHandlers::initializeWatcher()
 		}
 	}
 
+	// The limits of the config replace the declared ones
+	std::map< std::string, std::pair<float, float> > rateLimits = rateLimits_;
+
+	std::map< std::string, std::pair<float, float> >::const_iterator citer = g_extRateLimits.begin();
+	for (; citer != g_extRateLimits.end(); ++citer)
+		rateLimits[citer->first] = citer->second;
+
+	std::map< std::string, std::pair<float, float> >::iterator riter = rateLimits.begin();
+	for (; riter != rateLimits.end(); ++riter)
+	{
+		MessageHandlerMap::iterator iter = msgHandlers_.begin();
+		for (; iter != msgHandlers_.end(); ++iter)
+		{
+			if (riter->first == iter->second->name)
+			{
+				iter->second->rateLimit = riter->second.first;
+				iter->second->rateBurst = riter->second.second;
+			}
+		}
+	}
+
 	MessageHandlerMap::iterator iter = msgHandlers_.begin();
 	for(; iter != msgHandlers_.end(); ++iter)
 	{
@@ -123,6 +176,40 @@ bool MessageHandlers::initializeWatcher()
 
 		ouro_snprintf(buf, MAX_BUF * 2, "network/messages/%s/recvAvgSize", sname.c_str());
 		WATCH_OBJECT(buf, iter->second, &MessageHandler::recvavgsize);
+
+		ouro_snprintf(buf, MAX_BUF * 2, "network/messages/%s/handleTime", sname.c_str());
+		WATCH_OBJECT(buf, iter->second, &MessageHandler::handletime);
+
+		ouro_snprintf(buf, MAX_BUF * 2, "network/messages/%s/handleAvgTime", sname.c_str());
+		WATCH_OBJECT(buf, iter->second, &MessageHandler::handleavgtime);
+
+		ouro_snprintf(buf, MAX_BUF * 2, "network/messages/%s/droppedCount", sname.c_str());
+		WATCH_OBJECT(buf, iter->second, &MessageHandler::droppedcount);
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool MessageHandlers::initializeMetrics()
+{
+	MessageHandlerMap::iterator iter = msgHandlers_.begin();
+	for(; iter != msgHandlers_.end(); ++iter)
+	{
+		if(iter->second->pLatencyHistogram)
+			continue;
+
+		std::string sname = iter->second->name;
+		std::string::size_type fpos = iter->second->name.find("Entity::");
+
+		if (fpos != std::string::npos)
+		{
+			sname = name() + "::" + sname;
+			strutil::ouro_replace(sname, "Interface::", "::");
+		}
+
+		iter->second->pLatencyHistogram = Metrics::root().addHistogram("ouro_message_handler_seconds", 
+			"Time spent in a network message handler", fmt::format("handler=\"{}\"", sname));
 	}
 
 	return true;
@@ -383,6 +470,13 @@ bool MessageHandlers::pushExposedMessage(std::string msgname)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+bool MessageHandlers::pushMessageRateLimit(std::string msgname, float rate, float burst)
+{
+	rateLimits_[msgname] = std::make_pair(rate, burst);
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 } 
 }
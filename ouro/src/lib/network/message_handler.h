@@ -11,6 +11,7 @@
 namespace Ouroboros{
 
 class OURO_MD5;
+class MetricsHistogram;
 
 namespace Network
 {
@@ -60,11 +61,20 @@ public:
 	bool exposed;
 	MessageHandlers* pMessageHandlers;
 
+	// Handling latency, NULL while metrics are disabled
+	MetricsHistogram* pLatencyHistogram;
+
+	// Messages per second and burst a client channel may send, 0 unlimited(see Channel::admitMessage)
+	float rateLimit;
+	float rateBurst;
+
 	// stats
 	volatile mutable uint32 send_size;
 	volatile mutable uint32 send_count;
 	volatile mutable uint32 recv_size;
 	volatile mutable uint32 recv_count;
+	volatile mutable uint64 handle_time;
+	volatile mutable uint32 dropped_count;
 
 	uint32 sendsize() const  { return send_size; }
 	uint32 sendcount() const  { return send_count; }
@@ -74,6 +84,12 @@ public:
 	uint32 recvcount() const  { return recv_count; }
 	uint32 recvavgsize() const  { return (recv_count <= 0) ? 0 : recv_size / recv_count; }
 
+	// The time spent in handle, ms and the average us
+	uint64 handletime() const;
+	uint32 handleavgtime() const;
+
+	uint32 droppedcount() const  { return dropped_count; }
+
 	/**
 		The default return category is component message
 	*/
@@ -111,12 +127,14 @@ public:
 						MessageHandler* msgHandler);
 	
 	bool pushExposedMessage(std::string msgname);
+	bool pushMessageRateLimit(std::string msgname, float rate, float burst);
 
 	MessageHandler* find(MessageID msgID);
 	
 	MessageID lastMsgID() {return msgID_ - 1;}
 
 	bool initializeWatcher();
+	bool initializeMetrics();
 	
 	static void finalise(void);
 	static std::vector<MessageHandlers*>& messageHandlers();
@@ -134,9 +152,29 @@ private:
 	MessageID msgID_;
 
 	std::vector< std::string > exposedMessages_;
+	std::map< std::string, std::pair<float, float> > rateLimits_;
 	std::string name_;
 };
 
+/*
+	Accounts the time of a handle call to the handler, and observes the latency histogram if metrics are enabled
+*/
+class ScopedMessageHandleTimer
+{
+public:
+	ScopedMessageHandleTimer(MessageHandler& msgHandler):
+	msgHandler_(msgHandler),
+	startTime_(timestamp())
+	{
+	}
+
+	~ScopedMessageHandleTimer();
+
+private:
+	MessageHandler& msgHandler_;
+	uint64 startTime_;
+};
+
 }
 }
 #endif 
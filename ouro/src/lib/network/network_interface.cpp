@@ -16,6 +16,7 @@
 #include "network/delayed_channels.h"
 #include "network/interfaces.h"
 #include "network/message_handler.h"
+#include "network/io_thread.h"
 
 namespace Ouroboros { 
 namespace Network
@@ -38,7 +39,8 @@ NetworkInterface::NetworkInterface(Network::EventDispatcher * pDispatcher,
 	pDelayedChannels_(new DelayedChannels()),
 	pChannelTimeOutHandler_(NULL),
 	pChannelDeregisterHandler_(NULL),
-	numExtChannels_(0)
+	numExtChannels_(0),
+	pIOThreadPool_(NULL)
 {
 	if(extlisteningTcpPort_min != -1)
 	{
@@ -82,11 +84,25 @@ NetworkInterface::NetworkInterface(Network::EventDispatcher * pDispatcher,
 		"please check for ouroboros[_defs].xml!\n");
 
 	pDelayedChannels_->init(this->dispatcher(), this);
+
+	if (pExtListenerReceiver_ && Network::g_ioThreads > 0)
+	{
+		pIOThreadPool_ = new IOThreadPool(*this, Network::g_ioThreads);
+
+		if (!pIOThreadPool_->initialize())
+		{
+			ERROR_MSG("NetworkInterface::NetworkInterface: couldn't start the I/O threads, external channels stay on the main thread!\n");
+			pIOThreadPool_->finalise();
+			SAFE_RELEASE(pIOThreadPool_);
+		}
+	}
 }
 
 //-------------------------------------------------------------------------------------
 NetworkInterface::~NetworkInterface()
 {
+	stopIOThreads();
+
 	ChannelMap::iterator iter = channelMap_.begin();
 	while (iter != channelMap_.end())
 	{
@@ -98,6 +114,8 @@ NetworkInterface::~NetworkInterface()
 
 	channelMap_.clear();
 
+	SAFE_RELEASE(pIOThreadPool_);
+
 	this->closeSocket();
 
 	if (pDispatcher_ != NULL)
@@ -111,6 +129,13 @@ NetworkInterface::~NetworkInterface()
 	SAFE_RELEASE(pIntListenerReceiver_);
 }
 
+//-------------------------------------------------------------------------------------
+void NetworkInterface::stopIOThreads()
+{
+	if (pIOThreadPool_)
+		pIOThreadPool_->finalise();
+}
+
 //-------------------------------------------------------------------------------------
 void NetworkInterface::closeSocket()
 {
@@ -431,6 +456,10 @@ void NetworkInterface::onChannelTimeOut(Channel * pChannel)
 //-------------------------------------------------------------------------------------
 void NetworkInterface::processChannels(Ouroboros::Network::MessageHandlers* pMsgHandlers)
 {
+	// Messages framed after the last wakeup was handled
+	if (pIOThreadPool_)
+		pIOThreadPool_->processReady();
+
 	ChannelMap::iterator iter = channelMap_.begin();
 	for(; iter != channelMap_.end(); )
 	{
@@ -23,6 +23,7 @@ class ListenerReceiver;
 class Packet;
 class EventDispatcher;
 class MessageHandlers;
+class IOThreadPool;
 
 class NetworkInterface : public TimerHandler
 {
@@ -85,6 +86,12 @@ public:
 
 	INLINE int32 numExtChannels() const;
 
+	/**
+		NULL unless external channels are served by I/O threads(channelCommon->ioThreads)
+	*/
+	IOThreadPool* pIOThreadPool() const { return pIOThreadPool_; }
+	void stopIOThreads();
+
 private:
 	virtual void handleTimeout(TimerHandle handle, void * arg);
 
@@ -107,6 +114,8 @@ private:
 	ChannelDeregisterHandler *				pChannelDeregisterHandler_;
 
 	int32									numExtChannels_;
+
+	IOThreadPool*							pIOThreadPool_;
 };
 
 }
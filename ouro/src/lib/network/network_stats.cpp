@@ -13,6 +13,8 @@ namespace Network
 
 NetworkStats g_networkStats;
 
+static thread_local NetworkStats::DEFERRED_MESSAGES* g_pDeferredMessages = NULL;
+
 //-------------------------------------------------------------------------------------
 NetworkStats::NetworkStats():
 stats_(),
@@ -48,6 +50,16 @@ void NetworkStats::removeHandler(NetworkStatsHandler* pHandler)
 //-------------------------------------------------------------------------------------
 void NetworkStats::trackMessage(S_OP op, const MessageHandler& msgHandler, uint32 size)
 {
+	if(g_pDeferredMessages)
+	{
+		DeferredMessage deferred;
+		deferred.op = op;
+		deferred.pMsgHandler = &msgHandler;
+		deferred.size = size;
+		g_pDeferredMessages->push_back(deferred);
+		return;
+	}
+
 	MessageHandler* pMsgHandler = const_cast<MessageHandler*>(&msgHandler);
 
 	if(op == SEND)
@@ -71,6 +83,22 @@ void NetworkStats::trackMessage(S_OP op, const MessageHandler& msgHandler, uint3
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void NetworkStats::deferMessages(DEFERRED_MESSAGES* pDeferred)
+{
+	g_pDeferredMessages = pDeferred;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::flush(DEFERRED_MESSAGES& deferred)
+{
+	DEFERRED_MESSAGES::iterator iter = deferred.begin();
+	for(; iter != deferred.end(); ++iter)
+		trackMessage((*iter).op, *(*iter).pMsgHandler, (*iter).size);
+
+	deferred.clear();
+}
+
 //-------------------------------------------------------------------------------------
 }
 }
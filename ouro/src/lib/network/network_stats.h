@@ -44,11 +44,28 @@ public:
 
 	typedef OUROUnordered_map<std::string, Stats> STATS;
 
+	struct DeferredMessage
+	{
+		S_OP op;
+		const MessageHandler* pMsgHandler;
+		uint32 size;
+	};
+
+	typedef std::vector<DeferredMessage> DEFERRED_MESSAGES;
+
 	NetworkStats();
 	~NetworkStats();
 
 	void trackMessage(S_OP op, const MessageHandler& msgHandler, uint32 size);
 
+	/**
+		The counters and the handlers belong to the main thread, the messages tracked by another thread
+		(e.g. the witness updaters of cellapp) are kept in pDeferred until the main thread flushes them.
+		NULL tracks the messages of the calling thread directly again.
+	*/
+	static void deferMessages(DEFERRED_MESSAGES* pDeferred);
+	void flush(DEFERRED_MESSAGES& deferred);
+
 	NetworkStats::STATS& stats(){ return stats_; }
 
 	void addHandler(NetworkStatsHandler* pHandler);
@@ -4,6 +4,8 @@
 #include "network/channel.h"
 #include "network/message_handler.h"
 #include "network/network_stats.h"
+#include "helper/metrics.h"
+#include "helper/flight_recorder.h"
 
 namespace Ouroboros { 
 namespace Network
@@ -167,7 +169,14 @@ void PacketReader::processMessages(Ouroboros::Network::MessageHandlers* pMsgHand
 			if(pFragmentStream_ != NULL)
 			{
 				TRACE_MESSAGE_PACKET(true, pFragmentStream_, pMsgHandler, currMsgLen_, pChannel_->c_str(), false);
-				pMsgHandler->handle(pChannel_, *pFragmentStream_);
+
+				if (pChannel_->admitMessage(pMsgHandler))
+				{
+					ScopedMessageHandleTimer handleTimer(*pMsgHandler);
+					ScopedFlightEvent flightEvent(pMsgHandler->name.c_str());
+					pMsgHandler->handle(pChannel_, *pFragmentStream_);
+				}
+
 				MemoryStream::reclaimPoolObject(pFragmentStream_);
 				pFragmentStream_ = NULL;
 			}
@@ -186,7 +195,18 @@ void PacketReader::processMessages(Ouroboros::Network::MessageHandlers* pMsgHand
 				pPacket->wpos(frpos);
 
 				TRACE_MESSAGE_PACKET(true, pPacket, pMsgHandler, currMsgLen_, pChannel_->c_str(), true);
-				pMsgHandler->handle(pChannel_, *pPacket);
+
+				if (pChannel_->admitMessage(pMsgHandler))
+				{
+					ScopedMessageHandleTimer handleTimer(*pMsgHandler);
+					ScopedFlightEvent flightEvent(pMsgHandler->name.c_str());
+					pMsgHandler->handle(pChannel_, *pPacket);
+				}
+				else
+				{
+					// Dropped, skip the body
+					pPacket->rpos(frpos);
+				}
 
 				// Output a warning if the handler has not processed the data
 				if(currMsgLen_ > 0)
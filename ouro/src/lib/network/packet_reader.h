@@ -38,6 +38,15 @@ public:
 
 	virtual PacketReader::PACKET_READER_TYPE type()const { return PACKET_READER_TYPE_SOCKET; }
 
+	/**
+		True if no part of a message is buffered, the next byte received starts a new message
+	*/
+	bool idle() const
+	{
+		return fragmentDatasFlag_ == FRAGMENT_DATA_UNKNOW && pFragmentStream_ == NULL &&
+			currMsgID_ == 0 && currMsgLen_ == 0;
+	}
+
 
 protected:
 	enum FragmentDataTypes
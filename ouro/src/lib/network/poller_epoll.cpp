@@ -93,19 +93,25 @@ int EpollPoller::processPendingEvents(double maxWait)
 	int maxWaitInMilliseconds = int(ceil(maxWait * 1000));
 
 #if ENABLE_WATCHERS
-	g_idleProfile.start();
+	if (isMainThread_)
+		g_idleProfile.start();
 #else
 	uint64 startTime = timestamp();
 #endif
 
-	OUROConcurrency::onStartMainThreadIdling();
+	if (isMainThread_)
+		OUROConcurrency::onStartMainThreadIdling();
 	int nfds = epoll_wait(epfd_, events, MAX_EVENTS, maxWaitInMilliseconds);
-	OUROConcurrency::onEndMainThreadIdling();
+	if (isMainThread_)
+		OUROConcurrency::onEndMainThreadIdling();
 
 
 #if ENABLE_WATCHERS
-	g_idleProfile.stop();
-	spareTime_ += g_idleProfile.lastTime_;
+	if (isMainThread_)
+	{
+		g_idleProfile.stop();
+		spareTime_ += g_idleProfile.lastTime_;
+	}
 #else
 	spareTime_ += timestamp() - startTime;
 #endif
@@ -80,12 +80,14 @@ int SelectPoller::processPendingEvents(double maxWait)
 		(int)((maxWait - (double)nextTimeout.tv_sec) * 1000000.0);
 
 #if ENABLE_WATCHERS
-	g_idleProfile.start();
+	if (isMainThread_)
+		g_idleProfile.start();
 #else
 	uint64 startTime = timestamp();
 #endif
 
-	OUROConcurrency::onStartMainThreadIdling();
+	if (isMainThread_)
+		OUROConcurrency::onStartMainThreadIdling();
 
 	int countReady = 0;
 
@@ -101,11 +103,15 @@ int SelectPoller::processPendingEvents(double maxWait)
 				fdWriteCount_ ? &writeFDs : NULL, NULL, &nextTimeout);
 	}
 
-	OUROConcurrency::onEndMainThreadIdling();
+	if (isMainThread_)
+		OUROConcurrency::onEndMainThreadIdling();
 
 #if ENABLE_WATCHERS
-	g_idleProfile.stop();
-	spareTime_ += g_idleProfile.lastTime_;
+	if (isMainThread_)
+	{
+		g_idleProfile.stop();
+		spareTime_ += g_idleProfile.lastTime_;
+	}
 #else
 	spareTime_ += timestamp() - startTime;
 #endif
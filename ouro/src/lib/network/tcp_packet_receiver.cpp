@@ -14,6 +14,7 @@
 #include "network/network_interface.h"
 #include "network/event_poller.h"
 #include "network/error_reporter.h"
+#include "network/io_thread.h"
 #include <openssl/err.h>
 
 namespace Ouroboros { 
@@ -106,6 +107,12 @@ bool TCPPacketReceiver::processRecv(bool expectingPacket)
 
 	if(ret != REASON_SUCCESS)
 		this->dispatcher().errorReporter().reportException(ret, pEndpoint_->addr());
+
+	// Once the filter has consumed the whole packet the socket may be handed to an I/O thread,
+	// this receiver must not read from it any more then
+	IOThreadPool* pIOThreadPool = pChannel->networkInterface().pIOThreadPool();
+	if (pIOThreadPool && pIOThreadPool->attach(pChannel))
+		return false;
 	
 	return true;
 }
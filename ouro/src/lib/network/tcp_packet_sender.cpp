@@ -199,7 +199,7 @@ Reason TCPPacketSender::processFilterPacket(Channel* pChannel, Packet * pPacket,
 	}
 
 	EndPoint* pEndpoint = pChannel->pEndPoint();
-	int len = pEndpoint->send(pPacket->data() + pPacket->sentSize, pPacket->length() - pPacket->sentSize);
+	int len = pEndpoint->send(pPacket->data() + pPacket->rpos() + pPacket->sentSize, pPacket->length() - pPacket->sentSize);
 
 	if(len > 0)
 	{
@@ -10,23 +10,39 @@
 #include "network/network_interface.h"
 #include "network/packet_receiver.h"
 
+#include "zlib.h"
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+#ifdef _DEBUG
+#pragma comment(lib, "zlib_d.lib")
+#else
+#pragma comment(lib, "zlib.lib")
+#endif
+#endif
+
 namespace Ouroboros { 
 namespace Network
 {
 
 //-------------------------------------------------------------------------------------
-WebSocketPacketFilter::WebSocketPacketFilter(Channel* pChannel):
+WebSocketPacketFilter::WebSocketPacketFilter(Channel* pChannel, int deflateWindowBits):
 	pFragmentDatasRemain_(0),
 	fragmentDatasFlag_(FRAGMENT_MESSAGE_HREAD),
 	msg_opcode_(0),
 	msg_fin_(0),
+	msg_rsv1_(0),
 	msg_masked_(0),
 	msg_mask_(0),
 	msg_length_field_(0),
 	msg_payload_length_(0),
 	msg_frameType_(websocket::WebSocketProtocol::ERROR_FRAME),
 	pChannel_(pChannel),
-	pTCPPacket_(NULL)
+	pTCPPacket_(NULL),
+	deflateWindowBits_(deflateWindowBits),
+	pDeflater_(NULL),
+	pInflater_(NULL),
+	deflateBuffer_(),
+	msg_deflated_(false)
 {
 }
 
@@ -34,6 +50,20 @@ WebSocketPacketFilter::WebSocketPacketFilter(Channel* pChannel):
 WebSocketPacketFilter::~WebSocketPacketFilter()
 {
 	reset();
+
+	if (pDeflater_)
+	{
+		deflateEnd(pDeflater_);
+		delete pDeflater_;
+		pDeflater_ = NULL;
+	}
+
+	if (pInflater_)
+	{
+		inflateEnd(pInflater_);
+		delete pInflater_;
+		pInflater_ = NULL;
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -41,6 +71,7 @@ void WebSocketPacketFilter::reset()
 {
 	msg_opcode_ = 0;
 	msg_fin_ = 0;
+	msg_rsv1_ = 0;
 	msg_masked_ = 0;
 	msg_mask_ = 0;
 	msg_length_field_ = 0;
@@ -59,7 +90,6 @@ Reason WebSocketPacketFilter::send(Channel * pChannel, PacketSender& sender, Pac
 		return PacketFilter::send(pChannel, sender, pPacket, userarg);
 
 	Bundle* pBundle = pPacket->pBundle();
-	TCPPacket* pRetTCPPacket = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
 	websocket::WebSocketProtocol::FrameType frameType = websocket::WebSocketProtocol::BINARY_FRAME;
 
 	if (pBundle)
@@ -89,20 +119,17 @@ Reason WebSocketPacketFilter::send(Channel * pChannel, PacketSender& sender, Pac
 		}
 	}
 
-	websocket::WebSocketProtocol::makeFrame(frameType, pPacket, pRetTCPPacket);
+	uint8 frameByte = (uint8)frameType;
 
-	int space = pPacket->length() - pRetTCPPacket->space();
-	if(space > 0)
+	// Only messages of one packet are compressed, the frames of longer messages are sent as they are
+	if (deflateWindowBits_ > 0 && frameType == websocket::WebSocketProtocol::BINARY_FRAME &&
+		pPacket->length() >= g_websocketDeflateMinSize)
 	{
-		WARNING_MSG(fmt::format("WebSocketPacketFilter::send: no free space, buffer added:{}, total={}.\n",
-			space, pRetTCPPacket->size()));
-
-		pRetTCPPacket->data_resize(pRetTCPPacket->size() + space);
+		if (deflatePacket(pPacket))
+			frameByte |= websocket::WebSocketProtocol::FRAME_RSV1;
 	}
 
-	(*pRetTCPPacket).append(pPacket->data() + pPacket->rpos(), pPacket->length());
-	pRetTCPPacket->swap(*(static_cast<Ouroboros::MemoryStream*>(pPacket)));
-	TCPPacket::reclaimPoolObject(pRetTCPPacket);
+	writeFrameHeader(pPacket, frameByte);
 
 	pPacket->encrypted(true);
 	return PacketFilter::send(pChannel, sender, pPacket, userarg);
@@ -124,8 +151,8 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 				reset();
 
 				// If no cache has been created, try to parse the header directly. If the information is sufficiently parsed, continue to the next step.
-				pFragmentDatasRemain_ = websocket::WebSocketProtocol::getFrame(pPacket, msg_opcode_, msg_fin_, msg_masked_,
-					msg_mask_, msg_length_field_, msg_payload_length_, msg_frameType_);
+				pFragmentDatasRemain_ = websocket::WebSocketProtocol::getFrame(pPacket, msg_opcode_, msg_fin_, msg_rsv1_,
+					msg_masked_, msg_mask_, msg_length_field_, msg_payload_length_, msg_frameType_);
 
 				if (pFragmentDatasRemain_ > 0)
 				{
@@ -134,7 +161,7 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 					pTCPPacket_->append(*(static_cast<MemoryStream*>(pPacket)));
 					pPacket->done();
 				}
-				else
+				else if (msg_payload_length_ > 0)
 				{
 					fragmentDatasFlag_ = FRAGMENT_MESSAGE_DATAS;
 					pFragmentDatasRemain_ = (int32)msg_payload_length_;
@@ -163,8 +190,8 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 					pPacket->read_skip(pFragmentDatasRemain_);
 
 					size_t buffer_rpos = pTCPPacket_->rpos();
-					pFragmentDatasRemain_ = websocket::WebSocketProtocol::getFrame(pTCPPacket_, msg_opcode_, msg_fin_, msg_masked_,
-						msg_mask_, msg_length_field_, msg_payload_length_, msg_frameType_);
+					pFragmentDatasRemain_ = websocket::WebSocketProtocol::getFrame(pTCPPacket_, msg_opcode_, msg_fin_, msg_rsv1_,
+						msg_masked_, msg_mask_, msg_length_field_, msg_payload_length_, msg_frameType_);
 
 					// If it is still greater than 0, it means that it needs to continue to receive the package.
 					if (pFragmentDatasRemain_ > 0)
@@ -235,6 +262,19 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 			{
 				// continue to wait for subsequent content to arrive
 			}
+			else if (msg_frameType_ == websocket::WebSocketProtocol::BINARY_FRAME ||
+				msg_frameType_ == websocket::WebSocketProtocol::INCOMPLETE_BINARY_FRAME)
+			{
+				Reason reason = onDataFrame(pChannel, receiver);
+				if (reason != REASON_SUCCESS)
+				{
+					this->pChannel_->condemn("WebSocketPacketFilter::recv: data-frame error!");
+					reset();
+
+					TCPPacket::reclaimPoolObject(static_cast<TCPPacket*>(pPacket));
+					return reason;
+				}
+			}
 			else if (msg_frameType_ == websocket::WebSocketProtocol::PING_FRAME)
 			{
 				if (pFragmentDatasRemain_ <= 0)
@@ -269,6 +309,9 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 			if (pTCPPacket_ == NULL)
 				pTCPPacket_ = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
 
+			// Position of the data taken from this packet in the payload, the mask continues from there
+			uint64 payloadOffset = msg_payload_length_ - (uint64)pFragmentDatasRemain_;
+
 			if (pFragmentDatasRemain_ <= (int32)pPacket->length())
 			{
 				pTCPPacket_->append(pPacket->data() + pPacket->rpos(), pFragmentDatasRemain_);
@@ -306,7 +349,7 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 			}
 			else
 			{
-				if (!websocket::WebSocketProtocol::decodingDatas(pTCPPacket_, msg_masked_, msg_mask_))
+				if (!websocket::WebSocketProtocol::decodingDatas(pTCPPacket_, msg_masked_, msg_mask_, payloadOffset))
 				{
 					ERROR_MSG(fmt::format("WebSocketPacketFilter::recv: decoding-frame error! addr={}!\n",
 						pChannel_->c_str()));
@@ -318,8 +361,19 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 					return REASON_WEBSOCKET_ERROR;
 				}
 
-				reason = PacketFilter::recv(pChannel, receiver, pTCPPacket_);
-				OURO_ASSERT(reason == REASON_SUCCESS);
+				if (msg_deflated_)
+				{
+					reason = inflatePacket(pChannel, receiver, pTCPPacket_, msg_fin_ && pFragmentDatasRemain_ == 0);
+					TCPPacket::reclaimPoolObject(pTCPPacket_);
+
+					if (reason != REASON_SUCCESS)
+						this->pChannel_->condemn("WebSocketPacketFilter::recv: inflate error!");
+				}
+				else
+				{
+					reason = PacketFilter::recv(pChannel, receiver, pTCPPacket_);
+					OURO_ASSERT(reason == REASON_SUCCESS);
+				}
 
 				// pTCPPacket_ does not need to be recycled here
 				pTCPPacket_ = NULL;
@@ -378,6 +432,211 @@ Reason WebSocketPacketFilter::onPing(Channel * pChannel, Packet* pPacket)
 	return REASON_SUCCESS;
 }
 
+//-------------------------------------------------------------------------------------
+Reason WebSocketPacketFilter::onDataFrame(Channel * pChannel, PacketReceiver & receiver)
+{
+	// RSV1 is only set on the first frame of a message, the continuation frames(opcode 0) belong to it
+	if (msg_opcode_ != 0)
+	{
+		msg_deflated_ = msg_rsv1_ != 0;
+	}
+	else if (msg_rsv1_)
+	{
+		ERROR_MSG(fmt::format("WebSocketPacketFilter::onDataFrame: RSV1 set on a continuation frame! addr={}!\n",
+			pChannel_->c_str()));
+
+		return REASON_WEBSOCKET_ERROR;
+	}
+
+	if (msg_deflated_ && deflateWindowBits_ == 0)
+	{
+		ERROR_MSG(fmt::format("WebSocketPacketFilter::onDataFrame: permessage-deflate was not negotiated! addr={}!\n",
+			pChannel_->c_str()));
+
+		return REASON_WEBSOCKET_ERROR;
+	}
+
+	// An empty frame that ends a compressed message, the inflater still needs the end of the message
+	if (msg_deflated_ && msg_fin_ && msg_payload_length_ == 0)
+		return inflatePacket(pChannel, receiver, NULL, true);
+
+	return REASON_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------
+void WebSocketPacketFilter::writeFrameHeader(Packet* pPacket, uint8 frameByte)
+{
+	uint64 payloadLength = pPacket->length();
+	size_t headerSize = websocket::WebSocketProtocol::frameHeaderSize(payloadLength);
+
+	// The packet was not created by a bundle of a websocket channel(e.g. it was filled
+	// before the handshake), move the payload back to make room for the header
+	if (pPacket->rpos() < headerSize)
+	{
+		size_t shift = headerSize - pPacket->rpos();
+
+		if (pPacket->wpos() + shift > pPacket->size())
+			pPacket->data_resize(pPacket->wpos() + shift);
+
+		memmove(pPacket->data() + pPacket->rpos() + shift, pPacket->data() + pPacket->rpos(), (size_t)payloadLength);
+		pPacket->wpos((int)(pPacket->wpos() + shift));
+		pPacket->rpos((int)(pPacket->rpos() + shift));
+	}
+
+	pPacket->rpos((int)(pPacket->rpos() - headerSize));
+	websocket::WebSocketProtocol::writeFrameHeader(frameByte, payloadLength, pPacket->data() + pPacket->rpos());
+}
+
+//-------------------------------------------------------------------------------------
+bool WebSocketPacketFilter::deflatePacket(Packet* pPacket)
+{
+	if (pDeflater_ == NULL)
+	{
+		pDeflater_ = new z_stream;
+		memset(pDeflater_, 0, sizeof(z_stream));
+
+		// Raw deflate(negative window bits), see SERVER_DEFLATE_WINDOW_BITS for the size of the state
+		if (deflateInit2(pDeflater_, Z_BEST_SPEED, Z_DEFLATED, -deflateWindowBits_, 5, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			ERROR_MSG(fmt::format("WebSocketPacketFilter::deflatePacket: deflateInit2 error! addr={}!\n",
+				pChannel_->c_str()));
+
+			delete pDeflater_;
+			pDeflater_ = NULL;
+			deflateWindowBits_ = 0;
+			return false;
+		}
+	}
+	else
+	{
+		// server_no_context_takeover, every message is compressed on its own
+		deflateReset(pDeflater_);
+	}
+
+	size_t length = pPacket->length();
+
+	// The output is only used if it is shorter than the input, the 4 bytes of the flush are removed
+	deflateBuffer_.resize(length + 4);
+
+	pDeflater_->next_in = (Bytef*)(pPacket->data() + pPacket->rpos());
+	pDeflater_->avail_in = (uInt)length;
+	pDeflater_->next_out = (Bytef*)&deflateBuffer_[0];
+	pDeflater_->avail_out = (uInt)deflateBuffer_.size();
+
+	int ret = deflate(pDeflater_, Z_SYNC_FLUSH);
+
+	// Out of space, the data does not get shorter
+	if (ret != Z_OK || pDeflater_->avail_in > 0 || pDeflater_->avail_out == 0)
+		return false;
+
+	size_t size = deflateBuffer_.size() - pDeflater_->avail_out;
+	if (size < 4 || size - 4 >= length)
+		return false;
+
+	// RFC7692, the empty block(00 00 ff ff) that ends the flush is not sent
+	size -= 4;
+
+	memcpy(pPacket->data() + pPacket->rpos(), &deflateBuffer_[0], size);
+	pPacket->wpos((int)(pPacket->rpos() + size));
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+Reason WebSocketPacketFilter::inflatePacket(Channel * pChannel, PacketReceiver & receiver, Packet* pPacket, bool fin)
+{
+	if (pInflater_ == NULL)
+	{
+		pInflater_ = new z_stream;
+		memset(pInflater_, 0, sizeof(z_stream));
+
+		// The client may use any window and keep its context, the inflater is never reset
+		if (inflateInit2(pInflater_, -15) != Z_OK)
+		{
+			ERROR_MSG(fmt::format("WebSocketPacketFilter::inflatePacket: inflateInit2 error! addr={}!\n",
+				pChannel_->c_str()));
+
+			delete pInflater_;
+			pInflater_ = NULL;
+			return REASON_WEBSOCKET_ERROR;
+		}
+	}
+
+	static const uint8 flushTail[4] = { 0x00, 0x00, 0xff, 0xff };
+
+	TCPPacket* pOutPacket = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+
+	for (int i = 0; i < 2; ++i)
+	{
+		if (i == 0)
+		{
+			if (pPacket == NULL || pPacket->length() == 0)
+				continue;
+
+			pInflater_->next_in = (Bytef*)(pPacket->data() + pPacket->rpos());
+			pInflater_->avail_in = (uInt)pPacket->length();
+		}
+		else
+		{
+			// The end of the message, put back the bytes the client removed
+			if (!fin)
+				break;
+
+			pInflater_->next_in = (Bytef*)flushTail;
+			pInflater_->avail_in = sizeof(flushTail);
+		}
+
+		do
+		{
+			if (pOutPacket->space() < 256)
+				pOutPacket->data_resize(pOutPacket->size() * 2);
+
+			pInflater_->next_out = (Bytef*)(pOutPacket->data() + pOutPacket->wpos());
+			pInflater_->avail_out = (uInt)pOutPacket->space();
+
+			int ret = inflate(pInflater_, Z_SYNC_FLUSH);
+			pOutPacket->wpos((int)(pOutPacket->size() - pInflater_->avail_out));
+
+			if (ret == Z_STREAM_END)
+			{
+				// The client ended the stream(BFINAL), the next message starts a new one
+				inflateReset(pInflater_);
+			}
+			else if (ret == Z_BUF_ERROR && pInflater_->avail_out > 0)
+			{
+				// All the input was used
+				break;
+			}
+			else if (ret != Z_OK && ret != Z_BUF_ERROR)
+			{
+				ERROR_MSG(fmt::format("WebSocketPacketFilter::inflatePacket: inflate error({})! addr={}!\n",
+					ret, pChannel_->c_str()));
+
+				TCPPacket::reclaimPoolObject(pOutPacket);
+				return REASON_WEBSOCKET_ERROR;
+			}
+
+			// Same limit as an uncompressed frame
+			if (pOutPacket->length() > NETWORK_MESSAGE_MAX_SIZE)
+			{
+				ERROR_MSG(fmt::format("WebSocketPacketFilter::inflatePacket: msglen exceeds the limit! maxlen={}, addr={}!\n",
+					NETWORK_MESSAGE_MAX_SIZE, pChannel_->c_str()));
+
+				TCPPacket::reclaimPoolObject(pOutPacket);
+				return REASON_WEBSOCKET_ERROR;
+			}
+
+		} while (pInflater_->avail_in > 0 || pInflater_->avail_out == 0);
+	}
+
+	if (pOutPacket->length() == 0)
+	{
+		TCPPacket::reclaimPoolObject(pOutPacket);
+		return REASON_SUCCESS;
+	}
+
+	return PacketFilter::recv(pChannel, receiver, pOutPacket);
+}
+
 //-------------------------------------------------------------------------------------
 } 
 }
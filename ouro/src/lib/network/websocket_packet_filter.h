@@ -7,6 +7,8 @@
 #include "network/packet_filter.h"
 #include "network/websocket_protocol.h"
 
+struct z_stream_s;
+
 namespace Ouroboros { 
 namespace Network
 {
@@ -15,7 +17,10 @@ class TCPPacket;
 class WebSocketPacketFilter : public PacketFilter
 {
 public:
-	WebSocketPacketFilter(Channel* pChannel);
+	/**
+		deflateWindowBits > 0 if permessage-deflate was negotiated in the handshake
+	*/
+	WebSocketPacketFilter(Channel* pChannel, int deflateWindowBits = 0);
 	virtual ~WebSocketPacketFilter();
 
 	virtual Reason send(Channel * pChannel, PacketSender& sender, Packet * pPacket, int userarg);
@@ -25,6 +30,28 @@ protected:
 	void reset();
 	Reason onPing(Channel * pChannel, Packet* pPacket);
 
+	/**
+		Called when the header of a binary frame was parsed
+	*/
+	Reason onDataFrame(Channel * pChannel, PacketReceiver & receiver);
+
+	/**
+		Writes the frame header in front of the payload, into the room the bundle reserved
+		for websocket channels(see Bundle::newPacket), the payload is only moved if there is no room
+	*/
+	void writeFrameHeader(Packet* pPacket, uint8 frameByte);
+
+	/**
+		Compresses the payload in place, false if it did not get shorter
+	*/
+	bool deflatePacket(Packet* pPacket);
+
+	/**
+		Decompresses the payload of a frame of a compressed message and passes it on,
+		pPacket may be NULL for an empty frame
+	*/
+	Reason inflatePacket(Channel * pChannel, PacketReceiver & receiver, Packet* pPacket, bool fin);
+
 protected:
 	enum FragmentDataTypes
 	{
@@ -37,6 +64,7 @@ protected:
 
 	uint8										msg_opcode_;
 	uint8										msg_fin_;
+	uint8										msg_rsv1_;
 	uint8										msg_masked_;
 	uint32										msg_mask_;
 	int32										msg_length_field_;
@@ -46,6 +74,15 @@ protected:
 	Channel*									pChannel_;
 
 	TCPPacket*									pTCPPacket_;
+
+	// permessage-deflate, the streams are created the first time they are used
+	int											deflateWindowBits_;
+	z_stream_s*									pDeflater_;
+	z_stream_s*									pInflater_;
+	std::vector<uint8>							deflateBuffer_;
+
+	// The message the received frames belong to is compressed(RSV1 of its first frame)
+	bool										msg_deflated_;
 };
 
 
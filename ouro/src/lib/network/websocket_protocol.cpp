@@ -8,6 +8,11 @@
 #include "common/base64.h"
 #include "common/sha1.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OURO_WEBSOCKET_SSE2
+#include <emmintrin.h>
+#endif
+
 #if OURO_PLATFORM == PLATFORM_WIN32
 #ifdef _DEBUG
 #pragma comment(lib, "libeay32_d.lib")
@@ -22,6 +27,10 @@ namespace Ouroboros{
 namespace Network{
 namespace websocket{
 
+// The frames sent are at most one packet(PACKET_MAX_SIZE_TCP), a window of 2048 bytes covers them
+// and the deflate state of a channel stays small(about 24KB)
+static const int SERVER_DEFLATE_WINDOW_BITS = 11;
+
 //-------------------------------------------------------------------------------------
 bool WebSocketProtocol::isWebSocketProtocol(MemoryStream* s)
 {
@@ -64,9 +73,11 @@ bool WebSocketProtocol::isWebSocketProtocol(MemoryStream* s)
 }
 
 //-------------------------------------------------------------------------------------
-bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s)
+bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s, int& deflateWindowBits)
 {
 	OURO_ASSERT(s != NULL);
+
+	deflateWindowBits = 0;
 	
 	// The string plus the terminator must be at least 2 in length, otherwise it will be returned to avoid an exception in MemoryStream.
 	if(s->length() < 2)
@@ -146,6 +157,20 @@ bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s)
 
 	szHost = findIter->second;
 
+	std::string szExtensions;
+
+	findIter = headers.find("Sec-WebSocket-Extensions");
+	if (findIter != headers.end() && g_websocketDeflate)
+	{
+		deflateWindowBits = negotiateDeflate(findIter->second);
+
+		// The server deflates every message on its own, the client may keep its context
+		if (deflateWindowBits > 0)
+		{
+			szExtensions = fmt::format("Sec-WebSocket-Extensions: permessage-deflate; server_no_context_takeover; "
+				"server_max_window_bits={}\r\n", deflateWindowBits);
+		}
+	}
 
     std::string server_key = szKey;
 
@@ -168,9 +193,10 @@ bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s)
 								"Connection: Upgrade\r\n"
 								"Sec-WebSocket-Accept: {}\r\n"
 								"{}"
+								"{}"
 								"WebSocket-Location: ws://{}/WebManagerSocket\r\n"
 								"WebSocket-Protocol: WebManagerSocket\r\n\r\n", 
-								server_key, szOrigin, szHost);
+								server_key, szOrigin, szExtensions, szHost);
 
 	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
 	(*pBundle) << ackHandshake;
@@ -179,6 +205,105 @@ bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+int WebSocketProtocol::negotiateDeflate(const std::string& extensions)
+{
+	// e.g. "permessage-deflate; client_max_window_bits, x-webkit-deflate-frame"
+	std::vector<std::string> offers;
+	Ouroboros::strutil::ouro_splits(extensions, ",", offers);
+
+	std::vector<std::string>::iterator iter = offers.begin();
+	for (; iter != offers.end(); ++iter)
+	{
+		std::vector<std::string> params;
+		Ouroboros::strutil::ouro_splits((*iter), ";", params);
+
+		if (params.empty() || Ouroboros::strutil::ouro_trim(params[0]) != "permessage-deflate")
+			continue;
+
+		int windowBits = SERVER_DEFLATE_WINDOW_BITS;
+		bool accepted = true;
+
+		for (size_t i = 1; i < params.size() && accepted; ++i)
+		{
+			std::string param = Ouroboros::strutil::ouro_trim(params[i]);
+			std::string value;
+
+			std::string::size_type findex = param.find('=');
+			if (findex != std::string::npos)
+			{
+				value = param.substr(findex + 1);
+				param = param.substr(0, findex);
+
+				Ouroboros::strutil::ouro_replace(value, "\"", "");
+				value = Ouroboros::strutil::ouro_trim(value);
+				param = Ouroboros::strutil::ouro_trim(param);
+			}
+
+			if (param == "server_no_context_takeover" || param == "client_no_context_takeover" ||
+				param == "client_max_window_bits")
+			{
+				continue;
+			}
+			else if (param == "server_max_window_bits")
+			{
+				int bits = atoi(value.c_str());
+
+				// zlib does not write raw deflate with a window of 256 bytes
+				if (bits < 9 || bits > 15)
+					accepted = false;
+				else
+					windowBits = std::min(windowBits, bits);
+			}
+			else
+			{
+				// RFC7692, an offer with an unknown parameter is declined
+				accepted = false;
+			}
+		}
+
+		if (accepted)
+			return windowBits;
+	}
+
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------
+size_t WebSocketProtocol::frameHeaderSize(uint64 payloadLength)
+{
+	if (payloadLength <= 125)
+		return 2;
+	else if (payloadLength <= 65535)
+		return 4;
+
+	return 10;
+}
+
+//-------------------------------------------------------------------------------------
+void WebSocketProtocol::writeFrameHeader(uint8 frameByte, uint64 payloadLength, uint8* pBuffer)
+{
+	pBuffer[0] = frameByte;
+
+	if (payloadLength <= 125)
+	{
+		pBuffer[1] = (uint8)payloadLength;
+	}
+	else if (payloadLength <= 65535)
+	{
+		pBuffer[1] = 126;
+		pBuffer[2] = (uint8)((payloadLength >> 8) & 0xff);
+		pBuffer[3] = (uint8)(payloadLength & 0xff);
+	}
+	else
+	{
+		pBuffer[1] = 127;
+
+		for (int i = 0; i < 8; ++i)
+			pBuffer[2 + i] = (uint8)((payloadLength >> (56 - i * 8)) & 0xff);
+	}
+}
+
 //-------------------------------------------------------------------------------------
 int WebSocketProtocol::makeFrame(WebSocketProtocol::FrameType frame_type, 
 	Packet * pInPacket, Packet * pOutPacket)
@@ -213,8 +338,8 @@ int WebSocketProtocol::makeFrame(WebSocketProtocol::FrameType frame_type,
 }
 
 //-------------------------------------------------------------------------------------
-int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_masked, uint32& msg_mask, 
-		int32& msg_length_field, uint64& msg_payload_length, FrameType& frameType)
+int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_rsv1, uint8& msg_masked, 
+		uint32& msg_mask, int32& msg_length_field, uint64& msg_payload_length, FrameType& frameType)
 {
 	/*
 	 	0                   1                   2                   3
@@ -251,6 +376,7 @@ int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_
 
 	msg_opcode = bytedata & 0x0F;
 	msg_fin = (bytedata >> 7) & 0x01;
+	msg_rsv1 = (bytedata >> 6) & 0x01;
 
 	// The second byte, the second byte of the message is mainly used to describe the mask and message length. The highest bit uses 0 or 1 to describe whether there is mask processing.
 	(*pPacket) >> bytedata;
@@ -349,18 +475,53 @@ int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_
 }
 
 //-------------------------------------------------------------------------------------
-bool WebSocketProtocol::decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask)
+bool WebSocketProtocol::decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask, uint64 offset)
 {
 	// Decode the content
 	if(msg_masked) 
+		unmask(pPacket->data() + pPacket->rpos(), pPacket->length(), msg_mask, offset);
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void WebSocketProtocol::unmask(uint8* pData, size_t size, uint32 msg_mask, uint64 offset)
+{
+	// msg_mask holds the 4 bytes of the masking-key in the order they were received,
+	// rotate them so that the first one applies to pData[0]
+	const uint8* pKey = (const uint8*)&msg_mask;
+
+	uint8 mask[4];
+	for (int i = 0; i < 4; ++i)
+		mask[i] = pKey[(offset + i) & 3];
+
+	uint32 mask32;
+	memcpy(&mask32, mask, sizeof(mask32));
+
+	size_t i = 0;
+
+#ifdef OURO_WEBSOCKET_SSE2
+	const __m128i mask128 = _mm_set1_epi32((int)mask32);
+
+	for (; i + 16 <= size; i += 16)
 	{
-		uint8* c = pPacket->data() + pPacket->rpos();
-		for(int i=0; i<(int)pPacket->length(); i++) {
-			c[i] = c[i] ^ ((uint8*)(&msg_mask))[i % 4];
-		}
+		__m128i v = _mm_loadu_si128((const __m128i*)(pData + i));
+		_mm_storeu_si128((__m128i*)(pData + i), _mm_xor_si128(v, mask128));
 	}
+#endif
 
-	return true;
+	const uint64 mask64 = ((uint64)mask32 << 32) | mask32;
+
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64 v;
+		memcpy(&v, pData + i, sizeof(v));
+		v ^= mask64;
+		memcpy(pData + i, &v, sizeof(v));
+	}
+
+	for (; i < size; ++i)
+		pData[i] ^= mask[i & 3];
 }
 
 std::string WebSocketProtocol::getFrameTypeName(FrameType frame_type)
@@ -52,6 +52,14 @@ public:
 		CLOSE_FRAME = 0x08
 	};
 
+	// RSV1, set on the first frame of a message compressed by permessage-deflate
+	static const uint8 FRAME_RSV1 = 0x40;
+
+	// Room kept in front of the outgoing packets of websocket channels for the frame header,
+	// the frames of the server are not masked and a packet is shorter than 65536 bytes,
+	// so the 16-bit length form(4 bytes) is the longest header written, see Bundle::newPacket
+	static const int SEND_HEADER_RESERVE = 4;
+
 	/**
 		Is it a websocket protocol?
 	*/
@@ -60,16 +68,37 @@ public:
 	/**
 		Websocket protocol handshake
 	*/
-	static bool handshake(Network::Channel* pChannel, MemoryStream* s);
+	/**
+		deflateWindowBits is the window of the server for permessage-deflate, 0 if the client did not
+		offer the extension or the extension is disabled
+	*/
+	static bool handshake(Network::Channel* pChannel, MemoryStream* s, int& deflateWindowBits);
+
+	/**
+		Parses Sec-WebSocket-Extensions, returns the window bits of the server if an offer of
+		permessage-deflate was accepted, otherwise 0
+	*/
+	static int negotiateDeflate(const std::string& extensions);
 
 	/**
 		Frame parsing related
 	*/
 	static int makeFrame(FrameType frame_type, Packet* pInPacket, Packet* pOutPacket);
-	static int getFrame(Packet* pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_masked, uint32& msg_mask, 
-		int32& msg_length_field, uint64& msg_payload_length, FrameType& frameType);
+	static int getFrame(Packet* pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_rsv1, uint8& msg_masked, 
+		uint32& msg_mask, int32& msg_length_field, uint64& msg_payload_length, FrameType& frameType);
+
+	/**
+		Header of an unmasked frame, written into pBuffer which has at least frameHeaderSize bytes
+	*/
+	static size_t frameHeaderSize(uint64 payloadLength);
+	static void writeFrameHeader(uint8 frameByte, uint64 payloadLength, uint8* pBuffer);
 
-	static bool decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask);
+	/**
+		Unmasks the data in place, offset is the position of the first byte of the data in the
+		payload of the frame(the data of a frame can arrive in several packets)
+	*/
+	static bool decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask, uint64 offset = 0);
+	static void unmask(uint8* pData, size_t size, uint32 msg_mask, uint64 offset);
 
 	static std::string getFrameTypeName(FrameType frame_type);
 
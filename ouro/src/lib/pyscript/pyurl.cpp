@@ -9,7 +9,7 @@
 namespace Ouroboros{ namespace script {
 
 bool PyUrl::isInit = false;
-std::map<PyObject*, PyObjectPtr> PyUrl::pyCallbacks;
+std::multimap<PyObject*, PyObjectPtr> PyUrl::pyCallbacks;
 
 //-------------------------------------------------------------------------------------
 bool PyUrl::initialize(Script* pScript)
@@ -62,7 +62,10 @@ void PyUrl::onHttpCallback(bool success, const Network::Http::Request& pRequest,
 	}
 
 	Py_DECREF(pyargs);
-	pyCallbacks.erase((PyObject*)pRequest.getUserargs());
+
+	std::multimap<PyObject*, PyObjectPtr>::iterator iter = pyCallbacks.find((PyObject*)pRequest.getUserargs());
+	if (iter != pyCallbacks.end())
+		pyCallbacks.erase(iter);
 }
 
 //-------------------------------------------------------------------------------------
@@ -187,7 +190,7 @@ PyObject* PyUrl::__py_urlopen(PyObject* self, PyObject* args)
 
 	if (pyCallback)
 	{
-		pyCallbacks[pyCallback] = PyObjectPtr(pyCallback);
+		pyCallbacks.insert(std::make_pair(pyCallback, PyObjectPtr(pyCallback)));
 		pRequest->setUserargs(pyCallback);
 		pRequest->setCallback(onHttpCallback);
 	}
@@ -27,7 +27,8 @@ public:
 
 private:
 	static bool isInit; // whether it has been initialized
-	static std::map<PyObject*, PyObjectPtr> pyCallbacks;
+	// One entry per request, a callback may be used by several requests at once
+	static std::multimap<PyObject*, PyObjectPtr> pyCallbacks;
 
 };
 
@@ -685,7 +685,11 @@ void EntityApp<E>::handleTimeout(TimerHandle handle, void * arg)
 	switch (reinterpret_cast<uintptr>(arg))
 	{
 		case TIMEOUT_GAME_TICK:
-			this->handleGameTick();
+			{
+				ScopedMetricsTimer metricsTimer(pTickHistogram_);
+				ScopedFlightTick flightTick;
+				this->handleGameTick();
+			}
 			break;
 		default:
 			break;
@@ -0,0 +1,172 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "load_predictor.h"
+
+namespace Ouroboros{
+
+// Weight of a new sample in the learned cost of an entity type
+static const float COST_LEARNING_RATE = 0.2f;
+
+// A single report may move the cost of a type at most by this factor, loads are noisy
+static const float COST_MAX_RATIO = 4.f;
+
+static const float COST_MIN = 0.00001f;
+static const float COST_MAX = 0.1f;
+
+static const size_t RECENT_ASSIGNMENTS = 256;
+
+//-------------------------------------------------------------------------------------
+LoadPredictor::LoadPredictor(float defaultCost):
+apps_(),
+costs_(),
+defaultCost_(defaultCost),
+recent_(),
+recentCounts_(),
+numCandidates_(0),
+numAssigned_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+LoadPredictor::~LoadPredictor()
+{
+}
+
+//-------------------------------------------------------------------------------------
+void LoadPredictor::onReport(COMPONENT_ID cid, float load, ENTITY_ID numEntities)
+{
+	APP& app = apps_[cid];
+
+	// Only learn while the app grows, a shrinking app says nothing about the cost of new entities
+	if (app.reported && app.pendingCost > 0.f && numEntities > app.numEntities)
+	{
+		float ratio = (load - app.load) / app.pendingCost;
+		ratio = OURO_MAX(1.f / COST_MAX_RATIO, OURO_MIN(COST_MAX_RATIO, ratio));
+
+		std::map<std::string, uint32>::iterator iter = app.pendingTypes.begin();
+		for (; iter != app.pendingTypes.end(); ++iter)
+		{
+			float cost = entityCost(iter->first);
+			cost += COST_LEARNING_RATE * (cost * ratio - cost);
+			costs_[iter->first] = OURO_MAX(COST_MIN, OURO_MIN(COST_MAX, cost));
+		}
+	}
+
+	app.load = load;
+	app.predictedLoad = load;
+	app.numEntities = numEntities;
+	app.reported = true;
+	app.pendingCost = 0.f;
+	app.pendingTypes.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void LoadPredictor::onAssign(COMPONENT_ID cid, const std::string& entityType)
+{
+	APP& app = apps_[cid];
+
+	float cost = entityCost(entityType);
+	app.predictedLoad += cost;
+	app.pendingCost += cost;
+	++app.pendingTypes[entityType];
+
+	++numAssigned_;
+
+	recent_.push_back(cid);
+	++recentCounts_[cid];
+
+	if (recent_.size() > RECENT_ASSIGNMENTS)
+	{
+		std::map<COMPONENT_ID, uint32>::iterator iter = recentCounts_.find(recent_.front());
+		if (iter != recentCounts_.end() && --iter->second == 0)
+			recentCounts_.erase(iter);
+
+		recent_.pop_front();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void LoadPredictor::remove(COMPONENT_ID cid)
+{
+	apps_.erase(cid);
+}
+
+//-------------------------------------------------------------------------------------
+float LoadPredictor::predictedLoad(COMPONENT_ID cid) const
+{
+	std::map<COMPONENT_ID, APP>::const_iterator iter = apps_.find(cid);
+	if (iter == apps_.end())
+		return 0.f;
+
+	return iter->second.predictedLoad;
+}
+
+//-------------------------------------------------------------------------------------
+float LoadPredictor::entityCost(const std::string& entityType) const
+{
+	std::map<std::string, float>::const_iterator iter = costs_.find(entityType);
+	if (iter == costs_.end())
+		return defaultCost_;
+
+	return iter->second;
+}
+
+//-------------------------------------------------------------------------------------
+COMPONENT_ID LoadPredictor::choose(const std::vector<COMPONENT_ID>& candidates)
+{
+	numCandidates_ = (uint32)candidates.size();
+
+	if (candidates.size() == 0)
+		return 0;
+
+	if (candidates.size() == 1)
+		return candidates[0];
+
+	size_t i = rand() % candidates.size();
+	size_t j = rand() % (candidates.size() - 1);
+
+	// Distinct from i
+	if (j >= i)
+		++j;
+
+	float loadi = predictedLoad(candidates[i]);
+	float loadj = predictedLoad(candidates[j]);
+
+	if (loadi == loadj)
+		return candidates[(rand() & 1) ? i : j];
+
+	return loadi < loadj ? candidates[i] : candidates[j];
+}
+
+//-------------------------------------------------------------------------------------
+float LoadPredictor::assignSkew() const
+{
+	if (recent_.size() == 0 || numCandidates_ == 0)
+		return 0.f;
+
+	uint32 maxCount = 0;
+
+	std::map<COMPONENT_ID, uint32>::const_iterator iter = recentCounts_.begin();
+	for (; iter != recentCounts_.end(); ++iter)
+		maxCount = OURO_MAX(maxCount, iter->second);
+
+	return float(maxCount) * float(numCandidates_) / float(recent_.size());
+}
+
+//-------------------------------------------------------------------------------------
+std::string LoadPredictor::costsToString() const
+{
+	std::string str;
+
+	std::map<std::string, float>::const_iterator iter = costs_.begin();
+	for (; iter != costs_.end(); ++iter)
+	{
+		str += fmt::format("{}{}={:.6f}", (str.size() > 0 ? ", " : ""),
+			(iter->first.size() > 0 ? iter->first : "unknown"), iter->second);
+	}
+
+	return str;
+}
+
+//-------------------------------------------------------------------------------------
+}
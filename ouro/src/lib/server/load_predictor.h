@@ -0,0 +1,91 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_LOAD_PREDICTOR_H
+#define OURO_LOAD_PREDICTOR_H
+
+#include "common/common.h"
+#include "helper/debug_helper.h"
+#include <deque>
+#include <map>
+
+namespace Ouroboros{
+
+/*
+	Predicted load of the apps a manager places entities on(baseappmgr, cellappmgr).
+
+	Apps report their load once per report interval. In between, every placement adds the cost of its
+	entity type to the predicted load of the chosen app, so a login storm is spread over the apps instead of
+	landing on the app that was the least loaded at the last report.
+	The cost of an entity type is learned from the reports: the load an app gained between two reports is
+	compared with the cost that was predicted for the entities placed on it.
+*/
+class LoadPredictor
+{
+public:
+	struct APP
+	{
+		APP():
+		load(0.f),
+		predictedLoad(0.f),
+		numEntities(0),
+		reported(false),
+		pendingCost(0.f),
+		pendingTypes()
+		{
+		}
+
+		// Last report
+		float load;
+		float predictedLoad;
+		ENTITY_ID numEntities;
+		bool reported;
+
+		// Placements since the last report
+		float pendingCost;
+		std::map<std::string, uint32> pendingTypes;
+	};
+
+	LoadPredictor(float defaultCost = 0.001f);
+	~LoadPredictor();
+
+	void onReport(COMPONENT_ID cid, float load, ENTITY_ID numEntities);
+	void onAssign(COMPONENT_ID cid, const std::string& entityType);
+	void remove(COMPONENT_ID cid);
+
+	float predictedLoad(COMPONENT_ID cid) const;
+	float entityCost(const std::string& entityType) const;
+
+	/**
+		Power of two choices, the candidate with the lower predicted load of two random distinct candidates.
+		Returns 0 if there is no candidate.
+	*/
+	COMPONENT_ID choose(const std::vector<COMPONENT_ID>& candidates);
+
+	/**
+		Placements of the busiest app in the recent placements relative to an even spread, 1.0 is perfectly even
+	*/
+	float assignSkew() const;
+
+	uint32 numAssigned() const { return numAssigned_; }
+
+	/**
+		Learned costs, for the watchers
+	*/
+	std::string costsToString() const;
+
+private:
+	std::map<COMPONENT_ID, APP> apps_;
+	std::map<std::string, float> costs_;
+	float defaultCost_;
+
+	// The recent placements, the assignSkew window
+	std::deque<COMPONENT_ID> recent_;
+	std::map<COMPONENT_ID, uint32> recentCounts_;
+	uint32 numCandidates_;
+
+	uint32 numAssigned_;
+};
+
+}
+
+#endif // OURO_LOAD_PREDICTOR_H
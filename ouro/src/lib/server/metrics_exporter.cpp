@@ -0,0 +1,363 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+
+#include "metrics_exporter.h"
+#include "helper/watcher.h"
+#include "helper/metrics.h"
+
+namespace Ouroboros {
+
+// Requests are tiny, anything bigger is not a scraper
+#define METRICS_MAX_REQUEST_SIZE 8192
+
+//-------------------------------------------------------------------------------------
+MetricsExporter::MetricsExporter(Network::EventDispatcher& dispatcher):
+dispatcher_(dispatcher),
+listener_(),
+port_(0),
+clients_(),
+body_(),
+response_(),
+watcherStream_(),
+numScrapes_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+MetricsExporter::~MetricsExporter()
+{
+	stop();
+}
+
+//-------------------------------------------------------------------------------------
+bool MetricsExporter::start(uint16 port, uint32 ip)
+{
+	listener_.socket(SOCK_STREAM);
+	if (!listener_.good())
+	{
+		ERROR_MSG(fmt::format("MetricsExporter::start: couldn't create a socket! {}\n", ouro_strerror()));
+		return false;
+	}
+
+	listener_.setnonblocking(true);
+	listener_.setreuseaddr(true);
+
+	// Several components share a machine, the first free port from the configured one is used
+	int tryn = 0;
+	while(listener_.bind(htons(port), ip) == -1)
+	{
+		if(++tryn > 1024 || port == 65535)
+		{
+			ERROR_MSG(fmt::format("MetricsExporter::start: bind port({}) is failed! {}\n",
+				port, ouro_strerror()));
+
+			listener_.close();
+			return false;
+		}
+
+		++port;
+	}
+
+	if(listener_.listen() == -1)
+	{
+		ERROR_MSG(fmt::format("MetricsExporter::start: listen is failed! {}\n", ouro_strerror()));
+		listener_.close();
+		return false;
+	}
+
+	if(!dispatcher_.registerReadFileDescriptor(listener_, this))
+	{
+		ERROR_MSG("MetricsExporter::start: registerReadFileDescriptor is failed!\n");
+		listener_.close();
+		return false;
+	}
+
+	port_ = port;
+
+	INFO_MSG(fmt::format("MetricsExporter::start: http://{}:{}/metrics\n",
+		inet_ntoa((struct in_addr&)ip), port_));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void MetricsExporter::stop()
+{
+	while(!clients_.empty())
+		closeClient_(clients_.begin()->first);
+
+	if(listener_.good())
+	{
+		dispatcher_.deregisterReadFileDescriptor(listener_);
+		listener_.close();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void MetricsExporter::closeClient_(int fd)
+{
+	std::map<int, CLIENT>::iterator iter = clients_.find(fd);
+	if(iter == clients_.end())
+		return;
+
+	dispatcher_.deregisterReadFileDescriptor(fd);
+
+	if(iter->second.unsent.size() > 0)
+		dispatcher_.deregisterWriteFileDescriptor(fd);
+
+	Network::EndPoint::reclaimPoolObject(iter->second.pEndPoint);
+	clients_.erase(iter);
+}
+
+//-------------------------------------------------------------------------------------
+int MetricsExporter::handleInputNotification(int fd)
+{
+	if(fd == listener_)
+	{
+		onAccept_();
+		return 0;
+	}
+
+	std::map<int, CLIENT>::iterator iter = clients_.find(fd);
+	if(iter == clients_.end())
+		return 0;
+
+	CLIENT& client = iter->second;
+
+	char buffer[1024];
+	int len = client.pEndPoint->recv(buffer, sizeof(buffer));
+
+	if(len <= 0)
+	{
+		closeClient_(fd);
+		return 0;
+	}
+
+	// Already answering, ignore anything else sent on this connection
+	if(client.unsent.size() > 0)
+		return 0;
+
+	client.request.append(buffer, len);
+
+	if(client.request.size() > METRICS_MAX_REQUEST_SIZE)
+	{
+		closeClient_(fd);
+		return 0;
+	}
+
+	if(client.request.find("\r\n\r\n") != std::string::npos || client.request.find("\n\n") != std::string::npos)
+		onRequest_(client);
+
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------
+void MetricsExporter::onAccept_()
+{
+	int tickcount = 0;
+
+	while(tickcount++ < 256)
+	{
+		Network::EndPoint* pNewEndPoint = listener_.accept();
+		if(pNewEndPoint == NULL)
+			break;
+
+		if(!dispatcher_.registerReadFileDescriptor((*pNewEndPoint), this))
+		{
+			ERROR_MSG(fmt::format("MetricsExporter::onAccept_: registerReadFileDescriptor is failed! addr={}\n",
+				pNewEndPoint->c_str()));
+
+			Network::EndPoint::reclaimPoolObject(pNewEndPoint);
+			continue;
+		}
+
+		CLIENT& client = clients_[(*pNewEndPoint)];
+		client.pEndPoint = pNewEndPoint;
+		client.request.clear();
+		client.unsent.clear();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void MetricsExporter::onRequest_(CLIENT& client)
+{
+	int fd = (*client.pEndPoint);
+	const std::string& request = client.request;
+
+	response_.resize(0);
+
+	bool isMetrics = request.compare(0, 6, "GET / ") == 0 || 
+		(request.compare(0, 12, "GET /metrics") == 0 && request.size() > 12 && (request[12] == ' ' || request[12] == '?'));
+
+	if(isMetrics)
+	{
+		++numScrapes_;
+
+		body_.resize(0);
+		addWatchersToText_(WatcherPaths::root());
+		Metrics::root().addToText(body_);
+
+		fmt::format_to(response_, "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+			"Content-Length: {}\r\nConnection: close\r\n\r\n", body_.size());
+
+		response_.append(body_.data(), body_.data() + body_.size());
+	}
+	else
+	{
+		const char* notFound = "404 Not Found\n";
+		fmt::format_to(response_, "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}",
+			strlen(notFound), notFound);
+	}
+
+	size_t sent = 0;
+	if(!send_(client, response_.data(), response_.size(), sent) || sent == response_.size())
+	{
+		closeClient_(fd);
+		return;
+	}
+
+	// The rest goes out in handleOutputNotification
+	client.unsent.assign(response_.data() + sent, response_.size() - sent);
+	dispatcher_.registerWriteFileDescriptor(fd, this);
+}
+
+//-------------------------------------------------------------------------------------
+bool MetricsExporter::send_(CLIENT& client, const char* data, size_t size, size_t& sent)
+{
+	sent = 0;
+
+	while(sent < size)
+	{
+		int len = client.pEndPoint->send(data + sent, (int)(size - sent));
+		if(len > 0)
+		{
+			sent += len;
+			continue;
+		}
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+		int err = WSAGetLastError();
+		return err == WSAEWOULDBLOCK || err == WSAEINTR;
+#else
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+int MetricsExporter::handleOutputNotification(int fd)
+{
+	std::map<int, CLIENT>::iterator iter = clients_.find(fd);
+	if(iter == clients_.end())
+		return 0;
+
+	CLIENT& client = iter->second;
+
+	size_t sent = 0;
+	if(!send_(client, client.unsent.data(), client.unsent.size(), sent) || sent == client.unsent.size())
+	{
+		closeClient_(fd);
+		return 0;
+	}
+
+	client.unsent.erase(0, sent);
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------
+void MetricsExporter::addWatchersToText_(WatcherPaths& paths)
+{
+	Watchers::WATCHER_MAP& watcherObjs = paths.watchers().watcherObjs();
+	Watchers::WATCHER_MAP::iterator iter = watcherObjs.begin();
+	for(; iter != watcherObjs.end(); ++iter)
+	{
+		WatcherObject* pWobj = iter->second.get();
+
+		double v;
+		if(!watcherValue_(pWobj, v))
+			continue;
+
+		// Watcher paths are "root/a/b", the label is "a/b/name"
+		const char* path = pWobj->path();
+		if(strncmp(path, "root", 4) == 0)
+			path += (path[4] == '/') ? 5 : 4;
+
+		if(strpbrk(path, "\"\\\n") || strpbrk(pWobj->name(), "\"\\\n"))
+			continue;
+
+		fmt::format_to(body_, "ouro_watcher{{path=\"{}{}{}\"}} {}\n", path, (*path) ? "/" : "", pWobj->name(), v);
+	}
+
+	WatcherPaths::WATCHER_PATHS& childs = paths.watcherPaths();
+	WatcherPaths::WATCHER_PATHS::iterator piter = childs.begin();
+	for(; piter != childs.end(); ++piter)
+		addWatchersToText_(*piter->second);
+}
+
+//-------------------------------------------------------------------------------------
+bool MetricsExporter::watcherValue_(WatcherObject* pWobj, double& v)
+{
+	WATCHER_VALUE_TYPE type = pWobj->getType();
+
+	switch(type)
+	{
+	case WATCHER_VALUE_TYPE_UINT8:
+	case WATCHER_VALUE_TYPE_UINT16:
+	case WATCHER_VALUE_TYPE_UINT32:
+	case WATCHER_VALUE_TYPE_UINT64:
+	case WATCHER_VALUE_TYPE_INT8:
+	case WATCHER_VALUE_TYPE_INT16:
+	case WATCHER_VALUE_TYPE_INT32:
+	case WATCHER_VALUE_TYPE_INT64:
+	case WATCHER_VALUE_TYPE_FLOAT:
+	case WATCHER_VALUE_TYPE_DOUBLE:
+	case WATCHER_VALUE_TYPE_BOOL:
+	case WATCHER_VALUE_TYPE_COMPONENT_TYPE:
+		break;
+	default:
+		return false;
+	};
+
+	watcherStream_.clear(false);
+	pWobj->addToStream(&watcherStream_);
+
+	WATCHER_ID id;
+	watcherStream_ >> id;
+
+	switch(type)
+	{
+	case WATCHER_VALUE_TYPE_UINT8:
+		{ uint8 val; watcherStream_ >> val; v = val; break; }
+	case WATCHER_VALUE_TYPE_UINT16:
+		{ uint16 val; watcherStream_ >> val; v = val; break; }
+	case WATCHER_VALUE_TYPE_UINT32:
+		{ uint32 val; watcherStream_ >> val; v = val; break; }
+	case WATCHER_VALUE_TYPE_UINT64:
+		{ uint64 val; watcherStream_ >> val; v = (double)val; break; }
+	case WATCHER_VALUE_TYPE_INT8:
+		{ int8 val; watcherStream_ >> val; v = val; break; }
+	case WATCHER_VALUE_TYPE_INT16:
+		{ int16 val; watcherStream_ >> val; v = val; break; }
+	case WATCHER_VALUE_TYPE_INT32:
+		{ int32 val; watcherStream_ >> val; v = val; break; }
+	case WATCHER_VALUE_TYPE_INT64:
+		{ int64 val; watcherStream_ >> val; v = (double)val; break; }
+	case WATCHER_VALUE_TYPE_FLOAT:
+		{ float val; watcherStream_ >> val; v = val; break; }
+	case WATCHER_VALUE_TYPE_DOUBLE:
+		{ double val; watcherStream_ >> val; v = val; break; }
+	case WATCHER_VALUE_TYPE_BOOL:
+		{ bool val; watcherStream_ >> val; v = val ? 1.0 : 0.0; break; }
+	case WATCHER_VALUE_TYPE_COMPONENT_TYPE:
+		{ int32 val; watcherStream_ >> val; v = val; break; }
+	default:
+		return false;
+	};
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+}
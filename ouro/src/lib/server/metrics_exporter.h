@@ -0,0 +1,77 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_METRICS_EXPORTER_H
+#define OURO_METRICS_EXPORTER_H
+
+#include "common/common.h"
+#include "common/memorystream.h"
+#include "helper/debug_helper.h"
+#include "network/endpoint.h"
+#include "network/event_dispatcher.h"
+
+namespace Ouroboros{
+
+class WatcherPaths;
+class WatcherObject;
+
+/*
+	Local HTTP endpoint that serves the metrics of the component in Prometheus text format:
+		- every numeric watcher as ouro_watcher{path="..."}
+		- every histogram registered in Metrics::root()(tick duration, message handlers, database tasks)
+
+	GET /metrics (or /) is answered and the connection is closed, the text is built in a buffer
+	that is reused between scrapes.
+*/
+class MetricsExporter : public Network::InputNotificationHandler, public Network::OutputNotificationHandler
+{
+public:
+	MetricsExporter(Network::EventDispatcher& dispatcher);
+	virtual ~MetricsExporter();
+
+	/**
+		port: first port to try, the following ports are tried if it is occupied
+		ip: network byte order
+	*/
+	bool start(uint16 port, uint32 ip);
+	void stop();
+
+	uint16 port() const { return port_; }
+	uint32 numScrapes() const { return numScrapes_; }
+
+private:
+	struct CLIENT
+	{
+		Network::EndPoint* pEndPoint;
+		std::string request;
+		std::string unsent;
+	};
+
+	virtual int handleInputNotification(int fd);
+	virtual int handleOutputNotification(int fd);
+
+	void onAccept_();
+	void onRequest_(CLIENT& client);
+	bool send_(CLIENT& client, const char* data, size_t size, size_t& sent);
+	void closeClient_(int fd);
+
+	void addWatchersToText_(WatcherPaths& paths);
+	bool watcherValue_(WatcherObject* pWobj, double& v);
+
+private:
+	Network::EventDispatcher& dispatcher_;
+	Network::EndPoint listener_;
+	uint16 port_;
+
+	std::map<int, CLIENT> clients_;
+
+	// Reused between scrapes
+	fmt::memory_buffer body_;
+	fmt::memory_buffer response_;
+	MemoryStream watcherStream_;
+
+	uint32 numScrapes_;
+};
+
+}
+
+#endif // OURO_METRICS_EXPORTER_H
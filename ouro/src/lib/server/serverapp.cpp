@@ -6,9 +6,11 @@
 #include "server/shutdowner.h"
 #include "server/serverconfig.h"
 #include "server/components.h"
+#include "server/metrics_exporter.h"
 #include "network/channel.h"
 #include "network/bundle.h"
 #include "network/common.h"
+#include "network/network_interface.h"
 #include "common/memorystream.h"
 #include "helper/console_helper.h"
 #include "helper/sys_info.h"
@@ -52,6 +54,8 @@ startGlobalOrder_(-1),
 startGroupOrder_(-1),
 pShutdowner_(NULL),
 pActiveTimerHandle_(NULL),
+pMetricsExporter_(NULL),
+pTickHistogram_(NULL),
 threadPool_()
 {
 	networkInterface_.pChannelTimeOutHandler(this);
@@ -141,6 +145,13 @@ bool ServerApp::initialize()
 	
 	if(!loadConfig())
 		return false;
+
+	if(g_ouroSrvConfig.flightRecorderEnable())
+	{
+		FlightRecorder::initialize(g_ouroSrvConfig.flightRecorderEvents(), g_ouroSrvConfig.flightRecorderTicks(),
+			g_ouroSrvConfig.flightRecorderThreshold(), g_ouroSrvConfig.flightRecorderDumpInterval(),
+			g_ouroSrvConfig.flightRecorderPath(), fmt::format("{}{}", COMPONENT_NAME_EX(componentType_), componentID_));
+	}
 	
 	if(!initializeBegin())
 		return false;
@@ -155,12 +166,39 @@ bool ServerApp::initialize()
 		return false;
 
 #ifdef ENABLE_WATCHERS
-	return ret && Network::initialize() && initializeWatcher();
+	return ret && Network::initialize() && initializeWatcher() && initializeMetrics();
 #else
-	return ret && Network::initialize();
+	return ret && Network::initialize() && initializeMetrics();
 #endif
 }
 
+//-------------------------------------------------------------------------------------		
+bool ServerApp::initializeMetrics()
+{
+	if(!g_ouroSrvConfig.metricsEnable())
+		return true;
+
+	pTickHistogram_ = Metrics::root().addHistogram("ouro_tick_seconds", "Duration of the main tick of the component.");
+
+	if(!Network::initializeMetrics())
+		return false;
+
+	pMetricsExporter_ = new MetricsExporter(dispatcher_);
+	if(!pMetricsExporter_->start(g_ouroSrvConfig.metricsPort(), networkInterface_.intTcpAddr().ip))
+	{
+		// Metrics are optional, the component keeps running without the endpoint
+		SAFE_RELEASE(pMetricsExporter_);
+		return true;
+	}
+
+#ifdef ENABLE_WATCHERS
+	WATCH_OBJECT("metrics/port", pMetricsExporter_, &MetricsExporter::port);
+	WATCH_OBJECT("metrics/numScrapes", pMetricsExporter_, &MetricsExporter::numScrapes);
+#endif
+
+	return true;
+}
+
 //-------------------------------------------------------------------------------------		
 bool ServerApp::initializeWatcher()
 {
@@ -172,6 +210,10 @@ bool ServerApp::initializeWatcher()
 	WATCH_OBJECT("globalOrder", this, &ServerApp::globalOrder);
 	WATCH_OBJECT("groupOrder", this, &ServerApp::groupOrder);
 	WATCH_OBJECT("gametime", this, &ServerApp::time);
+	WATCH_OBJECT("stats/asyncLogDropped", DebugHelper::getSingletonPtr(), &DebugHelper::asyncLogDropped);
+
+	if(g_pFlightRecorder)
+		WATCH_OBJECT("stats/flightRecorderDumps", g_pFlightRecorder, &FlightRecorder::numDumps);
 
 	return Network::initializeWatcher() && Resmgr::getSingleton().initializeWatcher() &&
 		threadPool_.initializeWatcher() && WatchPool::initWatchPools();
@@ -230,9 +272,16 @@ bool ServerApp::initThreadPool()
 //-------------------------------------------------------------------------------------		
 void ServerApp::finalise(void)
 {
+	SAFE_RELEASE(pMetricsExporter_);
+
+	// The pools the I/O threads use are destroyed by Network::finalise
+	networkInterface_.stopIOThreads();
+
 	ProfileGroup::finalise();
 	threadPool_.finalise();
 	Network::finalise();
+	Metrics::finalise();
+	FlightRecorder::finalise();
 }
 
 //-------------------------------------------------------------------------------------		
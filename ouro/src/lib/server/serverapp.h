@@ -15,6 +15,8 @@
 #include "helper/profile.h"
 #include "helper/profiler.h"
 #include "helper/profile_handler.h"
+#include "helper/metrics.h"
+#include "helper/flight_recorder.h"
 #include "xml/xml.h"	
 #include "server/common.h"
 #include "server/components.h"
@@ -40,6 +42,7 @@ class Channel;
 
 class Shutdowner;
 class ComponentActiveReportHandler;
+class MetricsExporter;
 
 class ServerApp : 
 	public SignalHandler, 
@@ -76,6 +79,8 @@ public:
 
 	virtual bool initializeWatcher();
 
+	virtual bool initializeMetrics();
+
 	virtual bool loadConfig();
 	const char* name(){return COMPONENT_NAME_EX(componentType_);}
 	
@@ -194,6 +199,10 @@ protected:
 	Shutdowner*												pShutdowner_;
 	ComponentActiveReportHandler*							pActiveTimerHandle_;
 
+	// Prometheus endpoint, NULL if metrics are disabled
+	MetricsExporter*										pMetricsExporter_;
+	MetricsHistogram*										pTickHistogram_;
+
 		// Thread Pool
 	thread::ThreadPool										threadPool_;	
 };
@@ -22,6 +22,21 @@ ServerConfig::ServerConfig():
 	gameUpdateHertz_(10),
 	tick_max_buffered_logs_(4096),
 	tick_max_sync_logs_(32),
+	binlog_enable_(false),
+	binlog_path_("logs/binlog"),
+	binlog_segment_size_(64 * 1024 * 1024),
+	async_log_enable_(false),
+	async_log_ring_size_(1024 * 1024),
+	async_log_overflow_policy_(0),
+	async_log_block_timeout_(100),
+	metrics_enable_(false),
+	metrics_port_(50000),
+	flight_recorder_enable_(true),
+	flight_recorder_events_(65536),
+	flight_recorder_ticks_(20),
+	flight_recorder_threshold_(500),
+	flight_recorder_dump_interval_(60),
+	flight_recorder_path_("logs/traces"),
 	channelCommon_(),
 	bitsPerSecondToClient_(0),
 	interfacesAddr_(),
@@ -184,6 +199,62 @@ bool ServerConfig::loadConfig(std::string fileName)
 		}
 	}
 
+	rootNode = xml->getRootNode("metrics");
+	if(rootNode != NULL)
+	{
+		TiXmlNode* childnode = xml->enterNode(rootNode, "enable");
+		if(childnode)
+		{
+			metrics_enable_ = (xml->getValStr(childnode) == "true");
+		}
+
+		childnode = xml->enterNode(rootNode, "port");
+		if(childnode)
+		{
+			metrics_port_ = (uint16)xml->getValInt(childnode);
+		}
+	}
+
+	rootNode = xml->getRootNode("flight_recorder");
+	if(rootNode != NULL)
+	{
+		TiXmlNode* childnode = xml->enterNode(rootNode, "enable");
+		if(childnode)
+		{
+			flight_recorder_enable_ = (xml->getValStr(childnode) == "true");
+		}
+
+		childnode = xml->enterNode(rootNode, "events");
+		if(childnode)
+		{
+			flight_recorder_events_ = (uint32)OURO_MAX(1024, xml->getValInt(childnode));
+		}
+
+		childnode = xml->enterNode(rootNode, "ticks");
+		if(childnode)
+		{
+			flight_recorder_ticks_ = (uint32)OURO_MAX(1, xml->getValInt(childnode));
+		}
+
+		childnode = xml->enterNode(rootNode, "threshold");
+		if(childnode)
+		{
+			flight_recorder_threshold_ = (uint32)OURO_MAX(0, xml->getValInt(childnode));
+		}
+
+		childnode = xml->enterNode(rootNode, "dump_interval");
+		if(childnode)
+		{
+			flight_recorder_dump_interval_ = (uint32)OURO_MAX(0, xml->getValInt(childnode));
+		}
+
+		childnode = xml->enterNode(rootNode, "path");
+		if(childnode)
+		{
+			flight_recorder_path_ = xml->getValStr(childnode);
+		}
+	}
+
 	rootNode = xml->getRootNode("channelCommon");
 	if(rootNode != NULL)
 	{
@@ -363,6 +434,58 @@ bool ServerConfig::loadConfig(std::string fileName)
 			Network::g_sslPrivateKey = xml->getValStr(childnode);
 		}
 
+		childnode = xml->enterNode(rootNode, "ioThreads");
+		if (childnode)
+		{
+			Network::g_ioThreads = OURO_MAX(0, xml->getValInt(childnode));
+		}
+
+		TiXmlNode* rateLimitNode = xml->enterNode(rootNode, "rateLimit");
+		if (rateLimitNode)
+		{
+			childnode = xml->enterNode(rateLimitNode, "enabled");
+			if (childnode)
+				Network::g_extRateLimit = (xml->getValStr(childnode) == "true");
+
+			childnode = xml->enterNode(rateLimitNode, "defaultRate");
+			if (childnode)
+				Network::g_extRateLimitDefaultRate = OURO_MAX(0.f, float(xml->getValFloat(childnode)));
+
+			childnode = xml->enterNode(rateLimitNode, "defaultBurst");
+			if (childnode)
+				Network::g_extRateLimitDefaultBurst = OURO_MAX(0.f, float(xml->getValFloat(childnode)));
+
+			childnode = xml->enterNode(rateLimitNode, "condemnDrops");
+			if (childnode)
+				Network::g_extRateLimitCondemnDrops = OURO_MAX(0, xml->getValInt(childnode));
+
+			TiXmlNode* loopNode = xml->enterNode(rateLimitNode, "messages");
+			if (loopNode)
+			{
+				do
+				{
+					if (TiXmlNode::TINYXML_COMMENT == loopNode->Type())
+						continue;
+
+					std::string name = loopNode->Value();
+					name = strutil::ouro_trim(name);
+
+					if (name == "item" && loopNode->FirstChild() != NULL)
+					{
+						TiXmlNode* name_node = xml->enterNode(loopNode->FirstChild(), "name");
+						TiXmlNode* rate_node = xml->enterNode(loopNode->FirstChild(), "rate");
+						TiXmlNode* burst_node = xml->enterNode(loopNode->FirstChild(), "burst");
+						if (name_node && rate_node)
+						{
+							float rate = OURO_MAX(0.f, float(xml->getValFloat(rate_node)));
+							float burst = burst_node ? OURO_MAX(0.f, float(xml->getValFloat(burst_node))) : rate;
+							Network::g_extRateLimits[xml->getValStr(name_node)] = std::make_pair(rate, burst);
+						}
+					}
+				} while ((loopNode = loopNode->NextSibling()));
+			}
+		}
+
 		TiXmlNode* rudpChildnode = xml->enterNode(rootNode, "reliableUDP");
 		if(rudpChildnode)
 		{
@@ -428,6 +551,42 @@ bool ServerConfig::loadConfig(std::string fileName)
 		}
 	}
 
+	rootNode = xml->getRootNode("httpClient");
+	if(rootNode != NULL)
+	{
+		TiXmlNode* childnode = xml->enterNode(rootNode, "maxHostConnections");
+		if (childnode)
+			Network::g_httpMaxHostConnections = OURO_MAX(0, xml->getValInt(childnode));
+
+		childnode = xml->enterNode(rootNode, "maxConnections");
+		if (childnode)
+			Network::g_httpMaxConnections = OURO_MAX(0, xml->getValInt(childnode));
+
+		childnode = xml->enterNode(rootNode, "maxCachedConnections");
+		if (childnode)
+			Network::g_httpMaxCachedConnections = OURO_MAX(0, xml->getValInt(childnode));
+
+		childnode = xml->enterNode(rootNode, "pipelining");
+		if (childnode)
+			Network::g_httpPipelining = (xml->getValStr(childnode) == "true");
+
+		childnode = xml->enterNode(rootNode, "timeout");
+		if (childnode)
+			Network::g_httpTimeout = OURO_MAX(0, xml->getValInt(childnode));
+	}
+
+	rootNode = xml->getRootNode("websocket");
+	if(rootNode != NULL)
+	{
+		TiXmlNode* childnode = xml->enterNode(rootNode, "permessageDeflate");
+		if (childnode)
+			Network::g_websocketDeflate = (xml->getValStr(childnode) == "true");
+
+		childnode = xml->enterNode(rootNode, "deflateMinSize");
+		if (childnode)
+			Network::g_websocketDeflateMinSize = OURO_MAX(0, xml->getValInt(childnode));
+	}
+
 	rootNode = xml->getRootNode("gameUpdateHertz");
 	if(rootNode != NULL){
 		gameUpdateHertz_ = xml->getValInt(rootNode);
@@ -612,6 +771,12 @@ bool ServerConfig::loadConfig(std::string fileName)
 				_cellAppInfo.coordinateSystem_hasY = (xml->getValStr(childnode) == "true");
 			}
 
+			childnode = xml->enterNode(node, "deferred_updates");
+			if(childnode)
+			{
+				_cellAppInfo.coordinateSystem_deferredUpdates = (xml->getValStr(childnode) == "true");
+			}
+
 			childnode = xml->enterNode(node, "entity_posdir_additional_updates");
 			if(childnode)
 			{
@@ -671,6 +836,28 @@ bool ServerConfig::loadConfig(std::string fileName)
 			{
 				_cellAppInfo.witness_timeout = uint16(xml->getValInt(childnode));
 			}
+
+			childnode = xml->enterNode(node, "updateThreads");
+			if(childnode)
+			{
+				_cellAppInfo.witness_updateThreads = uint16(xml->getValInt(childnode));
+			}
+		}
+
+		node = xml->enterNode(rootNode, "navmesh");
+		if(node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "mapped");
+			if (childnode)
+				_cellAppInfo.navmesh.mapped = (xml->getValStr(childnode) == "true");
+
+			childnode = xml->enterNode(node, "tileEvictTime");
+			if (childnode)
+				_cellAppInfo.navmesh.tileEvictTime = OURO_MAX(0.f, float(xml->getValFloat(childnode)));
+
+			childnode = xml->enterNode(node, "obstacleBudget");
+			if (childnode)
+				_cellAppInfo.navmesh.obstacleBudget = OURO_MAX(0.f, float(xml->getValFloat(childnode)));
 		}
 	}
 	
@@ -1077,6 +1264,22 @@ bool ServerConfig::loadConfig(std::string fileName)
 						missingFields.push_back("unicodeString");
 					}
 
+					node = xml->enterNode(interfaceNode, "writeBehind");
+					if(node != NULL)
+					{
+						TiXmlNode* childnode = xml->enterNode(node, "interface");
+						if(childnode)
+							pDBInfo->writeBehind = xml->getValStr(childnode);
+
+						childnode = xml->enterNode(node, "flushInterval");
+						if(childnode)
+							pDBInfo->writeBehind_flushInterval = std::max(xml->getValInt(childnode), 1);
+
+						childnode = xml->enterNode(node, "batchSize");
+						if(childnode)
+							pDBInfo->writeBehind_batchSize = std::max(xml->getValInt(childnode), 1);
+					}
+
 					if (pDBInfo->db_unicodeString_characterSet.size() == 0)
 						pDBInfo->db_unicodeString_characterSet = "utf8";
 
@@ -1276,6 +1479,59 @@ bool ServerConfig::loadConfig(std::string fileName)
 		node = xml->enterNode(rootNode, "http_cbport");
 		if(node)
 			_loginAppInfo.http_cbport = xml->getValInt(node);
+
+		node = xml->enterNode(rootNode, "admission");
+		if(node != NULL)
+		{
+			LoginAdmission_Config& admission = _loginAppInfo.loginAdmission;
+
+			TiXmlNode* childnode = xml->enterNode(node, "enable");
+			if (childnode)
+				admission.enable = (xml->getValStr(childnode) == "true");
+
+			childnode = xml->enterNode(node, "maxRate");
+			if (childnode)
+				admission.maxRate = OURO_MAX(1.f, float(xml->getValFloat(childnode)));
+
+			childnode = xml->enterNode(node, "minRate");
+			if (childnode)
+				admission.minRate = OURO_MAX(0.1f, float(xml->getValFloat(childnode)));
+
+			childnode = xml->enterNode(node, "burst");
+			if (childnode)
+				admission.burst = OURO_MAX(1, xml->getValInt(childnode));
+
+			childnode = xml->enterNode(node, "maxPending");
+			if (childnode)
+				admission.maxPending = OURO_MAX(1, xml->getValInt(childnode));
+
+			childnode = xml->enterNode(node, "dbmgrLatency");
+			if (childnode)
+				admission.dbmgrLatency = float(xml->getValFloat(childnode));
+
+			childnode = xml->enterNode(node, "baseappLoad");
+			if (childnode)
+				admission.baseappLoad = float(xml->getValFloat(childnode));
+
+			childnode = xml->enterNode(node, "queueMax");
+			if (childnode)
+				admission.queueMax = xml->getValInt(childnode);
+
+			childnode = xml->enterNode(node, "queueTimeout");
+			if (childnode)
+				admission.queueTimeout = float(xml->getValFloat(childnode));
+
+			childnode = xml->enterNode(node, "positionUpdatePeriod");
+			if (childnode)
+				admission.positionUpdatePeriod = OURO_MAX(0.5f, float(xml->getValFloat(childnode)));
+
+			childnode = xml->enterNode(node, "reconnectTime");
+			if (childnode)
+				admission.reconnectTime = float(xml->getValFloat(childnode));
+
+			if (admission.minRate > admission.maxRate)
+				admission.minRate = admission.maxRate;
+		}
 	}
 	
 	rootNode = xml->getRootNode("cellappmgr");
@@ -1289,6 +1545,40 @@ bool ServerConfig::loadConfig(std::string fileName)
 		if(node != NULL){
 			_cellAppMgrInfo.tcp_SOMAXCONN = xml->getValInt(node);
 		}
+
+		node = xml->enterNode(rootNode, "spaceMigration");
+		if(node != NULL)
+		{
+			SpaceMigration_Config& migration = _cellAppMgrInfo.spaceMigration;
+
+			TiXmlNode* childnode = xml->enterNode(node, "enable");
+			if (childnode)
+				migration.enable = (xml->getValStr(childnode) == "true");
+
+			childnode = xml->enterNode(node, "period");
+			if (childnode)
+				migration.period = OURO_MAX(1.f, float(xml->getValFloat(childnode)));
+
+			childnode = xml->enterNode(node, "minLoad");
+			if (childnode)
+				migration.minLoad = float(xml->getValFloat(childnode));
+
+			childnode = xml->enterNode(node, "loadDiff");
+			if (childnode)
+				migration.loadDiff = float(xml->getValFloat(childnode));
+
+			childnode = xml->enterNode(node, "maxEntities");
+			if (childnode)
+				migration.maxEntities = xml->getValInt(childnode);
+
+			childnode = xml->enterNode(node, "timeout");
+			if (childnode)
+				migration.timeout = OURO_MAX(1.f, float(xml->getValFloat(childnode)));
+
+			childnode = xml->enterNode(node, "commitTimeout");
+			if (childnode)
+				migration.commitTimeout = OURO_MAX(1.f, float(xml->getValFloat(childnode)));
+		}
 	}
 	
 	rootNode = xml->getRootNode("baseappmgr");
@@ -1504,6 +1794,56 @@ bool ServerConfig::loadConfig(std::string fileName)
 		if(node != NULL){
 			tick_max_sync_logs_ = (uint32)xml->getValInt(node);
 		}
+
+		node = xml->enterNode(rootNode, "binlog");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "enable");
+			if (childnode)
+			{
+				binlog_enable_ = (xml->getValStr(childnode) == "true");
+			}
+
+			childnode = xml->enterNode(node, "path");
+			if (childnode)
+			{
+				binlog_path_ = xml->getValStr(childnode);
+			}
+
+			childnode = xml->enterNode(node, "segment_size");
+			if (childnode)
+			{
+				binlog_segment_size_ = (uint32)xml->getValInt(childnode) * 1024 * 1024;
+			}
+		}
+
+		node = xml->enterNode(rootNode, "async_log");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "enable");
+			if (childnode)
+			{
+				async_log_enable_ = (xml->getValStr(childnode) == "true");
+			}
+
+			childnode = xml->enterNode(node, "ring_size");
+			if (childnode)
+			{
+				async_log_ring_size_ = (uint32)xml->getValInt(childnode) * 1024;
+			}
+
+			childnode = xml->enterNode(node, "overflow_policy");
+			if (childnode)
+			{
+				async_log_overflow_policy_ = (xml->getValStr(childnode) == "block") ? 1 : 0;
+			}
+
+			childnode = xml->enterNode(node, "block_timeout");
+			if (childnode)
+			{
+				async_log_block_timeout_ = (uint32)xml->getValInt(childnode);
+			}
+		}
 	
 		node = xml->enterNode(rootNode, "telnet_service");
 		if (node != NULL)
@@ -47,6 +47,74 @@ struct Profiles_Config
 	bool open_networkprofile;
 };
 
+// loginapp admission control, logins are forwarded to dbmgr at a rate that follows the load of dbmgr and the baseapps
+struct LoginAdmission_Config
+{
+	LoginAdmission_Config():
+		enable(true),
+		maxRate(300.f),
+		minRate(10.f),
+		burst(50),
+		maxPending(2000),
+		dbmgrLatency(0.5f),
+		baseappLoad(0.8f),
+		queueMax(100000),
+		queueTimeout(600.f),
+		positionUpdatePeriod(3.f),
+		reconnectTime(600.f)
+	{
+	}
+
+	bool enable;
+	float maxRate; // logins per second forwarded to dbmgr when nothing is overloaded
+	float minRate; // the rate never drops below this
+	uint32 burst; // token bucket size
+	uint32 maxPending; // logins waiting for dbmgr at most
+	float dbmgrLatency; // dbmgr is overloaded when its average answer time(seconds) exceeds this
+	float baseappLoad; // the baseapps are overloaded when their average load exceeds this
+	uint32 queueMax; // logins beyond this are refused with SERVER_ERR_SRV_OVERLOAD
+	float queueTimeout; // seconds a login may wait in the queue
+	float positionUpdatePeriod; // seconds between queue position updates to the clients
+	float reconnectTime; // seconds an account is treated as online(reconnect priority) after it was last seen online
+};
+
+// cellappmgr moves whole spaces from busy cellapps to idle ones
+struct SpaceMigration_Config
+{
+	SpaceMigration_Config():
+		enable(false),
+		period(30.f),
+		minLoad(0.6f),
+		loadDiff(0.3f),
+		maxEntities(1000),
+		timeout(30.f),
+		commitTimeout(5.f)
+	{
+	}
+
+	bool enable; // automatic rebalancing, a requested migration(reqMigrateSpace) works either way
+	float period; // seconds between two automatic migrations
+	float minLoad; // only cellapps loaded above this give away spaces
+	float loadDiff; // the load of the busiest and the idlest cellapp must differ by at least this
+	uint32 maxEntities; // larger spaces are not moved, the freeze window grows with the number of entities
+	float timeout; // seconds a migration may take until the space is loaded on the target
+	float commitTimeout; // seconds between two queries of the frozen source to a target that did not answer the commit
+};
+
+struct NavMesh_Config
+{
+	NavMesh_Config():
+		mapped(false),
+		tileEvictTime(300.f),
+		obstacleBudget(2.f)
+	{
+	}
+
+	bool mapped; // bake the navmeshes into page aligned tiles that are mapped into memory and loaded on demand
+	float tileEvictTime; // seconds a mapped tile stays loaded without being used by a query, 0 never evicts
+	float obstacleBudget; // milliseconds per tick spent rebuilding the tiles changed by dynamic obstacles
+};
+
 struct ChannelCommon
 {
 	float channelInternalTimeout;
@@ -87,6 +155,8 @@ struct DBInterfaceInfo
 		isPure = false;
 		db_numConnections = 5;
 		db_passwordEncrypt = true;
+		writeBehind_flushInterval = 5;
+		writeBehind_batchSize = 500;
 
 		memset(name, 0, sizeof(name));
 		memset(db_type, 0, sizeof(db_type));
@@ -109,6 +179,9 @@ struct DBInterfaceInfo
 	uint16 db_numConnections; // database maximum connection
 	std::string db_unicodeString_characterSet; // Set the database character set
 	std::string db_unicodeString_collation;
+	std::string writeBehind; // The interface the entities are written behind to(redis only)
+	uint32 writeBehind_flushInterval; // Seconds between two writes behind
+	uint32 writeBehind_batchSize; // Entities of a table written behind at once
 };
 
 // engine component information structure
@@ -121,6 +194,8 @@ typedef struct EngineComponentInfo
 		account_registration_enable = false;
 		account_reset_password_enable = false;
 		use_coordinate_system = true;
+		coordinateSystem_deferredUpdates = false;
+		witness_updateThreads = 0;
 		account_type = 3;
 		debugDBMgr = false;
 
@@ -144,6 +219,7 @@ typedef struct EngineComponentInfo
 	float defaultViewRadius; // Configure the view radius of the player in the cellapp node
 	float defaultViewHysteresisArea; // Configure the hysteresis of the view of the player in the cellapp node
 	uint16 witness_timeout; // observer default timeout (seconds)
+	uint16 witness_updateThreads; // Threads that write the position and direction updates of the witnesses, 0: the main thread updates the witnesses one by one
 	const Network::Address* externalTcpAddr; // external address
 	const Network::Address* externalUdpAddr; // external address
 	const Network::Address* internalTcpAddr; // internal address
@@ -155,6 +231,7 @@ typedef struct EngineComponentInfo
 	
 	bool use_coordinate_system; // Whether to use the coordinate system If it is false, view, trap, move and other functions will no longer be maintained
 	bool coordinateSystem_hasY; // The scope manager manages the Y axis. Note: If there is a y axis, the functions such as view and trap have height, but the management of the y axis will bring some consumption.
+	bool coordinateSystem_deferredUpdates; // Moved entities are repositioned in the scope manager once per tick before the witnesses update, instead of on every position change
 	uint16 entity_posdir_additional_updates; // After the entity position stops changing, the engine continues to update the location information of the tick times to the client. If it is 0, it is always updated.
 	uint16 entity_posdir_updates_type; // Entity location update mode, 0: non-optimized high-precision synchronization, 1: optimized synchronization, 2: intelligent selection mode
 	uint16 entity_posdir_updates_smart_threshold; // Entity location update the number of people on the same screen in smart mode
@@ -229,6 +306,12 @@ typedef struct EngineComponentInfo
 	std::string http_cbhost;
 	uint16 http_cbport; // User http callback interface, handling authentication, password reset, etc.
 
+	LoginAdmission_Config loginAdmission;
+
+	SpaceMigration_Config spaceMigration;
+
+	NavMesh_Config navmesh;
+
 	bool debugDBMgr; // debug mode can output read and write operation information
 
 	bool isOnInitCallPropertysSetMethods; // bots dedicated: whether to trigger the set_* event of the property when Entity is initialized
@@ -277,6 +360,25 @@ public:
 	uint32 tickMaxBufferedLogs() const { return tick_max_buffered_logs_; }
 	uint32 tickMaxSyncLogs() const { return tick_max_sync_logs_; }
 
+	bool binlogEnable() const { return binlog_enable_; }
+	const std::string& binlogPath() const { return binlog_path_; }
+	uint32 binlogSegmentSize() const { return binlog_segment_size_; }
+
+	bool asyncLogEnable() const { return async_log_enable_; }
+	uint32 asyncLogRingSize() const { return async_log_ring_size_; }
+	uint8 asyncLogOverflowPolicy() const { return async_log_overflow_policy_; }
+	uint32 asyncLogBlockTimeout() const { return async_log_block_timeout_; }
+
+	bool metricsEnable() const { return metrics_enable_; }
+	uint16 metricsPort() const { return metrics_port_; }
+
+	bool flightRecorderEnable() const { return flight_recorder_enable_; }
+	uint32 flightRecorderEvents() const { return flight_recorder_events_; }
+	uint32 flightRecorderTicks() const { return flight_recorder_ticks_; }
+	uint32 flightRecorderThreshold() const { return flight_recorder_threshold_; }
+	uint32 flightRecorderDumpInterval() const { return flight_recorder_dump_interval_; }
+	const std::string& flightRecorderPath() const { return flight_recorder_path_; }
+
 	INLINE float channelExternalTimeout(void) const;
 	INLINE bool isPureDBInterfaceName(const std::string& dbInterfaceName);
 	INLINE DBInterfaceInfo* dbInterface(const std::string& name);
@@ -303,6 +405,25 @@ public:
 	uint32 tick_max_buffered_logs_;
 	uint32 tick_max_sync_logs_;
 
+	bool binlog_enable_;
+	std::string binlog_path_;
+	uint32 binlog_segment_size_;
+
+	bool async_log_enable_;
+	uint32 async_log_ring_size_;
+	uint8 async_log_overflow_policy_;
+	uint32 async_log_block_timeout_;
+
+	bool metrics_enable_;
+	uint16 metrics_port_;
+
+	bool flight_recorder_enable_;
+	uint32 flight_recorder_events_;
+	uint32 flight_recorder_ticks_;
+	uint32 flight_recorder_threshold_;
+	uint32 flight_recorder_dump_interval_;
+	std::string flight_recorder_path_;
+
 	ChannelCommon channelCommon_;
 
 	// The maximum bandwidth consumed per client per second
@@ -7,6 +7,7 @@
 #include "network/endpoint.h"
 #include "network/network_interface.h"
 #include "pyscript/script.h"
+#include "helper/flight_recorder.h"
 
 #ifndef CODE_INLINE
 #include "telnet_handler.inl"
@@ -182,6 +183,8 @@ std::string TelnetHandler::help()
 		"\r\n\t\t usage: \":eventprofile 30\""
 		"\r\n[:networkprofile]: collects and reports the network profiles \r\n\t\tof a server process over a period of time."
 		"\r\n\t\t usage: \":networkprofile 30\""
+		"\r\n[:flightrecorder]: writes the scoped profiles of the last ticks \r\n\t\tas Chrome trace JSON(see flight_recorder in ouroboros_defaults.xml)."
+		"\r\n\t\t usage: \":flightrecorder\""
 		"\r\n\r\n\033[0m";
 };
 
@@ -626,6 +629,24 @@ bool TelnetHandler::processCommand()
 		pTelnetServer_->closeHandler((*pEndPoint_), this);
 		return false;
 	}
+	else if(cmd == ":flightrecorder")
+	{
+		std::string str;
+
+		if(g_pFlightRecorder == NULL)
+		{
+			str = "\r\nflight recorder is disabled(ouroboros.xml->flight_recorder->enable).\r\n";
+		}
+		else
+		{
+			std::string file = g_pFlightRecorder->dump("telnet");
+			str = file.size() > 0 ? fmt::format("\r\nwritten to {}\r\n", file) : "\r\nwrite failed, see the log.\r\n";
+		}
+
+		pEndPoint_->send(str.c_str(), str.size());
+		sendNewLine();
+		return true;
+	}
 	else if(cmd.find(":cprofile") == 0)
 	{
 		uint32 timelen = 10;
@@ -116,6 +116,18 @@ public:
 		return true;
 	}
 
+		/**Take over a document that was built in memory instead of parsing a file*/
+	bool openDocument(TiXmlDocument* txdoc)
+	{
+		if(txdoc_)
+			delete txdoc_;
+
+		txdoc_ = txdoc;
+		rootElement_ = txdoc_->RootElement();
+		isGood_ = true;
+		return true;
+	}
+
 		/**Get the root element*/
 	TiXmlElement* getRootElement(void){return rootElement_;}
 
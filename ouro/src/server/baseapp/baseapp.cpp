@@ -3135,7 +3135,7 @@ bool Baseapp::createClientProxies(Proxy* pEntity, bool reload)
 	pEntity->initClientBasePropertys();
 
 	// Let the client know that the promises have been created and initialize some of the properties
-	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	Network::Bundle* pBundle = pEntity->createSendBundle();
 	(*pBundle).newMessage(ClientInterface::onCreatedProxies);
 	(*pBundle) << pEntity->rndUUID();
 	(*pBundle) << pEntity->id();
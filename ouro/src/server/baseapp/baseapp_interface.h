@@ -168,12 +168,15 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 	
 	// client accesses the cell method of the entity
 	BASEAPP_MESSAGE_EXPOSED(onRemoteCallCellMethodFromClient)
+	BASEAPP_MESSAGE_RATE_LIMIT(onRemoteCallCellMethodFromClient, 60, 120)
 	BASEAPP_MESSAGE_DECLARE_STREAM(onRemoteCallCellMethodFromClient,				NETWORK_VARIABLE_MESSAGE)
 
 	// client update data
 	BASEAPP_MESSAGE_EXPOSED(onUpdateDataFromClient)
+	BASEAPP_MESSAGE_RATE_LIMIT(onUpdateDataFromClient, 100, 200)
 	BASEAPP_MESSAGE_DECLARE_STREAM(onUpdateDataFromClient,							NETWORK_VARIABLE_MESSAGE)
 	BASEAPP_MESSAGE_EXPOSED(onUpdateDataFromClientForControlledEntity)
+	BASEAPP_MESSAGE_RATE_LIMIT(onUpdateDataFromClientForControlledEntity, 200, 400)
 	BASEAPP_MESSAGE_DECLARE_STREAM(onUpdateDataFromClientForControlledEntity,		NETWORK_VARIABLE_MESSAGE)
 
 	// executeRawDatabaseCommand callback from dbmgr
@@ -259,6 +262,7 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 
 	// request binding email
 	BASEAPP_MESSAGE_EXPOSED(reqAccountBindEmail)
+	BASEAPP_MESSAGE_RATE_LIMIT(reqAccountBindEmail, 1, 3)
 	BASEAPP_MESSAGE_DECLARE_ARGS3(reqAccountBindEmail,								NETWORK_VARIABLE_MESSAGE,
 									ENTITY_ID,										entityID,
 									std::string,									password,
@@ -284,6 +288,7 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 
 	// Request to change the password
 	BASEAPP_MESSAGE_EXPOSED(reqAccountNewPassword)
+	BASEAPP_MESSAGE_RATE_LIMIT(reqAccountNewPassword, 1, 3)
 	BASEAPP_MESSAGE_DECLARE_ARGS3(reqAccountNewPassword,							NETWORK_VARIABLE_MESSAGE,
 									ENTITY_ID,										entityID,
 									std::string,									oldpassword,
@@ -301,6 +306,7 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 	//--------------------------------------------Entity----------------------------------------------------------
 	// remote call entity method
 	ENTITY_MESSAGE_EXPOSED(onRemoteMethodCall)
+	ENTITY_MESSAGE_RATE_LIMIT(onRemoteMethodCall, 60, 120)
 	ENTITY_MESSAGE_DECLARE_STREAM(onRemoteMethodCall,								NETWORK_VARIABLE_MESSAGE)
 
 	// cellapp notifies that the cell part of the entity is destroyed or lost.
@@ -308,6 +314,7 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 
 	// The client sends a message directly to the cell entity
 	ENTITY_MESSAGE_EXPOSED(forwardEntityMessageToCellappFromClient)
+	ENTITY_MESSAGE_RATE_LIMIT(forwardEntityMessageToCellappFromClient, 60, 120)
 	ENTITY_MESSAGE_DECLARE_STREAM(forwardEntityMessageToCellappFromClient,			NETWORK_VARIABLE_MESSAGE)
 
 	// Callback result after an entity requests a teleport
@@ -36,6 +36,12 @@ namespace Ouroboros{
 #define ENTITY_MESSAGE_EXPOSED(NAME)											\
 	NETWORK_MESSAGE_EXPOSED(Entity, NAME)										\
 
+#define BASEAPP_MESSAGE_RATE_LIMIT(NAME, RATE, BURST)							\
+	NETWORK_MESSAGE_RATE_LIMIT(Baseapp, NAME, RATE, BURST)						\
+
+#define ENTITY_MESSAGE_RATE_LIMIT(NAME, RATE, BURST)							\
+	NETWORK_MESSAGE_RATE_LIMIT(Entity, NAME, RATE, BURST)						\
+
 #define PROXY_MESSAGE_EXPOSED(NAME)												\
 	NETWORK_MESSAGE_EXPOSED(Proxy, NAME)										\
 
@@ -133,7 +133,7 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 
 	propertyDescription->getDataType()->addToStream(mstream, pyData);
 
-	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	Network::Bundle* pBundle = static_cast<Proxy*>(this)->createSendBundle();
 	(*pBundle).newMessage(ClientInterface::onUpdatePropertys);
 	(*pBundle) << id();
 
@@ -150,7 +150,9 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 
 	pBundle->append(*mstream);
 	
-	g_privateClientEventHistoryStats.trackEvent(scriptName(), 
+	g_privateClientEventHistoryStats.trackEvent(pScriptModule()->getUType(), 
+		propertyDescription->eventID(), 
+		scriptName(), 
 		propertyDescription->getName(), 
 		pBundle->currMsgLength());
 
@@ -165,7 +167,7 @@ void Entity::onDestroy(bool callScript)
 {
 	if(callScript)
 	{
-		SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+		SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 		CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onDestroy"), GETERR));
 	}
 
@@ -876,7 +878,7 @@ PyObject* Entity::pyGetShouldAutoBackup()
 //-------------------------------------------------------------------------------------
 void Entity::onCreateCellFailure(void)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	creatingCell_ = false;
 	isGetingCellData_ = false;
@@ -887,7 +889,7 @@ void Entity::onCreateCellFailure(void)
 //-------------------------------------------------------------------------------------
 void Entity::onRemoteMethodCall(Network::Channel* pChannel, MemoryStream& s)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	if(isDestroyed())																				
 	{																										
@@ -980,6 +982,18 @@ void Entity::onRemoteMethodCall(Network::Channel* pChannel, MemoryStream& s)
 
 	EntityDef::context().currEntityID = this->id();
 
+	// Arguments that are numbers, vectors or strings are unpacked onto the stack and the method is called directly
+	if (pMethodDescription->isFastCall())
+	{
+		if (!pMethodDescription->callFromStream(pyCallObject, &s))
+			SCRIPT_ERROR_CHECK();
+
+		if (pyCallObject != static_cast<PyObject*>(this))
+			Py_DECREF(pyCallObject);
+
+		return;
+	}
+
 	PyObject* pyFunc = PyObject_GetAttrString(pyCallObject, const_cast<char*>
 						(pMethodDescription->getName()));
 
@@ -1016,7 +1030,7 @@ void Entity::onGetCell(Network::Channel* pChannel, COMPONENT_ID componentID)
 	if(pChannel->isExternal())
 		return;
 	
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	creatingCell_ = false;
 
@@ -1044,7 +1058,7 @@ void Entity::onGetCell(Network::Channel* pChannel, COMPONENT_ID componentID)
 //-------------------------------------------------------------------------------------
 void Entity::onClientDeath()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 	CALL_COMPONENTS_AND_ENTITY_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onClientDeath"), GETERR));
 }
 
@@ -1054,7 +1068,7 @@ void Entity::onLoseCell(Network::Channel* pChannel, MemoryStream& s)
 	if(pChannel->isExternal())
 		return;
 	
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	S_RELEASE(cellEntityCall_);
 
@@ -1079,7 +1093,7 @@ void Entity::onRestore()
 	if(!inRestore_)
 		return;
 
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 	CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onRestore"), GETERR));
 
 	inRestore_ = false;
@@ -1288,7 +1302,7 @@ void Entity::onWriteToDBCallback(ENTITY_ID eid,
 //-------------------------------------------------------------------------------------
 void Entity::onCellWriteToDBCompleted(CALLBACK_ID callbackID, int8 shouldAutoLoad, int dbInterfaceIndex)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 	CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onPreArchive"), GETERR));
 
 	if (dbInterfaceIndex >= 0)
@@ -1390,7 +1404,7 @@ void Entity::onCellWriteToDBCompleted(CALLBACK_ID callbackID, int8 shouldAutoLoa
 //-------------------------------------------------------------------------------------
 void Entity::onWriteToDB()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	PyObject* cd = cellDataDict_;
 	if (!cd)
@@ -1548,14 +1562,14 @@ void Entity::onTeleportCB(Network::Channel* pChannel, SPACE_ID spaceID, bool fro
 //-------------------------------------------------------------------------------------
 void Entity::onTeleportFailure()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 	CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onTeleportFailure"), GETERR));
 }
 
 //-------------------------------------------------------------------------------------
 void Entity::onTeleportSuccess(SPACE_ID spaceID)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	this->spaceID(spaceID);
 	CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onTeleportSuccess"), GETERR));
@@ -1651,7 +1665,7 @@ void Entity::onGetDBID(Network::Channel* pChannel, DBID dbid)
 //-------------------------------------------------------------------------------------
 void Entity::onTimer(ScriptID timerID, int useraAgs)
 {
-	SCOPED_PROFILE(ONTIMER_PROFILE);
+	SCOPED_PROFILE_ENTITY(ONTIMER_PROFILE, id());
 	
 	CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS2(pyTempObj, const_cast<char*>("onTimer"),
 		const_cast<char*>("Ii"), timerID, useraAgs, GETERR));
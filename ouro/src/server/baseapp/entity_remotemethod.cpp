@@ -58,7 +58,7 @@ PyObject* EntityRemoteMethod::tp_call(PyObject* self, PyObject* args,
 	// If the client method is called, we log the event and record the bandwidth
 	if(methodDescription->checkArgs(args))
 	{
-		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		Network::Bundle* pBundle = static_cast<Proxy*>(pEntity)->createSendBundle();
 		entityCall->newCall((*pBundle));
 
 		MemoryStream* mstream = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
@@ -80,7 +80,9 @@ PyObject* EntityRemoteMethod::tp_call(PyObject* self, PyObject* args,
 			(*pBundle).append(mstream->data(), (int)mstream->wpos());
 
 		// Record the amount of data generated by this event
-		g_privateClientEventHistoryStats.trackEvent(pEntity->scriptName(), 
+		g_privateClientEventHistoryStats.trackEvent(pEntity->pScriptModule()->getUType(), 
+			methodDescription->eventID(), 
+			pEntity->scriptName(), 
 			methodDescription->getName(), 
 			pBundle->currMsgLength(), 
 			"::");
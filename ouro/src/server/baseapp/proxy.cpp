@@ -85,7 +85,7 @@ void Proxy::kick()
 	Network::Channel* pChannel = Baseapp::getSingleton().networkInterface().findChannel(addr_);
 	if(pChannel && !pChannel->isDestroyed())
 	{
-		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		Network::Bundle* pBundle = createSendBundle();
 		(*pBundle).newMessage(ClientInterface::onKicked);
 		ClientInterface::onKickedArgs1::staticAddToBundle(*pBundle, SERVER_ERR_PROXY_DESTROYED);
 		//pBundle->send(Baseapp::getSingleton().networkInterface(), pChannel);
@@ -106,7 +106,7 @@ void Proxy::initClientBasePropertys()
 	
 	if(s1->wpos() > 0)
 	{
-		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		Network::Bundle* pBundle = createSendBundle();
 		(*pBundle).newMessage(ClientInterface::onUpdatePropertys);
 		(*pBundle) << this->id();
 		(*pBundle).append(*s1);
@@ -123,7 +123,7 @@ void Proxy::initClientCellPropertys()
 	if(clientEntityCall() == NULL)
 		return;
 
-	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	Network::Bundle* pBundle = createSendBundle();
 	(*pBundle).newMessage(ClientInterface::onUpdatePropertys);
 	(*pBundle) << this->id();
 
@@ -386,7 +386,7 @@ void Proxy::giveClientTo(Proxy* proxy)
 		}
 
 		// Since the client loses control of it, then notify the client to destroy the entity.
-		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		Network::Bundle* pBundle = createSendBundle();
 		(*pBundle).newMessage(ClientInterface::onEntityDestroyed);
 		(*pBundle) << this->id();
 		sendToClient(ClientInterface::onEntityDestroyed, pBundle);
@@ -775,6 +775,18 @@ bool Proxy::pushBundle(Network::Bundle* pBundle)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+Network::Bundle* Proxy::createSendBundle()
+{
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+
+	Network::Channel* pChannel = clientEntityCall() ? clientEntityCall()->getChannel() : NULL;
+	if (pChannel)
+		pBundle->pChannel(pChannel);
+
+	return pBundle;
+}
+
 //-------------------------------------------------------------------------------------
 bool Proxy::sendToClient(const Network::MessageHandler& msgHandler, Network::Bundle* pBundle)
 {
@@ -40,6 +40,12 @@ public:
 	typedef std::vector<Network::Bundle*> Bundles;
 	bool pushBundle(Network::Bundle* pBundle);
 
+	/**
+		A bundle for the client, it knows the channel before the messages are written 
+		(a websocket client gets the room for the frame header in every packet)
+	*/
+	Network::Bundle* createSendBundle();
+
 	/**
 		Push a message to the witness client
 	*/
@@ -23,6 +23,19 @@ ServerConfig g_serverConfig;
 OURO_SINGLETON_INIT(Baseappmgr);
 
 
+//-------------------------------------------------------------------------------------
+static std::string peekEntityType(MemoryStream& s)
+{
+	std::string entityType;
+
+	size_t rpos = s.rpos();
+	s >> entityType;
+	s.rpos(rpos);
+
+	return entityType;
+}
+
+//-------------------------------------------------------------------------------------
 class AppForwardItem : public ForwardItem
 {
 public:
@@ -67,6 +80,7 @@ Baseappmgr::Baseappmgr(Network::EventDispatcher& dispatcher,
 	forward_anywhere_baseapp_messagebuffer_(ninterface, BASEAPP_TYPE),
 	forward_baseapp_messagebuffer_(ninterface),
 	bestBaseappID_(0),
+	loadPredictor_(),
 	baseapps_(),
 	pending_logins_(),
 	baseappsInitProgress_(0.f)
@@ -98,7 +112,11 @@ void Baseappmgr::handleTimeout(TimerHandle handle, void * arg)
 	switch (reinterpret_cast<uintptr>(arg))
 	{
 		case TIMEOUT_GAME_TICK:
-			this->handleGameTick();
+			{
+				ScopedMetricsTimer metricsTimer(pTickHistogram_);
+				ScopedFlightTick flightTick;
+				this->handleGameTick();
+			}
 			break;
 		default:
 			break;
@@ -116,6 +134,49 @@ void Baseappmgr::handleGameTick()
 	++g_ourotime;
 	threadPool_.onMainThreadTick();
 	networkInterface().processChannels(&BaseappmgrInterface::messageHandlers);
+
+	// Once per second
+	if (g_ourotime % 50 == 0)
+		updateLoginappsLoad();
+}
+
+//-------------------------------------------------------------------------------------
+void Baseappmgr::updateLoginappsLoad()
+{
+	float load = 0.f;
+	uint32 num = 0;
+
+	std::map< COMPONENT_ID, Baseapp >::iterator iter = baseapps_.begin();
+	for (; iter != baseapps_.end(); ++iter)
+	{
+		if ((iter->second.flags() & APP_FLAGS_NOT_PARTCIPATING_LOAD_BALANCING) > 0)
+			continue;
+
+		if (iter->second.isDestroyed() || iter->second.initProgress() <= 1.f)
+			continue;
+
+		load += iter->second.load();
+		++num;
+	}
+
+	if (num == 0)
+		return;
+
+	load /= float(num);
+
+	Components::COMPONENTS& cts = Components::getSingleton().getComponents(LOGINAPP_TYPE);
+
+	Components::COMPONENTS::iterator ctiter = cts.begin();
+	for (; ctiter != cts.end(); ++ctiter)
+	{
+		if ((*ctiter).pChannel == NULL)
+			continue;
+
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		(*pBundle).newMessage(LoginappInterface::onBaseappsLoad);
+		(*pBundle) << load;
+		(*ctiter).pChannel->send(pBundle);
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -135,6 +196,7 @@ void Baseappmgr::onChannelDeregister(Network::Channel * pChannel)
 					cinfo->cid, (baseapps_.size() - 1)));
 
 				baseapps_.erase(iter);
+				loadPredictor_.remove(cinfo->cid);
 				updateBestBaseapp();
 			}
 		}
@@ -180,6 +242,16 @@ bool Baseappmgr::initializeEnd()
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+bool Baseappmgr::initializeWatcher()
+{
+	WATCH_OBJECT("balance/assignSkew", this, &Baseappmgr::assignSkew);
+	WATCH_OBJECT("balance/numAssigned", this, &Baseappmgr::numAssigned);
+	WATCH_OBJECT("balance/entityCosts", this, &Baseappmgr::entityCosts);
+
+	return ServerApp::initializeWatcher();
+}
+
 //-------------------------------------------------------------------------------------
 void Baseappmgr::finalise()
 {
@@ -268,6 +340,8 @@ void Baseappmgr::updateBaseapp(Network::Channel* pChannel, COMPONENT_ID componen
 	baseapp.numEntitys(numEntitys);
 	baseapp.flags(flags);
 
+	loadPredictor_.onReport(componentID, load, numEntitys + numProxices);
+
 	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(componentID);
 	if (cinfos)
 		cinfos->appFlags = flags;
@@ -279,10 +353,7 @@ void Baseappmgr::updateBaseapp(Network::Channel* pChannel, COMPONENT_ID componen
 COMPONENT_ID Baseappmgr::findFreeBaseapp()
 {
 	std::map< COMPONENT_ID, Baseapp >::iterator iter = baseapps_.begin();
-	COMPONENT_ID cid = 0;
-
-	float minload = 1.f;
-	ENTITY_ID numEntities = 0x7fffffff;
+	std::vector<COMPONENT_ID> candidates;
 
 	for(; iter != baseapps_.end(); ++iter)
 	{
@@ -291,24 +362,28 @@ COMPONENT_ID Baseappmgr::findFreeBaseapp()
 		
 		// First the process must be alive and initialized
 		if(!iter->second.isDestroyed() && iter->second.initProgress() > 1.f)
-		{
-			// unconditionally allocated if there are no entities
-			if(iter->second.numEntities() == 0)
-				return iter->first;
+			candidates.push_back(iter->first);
+	}
 
-			// Compare and record the least loaded process and eventually be assigned
-			if(minload > iter->second.load() || 
-				(minload == iter->second.load() && numEntities > iter->second.numEntities()))
-			{
-				cid = iter->first;
+	// The predicted load includes the entities placed since the last report, so placements
+	// between two reports do not all land on the same baseapp
+	return loadPredictor_.choose(candidates);
+}
 
-				numEntities = iter->second.numEntities();
-				minload = iter->second.load();
-			}
-		}
-	}
+//-------------------------------------------------------------------------------------
+void Baseappmgr::onAssignBaseapp(COMPONENT_ID cid, const std::string& entityType, bool isProxy)
+{
+	std::map< COMPONENT_ID, Baseapp >::iterator iter = baseapps_.find(cid);
+	if (iter == baseapps_.end())
+		return;
+
+	// Increase the number of entities in advance
+	if (isProxy)
+		iter->second.incNumProxices();
+	else
+		iter->second.incNumEntities();
 
-	return cid;
+	loadPredictor_.onAssign(cid, entityType);
 }
 
 //-------------------------------------------------------------------------------------
@@ -329,6 +404,8 @@ void Baseappmgr::reqCreateEntityAnywhere(Network::Channel* pChannel, MemoryStrea
 	if(cinfos)
 		cinfos->state = COMPONENT_STATE_RUN;
 
+	std::string entityType = peekEntityType(s);
+
 	updateBestBaseapp();
 
 	if (bestBaseappID_ == 0 && numLoadBalancingApp() == 0)
@@ -369,12 +446,7 @@ void Baseappmgr::reqCreateEntityAnywhere(Network::Channel* pChannel, MemoryStrea
 	cinfos->pChannel->send(pBundle);
 	s.done();
 
-	// Increase the number of entities in advance
-	std::map< COMPONENT_ID, Baseapp >::iterator baseapps_iter = baseapps_.find(bestBaseappID_);
-	if (baseapps_iter != baseapps_.end())
-	{
-		baseapps_iter->second.incNumEntities();
-	}
+	onAssignBaseapp(bestBaseappID_, entityType, false);
 }
 
 //-------------------------------------------------------------------------------------
@@ -392,6 +464,8 @@ void Baseappmgr::reqCreateEntityRemotely(Network::Channel* pChannel, MemoryStrea
 	COMPONENT_ID createToComponentID = 0;
 	s >> createToComponentID;
 
+	std::string entityType = peekEntityType(s);
+
 	cinfos = Components::getSingleton().findComponent(BASEAPP_TYPE, createToComponentID);
 	if (cinfos == NULL || cinfos->pChannel == NULL || cinfos->state != COMPONENT_STATE_RUN)
 	{
@@ -424,12 +498,7 @@ void Baseappmgr::reqCreateEntityRemotely(Network::Channel* pChannel, MemoryStrea
 	cinfos->pChannel->send(pBundle);
 	s.done();
 
-	// Increase the number of entities in advance
-	std::map< COMPONENT_ID, Baseapp >::iterator baseapps_iter = baseapps_.find(createToComponentID);
-	if (baseapps_iter != baseapps_.end())
-	{
-		baseapps_iter->second.incNumEntities();
-	}
+	onAssignBaseapp(createToComponentID, entityType, false);
 }
 
 //-------------------------------------------------------------------------------------
@@ -508,12 +577,8 @@ void Baseappmgr::reqCreateEntityAnywhereFromDBID(Network::Channel* pChannel, Mem
 	cinfos->pChannel->send(pBundle);
 	s.done();
 
-	// Increase the number of entities in advance
-	std::map< COMPONENT_ID, Baseapp >::iterator baseapps_iter = baseapps_.find(targetComponentID);
-	if (baseapps_iter != baseapps_.end())
-	{
-		baseapps_iter->second.incNumEntities();
-	}
+	// The entity type is not known before it is loaded from the database
+	onAssignBaseapp(targetComponentID, "", false);
 }
 
 //-------------------------------------------------------------------------------------
@@ -563,12 +628,8 @@ void Baseappmgr::reqCreateEntityRemotelyFromDBID(Network::Channel* pChannel, Mem
 	cinfos->pChannel->send(pBundle);
 	s.done();
 
-	// Increase the number of entities in advance
-	std::map< COMPONENT_ID, Baseapp >::iterator baseapps_iter = baseapps_.find(targetComponentID);
-	if (baseapps_iter != baseapps_.end())
-	{
-		baseapps_iter->second.incNumEntities();
-	}
+	// The entity type is not known before it is loaded from the database
+	onAssignBaseapp(targetComponentID, "", false);
 }
 
 //-------------------------------------------------------------------------------------
@@ -649,11 +710,7 @@ void Baseappmgr::registerPendingAccountToBaseapp(Network::Channel* pChannel, Mem
 	pBundle->appendBlob(datas);
 	cinfos->pChannel->send(pBundle);
 
-	// Increase the number of entities in advance
-	if (baseapps_iter != baseapps_.end())
-	{
-		baseapps_iter->second.incNumProxices();
-	}
+	onAssignBaseapp(bestBaseappID_, g_ouroSrvConfig.getDBMgr().dbAccountEntityScriptType, true);
 }
 
 //-------------------------------------------------------------------------------------
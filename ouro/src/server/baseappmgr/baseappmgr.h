@@ -10,6 +10,7 @@
 #include "server/idallocate.h"
 #include "server/serverconfig.h"
 #include "server/forward_messagebuffer.h"
+#include "server/load_predictor.h"
 #include "common/timer.h"
 #include "network/endpoint.h"
 
@@ -45,9 +46,25 @@ public:
 	bool initializeEnd();
 	void finalise();
 
+	virtual bool initializeWatcher();
+
 	COMPONENT_ID findFreeBaseapp();
 	void updateBestBaseapp();
 
+	/**
+		Sends the average load of the baseapps to the loginapps, they slow logins down while it is high
+	*/
+	void updateLoginappsLoad();
+
+	/**
+		Counts an entity placed on a baseapp in its predicted load until the baseapp reports again
+	*/
+	void onAssignBaseapp(COMPONENT_ID cid, const std::string& entityType, bool isProxy);
+
+	float assignSkew() const { return loadPredictor_.assignSkew(); }
+	uint32 numAssigned() const { return loadPredictor_.numAssigned(); }
+	std::string entityCosts() const { return loadPredictor_.costsToString(); }
+
 		/** Network Interface
 		Baseapp::createEntityAnywhere queries the current best component ID
 	*/
@@ -157,6 +174,8 @@ protected:
 
 	COMPONENT_ID												bestBaseappID_;
 
+	LoadPredictor												loadPredictor_;
+
 	std::map< COMPONENT_ID, Baseapp >							baseapps_;
 
 	OUROUnordered_map< std::string, COMPONENT_ID >				pending_logins_;
@@ -21,6 +21,7 @@
 #include "server/py_file_descriptor.h"
 #include "dbmgr/dbmgr_interface.h"
 #include "navigation/navigation.h"
+#include "navigation/navigation_mesh_tiles.h"
 #include "client_lib/client_interface.h"
 #include "common/sha1.h"
 
@@ -46,10 +47,13 @@ Cellapp::Cellapp(Network::EventDispatcher& dispatcher,
 	EntityApp<Entity>(dispatcher, ninterface, componentType, componentID),
 	pCellAppData_(NULL),
 	forward_messagebuffer_(ninterface),
+	moveBatch_(),
+	witnessUpdater_(),
 	cells_(),
 	pTelnetServer_(NULL),
 	pWitnessedTimeoutHandler_(NULL),
 	pGhostManager_(NULL),
+	spaceMigration_(),
 	flags_(APP_FLAGS_NONE),
 	spaceViewers_()
 {
@@ -141,6 +145,11 @@ bool Cellapp::initializeWatcher()
 	WATCH_OBJECT("load", this, &Cellapp::_getLoad);
 	WATCH_OBJECT("spaceSize", &Ouroboros::getUsername);
 	WATCH_OBJECT("stats/runningTime", &runningTime);
+	WATCH_OBJECT("spaceMigration/migrating", this, &Cellapp::numMigratingSpaces);
+	WATCH_OBJECT("spaceMigration/migratedOut", this, &Cellapp::numSpacesMigratedOut);
+	WATCH_OBJECT("spaceMigration/migratedIn", this, &Cellapp::numSpacesMigratedIn);
+	WATCH_OBJECT("spaceMigration/failed", this, &Cellapp::numSpaceMigrationsFailed);
+	WATCH_OBJECT("spaceMigration/lastFreezeTime", this, &Cellapp::lastSpaceFreezeTime);
 	return EntityApp<Entity>::initializeWatcher() && WatchObjectPool::initWatchPools();
 }
 
@@ -180,6 +189,9 @@ bool Cellapp::installPyModules()
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		setSpaceData,					SpaceMemory::__py_SetSpaceData,							METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		getSpaceData,					SpaceMemory::__py_GetSpaceData,							METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		delSpaceData,					SpaceMemory::__py_DelSpaceData,							METH_VARARGS,			0);
+	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		addNavObstacle,					SpaceMemory::__py_AddNavObstacle,						METH_VARARGS,			0);
+	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		addNavBoxObstacle,				SpaceMemory::__py_AddNavBoxObstacle,					METH_VARARGS,			0);
+	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		removeNavObstacle,				SpaceMemory::__py_RemoveNavObstacle,					METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		isShuttingDown,					__py_isShuttingDown,									METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		address,						__py_address,											METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		raycast,						__py_raycast,											METH_VARARGS,			0);
@@ -255,8 +267,15 @@ void Cellapp::handleGameTick()
 
 	EntityApp<Entity>::handleGameTick();
 
-	updatables_.update();
+	// The controllers move the entities, the moved coordinate nodes are integrated
+	// once before the witnesses send the updates to the clients
+	updatables_.update(UPDATE_PRIORITY_DEFAULT);
+	SpaceMemorys::integrateCoordinateSystems();
+	updatables_.update(UPDATE_PRIORITY_WITNESS);
+	witnessUpdater_.process();
+
 	SpaceMemorys::update();
+	spaceMigration_.process();
 }
 
 //-------------------------------------------------------------------------------------
@@ -279,6 +298,14 @@ bool Cellapp::initializeEnd()
 
 	// Whether to manage the Y axis
 	CoordinateSystem::hasY = g_ouroSrvConfig.getCellApp().coordinateSystem_hasY;
+	CoordinateSystem::deferredUpdates = g_ouroSrvConfig.getCellApp().coordinateSystem_deferredUpdates;
+
+	// Navmeshes baked into mapped tiles
+	NavMeshTiles::enabled = g_ouroSrvConfig.getCellApp().navmesh.mapped;
+	NavMeshTiles::evictTime = g_ouroSrvConfig.getCellApp().navmesh.tileEvictTime;
+
+	if (!witnessUpdater_.initialize(g_ouroSrvConfig.getCellApp().witness_updateThreads))
+		return false;
 
 	dispatcher_.clearSpareTime();
 
@@ -312,6 +339,8 @@ void Cellapp::finalise()
 	SpaceMemorys::finalise();
 	Navigation::getSingleton().finalise();
 	forward_messagebuffer_.clear();
+	moveBatch_.clear();
+	witnessUpdater_.finalise();
 	updatables_.clear();
 
 	destroyObjPool();
@@ -1124,6 +1153,26 @@ void Cellapp::onCreateCellEntityFromBaseapp(Network::Channel* pChannel, Ouroboro
 		return;
 	}
 
+	// The space was migrated to another cellapp(or is being migrated), the real space entity lives there
+	Entity* pCreateToEntity = pEntities_->find(createToEntityID);
+	COMPONENT_ID targetCell = 0;
+
+	if (pCreateToEntity && !pCreateToEntity->isReal())
+		targetCell = pCreateToEntity->realCell();
+	else if (pCreateToEntity == NULL && pGhostManager_)
+		targetCell = pGhostManager_->getRoute(createToEntityID);
+
+	if (targetCell > 0)
+	{
+		Network::Bundle* pForwardBundle = pGhostManager_->createSendBundle(targetCell);
+		(*pForwardBundle).newMessage(CellappInterface::onCreateCellEntityFromBaseapp);
+		(*pForwardBundle) << createToEntityID << entityType << entityID << componentID << hasClient << inRescore;
+		pForwardBundle->append(s);
+		pGhostManager_->pushRouteMessage(createToEntityID, targetCell, pForwardBundle);
+		s.done();
+		return;
+	}
+
 	_onCreateCellEntityFromBaseapp(entityType, createToEntityID, entityID, 
 					&s, hasClient, inRescore, componentID, spaceID);
 
@@ -2092,6 +2141,47 @@ void Cellapp::reqTeleportToCellAppOver(Network::Channel* pChannel, MemoryStream&
 	entity->removeFlags(ENTITY_FLAGS_TELEPORT_START);
 }
 
+//-------------------------------------------------------------------------------------
+void Cellapp::reqMigrateSpace(Network::Channel* pChannel, MemoryStream& s)
+{
+	SPACE_ID spaceID;
+	COMPONENT_ID targetCid;
+
+	s >> spaceID >> targetCid;
+
+	spaceMigration_.migrate(spaceID, targetCid);
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::onMigrateSpaceSnapshot(Network::Channel* pChannel, MemoryStream& s)
+{
+	spaceMigration_.onSnapshot(pChannel, s);
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::onMigrateSpaceSnapshotCB(Network::Channel* pChannel, MemoryStream& s)
+{
+	spaceMigration_.onSnapshotCB(pChannel, s);
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::onMigrateSpaceCommit(Network::Channel* pChannel, MemoryStream& s)
+{
+	spaceMigration_.onCommit(pChannel, s);
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::onMigrateSpaceCommitCB(Network::Channel* pChannel, MemoryStream& s)
+{
+	spaceMigration_.onCommitCB(pChannel, s);
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::onMigrateSpaceAbort(Network::Channel* pChannel, MemoryStream& s)
+{
+	spaceMigration_.onAbort(pChannel, s);
+}
+
 //-------------------------------------------------------------------------------------
 int Cellapp::raycast(SPACE_ID spaceID, int layer, const Position3D& start, const Position3D& end, std::vector<Position3D>& hitPos)
 {
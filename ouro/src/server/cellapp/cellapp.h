@@ -8,7 +8,10 @@
 #include "cells.h"
 #include "space_viewer.h"
 #include "updatables.h"
+#include "move_batch.h"
+#include "witness_updater.h"
 #include "ghost_manager.h"
+#include "space_migration.h"
 #include "witnessed_timeout_handler.h"
 #include "server/entity_app.h"
 #include "server/forward_messagebuffer.h"
@@ -196,6 +199,16 @@ public:
 	bool addUpdatable(Updatable* pObject);
 	bool removeUpdatable(Updatable* pObject);
 
+	/**
+		Moves the entities of moveToPoint, moveToEntity and navigate
+	*/
+	MoveBatch& moveBatch() { return moveBatch_; }
+
+	/**
+		Writes the position updates of the witnesses on the witness update threads
+	*/
+	WitnessUpdater& witnessUpdater() { return witnessUpdater_; }
+
 	/**
 		hook entitycallcall
 	*/
@@ -233,6 +246,24 @@ public:
 	void reqTeleportToCellAppCB(Network::Channel* pChannel, MemoryStream& s);
 	void reqTeleportToCellAppOver(Network::Channel* pChannel, MemoryStream& s);
 
+	/**
+				Network Interface
+		Space migration, cellappmgr asks to move a space, the source and the target cellapp hand it over
+	*/
+	void reqMigrateSpace(Network::Channel* pChannel, MemoryStream& s);
+	void onMigrateSpaceSnapshot(Network::Channel* pChannel, MemoryStream& s);
+	void onMigrateSpaceSnapshotCB(Network::Channel* pChannel, MemoryStream& s);
+	void onMigrateSpaceCommit(Network::Channel* pChannel, MemoryStream& s);
+	void onMigrateSpaceCommitCB(Network::Channel* pChannel, MemoryStream& s);
+	void onMigrateSpaceAbort(Network::Channel* pChannel, MemoryStream& s);
+
+	SpaceMigration& spaceMigration(){ return spaceMigration_; }
+	uint32 numMigratingSpaces() const { return spaceMigration_.numMigrating(); }
+	uint32 numSpacesMigratedOut() const { return spaceMigration_.numMigratedOut(); }
+	uint32 numSpacesMigratedIn() const { return spaceMigration_.numMigratedIn(); }
+	uint32 numSpaceMigrationsFailed() const { return spaceMigration_.numFailed(); }
+	float lastSpaceFreezeTime() const { return spaceMigration_.lastFreezeTime(); }
+
 	/**
 		Get and set the ghost manager
 	*/
@@ -260,6 +291,9 @@ protected:
 
 	Updatables							updatables_;
 
+	MoveBatch							moveBatch_;
+	WitnessUpdater						witnessUpdater_;
+
 	// all cells
 	Cells								cells_;
 
@@ -268,6 +302,8 @@ protected:
 	WitnessedTimeoutHandler	*			pWitnessedTimeoutHandler_;
 
 	GhostManager*						pGhostManager_;
+
+	SpaceMigration						spaceMigration_;
 	
 	// APP logo
 	uint32								flags_;
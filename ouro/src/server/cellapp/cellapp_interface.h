@@ -192,6 +192,20 @@ NETWORK_INTERFACE_DECLARE_BEGIN(CellappInterface)
 
 	//entity lost an observer (client)
 	ENTITY_MESSAGE_DECLARE_ARGS0(onLoseWitness,										NETWORK_FIXED_MESSAGE)
+
+	// cellappmgr asks the cellapp to move a space to another cellapp
+	CELLAPP_MESSAGE_DECLARE_STREAM(reqMigrateSpace,									NETWORK_VARIABLE_MESSAGE)
+
+	// Space migration: the source sends the space, the target loads it and answers
+	CELLAPP_MESSAGE_DECLARE_STREAM(onMigrateSpaceSnapshot,							NETWORK_VARIABLE_MESSAGE)
+	CELLAPP_MESSAGE_DECLARE_STREAM(onMigrateSpaceSnapshotCB,						NETWORK_VARIABLE_MESSAGE)
+
+	// Space migration: the source hands over the entities and the changes since the snapshot, the target takes them over and answers
+	CELLAPP_MESSAGE_DECLARE_STREAM(onMigrateSpaceCommit,							NETWORK_VARIABLE_MESSAGE)
+	CELLAPP_MESSAGE_DECLARE_STREAM(onMigrateSpaceCommitCB,							NETWORK_VARIABLE_MESSAGE)
+
+	// Space migration: the source gave up, the target drops the loaded space. After the commit deadline it answers with another CommitCB
+	CELLAPP_MESSAGE_DECLARE_STREAM(onMigrateSpaceAbort,								NETWORK_VARIABLE_MESSAGE)
 NETWORK_INTERFACE_DECLARE_END()
 
 #ifdef DEFINE_IN_INTERFACE
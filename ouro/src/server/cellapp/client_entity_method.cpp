@@ -157,7 +157,7 @@ PyObject* ClientEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 		if(ialiasID != -1)
 		{
 			OURO_ASSERT(msgHandler.msgID == ClientInterface::onRemoteMethodCallOptimized.msgID);
-			(*pSendBundle)  << (uint8)ialiasID;
+			srcEntity->pWitness()->addViewEntityAliasIDToBundle(pSendBundle, ialiasID);
 		}
 		else
 		{
@@ -68,7 +68,7 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 		S_Return;
 	}
 	
-	const std::list<ENTITY_ID>& entities = pEntity->witnesses();
+	const WITNESSES& entities = pEntity->witnesses();
 
 	if(otherClients_)
 	{
@@ -151,7 +151,9 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 			}
 
 			// Record the amount of data generated by this event
-			g_publicClientEventHistoryStats.trackEvent(pEntity->scriptName(),
+			g_publicClientEventHistoryStats.trackEvent(pEntity->pScriptModule()->getUType(),
+				methodDescription->eventID(),
+				pEntity->scriptName(),
 				methodDescription->getName(),
 				pSendBundle->currMsgLength(),
 				"::");
@@ -161,11 +163,10 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 		}
 
 		// broadcast to others
-		std::list<ENTITY_ID>::const_iterator iter = entities.begin();
-		for(; iter != entities.end(); ++iter)
+		for(size_t i = 0; i < entities.size(); ++i)
 		{
-			Entity* pViewEntity = Cellapp::getSingleton().findEntity((*iter));
-			if(pViewEntity == NULL || pViewEntity->pWitness() == NULL || pViewEntity->isDestroyed())
+			Entity* pViewEntity = entities[i].get();
+			if(pViewEntity->pWitness() == NULL || pViewEntity->isDestroyed())
 				continue;
 			
 			EntityCall* entityCall = pViewEntity->clientEntityCall();
@@ -194,7 +195,7 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 			if(ialiasID != -1)
 			{
 				OURO_ASSERT(msgHandler.msgID == ClientInterface::onRemoteMethodCallOptimized.msgID);
-				(*pSendBundle)  << (uint8)ialiasID;
+				pViewEntity->pWitness()->addViewEntityAliasIDToBundle(pSendBundle, ialiasID);
 			}
 			else
 			{
@@ -233,7 +234,9 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 			ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, msgHandler, viewEntityMessage);
 
 			// Record the amount of data generated by this event
-			g_publicClientEventHistoryStats.trackEvent(pViewEntity->scriptName(), 
+			g_publicClientEventHistoryStats.trackEvent(pViewEntity->pScriptModule()->getUType(), 
+				methodDescription->eventID(), 
+				pViewEntity->scriptName(), 
 				methodDescription->getName(), 
 				pSendBundle->currMsgLength(), 
 				"::");
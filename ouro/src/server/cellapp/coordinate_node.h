@@ -19,6 +19,7 @@ namespace Ouroboros{
 #define COORDINATE_NODE_FLAG_INSTALLING 0x00000080 // The node is installing the operation
 #define COORDINATE_NODE_FLAG_POSITIVE_BOUNDARY 0x00000100 // The node is the positive boundary of the trigger
 #define COORDINATE_NODE_FLAG_NEGATIVE_BOUNDARY 0x00000200 // The node is the negative boundary of the trigger
+#define COORDINATE_NODE_FLAG_MOVED 0x00000400 // The node has moved and waits for CoordinateSystem::integrateMovedNodes
 
 #define COORDINATE_NODE_FLAG_HIDE_OR_REMOVED		(COORDINATE_NODE_FLAG_REMOVED | COORDINATE_NODE_FLAG_HIDE)
 
@@ -10,6 +10,13 @@
 namespace Ouroboros{	
 
 bool CoordinateSystem::hasY = false;
+bool CoordinateSystem::deferredUpdates = false;
+
+//-------------------------------------------------------------------------------------
+static bool compareMovedNodeX(const CoordinateNode* a, const CoordinateNode* b)
+{
+	return a->xx() < b->xx();
+}
 
 //-------------------------------------------------------------------------------------
 CoordinateSystem::CoordinateSystem():
@@ -20,7 +27,8 @@ first_z_coordinateNode_(NULL),
 dels_(),
 dels_count_(0),
 updating_(0),
-releases_()
+releases_(),
+movedNodes_()
 {
 }
 
@@ -29,6 +37,7 @@ CoordinateSystem::~CoordinateSystem()
 {
 	dels_.clear();
 	dels_count_ = 0;
+	movedNodes_.clear();
 
 	if(first_x_coordinateNode_)
 	{
@@ -126,6 +135,15 @@ bool CoordinateSystem::insert(CoordinateNode* pNode)
 //-------------------------------------------------------------------------------------
 bool CoordinateSystem::remove(CoordinateNode* pNode)
 {
+	if (pNode->hasFlags(COORDINATE_NODE_FLAG_MOVED))
+	{
+		pNode->removeFlags(COORDINATE_NODE_FLAG_MOVED);
+
+		std::vector<CoordinateNode*>::iterator iter = std::find(movedNodes_.begin(), movedNodes_.end(), pNode);
+		if (iter != movedNodes_.end())
+			movedNodes_.erase(iter);
+	}
+
 	pNode->addFlags(COORDINATE_NODE_FLAG_REMOVING);
 	pNode->onRemove();
 	update(pNode);
@@ -636,5 +654,47 @@ void CoordinateSystem::update(CoordinateNode* pNode)
 #endif
 }
 
+//-------------------------------------------------------------------------------------
+void CoordinateSystem::addMovedNode(CoordinateNode* pNode)
+{
+	if (pNode->hasFlags(COORDINATE_NODE_FLAG_MOVED | COORDINATE_NODE_FLAG_REMOVING | COORDINATE_NODE_FLAG_REMOVED))
+		return;
+
+	pNode->addFlags(COORDINATE_NODE_FLAG_MOVED);
+	movedNodes_.push_back(pNode);
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateSystem::integrateMovedNodes()
+{
+	if (movedNodes_.empty())
+		return;
+
+	AUTO_SCOPED_PROFILE("coordinateSystemIntegrate");
+
+	// Nodes moved by the callbacks of this pass are integrated in the next one
+	std::vector<CoordinateNode*> nodes;
+	nodes.swap(movedNodes_);
+
+	// Taken in the order of their new x, a node only walks past the nodes that have not been placed yet
+	// and the ones placed before it are already in order, the lists are sorted like an insertion sort.
+	// The sort is stable so that the nodes at the same x keep the order they moved in, and the
+	// enter/leave events of a pass always come in the same order.
+	std::stable_sort(nodes.begin(), nodes.end(), compareMovedNodeX);
+
+	std::vector<CoordinateNode*>::iterator iter = nodes.begin();
+	for (; iter != nodes.end(); ++iter)
+	{
+		CoordinateNode* pNode = (*iter);
+
+		// Removed from the system since it moved
+		if (!pNode->hasFlags(COORDINATE_NODE_FLAG_MOVED))
+			continue;
+
+		pNode->removeFlags(COORDINATE_NODE_FLAG_MOVED);
+		pNode->update();
+	}
+}
+
 //-------------------------------------------------------------------------------------
 }
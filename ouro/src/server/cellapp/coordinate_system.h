@@ -37,6 +37,14 @@ public:
 	*/
 	void update(CoordinateNode* pNode);
 
+	/**
+		With deferredUpdates the moved nodes are only marked, all of them are repositioned
+		together by integrateMovedNodes once per tick
+	*/
+	void addMovedNode(CoordinateNode* pNode);
+	void integrateMovedNodes();
+	INLINE size_t movedNodesSize() const;
+
 	/**
 		Mobile node
 	*/
@@ -53,6 +61,7 @@ public:
 	INLINE uint32 size() const;
 
 	static bool hasY;
+	static bool deferredUpdates;
 
 	INLINE void incUpdating();
 	INLINE void decUpdating();
@@ -71,6 +80,9 @@ private:
 	int updating_;
 
 	std::list<CoordinateNode*> releases_;
+
+	// Nodes marked by addMovedNode, in the order they moved
+	std::vector<CoordinateNode*> movedNodes_;
 };
 
 }
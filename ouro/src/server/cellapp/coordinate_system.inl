@@ -22,6 +22,12 @@ INLINE bool CoordinateSystem::isEmpty() const
 	return first_x_coordinateNode_ == NULL && first_y_coordinateNode_ == NULL && first_z_coordinateNode_ == NULL;
 }
 
+//-------------------------------------------------------------------------------------
+INLINE size_t CoordinateSystem::movedNodesSize() const
+{
+	return movedNodes_.size();
+}
+
 //-------------------------------------------------------------------------------------
 INLINE void CoordinateSystem::incUpdating()
 {
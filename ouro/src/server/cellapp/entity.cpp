@@ -114,6 +114,7 @@ topSpeed_(-0.1f),
 topSpeedY_(-0.1f),
 witnesses_(),
 witnesses_count_(0),
+witnessIndexes_(),
 pWitness_(NULL),
 allClients_(new AllClients(pScriptModule, id, false)),
 otherClients_(new AllClients(pScriptModule, id, true)),
@@ -205,7 +206,7 @@ void Entity::onDestroy(bool callScript)
 {
 	if(callScript && isReal())
 	{
-		SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+		SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 		CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onDestroy"), GETERR));
 
 		// If this script is not notified, then this callback will not be generated.
@@ -254,13 +255,13 @@ void Entity::onDestroy(bool callScript)
 		ERROR_MSG(fmt::format("{}::onDestroy(): id={}, witnesses_count({}/{}) != 0, isReal={}, spaceID={}, position=({},{},{})\n", 
 			scriptName(), id(), witnesses_count_, witnesses_.size(), isReal(), this->spaceID(), position().x, position().y, position().z));
 
-		std::list<ENTITY_ID> witnesses_copy = witnesses_;
-		std::list<ENTITY_ID>::iterator it = witnesses_copy.begin();
+		WITNESSES witnesses_copy = witnesses_;
+		WITNESSES::iterator it = witnesses_copy.begin();
 		for (; it != witnesses_copy.end(); ++it)
 		{
-			Entity *ent = Cellapp::getSingleton().findEntity((*it));
+			Entity *ent = (*it).get();
 
-			if (ent)
+			if (!ent->isDestroyed())
 			{
 				bool inTargetView = false;
 
@@ -283,15 +284,16 @@ void Entity::onDestroy(bool callScript)
 				}
 				
 				ERROR_MSG(fmt::format("\t=>witnessed={}({}), isDestroyed={}, isReal={}, inTargetView={}, spaceID={}, position=({},{},{})\n", 
-					ent->scriptName(), (*it), ent->isDestroyed(), ent->isReal(), inTargetView, ent->spaceID(), ent->position().x, ent->position().y, ent->position().z));
+					ent->scriptName(), ent->id(), ent->isDestroyed(), ent->isReal(), inTargetView, ent->spaceID(), ent->position().x, ent->position().y, ent->position().z));
 			}
 			else
 			{
-				ERROR_MSG(fmt::format("\t=> witnessed={}, not found entity!\n", (*it)));
+				ERROR_MSG(fmt::format("\t=> witnessed={}, entity is destroyed!\n", ent->id()));
 			}
 			
 			witnesses_count_ = 0;
 			witnesses_.clear();
+			witnessIndexes_.clear();
 		}
 
 		//OURO_ASSERT(witnesses_count_ == 0);
@@ -380,7 +382,7 @@ void Entity::destroySpace()
 //-------------------------------------------------------------------------------------
 void Entity::onSpaceGone()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 	CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onSpaceGone"), GETERR));
 }
 
@@ -709,7 +711,9 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 			}
 
 			// Record the amount of data generated by this event
-			g_publicCellEventHistoryStats.trackEvent(scriptName(), 
+			g_publicCellEventHistoryStats.trackEvent(pScriptModule()->getUType(), 
+				propertyDescription->eventID(), 
+				scriptName(), 
 				propertyDescription->getName(), 
 				pForwardBundle->currMsgLength());
 
@@ -722,11 +726,10 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 	{
 		DETAIL_TYPE propertyDetailLevel = propertyDescription->getDetailLevel();
 
-		std::list<ENTITY_ID>::iterator witer = witnesses_.begin();
-		for(; witer != witnesses_.end(); ++witer)
+		for(size_t i = 0; i < witnesses_.size(); ++i)
 		{
-			Entity* pEntity = Cellapp::getSingleton().findEntity((*witer));
-			if(pEntity == NULL || pEntity->pWitness() == NULL)
+			Entity* pEntity = witnesses_[i].get();
+			if(pEntity->pWitness() == NULL)
 				continue;
 
 			EntityCall* clientEntityCall = pEntity->clientEntityCall();
@@ -759,7 +762,7 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 				if(ialiasID != -1)
 				{
 					OURO_ASSERT(msgHandler.msgID == ClientInterface::onUpdatePropertysOptimized.msgID);
-					(*pSendBundle)  << (uint8)ialiasID;
+					pEntity->pWitness()->addViewEntityAliasIDToBundle(pSendBundle, ialiasID);
 				}
 				else
 				{
@@ -781,7 +784,9 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 				pSendBundle->append(*mstream);
 				
 				// Record the amount of data generated by this event
-				g_publicClientEventHistoryStats.trackEvent(scriptName(), 
+				g_publicClientEventHistoryStats.trackEvent(pScriptModule()->getUType(), 
+					propertyDescription->eventID(), 
+					scriptName(), 
 					propertyDescription->getName(), 
 					pSendBundle->currMsgLength());
 
@@ -879,7 +884,9 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 		// Record the amount of data generated by this event
 		if((flags & ENTITY_BROADCAST_OTHER_CLIENT_FLAGS) <= 0)
 		{
-			g_privateClientEventHistoryStats.trackEvent(scriptName(), 
+			g_privateClientEventHistoryStats.trackEvent(pScriptModule()->getUType(), 
+				propertyDescription->eventID(), 
+				scriptName(), 
 				propertyDescription->getName(), 
 				pSendBundle->currMsgLength());
 		}
@@ -984,7 +991,7 @@ void Entity::onRemoteCallMethodFromClient(Network::Channel* pChannel, ENTITY_ID
 void Entity::onRemoteMethodCall_(PropertyDescription* pComponentPropertyDescription, 
 	MethodDescription* pMethodDescription, ENTITY_ID srcEntityID, MemoryStream& s)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	if (isDestroyed())
 	{
@@ -1021,6 +1028,19 @@ void Entity::onRemoteMethodCall_(PropertyDescription* pComponentPropertyDescript
 
 	EntityDef::context().currEntityID = srcEntityID;
 
+	// Arguments that are numbers, vectors or strings are unpacked onto the stack and the method is called directly
+	if (pMethodDescription->isFastCall())
+	{
+		if (!pMethodDescription->callFromStream(pyCallObject, &s))
+			s.done();
+
+		if (pyCallObject != static_cast<PyObject*>(this))
+			Py_DECREF(pyCallObject);
+
+		SCRIPT_ERROR_CHECK();
+		return;
+	}
+
 	PyObject* pyFunc = PyObject_GetAttrString(pyCallObject, const_cast<char*>
 						(pMethodDescription->getName()));
 
@@ -1251,7 +1271,7 @@ void Entity::writeToDB(void* data, void* extra1, void* extra2)
 //-------------------------------------------------------------------------------------
 void Entity::onWriteToDB()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	//DEBUG_MSG(fmt::format("{}::onWriteToDB(): {}.\n", 
 	//	this->scriptName(), this->id()));
@@ -1454,7 +1474,7 @@ void Entity::addWitnessed(Entity* entity)
 	if(Cellapp::getSingleton().pWitnessedTimeoutHandler())
 		Cellapp::getSingleton().pWitnessedTimeoutHandler()->delWitnessed(this);
 
-	witnesses_.push_back(entity->id());
+	_addWitness(entity);
 	++witnesses_count_;
 
 	/*
@@ -1478,7 +1498,7 @@ void Entity::addWitnessed(Entity* entity)
 
 	if(witnesses_count_ == 1)
 	{
-		SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+		SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 		bufferOrExeCallback(const_cast<char*>("onWitnessed"),
 			Py_BuildValue(const_cast<char*>("(O)"), PyBool_FromLong(1)));
@@ -1496,7 +1516,10 @@ void Entity::delWitnessed(Entity* entity)
 		return;
 	}
 
-	witnesses_.remove(entity->id());
+	// The entity may be released with its last reference
+	EntityPtr pEntity(entity);
+
+	_removeWitness(entity->id());
 	--witnesses_count_;
 
 	if (controlledBy_ != NULL && entity->id() == controlledBy_->id())
@@ -1506,7 +1529,7 @@ void Entity::delWitnessed(Entity* entity)
 		else
 			setControlledBy(NULL);
 
-		SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+		SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 		CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS1(pyTempObj, const_cast<char*>("onLoseControlledBy"),
 			const_cast<char*>("i"), entity->id(), GETERR));
 	}
@@ -1523,7 +1546,7 @@ void Entity::onDelWitnessed()
 {
 	if(witnesses_count_ == 0)
 	{
-		SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+		SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 		bufferOrExeCallback(const_cast<char*>("onWitnessed"),
 			Py_BuildValue(const_cast<char*>("(O)"), PyBool_FromLong(0)));
@@ -1533,14 +1556,35 @@ void Entity::onDelWitnessed()
 //-------------------------------------------------------------------------------------
 bool Entity::entityInWitnessed(ENTITY_ID entityID)
 {
-	std::list<ENTITY_ID>::iterator it = witnesses_.begin();
-	for (; it != witnesses_.end(); ++it)
+	return witnessIndexes_.find(entityID) != witnessIndexes_.end();
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::_addWitness(Entity* entity)
+{
+	if (!witnessIndexes_.insert(std::make_pair(entity->id(), witnesses_.size())).second)
+		return;
+
+	witnesses_.push_back(EntityPtr(entity));
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::_removeWitness(ENTITY_ID entityID)
+{
+	OUROUnordered_map<ENTITY_ID, size_t>::iterator iter = witnessIndexes_.find(entityID);
+	if (iter == witnessIndexes_.end())
+		return;
+
+	size_t index = iter->second;
+	witnessIndexes_.erase(iter);
+
+	if (index + 1 < witnesses_.size())
 	{
-		if (*it == entityID)
-			return true;
+		witnesses_[index] = witnesses_.back();
+		witnessIndexes_[witnesses_[index]->id()] = index;
 	}
 
-	return false;
+	witnesses_.pop_back();
 }
 
 //-------------------------------------------------------------------------------------
@@ -1751,7 +1795,7 @@ PyObject* Entity::__py_pyCancelController(PyObject* self, PyObject* args)
 //-------------------------------------------------------------------------------------
 void Entity::onEnterTrap(Entity* entity, float range_xz, float range_y, uint32 controllerID, int32 userarg)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onEnterTrap"), 
 		Py_BuildValue(const_cast<char*>("(OffIi)"), entity, range_xz, range_y, controllerID, userarg));
@@ -1760,7 +1804,7 @@ void Entity::onEnterTrap(Entity* entity, float range_xz, float range_y, uint32 c
 //-------------------------------------------------------------------------------------
 void Entity::onLeaveTrap(Entity* entity, float range_xz, float range_y, uint32 controllerID, int32 userarg)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onLeaveTrap"), 
 		Py_BuildValue(const_cast<char*>("(OffIi)"), entity, range_xz, range_y, controllerID, userarg));
@@ -1769,7 +1813,7 @@ void Entity::onLeaveTrap(Entity* entity, float range_xz, float range_y, uint32 c
 //-------------------------------------------------------------------------------------
 void Entity::onLeaveTrapID(ENTITY_ID entityID, float range_xz, float range_y, uint32 controllerID, int32 userarg)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onLeaveTrapID"), 
 		Py_BuildValue(const_cast<char*>("(kffIi)"), entityID, range_xz, range_y, controllerID, userarg));
@@ -1778,7 +1822,7 @@ void Entity::onLeaveTrapID(ENTITY_ID entityID, float range_xz, float range_y, ui
 //-------------------------------------------------------------------------------------
 void Entity::onEnteredView(Entity* entity)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onEnteredView"),
 		Py_BuildValue(const_cast<char*>("(O)"), entity));
@@ -1993,13 +2037,7 @@ void Entity::onPyPositionChanged()
 
 	onDefDataChanged(NULL, &positionDescription, pPyPosition_);
 
-	if (this->pEntityCoordinateNode())
-	{
-		Entity::bufferCallback(true);
-		this->pEntityCoordinateNode()->update();
-		Entity::bufferCallback(false);
-	}
-
+	_updateCoordinateNode();
 	updateLastPos();
 }
 
@@ -2011,14 +2049,26 @@ void Entity::onPositionChanged()
 
 	posChangedTime_ = g_ourotime;
 
-	if (this->pEntityCoordinateNode())
+	_updateCoordinateNode();
+	updateLastPos();
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::_updateCoordinateNode()
+{
+	EntityCoordinateNode* pNode = this->pEntityCoordinateNode();
+	if (!pNode)
+		return;
+
+	if (CoordinateSystem::deferredUpdates && pNode->pCoordinateSystem())
 	{
-		Entity::bufferCallback(true);
-		this->pEntityCoordinateNode()->update();
-		Entity::bufferCallback(false);
+		pNode->pCoordinateSystem()->addMovedNode(pNode);
+		return;
 	}
 
-	updateLastPos();
+	Entity::bufferCallback(true);
+	pNode->update();
+	Entity::bufferCallback(false);
 }
 
 //-------------------------------------------------------------------------------------
@@ -2173,7 +2223,7 @@ void Entity::onGetWitness(bool fromBase)
 	controlledBy(baseEntityCall());
 	
 	{
-		SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+		SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 		CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onGetWitness"), GETERR));
 	}
 
@@ -2211,7 +2261,7 @@ void Entity::onLoseWitness(Network::Channel* pChannel)
 	Witness::reclaimPoolObject(pWitness_);
 	pWitness_ = NULL;
 
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 	CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onLoseWitness"), GETERR));
 }
 
@@ -2469,11 +2519,10 @@ PyObject* Entity::pyGetWitnesses()
 {
 	std::vector<Entity*> entities;
 
-	std::list<ENTITY_ID>::iterator witer = witnesses_.begin();
-	for (; witer != witnesses_.end(); ++witer)
+	for (size_t i = 0; i < witnesses_.size(); ++i)
 	{
-		Entity* pEntity = Cellapp::getSingleton().findEntity((*witer));
-		if (pEntity == NULL || pEntity->pWitness() == NULL)
+		Entity* pEntity = witnesses_[i].get();
+		if (pEntity->pWitness() == NULL)
 			continue;
 
 		EntityCall* clientEntityCall = pEntity->clientEntityCall();
@@ -2938,7 +2987,7 @@ void Entity::onMove(uint32 controllerId, int layer, const Position3D& oldPos, Py
 	if(this->isDestroyed())
 		return;
 
-	SCOPED_PROFILE(ONMOVE_PROFILE);
+	SCOPED_PROFILE_ENTITY(ONMOVE_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onMove"),
 		Py_BuildValue(const_cast<char*>("(IO)"), controllerId, userarg));
@@ -2956,7 +3005,7 @@ void Entity::onMoveOver(uint32 controllerId, int layer, const Position3D& oldPos
 	pMoveController_->destroy();
 	pMoveController_.reset();
 
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onMoveOver"),
 		Py_BuildValue(const_cast<char*>("(IO)"), controllerId, userarg));
@@ -2974,7 +3023,7 @@ void Entity::onMoveFailure(uint32 controllerId, PyObject* userarg)
 	pMoveController_->destroy();
 	pMoveController_.reset();
 
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onMoveFailure"),
 		Py_BuildValue(const_cast<char*>("(IO)"), controllerId, userarg));
@@ -3090,7 +3139,7 @@ void Entity::onTurn(uint32 controllerId, PyObject* userarg)
 
 	pTurnController_.reset();
 
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onTurn"),
 		Py_BuildValue(const_cast<char*>("(IO)"), controllerId, userarg));
@@ -3670,11 +3719,10 @@ void Entity::teleportLocal(PyObject_ptr nearbyMBRef, Position3D& pos, Direction3
 
 	currspace->addEntityToNode(this);
 
-	std::list<ENTITY_ID>::iterator witer = witnesses_.begin();
-	for (; witer != witnesses_.end(); ++witer)
+	for (size_t i = 0; i < witnesses_.size(); ++i)
 	{
-		Entity* pEntity = Cellapp::getSingleton().findEntity((*witer));
-		if (pEntity == NULL || pEntity->pWitness() == NULL)
+		Entity* pEntity = witnesses_[i].get();
+		if (pEntity->pWitness() == NULL)
 			continue;
 
 		EntityCall* clientEntityCall = pEntity->clientEntityCall();
@@ -3778,7 +3826,7 @@ void Entity::teleport(PyObject_ptr nearbyMBRef, Position3D& pos, Direction3D& di
 void Entity::onTeleport()
 {
 	// This method is called only before the base.teleport jump, cell.teleport will not be called.
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onTeleport"), NULL);
 }
@@ -3789,7 +3837,7 @@ void Entity::onTeleportFailure()
 	ERROR_MSG(fmt::format("{}::onTeleportFailure(): entityID={}\n", 
 		this->scriptName(), id()));
 
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onTeleportFailure"), NULL);
 }
@@ -3806,7 +3854,7 @@ void Entity::onTeleportSuccess(PyObject* nearbyEntity, SPACE_ID lastSpaceID)
 	// If you have traps and other triggers, you have to add them back.
 	restoreProximitys();
 
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onTeleportSuccess"),
 		Py_BuildValue(const_cast<char*>("(O)"), nearbyEntity));
@@ -3815,7 +3863,7 @@ void Entity::onTeleportSuccess(PyObject* nearbyEntity, SPACE_ID lastSpaceID)
 //-------------------------------------------------------------------------------------
 void Entity::onEnterSpace(SpaceMemory* pSpace)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onEnterSpace"), NULL);
 }
@@ -3823,7 +3871,7 @@ void Entity::onEnterSpace(SpaceMemory* pSpace)
 //-------------------------------------------------------------------------------------
 void Entity::onLeaveSpace(SpaceMemory* pSpace)
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onLeaveSpace"), NULL);
 }
@@ -3831,7 +3879,7 @@ void Entity::onLeaveSpace(SpaceMemory* pSpace)
 //-------------------------------------------------------------------------------------
 void Entity::onEnteredCell()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onEnteredCell"), NULL);
 }
@@ -3839,7 +3887,7 @@ void Entity::onEnteredCell()
 //-------------------------------------------------------------------------------------
 void Entity::onEnteringCell()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onEnteringCell"), NULL);
 }
@@ -3847,7 +3895,7 @@ void Entity::onEnteringCell()
 //-------------------------------------------------------------------------------------
 void Entity::onLeavingCell()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onLeavingCell"), NULL);
 }
@@ -3855,7 +3903,7 @@ void Entity::onLeavingCell()
 //-------------------------------------------------------------------------------------
 void Entity::onLeftCell()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onLeftCell"), NULL);
 }
@@ -3863,7 +3911,7 @@ void Entity::onLeftCell()
 //-------------------------------------------------------------------------------------
 void Entity::onRestore()
 {
-	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+	SCOPED_PROFILE_ENTITY(SCRIPTCALL_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onRestore"), NULL);
 	removeFlags(ENTITY_FLAGS_INITING);
@@ -4157,10 +4205,10 @@ void Entity::addWitnessToStream(Ouroboros::MemoryStream& s)
 	uint32 size = witnesses_count_;
 	s << size;
 
-	std::list<ENTITY_ID>::iterator iter = witnesses_.begin();
+	WITNESSES::iterator iter = witnesses_.begin();
 	for(; iter != witnesses_.end(); ++iter)
 	{
-		s << (*iter);
+		s << (*iter)->id();
 	}
 
 	if(pWitness())
@@ -4186,7 +4234,7 @@ void Entity::createWitnessFromStream(Ouroboros::MemoryStream& s)
 			scriptName(), witnesses_.size(), witnesses_count_, id(), isReal()));
 
 		/*
-		std::list<ENTITY_ID>::iterator it = witnesses_.begin();
+		WITNESSES::iterator it = witnesses_.begin();
 		for (; it != witnesses_.end(); ++it)
 		{
 			Entity *ent = Cellapp::getSingleton().findEntity((*it));
@@ -4237,7 +4285,7 @@ void Entity::createWitnessFromStream(Ouroboros::MemoryStream& s)
 			if (pEntity == NULL || pEntity->spaceID() != spaceID())
 				continue;
 
-			witnesses_.push_back(entityID);
+			_addWitness(pEntity);
 			++witnesses_count_;
 		}
 	}
@@ -4317,7 +4365,7 @@ void Entity::createMovementHandlerFromStream(Ouroboros::MemoryStream& s)
 //-------------------------------------------------------------------------------------
 void Entity::onTimer(ScriptID timerID, int useraAgs)
 {
-	SCOPED_PROFILE(ONTIMER_PROFILE);
+	SCOPED_PROFILE_ENTITY(ONTIMER_PROFILE, id());
 
 	bufferOrExeCallback(const_cast<char*>("onTimer"),
 		Py_BuildValue(const_cast<char*>("(Ii)"), timerID, useraAgs));
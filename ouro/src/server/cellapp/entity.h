@@ -43,6 +43,10 @@ class Bundle;
 typedef SmartPointer<Entity> EntityPtr;
 typedef std::vector<EntityPtr> SPACE_ENTITIES;
 
+// The observers of an entity, an observer is kept alive while it is in the vector(a restored ghost observer may be
+// destroyed without leaving), removed by swapping with the last one(Entity::witnessIndexes_)
+typedef std::vector<EntityPtr> WITNESSES;
+
 class Entity : public script::ScriptObject
 {
 		/** Subclassing populates some py operations into derived classes*/
@@ -393,7 +397,7 @@ public:
 	*/
 	bool entityInWitnessed(ENTITY_ID entityID);
 
-	INLINE const std::list<ENTITY_ID>&	witnesses();
+	INLINE const WITNESSES& witnesses();
 	INLINE size_t witnessesSize() const;
 
 		/** Network Interface
@@ -593,6 +597,18 @@ private:
 	void _sendBaseTeleportResult(ENTITY_ID sourceEntityID, COMPONENT_ID sourceBaseAppID, 
 		SPACE_ID spaceID, SPACE_ID lastSpaceID, bool fromCellTeleport);
 
+	/**
+		Repositions the coordinate node after the position changed, or marks it as moved with
+		CoordinateSystem::deferredUpdates
+	*/
+	void _updateCoordinateNode();
+
+	/**
+		Add or swap-remove an observer in witnesses_
+	*/
+	void _addWitness(Entity* entity);
+	void _removeWitness(ENTITY_ID entityID);
+
 private:
 	struct BufferedScriptCall
 	{
@@ -655,9 +671,12 @@ protected:
 	SPACE_ENTITIES::size_type								spaceEntityIdx_;
 
 	// Is it monitored by any observer?
-	std::list<ENTITY_ID>									witnesses_;
+	WITNESSES												witnesses_;
 	size_t													witnesses_count_;
 
+	// Index of an observer in witnesses_
+	OUROUnordered_map<ENTITY_ID, size_t>					witnessIndexes_;
+
 	// Observer object
 	Witness*												pWitness_;
 
@@ -16,7 +16,7 @@ INLINE bool Entity::hasWitness(void) const
 }
 
 //-------------------------------------------------------------------------------------
-INLINE const std::list<ENTITY_ID>&	Entity::witnesses()
+INLINE const WITNESSES& Entity::witnesses()
 {
 	return witnesses_;
 }
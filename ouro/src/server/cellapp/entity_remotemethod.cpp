@@ -114,7 +114,9 @@ PyObject* EntityRemoteMethod::tp_call(PyObject* self, PyObject* args,
 		}
 
 		// Record the amount of data generated by this event
-		g_privateClientEventHistoryStats.trackEvent(pEntity->scriptName(), 
+		g_privateClientEventHistoryStats.trackEvent(pEntity->pScriptModule()->getUType(), 
+			methodDescription->eventID(), 
+			pEntity->scriptName(), 
 			methodDescription->getName(), 
 			pBundle->currMsgLength(), 
 			"::");
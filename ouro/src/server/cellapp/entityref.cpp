@@ -9,7 +9,7 @@ namespace Ouroboros{
 //-------------------------------------------------------------------------------------
 EntityRef::EntityRef(Entity* pEntity):
 id_(0),
-aliasID_(0),
+aliasID_(-1),
 pEntity_(pEntity),
 flags_(ENTITYREF_FLAG_UNKONWN)
 {
@@ -19,7 +19,7 @@ flags_(ENTITYREF_FLAG_UNKONWN)
 //-------------------------------------------------------------------------------------
 EntityRef::EntityRef():
 id_(0),
-aliasID_(0),
+aliasID_(-1),
 pEntity_(NULL),
 flags_(ENTITYREF_FLAG_UNKONWN)
 {
@@ -68,7 +68,7 @@ EntityRef::SmartPoolObjectPtr EntityRef::createSmartPoolObj(const std::string& l
 void EntityRef::onReclaimObject()
 {
 	id_ = 0;
-	aliasID_ =  0;
+	aliasID_ = -1;
 	pEntity_ = NULL;
 	flags_ = ENTITYREF_FLAG_UNKONWN;
 }
@@ -52,6 +52,7 @@ public:
 
 	ENTITY_ID id() const { return id_; }
 
+	// The slot of the entity on the client, -1 until the client has the entity(see Witness::allocAliasID_)
 	int aliasID() const { return aliasID_; }
 	void aliasID(int id) { aliasID_ = id; }
 
@@ -0,0 +1,315 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "cellapp.h"
+#include "entity.h"
+#include "move_batch.h"
+#include "moveto_point_handler.h"
+#include "helper/profile.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OURO_MOVEBATCH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Ouroboros{
+
+//-------------------------------------------------------------------------------------
+MoveBatch::MoveBatch():
+handlers_(),
+posX_(), posY_(), posZ_(),
+dstX_(), dstY_(), dstZ_(),
+velocity_(),
+distance_(),
+vertical_(),
+newX_(), newY_(), newZ_(),
+moveX_(), moveY_(), moveZ_(),
+arrived_(),
+removed_(),
+registered_(false)
+{
+	updatableName = "MoveBatch";
+}
+
+//-------------------------------------------------------------------------------------
+MoveBatch::~MoveBatch()
+{
+	clear();
+}
+
+//-------------------------------------------------------------------------------------
+void MoveBatch::clear()
+{
+	std::vector<MoveToPointHandler*>::iterator iter = handlers_.begin();
+	for (; iter != handlers_.end(); ++iter)
+		delete (*iter);
+
+	handlers_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void MoveBatch::add(MoveToPointHandler* pHandler)
+{
+	handlers_.push_back(pHandler);
+
+	if (!registered_)
+	{
+		registered_ = true;
+		Cellapp::getSingleton().addUpdatable(this);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void MoveBatch::resize_(size_t size)
+{
+	posX_.resize(size); posY_.resize(size); posZ_.resize(size);
+	dstX_.resize(size); dstY_.resize(size); dstZ_.resize(size);
+	velocity_.resize(size);
+	distance_.resize(size);
+	vertical_.resize(size);
+	newX_.resize(size); newY_.resize(size); newZ_.resize(size);
+	moveX_.resize(size); moveY_.resize(size); moveZ_.resize(size);
+	arrived_.resize(size);
+}
+
+//-------------------------------------------------------------------------------------
+bool MoveBatch::update()
+{
+	if (handlers_.empty())
+		return true;
+
+	AUTO_SCOPED_PROFILE("moveBatch");
+
+	// The movers added by the callbacks of this tick are moved from the next tick on
+	const size_t count = handlers_.size();
+	const size_t size = (count + 3) & ~size_t(3);
+
+	resize_(size);
+	removed_.assign(count, MOVER_MOVING);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		MoveToPointHandler* pHandler = handlers_[i];
+		Entity* pEntity = NULL;
+
+		if (!pHandler->checkMove())
+			removed_[i] = MOVER_REMOVED;
+		else if ((pEntity = pHandler->pEntity()) == NULL)
+			removed_[i] = MOVER_SKIPPED;
+
+		if (removed_[i] != MOVER_MOVING)
+		{
+			velocity_[i] = distance_[i] = vertical_[i] = 0.f;
+			posX_[i] = posY_[i] = posZ_[i] = dstX_[i] = dstY_[i] = dstZ_[i] = 0.f;
+			continue;
+		}
+
+		const Position3D& pos = pEntity->position();
+		const Position3D& dstPos = pHandler->destPos();
+
+		posX_[i] = pos.x; posY_[i] = pos.y; posZ_[i] = pos.z;
+		dstX_[i] = dstPos.x; dstY_[i] = dstPos.y; dstZ_[i] = dstPos.z;
+		velocity_[i] = pHandler->velocity();
+		distance_[i] = pHandler->distance();
+		vertical_[i] = pHandler->moveVertically() ? 1.f : 0.f;
+	}
+
+	for (size_t i = count; i < size; ++i)
+	{
+		velocity_[i] = distance_[i] = vertical_[i] = 0.f;
+		posX_[i] = posY_[i] = posZ_[i] = dstX_[i] = dstY_[i] = dstZ_[i] = 0.f;
+	}
+
+	step_(size);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (removed_[i] != MOVER_MOVING)
+			continue;
+
+		MoveToPointHandler* pHandler = handlers_[i];
+
+		// Stopped by the callbacks of the movers before it
+		if (pHandler->isDestroyed())
+		{
+			removed_[i] = MOVER_REMOVED;
+			continue;
+		}
+
+		if (!pHandler->onStep(Position3D(posX_[i], posY_[i], posZ_[i]), Position3D(newX_[i], newY_[i], newZ_[i]),
+			Vector3(moveX_[i], moveY_[i], moveZ_[i]), arrived_[i] != 0))
+		{
+			removed_[i] = MOVER_REMOVED;
+		}
+	}
+
+	compact_();
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void MoveBatch::step_(size_t size)
+{
+	/*
+		For each mover:
+			movement = dstPos - pos, the y is 0 if not moveVertically
+			if |movement| < velocity + distance, it arrives:
+				distance > 0: stops at distance from dstPos, or stays if it is already in range
+				distance <= 0: moves to dstPos
+			else moves velocity along movement
+
+		The movement returned is the one the facing is taken from.
+	*/
+#ifdef OURO_MOVEBATCH_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+
+	for (size_t i = 0; i < size; i += 4)
+	{
+		const __m128 px = _mm_loadu_ps(&posX_[i]);
+		const __m128 py = _mm_loadu_ps(&posY_[i]);
+		const __m128 pz = _mm_loadu_ps(&posZ_[i]);
+		const __m128 tx = _mm_loadu_ps(&dstX_[i]);
+		const __m128 ty = _mm_loadu_ps(&dstY_[i]);
+		const __m128 tz = _mm_loadu_ps(&dstZ_[i]);
+		const __m128 v = _mm_loadu_ps(&velocity_[i]);
+		const __m128 d = _mm_loadu_ps(&distance_[i]);
+		const __m128 vertical = _mm_cmpneq_ps(_mm_loadu_ps(&vertical_[i]), zero);
+
+		const __m128 dx = _mm_sub_ps(tx, px);
+		const __m128 dy = _mm_and_ps(_mm_sub_ps(ty, py), vertical);
+		const __m128 dz = _mm_sub_ps(tz, pz);
+
+		const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+		const __m128 inv = _mm_and_ps(_mm_div_ps(one, len), _mm_cmpgt_ps(len, zero));
+
+		const __m128 arrived = _mm_cmplt_ps(len, _mm_add_ps(v, d));
+		const __m128 hasDistance = _mm_cmpgt_ps(d, zero);
+		const __m128 outOfDistance = _mm_and_ps(hasDistance, _mm_cmpgt_ps(len, d));
+
+		// Not arrived: pos + movement * (velocity / |movement|)
+		const __m128 walkScale = _mm_mul_ps(v, inv);
+		__m128 nx = _mm_add_ps(px, _mm_mul_ps(dx, walkScale));
+		__m128 ny = _mm_add_ps(py, _mm_mul_ps(dy, walkScale));
+		__m128 nz = _mm_add_ps(pz, _mm_mul_ps(dz, walkScale));
+
+		// Arrived out of distance: dstPos - movement * (distance / |movement|)
+		const __m128 stopScale = _mm_mul_ps(d, inv);
+		const __m128 sx = _mm_sub_ps(tx, _mm_mul_ps(dx, stopScale));
+		const __m128 sy = _mm_sub_ps(ty, _mm_mul_ps(dy, stopScale));
+		const __m128 sz = _mm_sub_ps(tz, _mm_mul_ps(dz, stopScale));
+
+		// Arrived: distance > 0 ? (out of distance ? stop : pos) : dstPos
+		const __m128 ax = _mm_or_ps(_mm_and_ps(hasDistance, _mm_or_ps(_mm_and_ps(outOfDistance, sx), _mm_andnot_ps(outOfDistance, px))), _mm_andnot_ps(hasDistance, tx));
+		const __m128 ay = _mm_or_ps(_mm_and_ps(hasDistance, _mm_or_ps(_mm_and_ps(outOfDistance, sy), _mm_andnot_ps(outOfDistance, py))), _mm_andnot_ps(hasDistance, ty));
+		const __m128 az = _mm_or_ps(_mm_and_ps(hasDistance, _mm_or_ps(_mm_and_ps(outOfDistance, sz), _mm_andnot_ps(outOfDistance, pz))), _mm_andnot_ps(hasDistance, tz));
+
+		nx = _mm_or_ps(_mm_and_ps(arrived, ax), _mm_andnot_ps(arrived, nx));
+		ny = _mm_or_ps(_mm_and_ps(arrived, ay), _mm_andnot_ps(arrived, ny));
+		nz = _mm_or_ps(_mm_and_ps(arrived, az), _mm_andnot_ps(arrived, nz));
+
+		// The y is kept if not moveVertically
+		ny = _mm_or_ps(_mm_and_ps(vertical, ny), _mm_andnot_ps(vertical, py));
+
+		// Scale of the movement: arrived ? (distance > 0 ? (out of distance ? distance : 1) / |movement| : 1) : velocity / |movement|
+		const __m128 arriveScale = _mm_or_ps(_mm_and_ps(hasDistance, _mm_or_ps(_mm_and_ps(outOfDistance, stopScale), _mm_andnot_ps(outOfDistance, inv))),
+			_mm_andnot_ps(hasDistance, one));
+
+		const __m128 moveScale = _mm_or_ps(_mm_and_ps(arrived, arriveScale), _mm_andnot_ps(arrived, walkScale));
+
+		_mm_storeu_ps(&newX_[i], nx);
+		_mm_storeu_ps(&newY_[i], ny);
+		_mm_storeu_ps(&newZ_[i], nz);
+		_mm_storeu_ps(&moveX_[i], _mm_mul_ps(dx, moveScale));
+		_mm_storeu_ps(&moveY_[i], _mm_mul_ps(dy, moveScale));
+		_mm_storeu_ps(&moveZ_[i], _mm_mul_ps(dz, moveScale));
+
+		const int mask = _mm_movemask_ps(arrived);
+		arrived_[i] = uint8(mask & 1);
+		arrived_[i + 1] = uint8((mask >> 1) & 1);
+		arrived_[i + 2] = uint8((mask >> 2) & 1);
+		arrived_[i + 3] = uint8((mask >> 3) & 1);
+	}
+#else
+	for (size_t i = 0; i < size; ++i)
+	{
+		const float dx = dstX_[i] - posX_[i];
+		const float dy = vertical_[i] != 0.f ? dstY_[i] - posY_[i] : 0.f;
+		const float dz = dstZ_[i] - posZ_[i];
+
+		const float len = sqrtf(dx * dx + dy * dy + dz * dz);
+		const float inv = len > 0.f ? 1.f / len : 0.f;
+		const float v = velocity_[i];
+		const float d = distance_[i];
+
+		float scale = v * inv;
+		float nx = posX_[i] + dx * scale;
+		float ny = posY_[i] + dy * scale;
+		float nz = posZ_[i] + dz * scale;
+
+		const bool arrived = len < v + d;
+		if (arrived)
+		{
+			if (d > 0.f)
+			{
+				if (len > d)
+				{
+					scale = d * inv;
+					nx = dstX_[i] - dx * scale;
+					ny = dstY_[i] - dy * scale;
+					nz = dstZ_[i] - dz * scale;
+				}
+				else
+				{
+					scale = inv;
+					nx = posX_[i];
+					ny = posY_[i];
+					nz = posZ_[i];
+				}
+			}
+			else
+			{
+				scale = 1.f;
+				nx = dstX_[i];
+				ny = dstY_[i];
+				nz = dstZ_[i];
+			}
+		}
+
+		if (vertical_[i] == 0.f)
+			ny = posY_[i];
+
+		newX_[i] = nx;
+		newY_[i] = ny;
+		newZ_[i] = nz;
+		moveX_[i] = dx * scale;
+		moveY_[i] = dy * scale;
+		moveZ_[i] = dz * scale;
+		arrived_[i] = arrived ? 1 : 0;
+	}
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+void MoveBatch::compact_()
+{
+	size_t count = removed_.size();
+	size_t n = 0;
+
+	for (size_t i = 0; i < handlers_.size(); ++i)
+	{
+		MoveToPointHandler* pHandler = handlers_[i];
+
+		if ((i < count && removed_[i] == MOVER_REMOVED) || pHandler->isDestroyed())
+		{
+			delete pHandler;
+			continue;
+		}
+
+		handlers_[n++] = pHandler;
+	}
+
+	handlers_.resize(n);
+}
+
+//-------------------------------------------------------------------------------------
+}
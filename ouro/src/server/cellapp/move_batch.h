@@ -0,0 +1,79 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_MOVEBATCH_H
+#define OURO_MOVEBATCH_H
+
+#include "updatable.h"
+#include "math/math.h"
+
+namespace Ouroboros{
+
+class MoveToPointHandler;
+
+/*
+	Advances all the MoveToPointHandlers(moveToPoint, moveToEntity, navigate) of the app in one Updatable.
+
+	Every tick the positions and targets of the movers are gathered into arrays(structure of arrays),
+	the step of all of them is computed by one kernel(4 movers per SSE instruction), then the results
+	are written back to the entities in the order the movers were added.
+*/
+class MoveBatch : public Updatable
+{
+public:
+	MoveBatch();
+	virtual ~MoveBatch();
+
+	void add(MoveToPointHandler* pHandler);
+
+	virtual bool update();
+
+	/**
+		Deletes all the movers, called when the app is finalised
+	*/
+	void clear();
+
+	size_t size() const { return handlers_.size(); }
+
+private:
+	enum MoverState
+	{
+		MOVER_MOVING = 0,
+		MOVER_REMOVED = 1,		// done, deleted at the end of the tick
+		MOVER_SKIPPED = 2		// not bound to an entity, does not move in this tick
+	};
+
+	void resize_(size_t size);
+
+	/**
+		Computes the step of the movers [0, size), size is padded to a multiple of 4
+	*/
+	void step_(size_t size);
+
+	/**
+		Deletes the movers that are done, the others keep their order
+	*/
+	void compact_();
+
+private:
+	std::vector<MoveToPointHandler*> handlers_;
+
+	// Input
+	std::vector<float> posX_, posY_, posZ_;
+	std::vector<float> dstX_, dstY_, dstZ_;
+	std::vector<float> velocity_;
+	std::vector<float> distance_;
+	std::vector<float> vertical_;	// 1.f if moveVertically, 0.f if the y is kept
+
+	// Output
+	std::vector<float> newX_, newY_, newZ_;
+	std::vector<float> moveX_, moveY_, moveZ_;
+	std::vector<uint8> arrived_;
+
+	// MoverState of the movers in this tick
+	std::vector<uint8> removed_;
+
+	bool registered_;
+};
+
+}
+#endif // OURO_MOVEBATCH_H
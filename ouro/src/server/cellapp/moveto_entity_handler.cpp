@@ -14,7 +14,6 @@ MoveToPointHandler(pController, pController->pEntity()->layer(), pController->pE
 pTargetID_(pTargetID), 
 offsetPos_(offsetPos)
 {
-	updatableName = "MoveToEntityHandler";
 }
 
 //-------------------------------------------------------------------------------------
@@ -22,7 +21,6 @@ MoveToEntityHandler::MoveToEntityHandler():
 MoveToPointHandler(),
 pTargetID_(0)
 {
-	updatableName = "MoveToEntityHandler";
 }
 
 //-------------------------------------------------------------------------------------
@@ -53,13 +51,10 @@ const Position3D& MoveToEntityHandler::destPos()
 }
 
 //-------------------------------------------------------------------------------------
-bool MoveToEntityHandler::update()
+bool MoveToEntityHandler::checkMove()
 {
 	if (isDestroyed_)
-	{
-		delete this;
 		return false;
-	}
 
 	Entity* pEntity = Cellapp::getSingleton().findEntity(pTargetID_);
 	if(pEntity == NULL)
@@ -73,7 +68,7 @@ bool MoveToEntityHandler::update()
 		pController_.reset();
 	}
 
-	return MoveToPointHandler::update();
+	return MoveToPointHandler::checkMove();
 }
 
 //-------------------------------------------------------------------------------------
@@ -20,7 +20,7 @@ public:
 	void addToStream(Ouroboros::MemoryStream& s);
 	void createFromStream(Ouroboros::MemoryStream& s);
 
-	virtual bool update();
+	virtual bool checkMove();
 
 	virtual const Position3D& destPos();
 
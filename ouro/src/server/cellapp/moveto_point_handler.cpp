@@ -20,15 +20,14 @@ pyuserarg_(userarg),
 distance_(distance),
 pController_(pController),
 layer_(layer),
-isDestroyed_(false)
+isDestroyed_(false),
+hasOnMove_(-1)
 {
-	updatableName = "MoveToPointHandler";
-
 	Py_INCREF(userarg);
 
 	//std::static_pointer_cast<MoveController>(pController)->pMoveToPointHandler(this);
 	static_cast<MoveController*>(pController.get())->pMoveToPointHandler(this);
-	Cellapp::getSingleton().addUpdatable(this);
+	Cellapp::getSingleton().moveBatch().add(this);
 }
 
 //-------------------------------------------------------------------------------------
@@ -40,11 +39,10 @@ moveVertically_(false),
 pyuserarg_(NULL),
 distance_(0.f),
 layer_(0),
-isDestroyed_(false)
+isDestroyed_(false),
+hasOnMove_(-1)
 {
-	updatableName = "MoveToPointHandler";
-
-	Cellapp::getSingleton().addUpdatable(this);
+	Cellapp::getSingleton().moveBatch().add(this);
 }
 
 //-------------------------------------------------------------------------------------
@@ -97,63 +95,28 @@ bool MoveToPointHandler::requestMoveOver(const Position3D& oldPos)
 }
 
 //-------------------------------------------------------------------------------------
-bool MoveToPointHandler::update()
+Entity* MoveToPointHandler::pEntity() const
+{
+	if (!pController_)
+		return NULL;
+
+	return pController_->pEntity();
+}
+
+//-------------------------------------------------------------------------------------
+bool MoveToPointHandler::checkMove()
+{
+	return !isDestroyed_;
+}
+
+//-------------------------------------------------------------------------------------
+bool MoveToPointHandler::onStep(const Position3D& oldPos, const Position3D& newPos, const Vector3& movement, bool arrived)
 {
-	if (isDestroyed_)
-	{
-		delete this;
-		return false;
-	}
-	
 	Entity* pEntity = pController_->pEntity();
 	Py_INCREF(pEntity);
 
-	const Position3D& dstPos = destPos();
-	Position3D currpos = pEntity->position();
-	Position3D currpos_backup = currpos;
 	Direction3D direction = pEntity->direction();
 
-	Vector3 movement = dstPos - currpos;
-	if (!moveVertically_) movement.y = 0.f;
-	
-	bool ret = true;
-	float dist_len = OUROVec3Length(&movement);
-
-	if (dist_len < velocity_ + distance_)
-	{
-		float y = currpos.y;
-
-		if (distance_ > 0.0f)
-		{
-			// unitized vector
-			OUROVec3Normalize(&movement, &movement); 
-				
-			if(dist_len > distance_)
-			{
-				movement *= distance_;
-				currpos = dstPos - movement;
-			}
-		}
-		else
-		{
-			currpos = dstPos;
-		}
-
-		if (!moveVertically_)
-			currpos.y = y;
-
-		ret = false;
-	}
-	else
-	{
-		// unitized vector
-		OUROVec3Normalize(&movement, &movement); 
-
-				// move Place
-		movement *= velocity_;
-		currpos += movement;
-	}
-	
 	// Do you need to change your orientation?
 	if (faceMovement_)
 	{
@@ -166,22 +129,28 @@ bool MoveToPointHandler::update()
 	
 	// Set the new location and orientation of the entity
 	if(!isDestroyed_)
-		pEntity->setPositionAndDirection(currpos, direction);
+		pEntity->setPositionAndDirection(newPos, direction);
 
 	// non-navigate can't be sure it's on the ground
 	if(!isDestroyed_)
 		pEntity->isOnGround(isOnGround());
 
+	// Only entities that have onMove are called every step
+	if (hasOnMove_ < 0)
+	{
+		hasOnMove_ = PyObject_HasAttrString(pEntity, "onMove") ? 1 : 0;
+		PyErr_Clear();
+	}
+
 	// notification script
-	if(!isDestroyed_)
-		pEntity->onMove(pController_->id(), layer_, currpos_backup, pyuserarg_);
+	if(!isDestroyed_ && hasOnMove_ > 0)
+		pEntity->onMove(pController_->id(), layer_, oldPos, pyuserarg_);
 
 	// If it is stopped during the onMove process, or if it reaches its destination, it will be destroyed directly and will return false.
 	if (isDestroyed_ || 
-		(!ret && requestMoveOver(currpos_backup)))
+		(arrived && requestMoveOver(oldPos)))
 	{
 		Py_DECREF(pEntity);
-		delete this;
 		return false;
 	}
 
@@ -191,4 +160,3 @@ bool MoveToPointHandler::update()
 
 //-------------------------------------------------------------------------------------
 }
-
@@ -4,13 +4,18 @@
 #define OURO_MOVETOPOINTHANDLER_H
 
 #include "controller.h"
-#include "updatable.h"
 #include "pyscript/scriptobject.h"	
 #include "math/math.h"
 
 namespace Ouroboros{
 
-class MoveToPointHandler : public Updatable
+class Entity;
+
+/*
+	The steps of all the handlers are computed together by the MoveBatch of the Cellapp,
+	a handler only applies its step to the entity and calls the scripts.
+*/
+class MoveToPointHandler
 {
 public:
 	enum MoveType
@@ -29,7 +34,15 @@ public:
 	MoveToPointHandler();
 	virtual ~MoveToPointHandler();
 	
-	virtual bool update();
+	/**
+		Called before the step is computed, returns false if the handler is done
+	*/
+	virtual bool checkMove();
+
+	/**
+		Applies the step computed by the MoveBatch, returns false if the handler is done
+	*/
+	bool onStep(const Position3D& oldPos, const Position3D& newPos, const Vector3& movement, bool arrived);
 
 	virtual const Position3D& destPos() { return destPos_; }
 	virtual bool requestMoveOver(const Position3D& oldPos);
@@ -39,6 +52,9 @@ public:
 	virtual MoveType type() const { return MOVE_TYPE_POINT; }
 
 	void destroy() { isDestroyed_ = true; }
+	bool isDestroyed() const { return isDestroyed_; }
+
+	Entity* pEntity() const;
 
 	float velocity() const {
 		return velocity_;
@@ -48,6 +64,14 @@ public:
 		velocity_ = v;
 	}
 
+	float distance() const {
+		return distance_;
+	}
+
+	bool moveVertically() const {
+		return moveVertically_;
+	}
+
 protected:
 	Position3D destPos_;
 	float velocity_; // speed
@@ -58,6 +82,9 @@ protected:
 	OUROShared_ptr<Controller> pController_;
 	int layer_;
 	bool isDestroyed_;
+
+	// Whether the entity has onMove, -1 if not looked up yet
+	int8 hasOnMove_;
 };
  
 }
@@ -19,8 +19,7 @@ paths_(paths_ptr),
 maxMoveDistance_(maxMoveDistance)
 {
 	destPos_ = (*paths_)[destPosIdx_++];
-	
-	updatableName = "NavigateHandler";
+
 }
 
 //-------------------------------------------------------------------------------------
@@ -30,7 +29,6 @@ destPosIdx_(0),
 paths_(),
 maxMoveDistance_(0.f)
 {
-	updatableName = "NavigateHandler";
 }
 
 //-------------------------------------------------------------------------------------
@@ -0,0 +1,818 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "cellapp.h"
+#include "space_migration.h"
+#include "spacememory.h"
+#include "spacememorys.h"
+#include "witness.h"
+#include "network/bundle.h"
+#include "network/channel.h"
+#include "server/components.h"
+#include "entitydef/entitydef.h"
+
+#include "../../server/baseapp/baseapp_interface.h"
+#include "../../server/cellapp/cellapp_interface.h"
+#include "../../server/cellappmgr/cellappmgr_interface.h"
+
+namespace Ouroboros{
+
+//-------------------------------------------------------------------------------------
+SpaceMigration::SpaceMigration():
+outgoing_(),
+incoming_(),
+numMigratedOut_(0),
+numMigratedIn_(0),
+numFailed_(0),
+lastFreezeTime_(0.f)
+{
+}
+
+//-------------------------------------------------------------------------------------
+SpaceMigration::~SpaceMigration()
+{
+}
+
+//-------------------------------------------------------------------------------------
+bool SpaceMigration::isMigrating(SPACE_ID spaceID) const
+{
+	return outgoing_.find(spaceID) != outgoing_.end() || incoming_.find(spaceID) != incoming_.end();
+}
+
+//-------------------------------------------------------------------------------------
+bool SpaceMigration::migrate(SPACE_ID spaceID, COMPONENT_ID targetCid)
+{
+	if (spaceID == 0)
+		spaceID = chooseSpace_();
+
+	SpaceMemory* pSpace = SpaceMemorys::findSpace(spaceID);
+
+	std::string reason;
+	if (targetCid == g_componentID)
+		reason = "target is this cellapp";
+	else if (isMigrating(spaceID))
+		reason = "already migrating";
+	else
+		canMigrate_(pSpace, reason);
+
+	if (reason.size() > 0)
+	{
+		WARNING_MSG(fmt::format("SpaceMigration::migrate: space({}) can not be migrated to cellapp({}), {}.\n",
+			spaceID, targetCid, reason));
+
+		Network::Channel* pChannel = Components::getSingleton().getCellappmgrChannel();
+		if (pChannel)
+		{
+			Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+			(*pBundle).newMessage(CellappmgrInterface::onSpaceMigrated);
+			(*pBundle) << spaceID << g_componentID << targetCid << false << (uint32)0 << 0.f;
+			pChannel->send(pBundle);
+		}
+
+		return false;
+	}
+
+	OUTGOING& outgoing = outgoing_[spaceID];
+	outgoing.targetCid = targetCid;
+	outgoing.startTime = timestamp();
+	outgoing.freezeTime = 0;
+	outgoing.abortTime = 0;
+	outgoing.committed = false;
+	outgoing.datas = pSpace->datas();
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(CellappInterface::onMigrateSpaceSnapshot);
+	(*pBundle) << spaceID << g_componentID;
+	(*pBundle) << pSpace->scriptModuleName();
+
+	MemoryStream* s = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+	pSpace->addToMigrationStream(*s);
+	(*pBundle).append(*s);
+	MemoryStream::reclaimPoolObject(s);
+
+	if (!sendToCellapp_(targetCid, pBundle))
+	{
+		finish_(spaceID, outgoing, false, "target not found");
+		outgoing_.erase(spaceID);
+		return false;
+	}
+
+	INFO_MSG(fmt::format("SpaceMigration::migrate: space({}) with {} entities to cellapp({}).\n",
+		spaceID, pSpace->entities().size(), targetCid));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+SPACE_ID SpaceMigration::chooseSpace_()
+{
+	SpaceMemorys::SPACEMEMORYS& spaces = SpaceMemorys::spaces();
+
+	size_t numEntities = 0;
+
+	SpaceMemorys::SPACEMEMORYS::iterator iter = spaces.begin();
+	for (; iter != spaces.end(); ++iter)
+		numEntities += iter->second->entities().size();
+
+	// The largest space that holds at most half of the entities, moving more would only turn the imbalance around
+	SPACE_ID spaceID = 0;
+	size_t best = 0;
+
+	std::string reason;
+
+	for (iter = spaces.begin(); iter != spaces.end(); ++iter)
+	{
+		SpaceMemory* pSpace = iter->second.get();
+		size_t size = pSpace->entities().size();
+
+		if (size <= best || size * 2 > numEntities || isMigrating(pSpace->id()))
+			continue;
+
+		if (!canMigrate_(pSpace, reason))
+			continue;
+
+		spaceID = pSpace->id();
+		best = size;
+	}
+
+	return spaceID;
+}
+
+//-------------------------------------------------------------------------------------
+bool SpaceMigration::canMigrate_(SpaceMemory* pSpace, std::string& reason)
+{
+	if (pSpace == NULL || !pSpace->isGood() || pSpace->isMigratingIn())
+	{
+		reason = "space not found";
+		return false;
+	}
+
+	const SPACE_ENTITIES& entities = pSpace->entities();
+	uint32 maxEntities = g_ouroSrvConfig.getCellAppMgr().spaceMigration.maxEntities;
+
+	if (entities.size() == 0)
+	{
+		reason = "space is empty";
+		return false;
+	}
+
+	if (maxEntities > 0 && entities.size() > maxEntities)
+	{
+		reason = fmt::format("{} entities, maxEntities is {}", entities.size(), maxEntities);
+		return false;
+	}
+
+	// The obstacles are not part of the snapshot, the target would load the navmesh without them
+	if (pSpace->pNavHandle() && pSpace->pNavHandle()->numObstacles() > 0)
+	{
+		reason = "has dynamic navmesh obstacles";
+		return false;
+	}
+
+	SPACE_ENTITIES::const_iterator iter = entities.begin();
+	for (; iter != entities.end(); ++iter)
+	{
+		Entity* pEntity = (*iter).get();
+
+		if (!pEntity->isReal() || pEntity->isDestroyed())
+		{
+			reason = fmt::format("entity({}) is a ghost or destroyed", pEntity->id());
+			return false;
+		}
+
+		// A teleport between cellapps is not finished yet
+		if (pEntity->hasFlags(ENTITY_FLAGS_TELEPORT_START))
+		{
+			reason = fmt::format("entity({}) is teleporting", pEntity->id());
+			return false;
+		}
+
+		if (pEntity->baseEntityCall() && pEntity->baseEntityCall()->getChannel() == NULL)
+		{
+			reason = fmt::format("baseapp of entity({}) not found", pEntity->id());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::onSnapshot(Network::Channel* pChannel, MemoryStream& s)
+{
+	SPACE_ID spaceID;
+	COMPONENT_ID sourceCid;
+	std::string scriptModuleName;
+
+	s >> spaceID >> sourceCid >> scriptModuleName;
+
+	SpaceMemory* pSpace = SpaceMemorys::createNewSpace(spaceID, scriptModuleName);
+	if (pSpace == NULL)
+	{
+		ERROR_MSG(fmt::format("SpaceMigration::onSnapshot: space({}) from cellapp({}) already exists!\n",
+			spaceID, sourceCid));
+
+		s.done();
+		sendSnapshotCB_(pChannel, spaceID, false);
+		return;
+	}
+
+	INCOMING& incoming = incoming_[spaceID];
+	incoming.sourceCid = sourceCid;
+	incoming.startTime = timestamp();
+	incoming.loaded = false;
+
+	if (pSpace->createFromMigrationStream(s))
+		return;
+
+	onSpaceLoaded(pSpace);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::onSpaceLoaded(SpaceMemory* pSpace)
+{
+	std::map<SPACE_ID, INCOMING>::iterator iter = incoming_.find(pSpace->id());
+	if (iter == incoming_.end())
+		return;
+
+	iter->second.loaded = true;
+
+	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(CELLAPP_TYPE, iter->second.sourceCid);
+	if (cinfos == NULL || cinfos->pChannel == NULL)
+	{
+		ERROR_MSG(fmt::format("SpaceMigration::onSpaceLoaded: source cellapp({}) of space({}) not found!\n",
+			iter->second.sourceCid, pSpace->id()));
+
+		return;
+	}
+
+	sendSnapshotCB_(cinfos->pChannel, pSpace->id(), true);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::onSnapshotCB(Network::Channel* pChannel, MemoryStream& s)
+{
+	SPACE_ID spaceID;
+	COMPONENT_ID targetCid;
+	bool success;
+
+	s >> spaceID >> targetCid >> success;
+
+	std::map<SPACE_ID, OUTGOING>::iterator iter = outgoing_.find(spaceID);
+	if (iter == outgoing_.end() || iter->second.committed || iter->second.targetCid != targetCid)
+	{
+		WARNING_MSG(fmt::format("SpaceMigration::onSnapshotCB: space({}) is not migrating to cellapp({})!\n",
+			spaceID, targetCid));
+
+		return;
+	}
+
+	if (!success)
+	{
+		finish_(spaceID, iter->second, false, "target refused the snapshot");
+		outgoing_.erase(iter);
+		return;
+	}
+
+	commit_(spaceID, iter->second);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::commit_(SPACE_ID spaceID, OUTGOING& outgoing)
+{
+	SpaceMemory* pSpace = SpaceMemorys::findSpace(spaceID);
+
+	// The space may have changed while the target was loading
+	std::string reason;
+	if (!canMigrate_(pSpace, reason))
+	{
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		(*pBundle).newMessage(CellappInterface::onMigrateSpaceAbort);
+		(*pBundle) << spaceID << false;
+		sendToCellapp_(outgoing.targetCid, pBundle);
+
+		finish_(spaceID, outgoing, false, reason);
+		outgoing_.erase(spaceID);
+		return;
+	}
+
+	outgoing.freezeTime = timestamp();
+	outgoing.committed = true;
+	pSpace->frozen(true);
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(CellappInterface::onMigrateSpaceCommit);
+	(*pBundle) << spaceID << g_componentID;
+
+	// spaceData changed since the snapshot
+	const SPACE_DATA& datas = pSpace->datas();
+	std::vector< std::pair<std::string, std::string> > changed;
+	std::vector<std::string> deleted;
+
+	SPACE_DATA::const_iterator diter = datas.begin();
+	for (; diter != datas.end(); ++diter)
+	{
+		SPACE_DATA::iterator siter = outgoing.datas.find(diter->first);
+		if (siter == outgoing.datas.end() || siter->second != diter->second)
+			changed.push_back(*diter);
+	}
+
+	for (diter = outgoing.datas.begin(); diter != outgoing.datas.end(); ++diter)
+	{
+		if (datas.find(diter->first) == datas.end())
+			deleted.push_back(diter->first);
+	}
+
+	(*pBundle) << (uint32)changed.size();
+	for (size_t i = 0; i < changed.size(); ++i)
+		(*pBundle) << changed[i].first << changed[i].second;
+
+	(*pBundle) << (uint32)deleted.size();
+	for (size_t i = 0; i < deleted.size(); ++i)
+		(*pBundle) << deleted[i];
+
+	// changeToGhost does not remove the entities from the space
+	SPACE_ENTITIES entities = pSpace->entities();
+	(*pBundle) << (uint32)entities.size();
+
+	outgoing.records.clear();
+	outgoing.records.reserve(entities.size());
+
+	SPACE_ENTITIES::iterator iter = entities.begin();
+	for (; iter != entities.end(); ++iter)
+	{
+		Entity* pEntity = (*iter).get();
+
+		// The base buffers its messages to the cell until the target has taken the entity over
+		if (pEntity->baseEntityCall())
+		{
+			Network::Bundle* pBaseBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+			(*pBaseBundle).newMessage(BaseappInterface::onMigrationCellappStart);
+			(*pBaseBundle) << pEntity->id();
+			(*pBaseBundle) << g_componentID;
+			(*pBaseBundle) << outgoing.targetCid;
+			pEntity->baseEntityCall()->getChannel()->send(pBaseBundle);
+		}
+
+		ENTITY_RECORD record;
+		record.id = pEntity->id();
+		record.scriptUType = pEntity->pScriptModule()->getUType();
+		record.hasWitness = pEntity->pWitness() != NULL;
+
+		MemoryStream* s = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+
+		// The witness is gone after changeToGhost
+		if (record.hasWitness)
+		{
+			pEntity->pWitness()->addViewToStream(*s);
+			record.view.assign((const char*)s->data() + s->rpos(), s->length());
+			s->clear(false);
+		}
+
+		pEntity->changeToGhost(outgoing.targetCid, *s);
+		record.data.assign((const char*)s->data() + s->rpos(), s->length());
+		MemoryStream::reclaimPoolObject(s);
+
+		(*pBundle) << record.id << record.scriptUType << record.hasWitness;
+		(*pBundle).appendBlob(record.view);
+		(*pBundle).appendBlob(record.data);
+
+		outgoing.records.push_back(record);
+	}
+
+	sendToCellapp_(outgoing.targetCid, pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::readRecords_(MemoryStream& s, ENTITY_RECORDS& records)
+{
+	uint32 size;
+	s >> size;
+
+	records.resize(size);
+
+	for (uint32 i = 0; i < size; ++i)
+	{
+		ENTITY_RECORD& record = records[i];
+		s >> record.id >> record.scriptUType >> record.hasWitness;
+		s.readBlob(record.view);
+		s.readBlob(record.data);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::restoreViews_(const ENTITY_RECORDS& records)
+{
+	ENTITY_RECORDS::const_iterator iter = records.begin();
+	for (; iter != records.end(); ++iter)
+	{
+		if (!iter->hasWitness)
+			continue;
+
+		Entity* pEntity = Cellapp::getSingleton().findEntity(iter->id);
+		if (pEntity == NULL || pEntity->isDestroyed() || pEntity->pWitness() == NULL)
+			continue;
+
+		MemoryStream* s = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+		s->append(iter->view.data(), iter->view.size());
+		pEntity->pWitness()->createViewFromStream(*s);
+		MemoryStream::reclaimPoolObject(s);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::onCommit(Network::Channel* pChannel, MemoryStream& s)
+{
+	SPACE_ID spaceID;
+	COMPONENT_ID sourceCid;
+
+	s >> spaceID >> sourceCid;
+
+	std::map<SPACE_ID, INCOMING>::iterator iter = incoming_.find(spaceID);
+	SpaceMemory* pSpace = SpaceMemorys::findSpace(spaceID);
+
+	if (iter == incoming_.end() || !iter->second.loaded || pSpace == NULL || !pSpace->isMigratingIn())
+	{
+		ERROR_MSG(fmt::format("SpaceMigration::onCommit: space({}) from cellapp({}) is not loaded!\n",
+			spaceID, sourceCid));
+
+		s.done();
+		sendCommitCB_(pChannel, spaceID, false);
+		return;
+	}
+
+	incoming_.erase(iter);
+
+	uint32 size;
+	s >> size;
+
+	for (uint32 i = 0; i < size; ++i)
+	{
+		std::string key, value;
+		s >> key >> value;
+		pSpace->setSpaceData(key, value);
+	}
+
+	s >> size;
+
+	for (uint32 i = 0; i < size; ++i)
+	{
+		std::string key;
+		s >> key;
+		pSpace->delSpaceData(key);
+	}
+
+	ENTITY_RECORDS records;
+	readRecords_(s, records);
+
+	// Refuse all or nothing, the source still has every entity as a ghost
+	ENTITY_RECORDS::iterator riter = records.begin();
+	for (; riter != records.end(); ++riter)
+	{
+		if (Cellapp::getSingleton().findEntity(riter->id) != NULL || EntityDef::findScriptModule(riter->scriptUType) == NULL)
+		{
+			ERROR_MSG(fmt::format("SpaceMigration::onCommit: space({}), entity({}) exists or its type({}) is unknown!\n",
+				spaceID, riter->id, riter->scriptUType));
+
+			SpaceMemorys::destroySpace(spaceID, 0);
+			sendCommitCB_(pChannel, spaceID, false);
+			return;
+		}
+	}
+
+	// Every entity is created before any of them is loaded, until then they can be dropped
+	// without their witnesses or bases noticing and the source takes them all back
+	std::vector<Entity*> entities;
+	entities.reserve(records.size());
+
+	for (riter = records.begin(); riter != records.end(); ++riter)
+	{
+		Entity* e = Cellapp::getSingleton().createEntity(EntityDef::findScriptModule(riter->scriptUType)->getName(),
+			NULL, false, riter->id, false);
+
+		if (e == NULL)
+		{
+			ERROR_MSG(fmt::format("SpaceMigration::onCommit: space({}), create entity({}) error, refused!\n",
+				spaceID, riter->id));
+
+			std::vector<Entity*>::iterator eiter = entities.begin();
+			for (; eiter != entities.end(); ++eiter)
+				Cellapp::getSingleton().destroyEntity((*eiter)->id(), false);
+
+			SpaceMemorys::destroySpace(spaceID, 0);
+			sendCommitCB_(pChannel, spaceID, false);
+			return;
+		}
+
+		entities.push_back(e);
+	}
+
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		ENTITY_RECORD& record = records[i];
+		Entity* e = entities[i];
+
+		Py_INCREF(e);
+
+		MemoryStream* data = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+		data->append(record.data.data(), record.data.size());
+		e->createFromStream(*data);
+		MemoryStream::reclaimPoolObject(data);
+
+		// Changes must not be synchronized back to the source, its ghosts are destroyed
+		e->ghostCell(0);
+
+		pSpace->addMigratedEntity(e);
+
+		if (e->baseEntityCall())
+		{
+			e->addFlags(ENTITY_FLAGS_TELEPORT_START);
+
+			Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+			(*pBundle).newMessage(BaseappInterface::onMigrationCellappEnd);
+			(*pBundle) << e->id();
+			(*pBundle) << sourceCid << g_componentID;
+			e->baseEntityCall()->sendCall(pBundle);
+		}
+
+		Py_DECREF(e);
+	}
+
+	restoreViews_(records);
+	pSpace->onMigratedIn();
+
+	++numMigratedIn_;
+
+	INFO_MSG(fmt::format("SpaceMigration::onCommit: space({}) with {} entities taken over from cellapp({}).\n",
+		spaceID, records.size(), sourceCid));
+
+	sendCommitCB_(pChannel, spaceID, true);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::onCommitCB(Network::Channel* pChannel, MemoryStream& s)
+{
+	SPACE_ID spaceID;
+	COMPONENT_ID targetCid;
+	bool success;
+
+	s >> spaceID >> targetCid >> success;
+
+	std::map<SPACE_ID, OUTGOING>::iterator iter = outgoing_.find(spaceID);
+	if (iter == outgoing_.end() || !iter->second.committed || iter->second.targetCid != targetCid)
+	{
+		WARNING_MSG(fmt::format("SpaceMigration::onCommitCB: space({}) is not migrating to cellapp({})!\n",
+			spaceID, targetCid));
+
+		return;
+	}
+
+	OUTGOING& outgoing = iter->second;
+
+	if (!success)
+	{
+		rollback_(spaceID, outgoing);
+		finish_(spaceID, outgoing, false, "target refused the entities");
+		outgoing_.erase(iter);
+		return;
+	}
+
+	// The space destroys itself once its last ghost is gone
+	ENTITY_RECORDS::iterator riter = outgoing.records.begin();
+	for (; riter != outgoing.records.end(); ++riter)
+	{
+		Entity* pEntity = Cellapp::getSingleton().findEntity(riter->id);
+		if (pEntity && !pEntity->isReal())
+			Cellapp::getSingleton().destroyEntity(riter->id, false);
+	}
+
+	finish_(spaceID, outgoing, true, "");
+	outgoing_.erase(iter);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::rollback_(SPACE_ID spaceID, OUTGOING& outgoing)
+{
+	ENTITY_RECORDS::iterator iter = outgoing.records.begin();
+	for (; iter != outgoing.records.end(); ++iter)
+	{
+		Entity* pEntity = Cellapp::getSingleton().findEntity(iter->id);
+		if (pEntity == NULL || pEntity->isReal())
+		{
+			ERROR_MSG(fmt::format("SpaceMigration::rollback_: space({}), lose entity({})!\n",
+				spaceID, iter->id));
+
+			continue;
+		}
+
+		// The base stops buffering and keeps sending to this cellapp
+		if (pEntity->baseEntityCall())
+		{
+			Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+			(*pBundle).newMessage(BaseappInterface::onMigrationCellappEnd);
+			(*pBundle) << pEntity->id();
+			(*pBundle) << g_componentID << g_componentID;
+			pEntity->baseEntityCall()->sendCall(pBundle);
+		}
+
+		Py_INCREF(pEntity);
+
+		MemoryStream* data = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+		data->append(iter->data.data(), iter->data.size());
+		pEntity->changeToReal(0, *data);
+		MemoryStream::reclaimPoolObject(data);
+
+		Py_DECREF(pEntity);
+	}
+
+	restoreViews_(outgoing.records);
+
+	SpaceMemory* pSpace = SpaceMemorys::findSpace(spaceID);
+	if (pSpace)
+		pSpace->frozen(false);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::onAbort(Network::Channel* pChannel, MemoryStream& s)
+{
+	SPACE_ID spaceID;
+	bool committed;
+
+	s >> spaceID >> committed;
+
+	std::map<SPACE_ID, INCOMING>::iterator iter = incoming_.find(spaceID);
+	if (iter != incoming_.end())
+	{
+		incoming_.erase(iter);
+
+		SpaceMemory* pSpace = SpaceMemorys::findSpace(spaceID);
+		if (pSpace && pSpace->isMigratingIn())
+			SpaceMemorys::destroySpace(spaceID, 0);
+	}
+
+	if (!committed)
+		return;
+
+	// The source missed the CommitCB. The commit came through the same channel and was handled before,
+	// answer again: a space that was taken over is no longer migrating in, a refused one is destroyed.
+	SpaceMemory* pSpace = SpaceMemorys::findSpace(spaceID);
+	bool takenOver = (pSpace != NULL && !pSpace->isMigratingIn());
+
+	WARNING_MSG(fmt::format("SpaceMigration::onAbort: space({}) commit timed out on the source, {}.\n",
+		spaceID, takenOver ? "taken over" : "not taken over"));
+
+	sendCommitCB_(pChannel, spaceID, takenOver);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::finish_(SPACE_ID spaceID, OUTGOING& outgoing, bool success, const std::string& reason)
+{
+	float freezeTime = 0.f;
+
+	if (outgoing.committed)
+	{
+		freezeTime = float(double(timestamp() - outgoing.freezeTime) / stampsPerSecondD() * 1000.0);
+		lastFreezeTime_ = freezeTime;
+	}
+
+	if (success)
+	{
+		++numMigratedOut_;
+
+		INFO_MSG(fmt::format("SpaceMigration::finish_: space({}) with {} entities migrated to cellapp({}), took {:.1f}s, frozen {:.1f}ms.\n",
+			spaceID, outgoing.records.size(), outgoing.targetCid,
+			double(timestamp() - outgoing.startTime) / stampsPerSecondD(), freezeTime));
+	}
+	else
+	{
+		++numFailed_;
+
+		WARNING_MSG(fmt::format("SpaceMigration::finish_: space({}) not migrated to cellapp({}), {}.\n",
+			spaceID, outgoing.targetCid, reason));
+	}
+
+	Network::Channel* pChannel = Components::getSingleton().getCellappmgrChannel();
+	if (pChannel == NULL)
+		return;
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(CellappmgrInterface::onSpaceMigrated);
+	(*pBundle) << spaceID << g_componentID << outgoing.targetCid << success;
+	(*pBundle) << (uint32)outgoing.records.size() << freezeTime;
+	pChannel->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::process()
+{
+	if (outgoing_.size() == 0 && incoming_.size() == 0)
+		return;
+
+	TimeStamp now = timestamp();
+	TimeStamp timeout = TimeStamp(g_ouroSrvConfig.getCellAppMgr().spaceMigration.timeout * stampsPerSecondD());
+	TimeStamp commitTimeout = TimeStamp(g_ouroSrvConfig.getCellAppMgr().spaceMigration.commitTimeout * stampsPerSecondD());
+
+	std::map<SPACE_ID, OUTGOING>::iterator iter = outgoing_.begin();
+	while (iter != outgoing_.end())
+	{
+		OUTGOING& outgoing = iter->second;
+		Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(CELLAPP_TYPE, outgoing.targetCid);
+		bool targetGone = (cinfos == NULL || cinfos->pChannel == NULL);
+
+		if (!outgoing.committed && (targetGone || now - outgoing.startTime >= timeout))
+		{
+			if (!targetGone)
+			{
+				Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+				(*pBundle).newMessage(CellappInterface::onMigrateSpaceAbort);
+				(*pBundle) << iter->first << false;
+				cinfos->pChannel->send(pBundle);
+			}
+
+			finish_(iter->first, outgoing, false, targetGone ? "target is gone" : "snapshot timeout");
+			outgoing_.erase(iter++);
+			continue;
+		}
+
+		// Once committed only a dead target lets the source take the entities back, otherwise they could exist twice
+		if (outgoing.committed && targetGone)
+		{
+			rollback_(iter->first, outgoing);
+			finish_(iter->first, outgoing, false, "target is gone");
+			outgoing_.erase(iter++);
+			continue;
+		}
+
+		// The space stays frozen until the target answers or is gone, every commitTimeout the target is asked
+		// again whether it took the entities over. A late commit may still be applied there.
+		if (outgoing.committed && 
+			now - (outgoing.abortTime > 0 ? outgoing.abortTime : outgoing.freezeTime) >= commitTimeout)
+		{
+			WARNING_MSG(fmt::format("SpaceMigration::process: space({}) got no CommitCB from cellapp({}), {}.\n",
+				iter->first, outgoing.targetCid, outgoing.abortTime > 0 ? "asking again" : "aborting"));
+
+			outgoing.abortTime = now;
+
+			Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+			(*pBundle).newMessage(CellappInterface::onMigrateSpaceAbort);
+			(*pBundle) << iter->first << true;
+			cinfos->pChannel->send(pBundle);
+		}
+
+		++iter;
+	}
+
+	std::map<SPACE_ID, INCOMING>::iterator iiter = incoming_.begin();
+	while (iiter != incoming_.end())
+	{
+		// The source gives up after timeout, keep the space a little longer for its abort to arrive
+		if (now - iiter->second.startTime < timeout * 2)
+		{
+			++iiter;
+			continue;
+		}
+
+		WARNING_MSG(fmt::format("SpaceMigration::process: space({}) from cellapp({}) was never committed, dropped.\n",
+			iiter->first, iiter->second.sourceCid));
+
+		SpaceMemory* pSpace = SpaceMemorys::findSpace(iiter->first);
+		if (pSpace && pSpace->isMigratingIn())
+			SpaceMemorys::destroySpace(iiter->first, 0);
+
+		incoming_.erase(iiter++);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::sendSnapshotCB_(Network::Channel* pChannel, SPACE_ID spaceID, bool success)
+{
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(CellappInterface::onMigrateSpaceSnapshotCB);
+	(*pBundle) << spaceID << g_componentID << success;
+	pChannel->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+void SpaceMigration::sendCommitCB_(Network::Channel* pChannel, SPACE_ID spaceID, bool success)
+{
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(CellappInterface::onMigrateSpaceCommitCB);
+	(*pBundle) << spaceID << g_componentID << success;
+	pChannel->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+bool SpaceMigration::sendToCellapp_(COMPONENT_ID cid, Network::Bundle* pBundle)
+{
+	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(CELLAPP_TYPE, cid);
+	if (cinfos == NULL || cinfos->pChannel == NULL)
+	{
+		Network::Bundle::reclaimPoolObject(pBundle);
+		return false;
+	}
+
+	cinfos->pChannel->send(pBundle);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+}
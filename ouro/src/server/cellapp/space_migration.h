@@ -0,0 +1,142 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_SPACE_MIGRATION_H
+#define OURO_SPACE_MIGRATION_H
+
+#include "common/common.h"
+#include "common/timestamp.h"
+#include "common/memorystream.h"
+#include "helper/debug_helper.h"
+
+namespace Ouroboros{
+
+namespace Network
+{
+class Bundle;
+class Channel;
+}
+
+class SpaceMemory;
+
+/*
+	Moves a whole space with its entities to another cellapp, the clients stay connected to their baseapps and keep their view.
+
+	1: The source sends a snapshot of the space(spaceData, geometry), the target creates the space and loads the geometry
+	   without notifying the scripts. The entities keep running on the source meanwhile.
+	2: Once the target is loaded the source freezes the space for one round trip: every entity is turned into a ghost
+	   the way a teleport does it(controllers, timers, witness), the bases buffer their messages and
+	   the spaceData changes since the snapshot are sent along.
+	3: The target takes the entities over without leaving or entering the world, the witnesses keep the entities
+	   their clients have. The source destroys its ghosts, the ghost routes forward late messages.
+	   If the target refuses the entities the source turns its ghosts back into reals.
+	4: Without a CommitCB within commitTimeout the source asks the target again through an abort, the target answers
+	   with the result of the commit. The space stays frozen until the target answers or is gone.
+*/
+class SpaceMigration
+{
+public:
+	SpaceMigration();
+	~SpaceMigration();
+
+	/* Source */
+
+	/**
+		Starts moving the space to the target cellapp, spaceID 0 picks a space
+	*/
+	bool migrate(SPACE_ID spaceID, COMPONENT_ID targetCid);
+
+	void onSnapshotCB(Network::Channel* pChannel, MemoryStream& s);
+	void onCommitCB(Network::Channel* pChannel, MemoryStream& s);
+
+	/* Target */
+	void onSnapshot(Network::Channel* pChannel, MemoryStream& s);
+	void onSpaceLoaded(SpaceMemory* pSpace);
+	void onCommit(Network::Channel* pChannel, MemoryStream& s);
+	void onAbort(Network::Channel* pChannel, MemoryStream& s);
+
+	/**
+		Called every tick, gives up on migrations that take too long
+	*/
+	void process();
+
+	bool isMigrating(SPACE_ID spaceID) const;
+
+	uint32 numMigrating() const { return (uint32)(outgoing_.size() + incoming_.size()); }
+	uint32 numMigratedOut() const { return numMigratedOut_; }
+	uint32 numMigratedIn() const { return numMigratedIn_; }
+	uint32 numFailed() const { return numFailed_; }
+	float lastFreezeTime() const { return lastFreezeTime_; }
+
+private:
+	struct ENTITY_RECORD
+	{
+		ENTITY_ID id;
+		ENTITY_SCRIPT_UID scriptUType;
+		bool hasWitness;
+		std::string view;
+		std::string data;
+	};
+
+	typedef std::vector<ENTITY_RECORD> ENTITY_RECORDS;
+
+	struct OUTGOING
+	{
+		COMPONENT_ID targetCid;
+		TimeStamp startTime;
+		TimeStamp freezeTime;
+
+		// The last abort sent after the commit deadline, 0 until then
+		TimeStamp abortTime;
+		bool committed;
+
+		// spaceData as sent with the snapshot, the commit sends the differences
+		SPACE_DATA datas;
+
+		// The entities as handed over, to turn the ghosts back into reals if the target refuses them
+		ENTITY_RECORDS records;
+	};
+
+	struct INCOMING
+	{
+		COMPONENT_ID sourceCid;
+		TimeStamp startTime;
+		bool loaded;
+	};
+
+	SPACE_ID chooseSpace_();
+	bool canMigrate_(SpaceMemory* pSpace, std::string& reason);
+
+	void commit_(SPACE_ID spaceID, OUTGOING& outgoing);
+	void rollback_(SPACE_ID spaceID, OUTGOING& outgoing);
+
+	/**
+		Reports to cellappmgr, the entry must be erased afterwards
+	*/
+	void finish_(SPACE_ID spaceID, OUTGOING& outgoing, bool success, const std::string& reason);
+
+	void sendSnapshotCB_(Network::Channel* pChannel, SPACE_ID spaceID, bool success);
+	void sendCommitCB_(Network::Channel* pChannel, SPACE_ID spaceID, bool success);
+	bool sendToCellapp_(COMPONENT_ID cid, Network::Bundle* pBundle);
+
+	static void readRecords_(MemoryStream& s, ENTITY_RECORDS& records);
+
+	/**
+		Restores the views after all entities of the space exist
+	*/
+	static void restoreViews_(const ENTITY_RECORDS& records);
+
+private:
+	std::map<SPACE_ID, OUTGOING> outgoing_;
+	std::map<SPACE_ID, INCOMING> incoming_;
+
+	uint32 numMigratedOut_;
+	uint32 numMigratedIn_;
+	uint32 numFailed_;
+
+	// Milliseconds the last space was frozen on the source
+	float lastFreezeTime_;
+};
+
+}
+
+#endif // OURO_SPACE_MIGRATION_H
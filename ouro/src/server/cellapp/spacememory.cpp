@@ -24,11 +24,15 @@ id_(spaceID),
 scriptModuleName_(scriptModuleName),
 entities_(),
 hasGeometry_(false),
+geometryLoadOnServer_(false),
+geometryParams_(),
 pCell_(NULL),
 coordinateSystem_(),
 pNavHandle_(),
 state_(STATE_NORMAL),
-destroyTime_(0)
+destroyTime_(0),
+frozen_(false),
+migratingIn_(false)
 {
 	Network::Channel* pChannel = Components::getSingleton().getCellappmgrChannel();
 	if (pChannel != NULL)
@@ -263,6 +267,9 @@ bool SpaceMemory::addSpaceGeometryMapping(std::string respath, bool shouldLoadOn
 
 	setGeometryPath(respath);
 
+	geometryLoadOnServer_ = shouldLoadOnServer;
+	geometryParams_ = params;
+
 	if(shouldLoadOnServer)
 		loadSpaceGeometry(params);
 
@@ -302,14 +309,22 @@ void SpaceMemory::onLoadedSpaceGeometryMapping(NavigationHandlePtr pNavHandle)
 	INFO_MSG(fmt::format("Ouroboros::onLoadedSpaceGeometryMapping: spaceID={}, respath={}!\n",
 			id(), getGeometryPath()));
 
-	// notification script
+	if (migratingIn_)
 	{
-		SCOPED_PROFILE(SCRIPTCALL_PROFILE);
-		SCRIPT_OBJECT_CALL_ARGS2(Cellapp::getSingleton().getEntryScript().get(), const_cast<char*>("onSpaceGeometryLoaded"), 
-			const_cast<char*>("Is"), this->id(), getGeometryPath().c_str(), false);
+		// The scripts were notified when the space was loaded on the source cellapp
+		Cellapp::getSingleton().spaceMigration().onSpaceLoaded(this);
 	}
+	else
+	{
+		// notification script
+		{
+			SCOPED_PROFILE(SCRIPTCALL_PROFILE);
+			SCRIPT_OBJECT_CALL_ARGS2(Cellapp::getSingleton().getEntryScript().get(), const_cast<char*>("onSpaceGeometryLoaded"), 
+				const_cast<char*>("Is"), this->id(), getGeometryPath().c_str(), false);
+		}
 
-	onAllSpaceGeometryLoaded();
+		onAllSpaceGeometryLoaded();
+	}
 
 	Network::Channel* pChannel = Components::getSingleton().getCellappmgrChannel();
 	if (pChannel != NULL)
@@ -358,6 +373,13 @@ bool SpaceMemory::update()
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+void SpaceMemory::updateNavigation(uint64 endTime)
+{
+	if (pNavHandle_ && !isDestroyed())
+		pNavHandle_->updateObstacles(endTime);
+}
+
 //-------------------------------------------------------------------------------------
 void SpaceMemory::addEntityAndEnterWorld(Entity* pEntity, bool isRestore)
 {
@@ -375,6 +397,16 @@ void SpaceMemory::addEntity(Entity* pEntity)
 	pEntity->onEnterSpace(this);
 }
 
+//-------------------------------------------------------------------------------------
+void SpaceMemory::addMigratedEntity(Entity* pEntity)
+{
+	pEntity->spaceID(this->id_);
+	pEntity->spaceEntityIdx(entities_.size());
+	entities_.push_back(pEntity);
+
+	addEntityToNode(pEntity);
+}
+
 //-------------------------------------------------------------------------------------
 void SpaceMemory::addEntityToNode(Entity* pEntity)
 {
@@ -537,6 +569,57 @@ bool SpaceMemory::destroy(ENTITY_ID entityID, bool ignoreGhost)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+void SpaceMemory::addToMigrationStream(Ouroboros::MemoryStream& s)
+{
+	s << (uint32)datas_.size();
+
+	SPACE_DATA::iterator iter = datas_.begin();
+	for(; iter != datas_.end(); ++iter)
+		s << iter->first << iter->second;
+
+	s << hasGeometry_ << geometryLoadOnServer_;
+	s << (uint32)geometryParams_.size();
+
+	std::map< int, std::string >::iterator piter = geometryParams_.begin();
+	for(; piter != geometryParams_.end(); ++piter)
+		s << piter->first << piter->second;
+}
+
+//-------------------------------------------------------------------------------------
+bool SpaceMemory::createFromMigrationStream(Ouroboros::MemoryStream& s)
+{
+	migratingIn_ = true;
+
+	uint32 size = 0;
+	s >> size;
+
+	// Set directly, the clients and the scripts already know the data
+	for(uint32 i = 0; i < size; ++i)
+	{
+		std::string key, value;
+		s >> key >> value;
+		datas_[key] = value;
+	}
+
+	s >> hasGeometry_ >> geometryLoadOnServer_;
+	s >> size;
+
+	for(uint32 i = 0; i < size; ++i)
+	{
+		int key;
+		std::string value;
+		s >> key >> value;
+		geometryParams_[key] = value;
+	}
+
+	if(!hasGeometry_ || !geometryLoadOnServer_ || getGeometryPath().size() == 0)
+		return false;
+
+	loadSpaceGeometry(geometryParams_);
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 void SpaceMemory::setGeometryPath(const std::string& path)
 { 
@@ -602,6 +685,10 @@ void SpaceMemory::delSpaceData(const std::string& key)
 //-------------------------------------------------------------------------------------
 void SpaceMemory::onSpaceDataChanged(const std::string& key, const std::string& value, bool isdel)
 {
+	// Changes handed over by a space migration, the scripts and the clients know them from the source
+	if(migratingIn_)
+		return;
+
 	// notification script
 	if(!isdel)
 	{
@@ -868,5 +955,153 @@ PyObject* SpaceMemory::__py_DelSpaceData(PyObject* self, PyObject* args)
 	S_Return;
 }
 
+//-------------------------------------------------------------------------------------
+static NavigationHandlePtr findObstacleNavHandle(const char* funcName, SPACE_ID spaceID)
+{
+	SpaceMemory* space = SpaceMemorys::findSpace(spaceID);
+	if(space == NULL)
+	{
+		PyErr_Format(PyExc_AssertionError, "Ouroboros::%s: (spaceID=%u) not found!", 
+			funcName, spaceID);
+
+		PyErr_PrintEx(0);
+		return NULL;
+	}
+
+	NavigationHandlePtr pNavHandle = space->pNavHandle();
+	if(!pNavHandle || pNavHandle->type() != NavigationHandle::NAV_MESH_CACHE)
+	{
+		PyErr_Format(PyExc_AssertionError, "Ouroboros::%s: space(%u) has no tilecache navmesh!", 
+			funcName, spaceID);
+
+		PyErr_PrintEx(0);
+		return NULL;
+	}
+
+	return pNavHandle;
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* SpaceMemory::__py_AddNavObstacle(PyObject* self, PyObject* args)
+{
+	SPACE_ID spaceID = 0;
+	PyObject* pyPosition = NULL;
+	float radius = 0.f;
+	float height = 0.f;
+
+	if(PyTuple_Size(args) != 4)
+	{
+		PyErr_Format(PyExc_AssertionError, "Ouroboros::addNavObstacle: (argssize != (spaceID, position, radius, height)) error!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PyArg_ParseTuple(args, "IOff", &spaceID, &pyPosition, &radius, &height))
+	{
+		PyErr_Format(PyExc_TypeError, "Ouroboros::addNavObstacle: args error!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PySequence_Check(pyPosition) || PySequence_Size(pyPosition) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "Ouroboros::addNavObstacle: args2(position) invalid!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(radius <= 0.f || height <= 0.f)
+	{
+		PyErr_Format(PyExc_ValueError, "Ouroboros::addNavObstacle: radius(%f) and height(%f) must be > 0!", radius, height);
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	NavigationHandlePtr pNavHandle = findObstacleNavHandle("addNavObstacle", spaceID);
+	if(!pNavHandle)
+		return 0;
+
+	Position3D pos;
+	script::ScriptVector3::convertPyObjectToVector3(pos, pyPosition);
+
+	return PyLong_FromLong(pNavHandle->addObstacle(pos, radius, height));
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* SpaceMemory::__py_AddNavBoxObstacle(PyObject* self, PyObject* args)
+{
+	SPACE_ID spaceID = 0;
+	PyObject* pyCenter = NULL;
+	PyObject* pyHalfExtents = NULL;
+	float yaw = 0.f;
+
+	int argCount = PyTuple_Size(args);
+	if(argCount != 3 && argCount != 4)
+	{
+		PyErr_Format(PyExc_AssertionError, "Ouroboros::addNavBoxObstacle: (argssize != (spaceID, center, halfExtents[, yaw])) error!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PyArg_ParseTuple(args, "IOO|f", &spaceID, &pyCenter, &pyHalfExtents, &yaw))
+	{
+		PyErr_Format(PyExc_TypeError, "Ouroboros::addNavBoxObstacle: args error!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PySequence_Check(pyCenter) || PySequence_Size(pyCenter) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "Ouroboros::addNavBoxObstacle: args2(center) invalid!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PySequence_Check(pyHalfExtents) || PySequence_Size(pyHalfExtents) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "Ouroboros::addNavBoxObstacle: args3(halfExtents) invalid!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	NavigationHandlePtr pNavHandle = findObstacleNavHandle("addNavBoxObstacle", spaceID);
+	if(!pNavHandle)
+		return 0;
+
+	Position3D center;
+	Position3D halfExtents;
+	script::ScriptVector3::convertPyObjectToVector3(center, pyCenter);
+	script::ScriptVector3::convertPyObjectToVector3(halfExtents, pyHalfExtents);
+
+	return PyLong_FromLong(pNavHandle->addBoxObstacle(center, halfExtents, yaw));
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* SpaceMemory::__py_RemoveNavObstacle(PyObject* self, PyObject* args)
+{
+	SPACE_ID spaceID = 0;
+	int obstacleID = 0;
+
+	if(PyTuple_Size(args) != 2)
+	{
+		PyErr_Format(PyExc_AssertionError, "Ouroboros::removeNavObstacle: (argssize != (spaceID, obstacleID)) error!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PyArg_ParseTuple(args, "Ii", &spaceID, &obstacleID))
+	{
+		PyErr_Format(PyExc_TypeError, "Ouroboros::removeNavObstacle: args error!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	NavigationHandlePtr pNavHandle = findObstacleNavHandle("removeNavObstacle", spaceID);
+	if(!pNavHandle)
+		return 0;
+
+	return PyBool_FromLong(pNavHandle->removeObstacle(obstacleID));
+}
+
 //-------------------------------------------------------------------------------------
 }
@@ -14,6 +14,7 @@
 namespace Ouroboros{
 
 class Entity;
+class MemoryStream;
 typedef SmartPointer<Entity> EntityPtr;
 typedef std::vector<EntityPtr> SPACE_ENTITIES;
 
@@ -31,12 +32,22 @@ public:
 	*/
 	bool update();
 
+	/**
+		Rebuilds the navmesh tiles changed by obstacles until endTime
+	*/
+	void updateNavigation(uint64 endTime);
+
 	void addEntity(Entity* pEntity);
 	void addEntityToNode(Entity* pEntity);
 
 	void addEntityAndEnterWorld(Entity* pEntity, bool isRestore = false);
 	void removeEntity(Entity* pEntity);
 
+	/**
+		An entity taken over by a space migration, it is already in the world on the clients
+	*/
+	void addMigratedEntity(Entity* pEntity);
+
 	/**
 		An entity enters the game world
 	*/
@@ -47,6 +58,7 @@ public:
 	void onEntityAttachWitness(Entity* pEntity);
 
 	SPACE_ID id() const{ return id_; }
+	const std::string& scriptModuleName() const{ return scriptModuleName_; }
 
 	const SPACE_ENTITIES& entities() const{ return entities_; }
 	Entity* findEntity(ENTITY_ID entityID);
@@ -75,6 +87,13 @@ public:
 	
 	NavigationHandlePtr pNavHandle() const{ return pNavHandle_; }
 
+	/**
+		Dynamic obstacles of the navmesh(xxx.tilecache navmeshes only)
+	*/
+	static PyObject* __py_AddNavObstacle(PyObject* self, PyObject* args);
+	static PyObject* __py_AddNavBoxObstacle(PyObject* self, PyObject* args);
+	static PyObject* __py_RemoveNavObstacle(PyObject* self, PyObject* args);
+
 	/**
 		spaceData related operation interface
 	*/
@@ -83,6 +102,7 @@ public:
 	bool hasSpaceData(const std::string& key);
 	const std::string& getSpaceData(const std::string& key);
 	void onSpaceDataChanged(const std::string& key, const std::string& value, bool isdel);
+	const SPACE_DATA& datas() const { return datas_; }
 	static PyObject* __py_SetSpaceData(PyObject* self, PyObject* args);
 	static PyObject* __py_GetSpaceData(PyObject* self, PyObject* args);
 	static PyObject* __py_DelSpaceData(PyObject* self, PyObject* args);
@@ -90,7 +110,23 @@ public:
 	CoordinateSystem* pCoordinateSystem(){ return &coordinateSystem_; }
 
 	bool isDestroyed() const{ return state_ == STATE_DESTROYED; }
-	bool isGood() const{ return state_ == STATE_NORMAL; }
+	bool isGood() const{ return state_ == STATE_NORMAL && !frozen_; }
+
+	/**
+		Space migration.
+		The source is frozen while its entities are handed over, nothing may enter the space.
+		The target loads the space without notifying the scripts, it already exists for them.
+	*/
+	bool isFrozen() const{ return frozen_; }
+	void frozen(bool v){ frozen_ = v; }
+	bool isMigratingIn() const{ return migratingIn_; }
+	void addToMigrationStream(Ouroboros::MemoryStream& s);
+
+	/**
+		Returns true if the geometry is loading, onLoadedSpaceGeometryMapping follows
+	*/
+	bool createFromMigrationStream(Ouroboros::MemoryStream& s);
+	void onMigratedIn(){ migratingIn_ = false; }
 
 protected:
 	void _addSpaceDatasToEntityClient(const Entity* pEntity);
@@ -117,6 +153,10 @@ protected:
 	// Whether terrain data has been loaded
 	bool						hasGeometry_;
 
+	// How the geometry was loaded, a space migration loads it again on the target
+	bool						geometryLoadOnServer_;
+	std::map< int, std::string > geometryParams_;
+
 	// There is at most one cell per space
 	Cell*						pCell_;
 
@@ -131,6 +171,9 @@ protected:
 	int8						state_;
 	
 	uint64						destroyTime_;	
+
+	bool						frozen_;
+	bool						migratingIn_;
 };
 
 
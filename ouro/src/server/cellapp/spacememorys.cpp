@@ -1,6 +1,8 @@
 // 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
 
 #include "spacememorys.h"	
+#include "entity.h"
+#include "server/serverconfig.h"
 namespace Ouroboros{	
 SpaceMemorys::SPACEMEMORYS SpaceMemorys::spaces_;
 
@@ -82,6 +84,10 @@ SpaceMemory* SpaceMemorys::findSpace(SPACE_ID spaceID)
 //-------------------------------------------------------------------------------------
 void SpaceMemorys::update()
 {
+	// The spaces share the budget for rebuilding the tiles changed by navmesh obstacles
+	uint64 navEndTime = timestamp() + 
+		uint64(g_ouroSrvConfig.getCellApp().navmesh.obstacleBudget * stampsPerSecondD() / 1000.0);
+
 	SPACEMEMORYS::iterator iter = spaces_.begin();
 
 	for(; iter != spaces_.end(); )
@@ -92,10 +98,27 @@ void SpaceMemorys::update()
 		}
 		else
 		{
+			iter->second->updateNavigation(navEndTime);
 			++iter;
 		}
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void SpaceMemorys::integrateCoordinateSystems()
+{
+	if (!CoordinateSystem::deferredUpdates)
+		return;
+
+	// Script callbacks of the triggers are called after all the spaces are done
+	Entity::bufferCallback(true);
+
+	SPACEMEMORYS::iterator iter = spaces_.begin();
+	for (; iter != spaces_.end(); ++iter)
+		iter->second->pCoordinateSystem()->integrateMovedNodes();
+
+	Entity::bufferCallback(false);
+}
+
 //-------------------------------------------------------------------------------------
 }
@@ -41,8 +41,15 @@ public:
 	*/
 	static void update();
 
+	/**
+		Repositions the coordinate nodes moved since the last pass, see CoordinateSystem::deferredUpdates
+	*/
+	static void integrateCoordinateSystems();
+
 	static size_t size(){ return spaces_.size(); }
 
+	static SPACEMEMORYS& spaces(){ return spaces_; }
+
 protected:
 	static SPACEMEMORYS spaces_;
 };
@@ -7,6 +7,8 @@ namespace Ouroboros{
 //-------------------------------------------------------------------------------------
 Updatable::Updatable():
 removeIdx(-1),
+updatePeriod(1),
+updatePhase(-1),
 updatableName("Updatable")
 {
 }
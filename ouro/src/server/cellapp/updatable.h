@@ -16,6 +16,16 @@
 
 namespace Ouroboros{
 
+/*
+	The Updatables of a lower priority are updated first
+*/
+enum UPDATE_PRIORITY
+{
+	UPDATE_PRIORITY_DEFAULT = 0,	// controllers and the rest
+	UPDATE_PRIORITY_WITNESS = 1,	// after the entities moved
+	UPDATE_PRIORITY_MAX = 2
+};
+
 /*
 	Used to describe an object that will always be updated, the app will call all the tick
 	Updatable to update the state, you need to implement different Updatable to complete different update features.
@@ -29,14 +39,22 @@ public:
 	virtual bool update() = 0;
 
 	virtual uint8 updatePriority() const {
-		return 0;
+		return UPDATE_PRIORITY_DEFAULT;
 	}
 
 	std::string c_str() { return updatableName; }
 
-	// its position in the Updatables container
+	// its position in the Updatables container, -1 if not added
 	int removeIdx;
 
+	// Updated once every updatePeriod ticks, 0 and 1 are every tick.
+	// Set before the Updatable is added.
+	uint32 updatePeriod;
+
+	// Updated at the ticks where tick % updatePeriod == updatePhase, if it is -1 when added the
+	// Updatables picks one so that the Updatables of the same period are spread over the ticks
+	int32 updatePhase;
+
 	std::string updatableName;
 };
 
@@ -7,7 +7,11 @@ namespace Ouroboros{
 
 
 //-------------------------------------------------------------------------------------
-Updatables::Updatables()
+Updatables::Updatables():
+objects_(),
+updating_(-1),
+holes_(0),
+nextPhase_(0)
 {
 }
 
@@ -21,6 +25,19 @@ Updatables::~Updatables()
 void Updatables::clear()
 {
 	objects_.clear();
+	holes_ = 0;
+}
+
+//-------------------------------------------------------------------------------------
+size_t Updatables::size() const
+{
+	size_t n = 0;
+
+	std::vector< std::vector<Updatable*> >::const_iterator iter = objects_.begin();
+	for (; iter != objects_.end(); ++iter)
+		n += iter->size();
+
+	return n - holes_;
 }
 
 //-------------------------------------------------------------------------------------
@@ -28,24 +45,23 @@ bool Updatables::add(Updatable* updatable)
 {
 	// Fixed priority array here because there are not a lot of priority requirements
 	if (objects_.size() == 0)
-	{
-		objects_.push_back(std::map<uint32, Updatable*>());
-		objects_.push_back(std::map<uint32, Updatable*>());
-	}
+		objects_.resize(UPDATE_PRIORITY_MAX);
 
 	OURO_ASSERT(updatable->updatePriority() < objects_.size());
 
-	static uint32 idx = 1;
-	std::map<uint32, Updatable*>& pools = objects_[updatable->updatePriority()];
+	std::vector<Updatable*>& pool = objects_[updatable->updatePriority()];
 
-	// prevent duplication
-	while (pools.find(idx) != pools.end())
-		++idx;
-
-	pools[idx] = updatable;
+	// prevent duplication, the index is left as it is when the Updatable returned false from update()
+	int idx = updatable->removeIdx;
+	if (idx >= 0 && (size_t)idx < pool.size() && pool[idx] == updatable)
+		return false;
 
 	// record storage location
-	updatable->removeIdx = idx++;
+	updatable->removeIdx = (int)pool.size();
+	pool.push_back(updatable);
+
+	if (updatable->updatePeriod > 1 && updatable->updatePhase < 0)
+		updatable->updatePhase = int32(nextPhase_++ % updatable->updatePeriod);
 
 	return true;
 }
@@ -53,34 +69,98 @@ bool Updatables::add(Updatable* updatable)
 //-------------------------------------------------------------------------------------
 bool Updatables::remove(Updatable* updatable)
 {
-	std::map<uint32, Updatable*>& pools = objects_[updatable->updatePriority()];
-	pools.erase(updatable->removeIdx);
+	uint8 priority = updatable->updatePriority();
+	int idx = updatable->removeIdx;
+
+	if (idx < 0 || priority >= objects_.size())
+		return false;
+
+	std::vector<Updatable*>& pools = objects_[priority];
+
+	// Already removed by returning false from update()
+	if ((size_t)idx >= pools.size() || pools[idx] != updatable)
+	{
+		updatable->removeIdx = -1;
+		return false;
+	}
+
 	updatable->removeIdx = -1;
+
+	// The slots are not moved during the pass
+	if (updating_ == (int)priority)
+	{
+		pools[idx] = NULL;
+		++holes_;
+		return true;
+	}
+
+	Updatable* pLast = pools.back();
+	pools[idx] = pLast;
+	pLast->removeIdx = idx;
+	pools.pop_back();
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
 void Updatables::update()
+{
+	for (uint8 priority = 0; priority < objects_.size(); ++priority)
+		update(priority);
+}
+
+//-------------------------------------------------------------------------------------
+void Updatables::update(uint8 priority)
 {
 	AUTO_SCOPED_PROFILE("callUpdates");
 
-	std::vector< std::map<uint32, Updatable*> >::iterator fpIter = objects_.begin();
-	for (; fpIter != objects_.end(); ++fpIter)
+	if (priority >= objects_.size())
+		return;
+
+	std::vector<Updatable*>& pools = objects_[priority];
+	updating_ = priority;
+
+	// The Updatables added during the pass are updated in it too
+	for (size_t i = 0; i < pools.size(); ++i)
 	{
-		std::map<uint32, Updatable*>& pools = (*fpIter);
-		std::map<uint32, Updatable*>::iterator iter = pools.begin();
-		for (; iter != pools.end();)
+		Updatable* pUpdatable = pools[i];
+		if (!pUpdatable)
+			continue;
+
+		if (pUpdatable->updatePeriod > 1 && 
+			(g_ourotime % pUpdatable->updatePeriod) != (uint32)pUpdatable->updatePhase % pUpdatable->updatePeriod)
+			continue;
+
+		// It may be destroyed if false is returned, only the slot is cleared
+		if (!pUpdatable->update() && pools[i] == pUpdatable)
 		{
-			if (!iter->second->update())
-			{
-				pools.erase(iter++);
-			}
-			else
-			{
-				++iter;
-			}
+			pools[i] = NULL;
+			++holes_;
 		}
 	}
+
+	updating_ = -1;
+
+	if (holes_ > 0)
+		compact_(pools);
+}
+
+//-------------------------------------------------------------------------------------
+void Updatables::compact_(std::vector<Updatable*>& pools)
+{
+	size_t n = 0;
+
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		Updatable* pUpdatable = pools[i];
+		if (!pUpdatable)
+			continue;
+
+		pUpdatable->removeIdx = (int)n;
+		pools[n++] = pUpdatable;
+	}
+
+	pools.resize(n);
+	holes_ = 0;
 }
 
 //-------------------------------------------------------------------------------------
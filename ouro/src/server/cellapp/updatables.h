@@ -16,6 +16,12 @@
 
 namespace Ouroboros{
 
+/*
+	The Updatables of each priority are kept in an array, an Updatable knows its index(removeIdx)
+	so that it is removed in O(1) by moving the last one into its place.
+	Updatables removed while their priority is being updated leave an empty slot, the slots are
+	compacted after the pass so that the order of the others does not change.
+*/
 class Updatables
 {
 public:
@@ -29,8 +35,27 @@ public:
 
 	void update();
 
+	/**
+		Updates only the Updatables of this priority
+	*/
+	void update(uint8 priority);
+
+	size_t size() const;
+
+private:
+	void compact_(std::vector<Updatable*>& pool);
+
 private:
-	std::vector< std::map<uint32, Updatable*> > objects_;
+	std::vector< std::vector<Updatable*> > objects_;
+
+	// The priority being updated, -1 if none
+	int updating_;
+
+	// Empty slots left in the priority being updated
+	size_t holes_;
+
+	// Picks the phases of the Updatables that do not update every tick
+	uint32 nextPhase_;
 };
 
 }
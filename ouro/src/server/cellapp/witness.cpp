@@ -4,6 +4,7 @@
 #include "entity.h"	
 #include "profile.h"
 #include "cellapp.h"
+#include "witness_updater.h"
 #include "view_trigger.h"
 #include "network/channel.h"	
 #include "network/bundle.h"
@@ -29,6 +30,9 @@
 #define UPDATE_FLAG_PITCH_ROLL			0x00000100
 #define UPDATE_FLAG_ONGOUND				0x00000200
 
+#define UPDATE_SCRIPT_BEGIN				0x01
+#define UPDATE_SCRIPT_END				0x02
+
 namespace Ouroboros{	
 
 
@@ -41,7 +45,13 @@ pViewTrigger_(NULL),
 pViewHysteresisAreaTrigger_(NULL),
 viewEntities_(),
 viewEntities_map_(),
-clientViewSize_(0)
+aliasSlots_(),
+freeAliasIDs_(),
+clientViewSize_(0),
+pUpdateBundle_(NULL),
+isBufferedUpdateBundle_(false),
+updateEntities_(),
+updateScripts_(-1)
 {
 	updatableName = "Witness";
 }
@@ -98,9 +108,10 @@ void Witness::createFromStream(Ouroboros::MemoryStream& s)
 		pEntityRef->createFromStream(s);
 		viewEntities_.push_back(pEntityRef);
 		viewEntities_map_[pEntityRef->id()] = pEntityRef;
-		pEntityRef->aliasID(i);
 	}
 
+	restoreAliasIDs_();
+
 	setViewRadius(viewRadius_, viewHysteresisArea_);
 
 	lastBasePos_.z = -FLT_MAX;
@@ -108,6 +119,46 @@ void Witness::createFromStream(Ouroboros::MemoryStream& s)
 	Cellapp::getSingleton().addUpdatable(this);
 }
 
+//-------------------------------------------------------------------------------------
+void Witness::addViewToStream(Ouroboros::MemoryStream& s)
+{
+	s << clientViewSize_ << (uint32)viewEntities_.size();
+
+	VIEW_ENTITIES::iterator iter = viewEntities_.begin();
+	for(; iter != viewEntities_.end(); ++iter)
+		(*iter)->addToStream(s);
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::createViewFromStream(Ouroboros::MemoryStream& s)
+{
+	uint32 size;
+	s >> clientViewSize_ >> size;
+
+	for(uint32 i=0; i<size; ++i)
+	{
+		EntityRef* pEntityRef = EntityRef::createPoolObject(OBJECTPOOL_POINT);
+		pEntityRef->createFromStream(s);
+
+		Entity* pEntity = pEntityRef->pEntity();
+
+		// Entities that were leaving the view have no entity any more, update() removes them from the client
+		if(pEntity && (pEntityRef->flags() & ENTITYREF_FLAG_LEAVE_CLIENT_PENDING) > 0)
+			pEntityRef->pEntity(NULL);
+		else if(pEntity && !pEntity->entityInWitnessed(pEntity_->id()))
+			pEntity->addWitnessed(pEntity_);
+
+		viewEntities_.push_back(pEntityRef);
+		viewEntities_map_[pEntityRef->id()] = pEntityRef;
+	}
+
+	// The client keeps its slots, the entities keep their aliasIDs
+	restoreAliasIDs_();
+
+	// The view trigger reports the entities in range, those the client has are already in the view
+	installViewTrigger();
+}
+
 //-------------------------------------------------------------------------------------
 void Witness::attach(Entity* pEntity)
 {
@@ -166,6 +217,8 @@ void Witness::detach(Entity* pEntity)
 	//DEBUG_MSG(fmt::format("Witness::detach: {}({}).\n", 
 	//	pEntity->scriptName(), pEntity->id()));
 
+	flushUpdate_();
+
 	EntityCall* pClientMB = pEntity_->clientEntityCall();
 	if(pClientMB)
 	{
@@ -192,6 +245,7 @@ void Witness::detach(Entity* pEntity)
 void Witness::clear(Entity* pEntity)
 {
 	OURO_ASSERT(pEntity == pEntity_);
+	flushUpdate_();
 	uninstallViewTrigger();
 
 	VIEW_ENTITIES::iterator iter = viewEntities_.begin();
@@ -209,6 +263,7 @@ void Witness::clear(Entity* pEntity)
 	viewRadius_ = 0.0f;
 	viewHysteresisArea_ = 5.0f;
 	clientViewSize_ = 0;
+	updateScripts_ = -1;
 
 	// No need to destroy, can be reused later
 	// Destroy here may generate an error because the entityview process may cause the entity to be destroyed
@@ -218,6 +273,7 @@ void Witness::clear(Entity* pEntity)
 
 	viewEntities_.clear();
 	viewEntities_map_.clear();
+	clearAliasIDs_();
 
 	Cellapp::getSingleton().removeUpdatable(this);
 }
@@ -393,19 +449,7 @@ void Witness::onEnterView(ViewTrigger* pViewTrigger, Entity* pEntity)
 
 					OURO_ASSERT(clientViewSize_ > 0);
 					--clientViewSize_;
-
-					VIEW_ENTITIES::iterator iter1 = viewEntities_.begin();
-					for (; iter1 != viewEntities_.end(); iter1++)
-					{
-						if ((*iter1)->id() == pEntityRef->id())
-						{
-							viewEntities_.erase(iter1);
-							break;
-						}
-					}
-
-					viewEntities_.push_back(pEntityRef);
-					updateEntitiesAliasID();
+					freeAliasID_(pEntityRef);
 				}
 			}
 
@@ -428,7 +472,6 @@ void Witness::onEnterView(ViewTrigger* pViewTrigger, Entity* pEntity)
 	pEntityRef->flags(pEntityRef->flags() | ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
 	viewEntities_.push_back(pEntityRef);
 	viewEntities_map_[pEntityRef->id()] = pEntityRef;
-	pEntityRef->aliasID(viewEntities_map_.size() - 1);
 	
 	pEntity->addWitnessed(pEntity_);
 	pSelfEntity->onEnteredView(pEntity);
@@ -473,28 +516,31 @@ void Witness::_onLeaveView(EntityRef* pEntityRef)
 //-------------------------------------------------------------------------------------
 void Witness::resetViewEntities()
 {
+	flushUpdate_();
+
+	// The client starts with no entities
 	clientViewSize_ = 0;
-	VIEW_ENTITIES::iterator iter = viewEntities_.begin();
-	for(; iter != viewEntities_.end(); )
+	clearAliasIDs_();
+
+	for(size_t i = 0; i < viewEntities_.size(); )
 	{
-		if(((*iter)->flags() & ENTITYREF_FLAG_LEAVE_CLIENT_PENDING) > 0)
+		EntityRef* pEntityRef = viewEntities_[i];
+		if((pEntityRef->flags() & ENTITYREF_FLAG_LEAVE_CLIENT_PENDING) > 0)
 		{
-			viewEntities_map_.erase((*iter)->id());
-			EntityRef::reclaimPoolObject((*iter));
-			iter = viewEntities_.erase(iter);
+			removeViewEntity_(i);
 			continue;
 		}
 
-		(*iter)->flags(ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
-		++iter;
+		pEntityRef->flags(ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
+		++i;
 	}
-	
-	updateEntitiesAliasID();
 }
 
 //-------------------------------------------------------------------------------------
 void Witness::onEnterSpace(SpaceMemory* pSpace)
 {
+	flushUpdate_();
+
 	Network::Bundle* pSendBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
 	NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pEntity_->id(), (*pSendBundle));
 
@@ -526,6 +572,7 @@ void Witness::onEnterSpace(SpaceMemory* pSpace)
 //-------------------------------------------------------------------------------------
 void Witness::onLeaveSpace(SpaceMemory* pSpace)
 {
+	flushUpdate_();
 	uninstallViewTrigger();
 
 	Network::Bundle* pSendBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
@@ -552,6 +599,7 @@ void Witness::onLeaveSpace(SpaceMemory* pSpace)
 
 	viewEntities_.clear();
 	viewEntities_map_.clear();
+	clearAliasIDs_();
 
 	clientViewSize_ = 0;
 }
@@ -601,6 +649,9 @@ void Witness::uninstallViewTrigger()
 //-------------------------------------------------------------------------------------
 bool Witness::pushBundle(Network::Bundle* pBundle)
 {
+	// Sent after the update the client got first
+	flushUpdate_();
+
 	Network::Channel* pc = pChannel();
 	if(!pc)
 		return false;
@@ -636,22 +687,19 @@ void Witness::_addViewEntityIDToBundle(Network::Bundle* pBundle, EntityRef* pEnt
 	else
 	{
 		// Note: Cannot be used outside the module, otherwise the client table may not find the entityID.
-		// clientViewSize_ needs to be added when the entity is actually synced to the client.
-		if(clientViewSize_ > 255)
+		// The entity has a slot once it is actually synced to the client.
+		uint8 size = aliasIDSize();
+		if(size == 0 || (pEntityRef->flags() & (ENTITYREF_FLAG_NORMAL)) <= 0 || pEntityRef->aliasID() < 0)
 		{
 			(*pBundle) << pEntityRef->id();
 		}
+		else if(size == 1)
+		{
+			(*pBundle) << (uint8)pEntityRef->aliasID();
+		}
 		else
 		{
-			if ((pEntityRef->flags() & (ENTITYREF_FLAG_NORMAL)) > 0)
-			{
-				OURO_ASSERT(pEntityRef->aliasID() <= 255);
-				(*pBundle) << (uint8)pEntityRef->aliasID();
-			}
-			else
-			{
-				(*pBundle) << pEntityRef->id();
-			}
+			(*pBundle) << (uint16)pEntityRef->aliasID();
 		}
 	}
 }
@@ -667,13 +715,13 @@ const Network::MessageHandler& Witness::getViewEntityMessageHandler(const Networ
 	}
 	else
 	{
-		if (clientViewSize_ > 255)
+		if (aliasIDSize() == 0)
 		{
 			return normalMsgHandler;
 		}
 		else
 		{
-			uint8 aliasID = 0;
+			uint16 aliasID = 0;
 			if(entityID2AliasID(entityID, aliasID))
 			{
 				ialiasID = aliasID;
@@ -690,7 +738,7 @@ const Network::MessageHandler& Witness::getViewEntityMessageHandler(const Networ
 }
 
 //-------------------------------------------------------------------------------------
-bool Witness::entityID2AliasID(ENTITY_ID id, uint8& aliasID)
+bool Witness::entityID2AliasID(ENTITY_ID id, uint16& aliasID)
 {
 	VIEW_ENTITIES_MAP::iterator iter = viewEntities_map_.find(id);
 	if (iter == viewEntities_map_.end())
@@ -707,29 +755,135 @@ bool Witness::entityID2AliasID(ENTITY_ID id, uint8& aliasID)
 	}
 
 	// overflow
-	if (pEntityRef->aliasID() > 255)
+	if (pEntityRef->aliasID() < 0 || pEntityRef->aliasID() > 65535)
 	{
 		aliasID = 0;
 		return false;
 	}
 	
-	aliasID = (uint8)pEntityRef->aliasID();
+	aliasID = (uint16)pEntityRef->aliasID();
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
-void Witness::updateEntitiesAliasID()
+void Witness::addViewEntityAliasIDToBundle(Network::Bundle* pBundle, int aliasID)
+{
+	if (aliasIDSize() == 1)
+		(*pBundle) << (uint8)aliasID;
+	else
+		(*pBundle) << (uint16)aliasID;
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::allocAliasID_(EntityRef* pEntityRef)
+{
+	OURO_ASSERT(pEntityRef->aliasID() < 0);
+
+	if (freeAliasIDs_.size() > 0)
+	{
+		std::pop_heap(freeAliasIDs_.begin(), freeAliasIDs_.end(), std::greater<int>());
+		int aliasID = freeAliasIDs_.back();
+		freeAliasIDs_.pop_back();
+
+		aliasSlots_[aliasID] = pEntityRef;
+		pEntityRef->aliasID(aliasID);
+		return;
+	}
+
+	pEntityRef->aliasID((int)aliasSlots_.size());
+	aliasSlots_.push_back(pEntityRef);
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::freeAliasID_(EntityRef* pEntityRef)
 {
-	int n = 0;
+	int aliasID = pEntityRef->aliasID();
+	if (aliasID < 0)
+		return;
+
+	OURO_ASSERT(aliasID < (int)aliasSlots_.size() && aliasSlots_[aliasID] == pEntityRef);
+
+	pEntityRef->aliasID(-1);
+	aliasSlots_[aliasID] = NULL;
+
+	if (aliasID + 1 < (int)aliasSlots_.size())
+	{
+		freeAliasIDs_.push_back(aliasID);
+		std::push_heap(freeAliasIDs_.begin(), freeAliasIDs_.end(), std::greater<int>());
+		return;
+	}
+
+	// Drop the free slots at the end, the client does the same
+	while (aliasSlots_.size() > 0 && aliasSlots_.back() == NULL)
+		aliasSlots_.pop_back();
+
+	size_t n = 0;
+	for (size_t i = 0; i < freeAliasIDs_.size(); ++i)
+	{
+		if (freeAliasIDs_[i] < (int)aliasSlots_.size())
+			freeAliasIDs_[n++] = freeAliasIDs_[i];
+	}
+
+	if (n != freeAliasIDs_.size())
+	{
+		freeAliasIDs_.resize(n);
+		std::make_heap(freeAliasIDs_.begin(), freeAliasIDs_.end(), std::greater<int>());
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::clearAliasIDs_()
+{
+	std::vector<EntityRef*>::iterator iter = aliasSlots_.begin();
+	for (; iter != aliasSlots_.end(); ++iter)
+	{
+		if ((*iter))
+			(*iter)->aliasID(-1);
+	}
+
+	aliasSlots_.clear();
+	freeAliasIDs_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::restoreAliasIDs_()
+{
+	aliasSlots_.clear();
+	freeAliasIDs_.clear();
+
 	VIEW_ENTITIES::iterator iter = viewEntities_.begin();
-	for(; iter != viewEntities_.end(); ++iter)
+	for (; iter != viewEntities_.end(); ++iter)
 	{
-		EntityRef* pEntityRef = (*iter);
-		pEntityRef->aliasID(n++);
-		
-		if(n >= 255)
-			break;
+		int aliasID = (*iter)->aliasID();
+		if (aliasID < 0)
+			continue;
+
+		if (aliasID >= (int)aliasSlots_.size())
+			aliasSlots_.resize(aliasID + 1, NULL);
+
+		aliasSlots_[aliasID] = (*iter);
 	}
+
+	for (int i = 0; i < (int)aliasSlots_.size(); ++i)
+	{
+		if (aliasSlots_[i] == NULL)
+			freeAliasIDs_.push_back(i);
+	}
+
+	std::make_heap(freeAliasIDs_.begin(), freeAliasIDs_.end(), std::greater<int>());
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::removeViewEntity_(size_t idx)
+{
+	EntityRef* pEntityRef = viewEntities_[idx];
+	freeAliasID_(pEntityRef);
+
+	viewEntities_[idx] = viewEntities_.back();
+	viewEntities_.pop_back();
+
+	viewEntities_map_.erase(pEntityRef->id());
+	EntityRef::reclaimPoolObject(pEntityRef);
 }
 
 //-------------------------------------------------------------------------------------
@@ -744,173 +898,273 @@ bool Witness::update()
 	if(!pChannel)
 		return true;
 
-	Py_INCREF(pEntity_);
+	// The scripts may destroy the entity, clear() resets pEntity_
+	Entity* pEntity = pEntity_;
+	Py_INCREF(pEntity);
 
-	static bool notificationScriptBegin = PyObject_HasAttrString(pEntity_, "onUpdateBegin") > 0;
-	if (notificationScriptBegin)
-	{
-		PyObject* pyResult = PyObject_CallMethod(pEntity_,
-			const_cast<char*>("onUpdateBegin"),
-			const_cast<char*>(""));
+	bool hasScripts = hasUpdateScripts();
+	if ((updateScripts_ & UPDATE_SCRIPT_BEGIN) > 0)
+		callUpdateScript_("onUpdateBegin");
 
-		if (pyResult != NULL)
+	WitnessUpdater& witnessUpdater = Cellapp::getSingleton().witnessUpdater();
+
+	// The scripts expect the update to be sent when onUpdateEnd is called
+	bool deferred = !hasScripts && witnessUpdater.isParallel();
+
+	if (beginUpdate(deferred))
+	{
+		if (deferred)
 		{
-			Py_DECREF(pyResult);
+			witnessUpdater.push(this);
 		}
 		else
 		{
-			SCRIPT_ERROR_CHECK();
+			updateViewEntities();
+			endUpdate();
 		}
 	}
 
-	if (viewEntities_map_.size() > 0 || pEntity_->isControlledNotSelfClient())
+	if (pEntity_ == pEntity && (updateScripts_ & UPDATE_SCRIPT_END) > 0)
+		callUpdateScript_("onUpdateEnd");
+
+	Py_DECREF(pEntity);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool Witness::hasUpdateScripts()
+{
+	if (updateScripts_ < 0)
 	{
-		Network::Bundle* pSendBundle = pChannel->createSendBundle();
-		
-		// Is there any data in the current pSendBundle, if there is data indicating that the bundle is a reused cached packet
-		bool isBufferedSendBundleMessageLength = pSendBundle->packets().size() > 0 ? true : 
-			(pSendBundle->pCurrPacket() && pSendBundle->pCurrPacket()->length() > 0);
-		
-		NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pEntity_->id(), (*pSendBundle));
-		addBaseDataToStream(pSendBundle);
+		updateScripts_ = 0;
 
-		VIEW_ENTITIES::iterator iter = viewEntities_.begin();
-		for(; iter != viewEntities_.end(); )
-		{
-			EntityRef* pEntityRef = (*iter);
-			
-			if((pEntityRef->flags() & ENTITYREF_FLAG_ENTER_CLIENT_PENDING) > 0)
-			{
-				// Use id here to find out that the entity is accidentally destroyed in the callback when entering View.
-				Entity* otherEntity = Cellapp::getSingleton().findEntity(pEntityRef->id());
-				if(otherEntity == NULL)
-				{
-					pEntityRef->pEntity(NULL);
-					_onLeaveView(pEntityRef);
-					viewEntities_map_.erase(pEntityRef->id());
-					EntityRef::reclaimPoolObject(pEntityRef);
-					iter = viewEntities_.erase(iter);
-					updateEntitiesAliasID();
-					continue;
-				}
-				
-				pEntityRef->removeflags(ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
+		if (PyObject_HasAttrString(pEntity_, "onUpdateBegin") > 0)
+			updateScripts_ |= UPDATE_SCRIPT_BEGIN;
 
-				MemoryStream* s1 = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
-				otherEntity->addPositionAndDirectionToStream(*s1, true);			
-				otherEntity->addClientDataToStream(s1, true);
-				
-				ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onUpdatePropertys, updatePropertys);
-				(*pSendBundle) << otherEntity->id();
-				(*pSendBundle).append(*s1);
-				MemoryStream::reclaimPoolObject(s1);
-				ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onUpdatePropertys, updatePropertys);
-				
-				ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onEntityEnterWorld, entityEnterWorld);
-				(*pSendBundle) << otherEntity->id();
-				otherEntity->pScriptModule()->addSmartUTypeToBundle(pSendBundle);
-				if(!otherEntity->isOnGround())
-					(*pSendBundle) << otherEntity->isOnGround();
+		if (PyObject_HasAttrString(pEntity_, "onUpdateEnd") > 0)
+			updateScripts_ |= UPDATE_SCRIPT_END;
+	}
 
-				ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onEntityEnterWorld, entityEnterWorld);
+	return updateScripts_ > 0;
+}
 
-				pEntityRef->flags(ENTITYREF_FLAG_NORMAL);
+//-------------------------------------------------------------------------------------
+void Witness::callUpdateScript_(const char* name)
+{
+	PyObject* pyResult = PyObject_CallMethod(pEntity_,
+		const_cast<char*>(name),
+		const_cast<char*>(""));
 
-				OURO_ASSERT(clientViewSize_ != 65535);
+	if (pyResult != NULL)
+	{
+		Py_DECREF(pyResult);
+	}
+	else
+	{
+		SCRIPT_ERROR_CHECK();
+	}
+}
 
-				++clientViewSize_;
-			}
-			else if((pEntityRef->flags() & ENTITYREF_FLAG_LEAVE_CLIENT_PENDING) > 0)
-			{
-				pEntityRef->removeflags(ENTITYREF_FLAG_LEAVE_CLIENT_PENDING);
+//-------------------------------------------------------------------------------------
+bool Witness::beginUpdate(bool deferred)
+{
+	Network::Channel* pChannel = this->pChannel();
+	if(!pChannel)
+		return false;
 
-				if((pEntityRef->flags() & ENTITYREF_FLAG_NORMAL) > 0)
-				{
-					ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
-					_addViewEntityIDToBundle(pSendBundle, pEntityRef);
-					ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
-					
-					OURO_ASSERT(clientViewSize_ > 0);
-					--clientViewSize_;
-				}
+	if (viewEntities_map_.size() == 0 && !pEntity_->isControlledNotSelfClient())
+		return false;
 
-				viewEntities_map_.erase(pEntityRef->id());
-				EntityRef::reclaimPoolObject(pEntityRef);
-				iter = viewEntities_.erase(iter);
-				updateEntitiesAliasID();
-				continue;
-			}
-			else
+	Network::Bundle* pSendBundle = NULL;
+
+	if (deferred)
+	{
+		// The cached bundle of the channel holds earlier messages, everything sent to the client until the
+		// WitnessUpdater gets here would overtake them
+		pSendBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		pSendBundle->pChannel(pChannel);
+		isBufferedUpdateBundle_ = false;
+	}
+	else
+	{
+		pSendBundle = pChannel->createSendBundle();
+
+		// Is there any data in the current pSendBundle, if there is data indicating that the bundle is a reused cached packet
+		isBufferedUpdateBundle_ = pSendBundle->packets().size() > 0 ? true : 
+			(pSendBundle->pCurrPacket() && pSendBundle->pCurrPacket()->length() > 0);
+	}
+	
+	pUpdateBundle_ = pSendBundle;
+	updateEntities_.clear();
+
+	NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pEntity_->id(), (*pSendBundle));
+	addBaseDataToStream(pSendBundle);
+
+	// Removed entities are swapped with the last one, which is visited next
+	for(size_t i = 0; i < viewEntities_.size(); )
+	{
+		EntityRef* pEntityRef = viewEntities_[i];
+		
+		if((pEntityRef->flags() & ENTITYREF_FLAG_ENTER_CLIENT_PENDING) > 0)
+		{
+			// Use id here to find out that the entity is accidentally destroyed in the callback when entering View.
+			Entity* otherEntity = Cellapp::getSingleton().findEntity(pEntityRef->id());
+			if(otherEntity == NULL)
 			{
-				Entity* otherEntity = pEntityRef->pEntity();
-				if(otherEntity == NULL)
-				{
-					viewEntities_map_.erase(pEntityRef->id());
-					EntityRef::reclaimPoolObject(pEntityRef);
-					iter = viewEntities_.erase(iter);
-					OURO_ASSERT(clientViewSize_ > 0);
-					--clientViewSize_;
-					updateEntitiesAliasID();
-					continue;
-				}
-				
-				OURO_ASSERT(pEntityRef->flags() == ENTITYREF_FLAG_NORMAL);
-				
-				addUpdateToStream(pSendBundle, getEntityVolatileDataUpdateFlags(otherEntity), pEntityRef);
+				pEntityRef->pEntity(NULL);
+				_onLeaveView(pEntityRef);
+				removeViewEntity_(i);
+				continue;
 			}
+			
+			pEntityRef->removeflags(ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
 
-			++iter;
-		}
+			MemoryStream* s1 = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+			otherEntity->addPositionAndDirectionToStream(*s1, true);			
+			otherEntity->addClientDataToStream(s1, true);
+			
+			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onUpdatePropertys, updatePropertys);
+			(*pSendBundle) << otherEntity->id();
+			(*pSendBundle).append(*s1);
+			MemoryStream::reclaimPoolObject(s1);
+			ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onUpdatePropertys, updatePropertys);
+			
+			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onEntityEnterWorld, entityEnterWorld);
+			(*pSendBundle) << otherEntity->id();
+			otherEntity->pScriptModule()->addSmartUTypeToBundle(pSendBundle);
+			if(!otherEntity->isOnGround())
+				(*pSendBundle) << otherEntity->isOnGround();
 
-		size_t pSendBundleMessageLength = pSendBundle->currMsgLength();
-				if (pSendBundleMessageLength > 8/*Base package size generated by NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN*/)
+			ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onEntityEnterWorld, entityEnterWorld);
+
+			pEntityRef->flags(ENTITYREF_FLAG_NORMAL);
+			allocAliasID_(pEntityRef);
+
+			OURO_ASSERT(clientViewSize_ != 65535);
+
+			++clientViewSize_;
+		}
+		else if((pEntityRef->flags() & ENTITYREF_FLAG_LEAVE_CLIENT_PENDING) > 0)
 		{
-			if(pSendBundleMessageLength > PACKET_MAX_SIZE_TCP)
+			pEntityRef->removeflags(ENTITYREF_FLAG_LEAVE_CLIENT_PENDING);
+
+			if((pEntityRef->flags() & ENTITYREF_FLAG_NORMAL) > 0)
 			{
-				WARNING_MSG(fmt::format("Witness::update({}): sendToClient {} Bytes.\n", 
-					pEntity_->id(), pSendBundleMessageLength));
+				ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
+				_addViewEntityIDToBundle(pSendBundle, pEntityRef);
+				ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
+				
+				OURO_ASSERT(clientViewSize_ > 0);
+				--clientViewSize_;
 			}
 
-			AUTO_SCOPED_PROFILE("sendToClient");
-			pChannel->send(pSendBundle);
+			removeViewEntity_(i);
+			continue;
 		}
 		else
 		{
-			// If the bundle is a channel cached package
-			// Take it out and reuse it if you want to discard this message.
-			// NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN should be erased from it at this point
-			if(isBufferedSendBundleMessageLength)
+			Entity* otherEntity = pEntityRef->pEntity();
+			if(otherEntity == NULL)
 			{
-				OURO_ASSERT(pSendBundleMessageLength == 8);
-				pSendBundle->revokeMessage(8);
-				pChannel->pushBundle(pSendBundle);
-			}
-			else
-			{
-				Network::Bundle::reclaimPoolObject(pSendBundle);
+				// The client still has the entity, it has to free the slot as well
+				ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
+				_addViewEntityIDToBundle(pSendBundle, pEntityRef);
+				ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
+
+				OURO_ASSERT(clientViewSize_ > 0);
+				--clientViewSize_;
+				removeViewEntity_(i);
+				continue;
 			}
+			
+			OURO_ASSERT(pEntityRef->flags() == ENTITYREF_FLAG_NORMAL);
+			
+			// Written by updateViewEntities, the entities that just entered are updated from the next tick on
+			updateEntities_.push_back(pEntityRef);
 		}
+
+		++i;
 	}
 
-	static bool notificationScriptEnd = PyObject_HasAttrString(pEntity_, "onUpdateEnd") > 0;
-	if (notificationScriptEnd)
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::updateViewEntities()
+{
+	// Only reads the entities and writes the own bundle, no scripts and no shared state
+	std::vector<EntityRef*>::iterator iter = updateEntities_.begin();
+	for(; iter != updateEntities_.end(); ++iter)
 	{
-		PyObject* pyResult = PyObject_CallMethod(pEntity_,
-			const_cast<char*>("onUpdateEnd"),
-			const_cast<char*>(""));
+		EntityRef* pEntityRef = (*iter);
+		Entity* otherEntity = pEntityRef->pEntity();
 
-		if (pyResult != NULL)
+		// Destroyed by the scripts of a witness updated after beginUpdate
+		if(otherEntity == NULL || pEntityRef->flags() != ENTITYREF_FLAG_NORMAL)
+			continue;
+
+		addUpdateToStream(pUpdateBundle_, getEntityVolatileDataUpdateFlags(otherEntity), pEntityRef);
+	}
+
+	updateEntities_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::endUpdate()
+{
+	Network::Bundle* pSendBundle = pUpdateBundle_;
+	if(pSendBundle == NULL)
+		return;
+
+	pUpdateBundle_ = NULL;
+	updateEntities_.clear();
+
+	Network::Channel* pChannel = this->pChannel();
+	if(!pChannel)
+	{
+		Network::Bundle::reclaimPoolObject(pSendBundle);
+		return;
+	}
+
+	size_t pSendBundleMessageLength = pSendBundle->currMsgLength();
+	if (pSendBundleMessageLength > 8/*Base package size generated by NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN*/)
+	{
+		if(pSendBundleMessageLength > PACKET_MAX_SIZE_TCP)
+		{
+			WARNING_MSG(fmt::format("Witness::update({}): sendToClient {} Bytes.\n", 
+				pEntity_->id(), pSendBundleMessageLength));
+		}
+
+		AUTO_SCOPED_PROFILE("sendToClient");
+		pChannel->send(pSendBundle);
+	}
+	else
+	{
+		// If the bundle is a channel cached package
+		// Take it out and reuse it if you want to discard this message.
+		// NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN should be erased from it at this point
+		if(isBufferedUpdateBundle_)
 		{
-			Py_DECREF(pyResult);
+			OURO_ASSERT(pSendBundleMessageLength == 8);
+			pSendBundle->revokeMessage(8);
+			pChannel->pushBundle(pSendBundle);
 		}
 		else
 		{
-			SCRIPT_ERROR_CHECK();
+			Network::Bundle::reclaimPoolObject(pSendBundle);
 		}
 	}
+}
 
-	Py_DECREF(pEntity_);
-	return true;
+//-------------------------------------------------------------------------------------
+void Witness::flushUpdate_()
+{
+	if(pUpdateBundle_ == NULL)
+		return;
+
+	// Sent without the position updates, the client gets the messages in the order they were written
+	Cellapp::getSingleton().witnessUpdater().remove(this);
+	endUpdate();
 }
 
 //-------------------------------------------------------------------------------------
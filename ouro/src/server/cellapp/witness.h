@@ -61,19 +61,26 @@ struct WitnessInfo
 class Witness : public PoolObject, public Updatable
 {
 public:
-	typedef std::list<EntityRef*> VIEW_ENTITIES;
-	typedef std::map<ENTITY_ID, EntityRef*> VIEW_ENTITIES_MAP;
+	typedef std::vector<EntityRef*> VIEW_ENTITIES;
+	typedef OUROUnordered_map<ENTITY_ID, EntityRef*> VIEW_ENTITIES_MAP;
 
 	Witness();
 	~Witness();
 	
 	virtual uint8 updatePriority() const {
-		return 1;
+		return UPDATE_PRIORITY_WITNESS;
 	}
 
 	void addToStream(Ouroboros::MemoryStream& s);
 	void createFromStream(Ouroboros::MemoryStream& s);
 
+	/**
+		The entities the client has, a space migration moves them along with the space so the client keeps them.
+		createViewFromStream must run after all entities of the space exist.
+	*/
+	void addViewToStream(Ouroboros::MemoryStream& s);
+	void createViewFromStream(Ouroboros::MemoryStream& s);
+
 	typedef OUROShared_ptr< SmartPoolObject< Witness > > SmartPoolObjectPtr;
 	static SmartPoolObjectPtr createSmartPoolObj(const std::string& logPoint);
 
@@ -88,7 +95,8 @@ public:
 		size_t bytes = sizeof(pEntity_)
 		 + sizeof(viewRadius_) + sizeof(viewHysteresisArea_)
 		 + sizeof(pViewTrigger_) + sizeof(pViewHysteresisAreaTrigger_) + sizeof(clientViewSize_)
-		 + sizeof(lastBasePos_) + (sizeof(EntityRef*) * viewEntities_map_.size());
+		 + sizeof(lastBasePos_) + (sizeof(EntityRef*) * (viewEntities_.capacity() + aliasSlots_.capacity()))
+		 + (sizeof(int) * freeAliasIDs_.capacity());
 
 		return bytes;
 	}
@@ -120,6 +128,22 @@ public:
 	INLINE const Direction3D& baseDir();
 
 	bool update();
+
+	/**
+		The update of a tick in three steps, the WitnessUpdater runs updateViewEntities of the witnesses on its threads:
+		beginUpdate(main thread): base data and the entities entering and leaving the view, false if nothing is sent.
+			A deferred update is written into a bundle of its own, not into the cached bundle of the channel
+		updateViewEntities(any thread): the position and direction updates of the other view entities
+		endUpdate(main thread): sends the bundle
+	*/
+	bool beginUpdate(bool deferred);
+	void updateViewEntities();
+	void endUpdate();
+
+	/**
+		Whether the entity has onUpdateBegin or onUpdateEnd, such witnesses are updated by the main thread at once
+	*/
+	bool hasUpdateScripts();
 	
 	void onEnterSpace(SpaceMemory* pSpace);
 	void onLeaveSpace(SpaceMemory* pSpace);
@@ -137,7 +161,12 @@ public:
 	const Network::MessageHandler& getViewEntityMessageHandler(const Network::MessageHandler& normalMsgHandler, 
 											   const Network::MessageHandler& optimizedMsgHandler, ENTITY_ID entityID, int& ialiasID);
 
-	bool entityID2AliasID(ENTITY_ID id, uint8& aliasID);
+	bool entityID2AliasID(ENTITY_ID id, uint16& aliasID);
+
+	/**
+		Writes an aliasID got from getViewEntityMessageHandler, 1 or 2 bytes depending on the alias slots the client has
+	*/
+	void addViewEntityAliasIDToBundle(Network::Bundle* pBundle, int aliasID);
 
 	/**
 		Which protocol is used to update the client
@@ -175,16 +204,39 @@ public:
 	*/
 	void resetViewEntities();
 
+	/**
+		The size of the aliasIDs sent to the client, 1 or 2 bytes, 0 if the entityIDs are sent.
+		Decided by the number of alias slots, the client keeps the same slots(see ClientObjectBase::getViewEntityIDFromStream)
+	*/
+	INLINE uint8 aliasIDSize() const;
+
 private:
 	/**
-		if the number of entities in the view is less than 256, only the index position is sent.
+		Sends the alias slot of the entity instead of the entityID if the client has the entity
 	*/
 	INLINE void _addViewEntityIDToBundle(Network::Bundle* pBundle, EntityRef* pEntityRef);
 	
 	/**
-		Need to update the aliasID of the entityRef when the view list has changed when the update is executed.
+		The client gives an entity the lowest free slot when it enters the world and frees it when it leaves,
+		the slots at the end are dropped. The witness does the same in the same order, so an entity keeps
+		its aliasID the whole time it is in the view.
 	*/
-	void updateEntitiesAliasID();
+	void allocAliasID_(EntityRef* pEntityRef);
+	void freeAliasID_(EntityRef* pEntityRef);
+	void clearAliasIDs_();
+
+	/* Rebuilds the slots from the aliasIDs of the view entities after they were restored from a stream */
+	void restoreAliasIDs_();
+
+	/* Swaps the last view entity into the place of the removed one */
+	void removeViewEntity_(size_t idx);
+
+	/* Calls onUpdateBegin or onUpdateEnd of the entity */
+	void callUpdateScript_(const char* name);
+
+	/* Sends what beginUpdate wrote before anything else is sent to the client or the view is cleared,
+	   if the WitnessUpdater has not got to the witness yet */
+	void flushUpdate_();
 		
 private:
 	Entity*									pEntity_;
@@ -200,10 +252,23 @@ private:
 	VIEW_ENTITIES							viewEntities_;
 	VIEW_ENTITIES_MAP						viewEntities_map_;
 
+	// aliasID -> the entity the client has in the slot, NULL if free
+	std::vector<EntityRef*>					aliasSlots_;
+	// Min-heap of the free slots below aliasSlots_.size()
+	std::vector<int>						freeAliasIDs_;
+
 	Position3D								lastBasePos_;
 	Direction3D								lastBaseDir_;
 
 	uint16									clientViewSize_;
+
+	// Written between beginUpdate and endUpdate
+	Network::Bundle*						pUpdateBundle_;
+	bool									isBufferedUpdateBundle_;
+	std::vector<EntityRef*>					updateEntities_;
+
+	// Which of onUpdateBegin and onUpdateEnd the entity has, -1 if it was not looked up yet
+	int8									updateScripts_;
 };
 
 }
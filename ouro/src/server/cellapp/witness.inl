@@ -63,6 +63,18 @@ INLINE ViewTrigger* Witness::pViewHysteresisAreaTrigger()
 	return pViewHysteresisAreaTrigger_;
 }
 
+//-------------------------------------------------------------------------------------
+INLINE uint8 Witness::aliasIDSize() const
+{
+	if (aliasSlots_.size() <= 256)
+		return 1;
+
+	if (aliasSlots_.size() <= 65536)
+		return 2;
+
+	return 0;
+}
+
 //-------------------------------------------------------------------------------------
 INLINE Witness::VIEW_ENTITIES_MAP& Witness::viewEntitiesMap()
 { 
@@ -0,0 +1,236 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "witness_updater.h"
+#include "witness.h"
+#include "network/bundle.h"
+#include "network/tcp_packet.h"
+#include "network/udp_packet.h"
+#include "helper/profile.h"
+#include "thread/threadmutex.h"
+
+namespace Ouroboros{
+
+//-------------------------------------------------------------------------------------
+template<typename T>
+static void makeThreadSafe(ObjectPool<T>& pool)
+{
+	// Already shared with the network I/O threads
+	if (dynamic_cast<thread::ThreadMutex*>(pool.pMutex()) == NULL)
+		pool.pMutex(new thread::ThreadMutex());
+}
+
+//-------------------------------------------------------------------------------------
+WitnessUpdater::WitnessUpdater():
+batch_(),
+workers_(),
+mutex_(),
+startCond_(),
+doneCond_(),
+generation_(0),
+running_(false),
+next_(0),
+busy_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+WitnessUpdater::~WitnessUpdater()
+{
+	finalise();
+}
+
+//-------------------------------------------------------------------------------------
+bool WitnessUpdater::initialize(uint32 numThreads)
+{
+	if (numThreads == 0)
+		return true;
+
+	// The bundles of the witnesses get their packets from the pools on every thread
+	makeThreadSafe(Network::Bundle::ObjPool());
+	makeThreadSafe(Network::TCPPacket::ObjPool());
+	makeThreadSafe(Network::UDPPacket::ObjPool());
+	makeThreadSafe(MemoryStream::ObjPool());
+
+	running_ = true;
+
+	for (uint32 i = 0; i < numThreads; ++i)
+	{
+		Worker* pWorker = new Worker();
+		pWorker->pUpdater = this;
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+		pWorker->tid = (THREAD_ID)_beginthreadex(NULL, 0, &WitnessUpdater::threadFunc, (void*)pWorker, 0, NULL);
+		bool started = pWorker->tid != 0;
+#else
+		bool started = pthread_create(&pWorker->tid, NULL, WitnessUpdater::threadFunc, (void*)pWorker) == 0;
+#endif
+
+		if (!started)
+		{
+			ERROR_MSG(fmt::format("WitnessUpdater::initialize: couldn't start thread({})!\n", i));
+			delete pWorker;
+			finalise();
+			return false;
+		}
+
+		workers_.push_back(pWorker);
+	}
+
+	INFO_MSG(fmt::format("WitnessUpdater::initialize: {} witness update threads.\n", numThreads));
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void WitnessUpdater::finalise()
+{
+	batch_.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		running_ = false;
+	}
+
+	startCond_.notify_all();
+
+	std::vector<Worker*>::iterator iter = workers_.begin();
+	for (; iter != workers_.end(); ++iter)
+	{
+#if OURO_PLATFORM == PLATFORM_WIN32
+		if (WaitForSingleObject((*iter)->tid, INFINITE) == WAIT_OBJECT_0)
+			CloseHandle((*iter)->tid);
+#else
+		pthread_join((*iter)->tid, NULL);
+#endif
+
+		delete (*iter);
+	}
+
+	workers_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void WitnessUpdater::push(Witness* pWitness)
+{
+	batch_.push_back(pWitness);
+}
+
+//-------------------------------------------------------------------------------------
+void WitnessUpdater::remove(Witness* pWitness)
+{
+	std::vector<Witness*>::iterator iter = std::find(batch_.begin(), batch_.end(), pWitness);
+	if (iter != batch_.end())
+		(*iter) = NULL;
+}
+
+//-------------------------------------------------------------------------------------
+void WitnessUpdater::process()
+{
+	if (batch_.empty())
+		return;
+
+	AUTO_SCOPED_PROFILE("witnessUpdater");
+
+	next_.store(0, std::memory_order_relaxed);
+
+	if (batch_.size() > 1 && !workers_.empty())
+	{
+		busy_.store((uint32)workers_.size(), std::memory_order_relaxed);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			++generation_;
+		}
+
+		startCond_.notify_all();
+		updateViewEntities_();
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		doneCond_.wait(lock, [this]{ return busy_.load(std::memory_order_acquire) == 0; });
+	}
+	else
+	{
+		updateViewEntities_();
+	}
+
+	std::vector<Worker*>::iterator iter = workers_.begin();
+	for (; iter != workers_.end(); ++iter)
+		Network::NetworkStats::getSingleton().flush((*iter)->deferred);
+
+	// Sent in the order the witnesses were updated
+	for (size_t i = 0; i < batch_.size(); ++i)
+	{
+		if (batch_[i])
+			batch_[i]->endUpdate();
+	}
+
+	batch_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void WitnessUpdater::updateViewEntities_()
+{
+	const size_t size = batch_.size();
+
+	while (true)
+	{
+		size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+		if (i >= size)
+			break;
+
+		if (batch_[i])
+			batch_[i]->updateViewEntities();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void WitnessUpdater::run_(Worker* pWorker)
+{
+	g_profileDisabledThread = true;
+	Network::NetworkStats::deferMessages(&pWorker->deferred);
+
+	uint32 generation = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			startCond_.wait(lock, [this, generation]{ return !running_ || generation_ != generation; });
+
+			if (!running_)
+				break;
+
+			generation = generation_;
+		}
+
+		updateViewEntities_();
+
+		if (busy_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			doneCond_.notify_one();
+		}
+	}
+
+	Network::NetworkStats::deferMessages(NULL);
+}
+
+//-------------------------------------------------------------------------------------
+#if OURO_PLATFORM == PLATFORM_WIN32
+unsigned __stdcall WitnessUpdater::threadFunc(void* arg)
+#else
+void* WitnessUpdater::threadFunc(void* arg)
+#endif
+{
+	Worker* pWorker = static_cast<Worker*>(arg);
+	pWorker->pUpdater->run_(pWorker);
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	return 0;
+#else
+	pthread_exit(NULL);
+	return NULL;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+}
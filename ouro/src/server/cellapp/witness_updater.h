@@ -0,0 +1,97 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_WITNESS_UPDATER_H
+#define OURO_WITNESS_UPDATER_H
+
+#include "common/common.h"
+#include "network/network_stats.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace Ouroboros{
+
+class Witness;
+
+/*
+	Writes the position and direction updates of the witnesses on several threads.
+
+	Witness::update runs on the main thread as before and writes everything that touches scripts or
+	other witnesses(base data, entities entering and leaving the view) into the bundle of the witness,
+	then hands the witness to the updater. After all witnesses were updated, process() lets the threads
+	and the main thread write the volatile updates of the collected witnesses, each witness into its own
+	bundle, and the main thread sends the bundles in the order the witnesses were collected.
+*/
+class WitnessUpdater
+{
+public:
+	WitnessUpdater();
+	~WitnessUpdater();
+
+	bool initialize(uint32 numThreads);
+	void finalise();
+
+	/**
+		Whether Witness::update hands the witnesses to the updater
+	*/
+	bool isParallel() const { return !workers_.empty(); }
+
+	void push(Witness* pWitness);
+
+	/**
+		A witness that is cleared before process() drops out of the batch
+	*/
+	void remove(Witness* pWitness);
+
+	/**
+		Called once per tick after the witnesses were updated
+	*/
+	void process();
+
+	size_t size() const { return batch_.size(); }
+
+private:
+	struct Worker
+	{
+		WitnessUpdater* pUpdater;
+		THREAD_ID tid;
+
+		// The messages written by the thread in this tick, see NetworkStats::deferMessages
+		Network::NetworkStats::DEFERRED_MESSAGES deferred;
+	};
+
+	/**
+		Takes witnesses of the batch until none is left, run by the threads and the main thread
+	*/
+	void updateViewEntities_();
+
+	void run_(Worker* pWorker);
+
+#if OURO_PLATFORM == PLATFORM_WIN32
+	static unsigned __stdcall threadFunc(void* arg);
+#else
+	static void* threadFunc(void* arg);
+#endif
+
+private:
+	std::vector<Witness*> batch_;
+	std::vector<Worker*> workers_;
+
+	std::mutex mutex_;
+	std::condition_variable startCond_;
+	std::condition_variable doneCond_;
+
+	// Both guarded by mutex_, a thread runs once for each generation
+	uint32 generation_;
+	bool running_;
+
+	// Next index of batch_ to be taken
+	std::atomic<size_t> next_;
+
+	// Threads that have not finished the current generation yet
+	std::atomic<uint32> busy_;
+};
+
+}
+
+#endif // OURO_WITNESS_UPDATER_H
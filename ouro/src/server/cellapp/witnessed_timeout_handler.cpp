@@ -35,17 +35,17 @@ void WitnessedTimeoutHandler::cancel()
 //-------------------------------------------------------------------------------------
 void WitnessedTimeoutHandler::handleTimeout(TimerHandle, void * arg)
 {
-	std::map<ENTITY_ID, uint16>::iterator iter = witnessedEntityIDs_.begin();
+	std::map<ENTITY_ID, WITNESSED>::iterator iter = witnessedEntityIDs_.begin();
 	for(; iter != witnessedEntityIDs_.end();)
 	{
-		if(iter->second > TICKSECS)
+		if(iter->second.timeout > TICKSECS)
 		{
-			iter->second -= TICKSECS;
+			iter->second.timeout -= TICKSECS;
 			iter++;
 		}
 		else
 		{
-			Entity* pEntity = Cellapp::getSingleton().findEntity(iter->first);
+			Entity* pEntity = Cellapp::getSingleton().pEntities()->find(iter->first, iter->second.generation);
 			
 			witnessedEntityIDs_.erase(iter++);
 
@@ -75,10 +75,9 @@ void WitnessedTimeoutHandler::addWitnessed(Entity* pEntity)
 		return;
 	}
 
-	if(witnessedEntityIDs_.find(pEntity->id()) != witnessedEntityIDs_.end())
-		witnessedEntityIDs_[pEntity->id()] = witness_timeout_dec;
-	else
-		witnessedEntityIDs_.insert(std::map<ENTITY_ID, uint16>::value_type(pEntity->id(), witness_timeout_dec));
+	WITNESSED& witnessed = witnessedEntityIDs_[pEntity->id()];
+	witnessed.timeout = witness_timeout_dec;
+	witnessed.generation = Cellapp::getSingleton().pEntities()->generation(pEntity->id());
 	
 	if(pTimerHandle_ == NULL)
 	{
@@ -94,7 +93,7 @@ void WitnessedTimeoutHandler::delWitnessed(Entity* pEntity)
 	if(witnessedEntityIDs_.size() == 0)
 		return;
 
-	std::map<ENTITY_ID, uint16>::iterator iter = witnessedEntityIDs_.find(pEntity->id());
+	std::map<ENTITY_ID, WITNESSED>::iterator iter = witnessedEntityIDs_.find(pEntity->id());
 
 	if(iter != witnessedEntityIDs_.end())
 	{
@@ -32,7 +32,15 @@ private:
 
 	void cancel();
 
-	std::map<ENTITY_ID, uint16>		witnessedEntityIDs_;
+	struct WITNESSED
+	{
+		uint16 timeout;
+
+		// The entity may be destroyed and its ID reused(e.g. by a ghost) before the timeout
+		uint32 generation;
+	};
+
+	std::map<ENTITY_ID, WITNESSED>	witnessedEntityIDs_;
 	TimerHandle* pTimerHandle_;
 };	
 
@@ -63,8 +63,19 @@ Cellappmgr::Cellappmgr(Network::EventDispatcher& dispatcher,
 	gameTimer_(),
 	forward_anywhere_cellapp_messagebuffer_(ninterface, CELLAPP_TYPE),
 	forward_cellapp_messagebuffer_(ninterface),
+	bestCellappID_(0),
+	loadPredictor_(),
 	cellapps_(),
-	cellapp_cids_()
+	cellapp_cids_(),
+	spaceViewers_(),
+	migratingSpaceID_(0),
+	migratingSourceCid_(0),
+	migratingTargetCid_(0),
+	migrationStartTime_(0),
+	lastMigrationTime_(timestamp()),
+	numSpacesMigrated_(0),
+	numSpaceMigrationsFailed_(0),
+	lastSpaceFreezeTime_(0.f)
 {
 	Ouroboros::Network::MessageHandlers::pMainMessageHandlers = &CellappmgrInterface::messageHandlers;
 }
@@ -98,6 +109,17 @@ void Cellappmgr::removeCellapp(COMPONENT_ID cid)
 			cid, (cellapps_.size() - 1)));
 
 		cellapps_.erase(iter);
+		loadPredictor_.remove(cid);
+
+		// The source rolls back or the target drops the prepared space by itself, this only frees the slot
+		if (migratingSourceCid_ > 0 && (migratingSourceCid_ == cid || migratingTargetCid_ == cid))
+		{
+			WARNING_MSG(fmt::format("Cellappmgr::removeCellapp: cellapp[{}] is gone while migrating space({}).\n",
+				cid, migratingSpaceID_));
+
+			++numSpaceMigrationsFailed_;
+			migratingSourceCid_ = 0;
+		}
 		
 		std::vector<COMPONENT_ID>::iterator viter = cellapp_cids_.begin();
 		for (; viter != cellapp_cids_.end(); ++viter)
@@ -137,7 +159,11 @@ void Cellappmgr::handleTimeout(TimerHandle handle, void * arg)
 	switch (reinterpret_cast<uintptr>(arg))
 	{
 		case TIMEOUT_GAME_TICK:
-			this->handleGameTick();
+			{
+				ScopedMetricsTimer metricsTimer(pTickHistogram_);
+				ScopedFlightTick flightTick;
+				this->handleGameTick();
+			}
 			break;
 		default:
 			break;
@@ -178,6 +204,9 @@ void Cellappmgr::handleGameTick()
 	++g_ourotime;
 	threadPool_.onMainThreadTick();
 	networkInterface().processChannels(&CellappmgrInterface::messageHandlers);
+
+	if (g_ourotime % 50 == 0)
+		checkSpaceMigration();
 }
 
 //-------------------------------------------------------------------------------------
@@ -200,6 +229,20 @@ bool Cellappmgr::initializeEnd()
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+bool Cellappmgr::initializeWatcher()
+{
+	WATCH_OBJECT("balance/assignSkew", this, &Cellappmgr::assignSkew);
+	WATCH_OBJECT("balance/numAssigned", this, &Cellappmgr::numAssigned);
+	WATCH_OBJECT("balance/entityCosts", this, &Cellappmgr::entityCosts);
+	WATCH_OBJECT("spaceMigration/migrating", this, &Cellappmgr::isMigratingSpace);
+	WATCH_OBJECT("spaceMigration/migrated", this, &Cellappmgr::numSpacesMigrated);
+	WATCH_OBJECT("spaceMigration/failed", this, &Cellappmgr::numSpaceMigrationsFailed);
+	WATCH_OBJECT("spaceMigration/lastFreezeTime", this, &Cellappmgr::lastSpaceFreezeTime);
+
+	return ServerApp::initializeWatcher();
+}
+
 //-------------------------------------------------------------------------------------
 void Cellappmgr::finalise()
 {
@@ -230,10 +273,7 @@ void Cellappmgr::forwardMessage(Network::Channel* pChannel, MemoryStream& s)
 COMPONENT_ID Cellappmgr::findFreeCellapp(void)
 {
 	std::map< COMPONENT_ID, Cellapp >::iterator iter = cellapps_.begin();
-	COMPONENT_ID cid = 0;
-
-	float minload = 1.f;
-	ENTITY_ID numEntities = 0x7fffffff;
+	std::vector<COMPONENT_ID> candidates;
 
 	for(; iter != cellapps_.end(); ++iter)
 	{
@@ -242,24 +282,25 @@ COMPONENT_ID Cellappmgr::findFreeCellapp(void)
 		
 		// First the process must be alive and initialized
 		if(!iter->second.isDestroyed() && iter->second.initProgress() > 1.f)
-		{
-			// unconditionally allocated if there are no entities
-			if(iter->second.numEntities() == 0)
-				return iter->first;
+			candidates.push_back(iter->first);
+	}
 
-			// Compare and record the least loaded process and eventually be assigned
-			if(minload > iter->second.load() || 
-				(minload == iter->second.load() && numEntities > iter->second.numEntities()))
-			{
-				cid = iter->first;
+	// The predicted load includes the spaces placed since the last report, so placements
+	// between two reports do not all land on the same cellapp
+	return loadPredictor_.choose(candidates);
+}
 
-				numEntities = iter->second.numEntities();
-				minload = iter->second.load();
-			}
-		}
-	}
+//-------------------------------------------------------------------------------------
+void Cellappmgr::onAssignCellapp(COMPONENT_ID cid, const std::string& entityType)
+{
+	std::map< COMPONENT_ID, Cellapp >::iterator iter = cellapps_.find(cid);
+	if (iter == cellapps_.end())
+		return;
+
+	// Increase the number of entities in advance
+	iter->second.incNumEntities();
 
-	return cid;
+	loadPredictor_.onAssign(cid, entityType);
 }
 
 //-------------------------------------------------------------------------------------
@@ -382,14 +423,11 @@ void Cellappmgr::reqCreateCellEntityInNewSpace(Network::Channel* pChannel, Memor
 	}
 
 	std::map< COMPONENT_ID, Cellapp >::iterator cellapp_iter = cellapps_.find(bestCellappID_);
-	DEBUG_MSG(fmt::format("Cellappmgr::reqCreateCellEntityInNewSpace: entityType={}, entityID={}, componentID={}, cellapp(cid={}, load={}, numEntities={}).\n",
-		entityType, id, componentID, bestCellappID_, cellapp_iter->second.load(), cellapp_iter->second.numEntities()));
+	DEBUG_MSG(fmt::format("Cellappmgr::reqCreateCellEntityInNewSpace: entityType={}, entityID={}, componentID={}, cellapp(cid={}, load={}, numEntities={}, predictedLoad={}).\n",
+		entityType, id, componentID, bestCellappID_, cellapp_iter->second.load(), cellapp_iter->second.numEntities(),
+		loadPredictor_.predictedLoad(bestCellappID_)));
 
-	// Increase the number of entities in advance
-	if (cellapp_iter != cellapps_.end())
-	{
-		cellapp_iter->second.incNumEntities();
-	}
+	onAssignCellapp(bestCellappID_, entityType);
 }
 
 //-------------------------------------------------------------------------------------
@@ -421,6 +459,8 @@ void Cellappmgr::reqRestoreSpaceInCell(Network::Channel* pChannel, MemoryStream&
 	DEBUG_MSG(fmt::format("Cellappmgr::reqRestoreSpaceInCell: entityType={0}, entityID={1}, componentID={2}, spaceID={3}.\n",
 		entityType, id, componentID, spaceID));
 
+	updateBestCellapp();
+
 	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(CELLAPP_TYPE, bestCellappID_);
 	if(cinfos == NULL || cinfos->pChannel == NULL || cinfos->state != COMPONENT_STATE_RUN)
 	{
@@ -436,12 +476,7 @@ void Cellappmgr::reqRestoreSpaceInCell(Network::Channel* pChannel, MemoryStream&
 		cinfos->pChannel->send(pBundle);
 	}
 
-	// Increase the number of entities in advance
-	std::map< COMPONENT_ID, Cellapp >::iterator cellapp_iter = cellapps_.find(bestCellappID_);
-	if (cellapp_iter != cellapps_.end())
-	{
-		cellapp_iter->second.incNumEntities();
-	}
+	onAssignCellapp(bestCellappID_, entityType);
 }
 
 //-------------------------------------------------------------------------------------
@@ -454,6 +489,8 @@ void Cellappmgr::updateCellapp(Network::Channel* pChannel, COMPONENT_ID componen
 	cellapp.numEntities(numEntities);
 	cellapp.flags(flags);
 
+	loadPredictor_.onReport(componentID, load, numEntities);
+
 	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(componentID);
 	if (cinfos)
 		cinfos->appFlags = flags;
@@ -635,4 +672,204 @@ void Cellappmgr::setSpaceViewer(Network::Channel* pChannel, MemoryStream& s)
 
 //-------------------------------------------------------------------------------------
 
+//-------------------------------------------------------------------------------------
+void Cellappmgr::reqMigrateSpace(Network::Channel* pChannel, MemoryStream& s)
+{
+	SPACE_ID spaceID;
+	COMPONENT_ID targetCid;
+
+	s >> spaceID >> targetCid;
+
+	COMPONENT_ID sourceCid = 0;
+
+	std::map< COMPONENT_ID, Cellapp >::iterator iter = cellapps_.begin();
+	for (; iter != cellapps_.end(); ++iter)
+	{
+		if (iter->second.spaces().getSpace(spaceID))
+		{
+			sourceCid = iter->first;
+			break;
+		}
+	}
+
+	if (sourceCid == 0)
+	{
+		ERROR_MSG(fmt::format("Cellappmgr::reqMigrateSpace: not found space({})!\n", spaceID));
+		return;
+	}
+
+	if (targetCid == 0)
+	{
+		float minLoad = 0.f;
+
+		for (iter = cellapps_.begin(); iter != cellapps_.end(); ++iter)
+		{
+			if (iter->first == sourceCid || iter->second.isDestroyed() || iter->second.initProgress() < 1.f)
+				continue;
+
+			if ((iter->second.flags() & APP_FLAGS_NOT_PARTCIPATING_LOAD_BALANCING) > 0)
+				continue;
+
+			float load = loadPredictor_.predictedLoad(iter->first);
+			if (targetCid == 0 || load < minLoad)
+			{
+				targetCid = iter->first;
+				minLoad = load;
+			}
+		}
+	}
+
+	migrateSpace(spaceID, sourceCid, targetCid);
+}
+
+//-------------------------------------------------------------------------------------
+bool Cellappmgr::migrateSpace(SPACE_ID spaceID, COMPONENT_ID sourceCid, COMPONENT_ID targetCid)
+{
+	if (migratingSourceCid_ > 0)
+	{
+		WARNING_MSG(fmt::format("Cellappmgr::migrateSpace: space({}) is still migrating, space({}) has to wait!\n",
+			migratingSpaceID_, spaceID));
+
+		return false;
+	}
+
+	if (sourceCid == targetCid || !componentReady(sourceCid) || !componentReady(targetCid))
+	{
+		ERROR_MSG(fmt::format("Cellappmgr::migrateSpace: can not migrate space({}) from cellapp({}) to cellapp({})!\n",
+			spaceID, sourceCid, targetCid));
+
+		return false;
+	}
+
+	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(CELLAPP_TYPE, sourceCid);
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(CellappInterface::reqMigrateSpace);
+	(*pBundle) << spaceID << targetCid;
+	cinfos->pChannel->send(pBundle);
+
+	migratingSpaceID_ = spaceID;
+	migratingSourceCid_ = sourceCid;
+	migratingTargetCid_ = targetCid;
+	migrationStartTime_ = timestamp();
+
+	INFO_MSG(fmt::format("Cellappmgr::migrateSpace: space({}) from cellapp({}) to cellapp({}).\n",
+		spaceID, sourceCid, targetCid));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void Cellappmgr::onSpaceMigrated(Network::Channel* pChannel, MemoryStream& s)
+{
+	SPACE_ID spaceID;
+	COMPONENT_ID sourceCid, targetCid;
+	bool success;
+	uint32 numEntities;
+	float freezeTime;
+
+	s >> spaceID >> sourceCid >> targetCid >> success >> numEntities >> freezeTime;
+
+	// spaceID may differ from the request, with spaceID 0 the source picks the space itself
+	if (migratingSourceCid_ == sourceCid)
+		migratingSourceCid_ = 0;
+
+	lastMigrationTime_ = timestamp();
+
+	if (!success)
+	{
+		++numSpaceMigrationsFailed_;
+		return;
+	}
+
+	++numSpacesMigrated_;
+	lastSpaceFreezeTime_ = freezeTime;
+
+	std::map< COMPONENT_ID, Cellapp >::iterator siter = cellapps_.find(sourceCid);
+	std::map< COMPONENT_ID, Cellapp >::iterator titer = cellapps_.find(targetCid);
+
+	// The load reports follow, until then the entities count on the target
+	if (siter != cellapps_.end())
+	{
+		Space* pSpace = siter->second.spaces().getSpace(spaceID);
+		if (pSpace && titer != cellapps_.end())
+			titer->second.spaces().updateSpaceData(spaceID, pSpace->getScriptModuleName(), pSpace->getGeomappingPath(), false);
+
+		siter->second.spaces().updateSpaceData(spaceID, "", "", true);
+		siter->second.numEntities(siter->second.numEntities() > (ENTITY_ID)numEntities ? siter->second.numEntities() - numEntities : 0);
+	}
+
+	if (titer != cellapps_.end())
+		titer->second.numEntities(titer->second.numEntities() + numEntities);
+}
+
+//-------------------------------------------------------------------------------------
+void Cellappmgr::checkSpaceMigration()
+{
+	const SpaceMigration_Config& config = g_ouroSrvConfig.getCellAppMgr().spaceMigration;
+	if (!config.enable)
+		return;
+
+	TimeStamp now = timestamp();
+
+	if (migratingSourceCid_ > 0)
+	{
+		// The cellapps give up by themselves, this only frees the slot if the report was lost
+		if (double(now - migrationStartTime_) / stampsPerSecondD() >= config.timeout * 3.f)
+		{
+			WARNING_MSG(fmt::format("Cellappmgr::checkSpaceMigration: space({}) migration timed out.\n",
+				migratingSpaceID_));
+
+			++numSpaceMigrationsFailed_;
+			migratingSourceCid_ = 0;
+			lastMigrationTime_ = now;
+		}
+
+		return;
+	}
+
+	if (double(now - lastMigrationTime_) / stampsPerSecondD() < config.period)
+		return;
+
+	COMPONENT_ID busiestCid = 0, idlestCid = 0;
+	float maxLoad = 0.f, minLoad = 0.f;
+
+	std::map< COMPONENT_ID, Cellapp >::iterator iter = cellapps_.begin();
+	for (; iter != cellapps_.end(); ++iter)
+	{
+		Cellapp& cellapp = iter->second;
+
+		if ((cellapp.flags() & APP_FLAGS_NOT_PARTCIPATING_LOAD_BALANCING) > 0)
+			continue;
+
+		if (cellapp.isDestroyed() || cellapp.initProgress() < 1.f || !componentReady(iter->first))
+			continue;
+
+		// The reported load for the source, placements since the last report do not make it busier yet
+		if (cellapp.numSpaces() >= 2 && (busiestCid == 0 || cellapp.load() > maxLoad))
+		{
+			busiestCid = iter->first;
+			maxLoad = cellapp.load();
+		}
+
+		float load = loadPredictor_.predictedLoad(iter->first);
+		if (idlestCid == 0 || load < minLoad)
+		{
+			idlestCid = iter->first;
+			minLoad = load;
+		}
+	}
+
+	if (busiestCid == 0 || idlestCid == 0 || busiestCid == idlestCid)
+		return;
+
+	if (maxLoad < config.minLoad || maxLoad - minLoad < config.loadDiff)
+		return;
+
+	// The source picks the space that fits best
+	if (migrateSpace(0, busiestCid, idlestCid))
+		lastMigrationTime_ = now;
+}
+
+//-------------------------------------------------------------------------------------
 }
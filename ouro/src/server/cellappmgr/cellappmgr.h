@@ -11,7 +11,9 @@
 #include "server/idallocate.h"
 #include "server/serverconfig.h"
 #include "server/forward_messagebuffer.h"
+#include "server/load_predictor.h"
 #include "common/timer.h"
+#include "common/timestamp.h"
 #include "network/endpoint.h"
 
 namespace Ouroboros{
@@ -46,10 +48,21 @@ public:
 	bool initializeEnd();
 	void finalise();
 
+	virtual bool initializeWatcher();
+
 		/** Find one of the most idle cellapps*/
 	COMPONENT_ID findFreeCellapp(void);
 	void updateBestCellapp();
 
+	/**
+		Counts an entity placed on a cellapp in its predicted load until the cellapp reports again
+	*/
+	void onAssignCellapp(COMPONENT_ID cid, const std::string& entityType);
+
+	float assignSkew() const { return loadPredictor_.assignSkew(); }
+	uint32 numAssigned() const { return loadPredictor_.numAssigned(); }
+	std::string entityCosts() const { return loadPredictor_.costsToString(); }
+
 		/** Network Interface
 		baseEntity request is created in a new space
 	*/
@@ -114,6 +127,28 @@ public:
 	*/
 	void setSpaceViewer(Network::Channel* pChannel, MemoryStream& s);
 
+	/** Network Interface
+	Request to move a space to another cellapp, targetCid 0 picks the most idle cellapp
+	*/
+	void reqMigrateSpace(Network::Channel* pChannel, MemoryStream& s);
+
+	/** Network Interface
+	The source cellapp reports the end of a space migration
+	*/
+	void onSpaceMigrated(Network::Channel* pChannel, MemoryStream& s);
+
+	bool migrateSpace(SPACE_ID spaceID, COMPONENT_ID sourceCid, COMPONENT_ID targetCid);
+
+	/**
+		Moves a space from the busiest cellapp to the most idle one if their loads are too far apart
+	*/
+	void checkSpaceMigration();
+
+	uint32 numSpacesMigrated() const { return numSpacesMigrated_; }
+	uint32 numSpaceMigrationsFailed() const { return numSpaceMigrationsFailed_; }
+	float lastSpaceFreezeTime() const { return lastSpaceFreezeTime_; }
+	bool isMigratingSpace() const { return migratingSourceCid_ > 0; }
+
 protected:
 	TimerHandle							gameTimer_;
 	ForwardAnywhere_MessageBuffer		forward_anywhere_cellapp_messagebuffer_;
@@ -121,11 +156,24 @@ protected:
 
 	COMPONENT_ID						bestCellappID_;
 
+	LoadPredictor						loadPredictor_;
+
 	std::map< COMPONENT_ID, Cellapp >	cellapps_;
 	std::vector<COMPONENT_ID>			cellapp_cids_;
 
 	// View space by tool
 	SpaceViewers						spaceViewers_;
+
+	// The space being migrated, only one at a time, migratingSourceCid_ 0 if none
+	SPACE_ID							migratingSpaceID_;
+	COMPONENT_ID						migratingSourceCid_;
+	COMPONENT_ID						migratingTargetCid_;
+	TimeStamp							migrationStartTime_;
+	TimeStamp							lastMigrationTime_;
+
+	uint32								numSpacesMigrated_;
+	uint32								numSpaceMigrationsFailed_;
+	float								lastSpaceFreezeTime_;
 };
 
 } 
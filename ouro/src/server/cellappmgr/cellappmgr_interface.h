@@ -100,6 +100,12 @@ NETWORK_INTERFACE_DECLARE_BEGIN(CellappmgrInterface)
 	// The tool requests to change the space viewer (with add and delete functions)
 	CELLAPPMGR_MESSAGE_DECLARE_STREAM(setSpaceViewer,						NETWORK_VARIABLE_MESSAGE)
 
+	// Request to move a space to another cellapp(tools, scripts)
+	CELLAPPMGR_MESSAGE_DECLARE_STREAM(reqMigrateSpace,						NETWORK_VARIABLE_MESSAGE)
+
+	// The source cellapp reports the end of a space migration
+	CELLAPPMGR_MESSAGE_DECLARE_STREAM(onSpaceMigrated,						NETWORK_VARIABLE_MESSAGE)
+
 NETWORK_INTERFACE_DECLARE_END()
 
 #ifdef DEFINE_IN_INTERFACE
@@ -183,6 +183,15 @@ bool Dbmgr::initializeWatcher()
 	return ServerApp::initializeWatcher() && DBUtil::initializeWatcher();
 }
 
+//-------------------------------------------------------------------------------------
+bool Dbmgr::initializeMetrics()
+{
+	if(!ServerApp::initializeMetrics())
+		return false;
+
+	return g_ouroSrvConfig.metricsEnable() ? DBUtil::initializeMetrics() : true;
+}
+
 //-------------------------------------------------------------------------------------
 bool Dbmgr::run()
 {
@@ -197,7 +206,11 @@ void Dbmgr::handleTimeout(TimerHandle handle, void * arg)
 	switch (reinterpret_cast<uintptr>(arg))
 	{
 		case TIMEOUT_TICK:
-			this->handleMainTick();
+			{
+				ScopedMetricsTimer metricsTimer(pTickHistogram_);
+				ScopedFlightTick flightTick;
+				this->handleMainTick();
+			}
 			break;
 		case TIMEOUT_CHECK_STATUS:
 			this->handleCheckStatusTick();
@@ -172,6 +172,7 @@ public:
 	void syncEntityStreamTemplate(Network::Channel* pChannel, Ouroboros::MemoryStream& s);
 
 	virtual bool initializeWatcher();
+	virtual bool initializeMetrics();
 
 		/** Network Interface
 		Request recharge
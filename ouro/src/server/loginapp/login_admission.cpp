@@ -0,0 +1,384 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#include "loginapp.h"
+#include "login_admission.h"
+#include "network/bundle.h"
+#include "network/channel.h"
+#include "network/network_interface.h"
+#include "client_lib/client_interface.h"
+
+namespace Ouroboros{
+
+// Multiplier of the rate per second while something is overloaded, and the share of maxRate added per second otherwise
+static const float RATE_DECREASE = 0.7f;
+static const float RATE_INCREASE = 0.1f;
+
+// Weight of a new sample in the average answer time of dbmgr
+static const float LATENCY_SMOOTHING = 0.1f;
+
+// dbmgr requests that were never answered(the client went away, dbmgr dropped the request) are forgotten after this
+static const float PENDING_TIMEOUT = 120.f;
+
+static const float EXPIRE_PERIOD = 10.f;
+
+//-------------------------------------------------------------------------------------
+LoginAdmission::LoginAdmission(Network::NetworkInterface& networkInterface):
+networkInterface_(networkInterface),
+config_(g_ouroSrvConfig.getLoginApp().loginAdmission),
+rate_(config_.maxRate),
+tokens_(float(config_.burst)),
+lastRefillTime_(timestamp()),
+lastRateTime_(lastRefillTime_),
+lastPositionTime_(lastRefillTime_),
+lastExpireTime_(lastRefillTime_),
+reconnectQueue_(),
+queue_(),
+queued_(),
+seq_(0),
+numReconnects_(0),
+dbmgrPending_(),
+dbmgrLatency_(0.f),
+baseappLoad_(0.f),
+onlineAccounts_(),
+numAdmitted_(0),
+numQueued_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+LoginAdmission::~LoginAdmission()
+{
+	OUROUnordered_map<std::string, QUEUED>::iterator iter = queued_.begin();
+	for (; iter != queued_.end(); ++iter)
+		delete iter->second.pInfos;
+
+	queued_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+bool LoginAdmission::acquire(Network::Channel* pChannel, PendingLoginMgr::PLInfos* pInfos)
+{
+	if (!config_.enable)
+		return true;
+
+	// The client logs in again while it is queued, it keeps its place
+	OUROUnordered_map<std::string, QUEUED>::iterator iter = queued_.find(pInfos->accountName);
+	if (iter != queued_.end())
+	{
+		pInfos->lastProcessTime = iter->second.pInfos->lastProcessTime;
+		delete iter->second.pInfos;
+		iter->second.pInfos = pInfos;
+		return false;
+	}
+
+	bool reconnect = isReconnect(pInfos->accountName);
+
+	// Nobody is ahead of this login
+	bool first = reconnect ? (numReconnects_ == 0) : queued_.empty();
+
+	if (first && tokens_ >= 1.f && dbmgrPending_.size() < config_.maxPending)
+	{
+		tokens_ -= 1.f;
+		++numAdmitted_;
+		return true;
+	}
+
+	QUEUED queued;
+	queued.pInfos = pInfos;
+	queued.seq = ++seq_;
+	queued.reconnect = reconnect;
+	queued_[pInfos->accountName] = queued;
+
+	pInfos->lastProcessTime = timestamp();
+	++numQueued_;
+
+	if (reconnect)
+	{
+		reconnectQueue_.push_back(std::make_pair(pInfos->accountName, queued.seq));
+		++numReconnects_;
+		sendPosition_(pInfos, numReconnects_);
+	}
+	else
+	{
+		queue_.push_back(std::make_pair(pInfos->accountName, queued.seq));
+		sendPosition_(pInfos, (uint32)queued_.size());
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool LoginAdmission::isFull() const
+{
+	return config_.enable && config_.queueMax > 0 && queued_.size() >= config_.queueMax;
+}
+
+//-------------------------------------------------------------------------------------
+bool LoginAdmission::isQueued(const std::string& loginName) const
+{
+	return queued_.find(loginName) != queued_.end();
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::remove(const std::string& loginName, const Network::Address& addr)
+{
+	OUROUnordered_map<std::string, QUEUED>::iterator iter = queued_.find(loginName);
+	if (iter == queued_.end() || iter->second.pInfos->addr != addr)
+		return;
+
+	if (iter->second.reconnect)
+		--numReconnects_;
+
+	delete iter->second.pInfos;
+	queued_.erase(iter);
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::process()
+{
+	if (!config_.enable)
+		return;
+
+	TimeStamp now = timestamp();
+
+	tokens_ += rate_ * float(double(now - lastRefillTime_) / stampsPerSecondD());
+	tokens_ = OURO_MIN(tokens_, float(config_.burst));
+	lastRefillTime_ = now;
+
+	if (now - lastRateTime_ >= stampsPerSecond())
+	{
+		lastRateTime_ = now;
+		updateRate_();
+	}
+
+	while (tokens_ >= 1.f && dbmgrPending_.size() < config_.maxPending)
+	{
+		PendingLoginMgr::PLInfos* pInfos = pop_();
+		if (pInfos == NULL)
+			break;
+
+		// Clients that went away do not use up tokens
+		Network::Channel* pChannel = networkInterface_.findChannel(pInfos->addr);
+		if (pChannel == NULL || pChannel->isDestroyed())
+		{
+			delete pInfos;
+			continue;
+		}
+
+		tokens_ -= 1.f;
+		++numAdmitted_;
+		Loginapp::getSingleton()._admitLogin(pChannel, pInfos);
+	}
+
+	if (double(now - lastExpireTime_) / stampsPerSecondD() >= EXPIRE_PERIOD)
+	{
+		lastExpireTime_ = now;
+		expire_();
+	}
+
+	if (double(now - lastPositionTime_) / stampsPerSecondD() >= config_.positionUpdatePeriod)
+	{
+		lastPositionTime_ = now;
+		sendPositions_();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool LoginAdmission::isOverloaded_() const
+{
+	if (dbmgrPending_.size() >= config_.maxPending)
+		return true;
+
+	if (config_.dbmgrLatency > 0.f && dbmgrLatency_ > config_.dbmgrLatency)
+		return true;
+
+	if (config_.baseappLoad > 0.f && baseappLoad_ > config_.baseappLoad)
+		return true;
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::updateRate_()
+{
+	// Without requests in flight there are no new samples, the last answer times must not hold the rate down forever
+	if (dbmgrPending_.empty())
+		dbmgrLatency_ *= 0.5f;
+
+	if (isOverloaded_())
+		rate_ = OURO_MAX(config_.minRate, rate_ * RATE_DECREASE);
+	else
+		rate_ = OURO_MIN(config_.maxRate, rate_ + OURO_MAX(1.f, config_.maxRate * RATE_INCREASE));
+}
+
+//-------------------------------------------------------------------------------------
+PendingLoginMgr::PLInfos* LoginAdmission::pop_()
+{
+	PendingLoginMgr::PLInfos* pInfos = pop_(reconnectQueue_);
+	if (pInfos)
+		return pInfos;
+
+	return pop_(queue_);
+}
+
+//-------------------------------------------------------------------------------------
+PendingLoginMgr::PLInfos* LoginAdmission::pop_(QUEUE& queue)
+{
+	while (!queue.empty())
+	{
+		std::pair<std::string, uint32> front = queue.front();
+		queue.pop_front();
+
+		OUROUnordered_map<std::string, QUEUED>::iterator iter = queued_.find(front.first);
+		if (iter == queued_.end() || iter->second.seq != front.second)
+			continue;
+
+		PendingLoginMgr::PLInfos* pInfos = iter->second.pInfos;
+
+		if (iter->second.reconnect)
+			--numReconnects_;
+
+		queued_.erase(iter);
+		return pInfos;
+	}
+
+	return NULL;
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::expire_()
+{
+	TimeStamp now = timestamp();
+
+	OUROUnordered_map<std::string, TimeStamp>::iterator iter = onlineAccounts_.begin();
+	while (iter != onlineAccounts_.end())
+	{
+		if (iter->second <= now)
+			iter = onlineAccounts_.erase(iter);
+		else
+			++iter;
+	}
+
+	TimeStamp pendingTimeout = TimeStamp(PENDING_TIMEOUT * stampsPerSecondD());
+
+	iter = dbmgrPending_.begin();
+	while (iter != dbmgrPending_.end())
+	{
+		if (now - iter->second >= pendingTimeout)
+			iter = dbmgrPending_.erase(iter);
+		else
+			++iter;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::sendPositions_()
+{
+	uint32 position = 0;
+	sendPositions_(reconnectQueue_, position);
+	sendPositions_(queue_, position);
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::sendPositions_(QUEUE& queue, uint32& position)
+{
+	TimeStamp now = timestamp();
+	TimeStamp timeout = TimeStamp(config_.queueTimeout * stampsPerSecondD());
+
+	QUEUE valid;
+
+	QUEUE::iterator iter = queue.begin();
+	for (; iter != queue.end(); ++iter)
+	{
+		OUROUnordered_map<std::string, QUEUED>::iterator qiter = queued_.find(iter->first);
+		if (qiter == queued_.end() || qiter->second.seq != iter->second)
+			continue;
+
+		PendingLoginMgr::PLInfos* pInfos = qiter->second.pInfos;
+		Network::Channel* pChannel = networkInterface_.findChannel(pInfos->addr);
+
+		if (pChannel == NULL || (config_.queueTimeout > 0.f && now - pInfos->lastProcessTime >= timeout))
+		{
+			if (qiter->second.reconnect)
+				--numReconnects_;
+
+			queued_.erase(qiter);
+
+			if (pChannel)
+			{
+				INFO_MSG(fmt::format("LoginAdmission::sendPositions_: {} waited too long in the queue.\n",
+					pInfos->accountName));
+
+				std::string datas;
+				Loginapp::getSingleton()._loginFailed(pChannel, pInfos->accountName, SERVER_ERR_SRV_OVERLOAD, datas, true);
+			}
+
+			delete pInfos;
+			continue;
+		}
+
+		valid.push_back(*iter);
+		sendPosition_(pInfos, ++position);
+	}
+
+	queue.swap(valid);
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::sendPosition_(PendingLoginMgr::PLInfos* pInfos, uint32 position)
+{
+	Network::Channel* pChannel = networkInterface_.findChannel(pInfos->addr);
+	if (pChannel == NULL)
+		return;
+
+	uint32 waitSeconds = uint32(float(position) / OURO_MAX(rate_, 0.1f));
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(ClientInterface::onLoginQueuePosition);
+	ClientInterface::onLoginQueuePositionArgs2::staticAddToBundle((*pBundle), position, waitSeconds);
+	pChannel->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::onDbmgrRequest(const std::string& loginName)
+{
+	dbmgrPending_[loginName] = timestamp();
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::onDbmgrResult(const std::string& loginName)
+{
+	OUROUnordered_map<std::string, TimeStamp>::iterator iter = dbmgrPending_.find(loginName);
+	if (iter == dbmgrPending_.end())
+		return;
+
+	float latency = float(double(timestamp() - iter->second) / stampsPerSecondD());
+	dbmgrPending_.erase(iter);
+
+	if (dbmgrLatency_ <= 0.f)
+		dbmgrLatency_ = latency;
+	else
+		dbmgrLatency_ += LATENCY_SMOOTHING * (latency - dbmgrLatency_);
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::onAccountOnline(const std::string& loginName)
+{
+	if (!config_.enable || config_.reconnectTime <= 0.f)
+		return;
+
+	onlineAccounts_[loginName] = timestamp() + TimeStamp(config_.reconnectTime * stampsPerSecondD());
+}
+
+//-------------------------------------------------------------------------------------
+bool LoginAdmission::isReconnect(const std::string& loginName) const
+{
+	OUROUnordered_map<std::string, TimeStamp>::const_iterator iter = onlineAccounts_.find(loginName);
+	if (iter == onlineAccounts_.end())
+		return false;
+
+	return iter->second > timestamp();
+}
+
+//-------------------------------------------------------------------------------------
+}
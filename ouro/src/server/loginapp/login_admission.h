@@ -0,0 +1,140 @@
+// 2017-2019 Rotten Visions, LLC. https://www.rottenvisions.com
+
+#ifndef OURO_LOGIN_ADMISSION_H
+#define OURO_LOGIN_ADMISSION_H
+
+#include "common/common.h"
+#include "common/timestamp.h"
+#include "server/pendingLoginmgr.h"
+#include "server/serverconfig.h"
+#include <deque>
+
+namespace Ouroboros{
+
+namespace Network
+{
+class Channel;
+class NetworkInterface;
+}
+
+/*
+	Login admission control of the loginapp.
+
+	Logins are forwarded to dbmgr through a token bucket. The rate is lowered while dbmgr answers slowly,
+	too many logins wait for dbmgr or the baseapps are loaded, and raised again once they have recovered.
+	Logins that get no token wait in a FIFO queue and their clients are told their position periodically.
+	Accounts that are still online(dbmgr found them in the entity log, or this loginapp has just sent them to a baseapp)
+	have their own queue which is always served first, so a mass reconnect after a patch does not stall behind new logins.
+*/
+class LoginAdmission
+{
+public:
+	LoginAdmission(Network::NetworkInterface& networkInterface);
+	~LoginAdmission();
+
+	/**
+		Returns true if the login may be sent to dbmgr now.
+		Otherwise the login is queued, the admission owns pInfos and hands it to Loginapp::_admitLogin once it is its turn.
+	*/
+	bool acquire(Network::Channel* pChannel, PendingLoginMgr::PLInfos* pInfos);
+
+	/**
+		The queue is full, new logins are refused
+	*/
+	bool isFull() const;
+
+	/**
+		The client of a queued login is gone
+	*/
+	void remove(const std::string& loginName, const Network::Address& addr);
+
+	bool isQueued(const std::string& loginName) const;
+
+	/**
+		Called every tick, refills the tokens, admits queued logins and sends the queue positions
+	*/
+	void process();
+
+	/* Load feedback */
+	void onDbmgrRequest(const std::string& loginName);
+	void onDbmgrResult(const std::string& loginName);
+	void onBaseappsLoad(float load) { baseappLoad_ = load; }
+
+	/**
+		The account is online, its next login counts as a reconnect
+	*/
+	void onAccountOnline(const std::string& loginName);
+	bool isReconnect(const std::string& loginName) const;
+
+	float rate() const { return rate_; }
+	uint32 queueSize() const { return (uint32)queued_.size(); }
+	uint32 reconnectQueueSize() const { return numReconnects_; }
+	uint32 numPending() const { return (uint32)dbmgrPending_.size(); }
+	float dbmgrLatency() const { return dbmgrLatency_; }
+	float baseappLoad() const { return baseappLoad_; }
+	uint32 numAdmitted() const { return numAdmitted_; }
+	uint32 numQueued() const { return numQueued_; }
+
+private:
+	struct QUEUED
+	{
+		PendingLoginMgr::PLInfos* pInfos;
+		uint32 seq;
+		bool reconnect;
+	};
+
+	typedef std::deque< std::pair<std::string, uint32> > QUEUE;
+
+	bool isOverloaded_() const;
+	void updateRate_();
+
+	/**
+		Pops the next login, reconnects first, NULL if both queues are empty
+	*/
+	PendingLoginMgr::PLInfos* pop_();
+	PendingLoginMgr::PLInfos* pop_(QUEUE& queue);
+
+	void expire_();
+
+	/**
+		Drops the stale entries of the queues, refuses the logins that waited too long and tells the others their position
+	*/
+	void sendPositions_();
+	void sendPositions_(QUEUE& queue, uint32& position);
+	void sendPosition_(PendingLoginMgr::PLInfos* pInfos, uint32 position);
+
+private:
+	Network::NetworkInterface& networkInterface_;
+	const LoginAdmission_Config& config_;
+
+	// Token bucket
+	float rate_;
+	float tokens_;
+	TimeStamp lastRefillTime_;
+	TimeStamp lastRateTime_;
+	TimeStamp lastPositionTime_;
+	TimeStamp lastExpireTime_;
+
+	// The queues only hold names, an entry whose login was removed or requeued no longer matches queued_
+	QUEUE reconnectQueue_;
+	QUEUE queue_;
+	OUROUnordered_map<std::string, QUEUED> queued_;
+	uint32 seq_;
+	uint32 numReconnects_;
+
+	// Logins sent to dbmgr and not answered yet, and when they were sent
+	OUROUnordered_map<std::string, TimeStamp> dbmgrPending_;
+	float dbmgrLatency_;
+
+	float baseappLoad_;
+
+	// Accounts known to be online, and until when they count as reconnects
+	OUROUnordered_map<std::string, TimeStamp> onlineAccounts_;
+
+	uint32 numAdmitted_;
+	uint32 numQueued_;
+};
+
+}
+
+#endif // OURO_LOGIN_ADMISSION_H
@@ -38,6 +38,7 @@ Loginapp::Loginapp(Network::EventDispatcher& dispatcher,
 	mainProcessTimer_(),
 	pendingCreateMgr_(ninterface),
 	pendingLoginMgr_(ninterface),
+	loginAdmission_(ninterface),
 	digest_(),
 	pHttpCBHandler(NULL),
 	initProgress_(0.f),
@@ -82,7 +83,11 @@ void Loginapp::handleTimeout(TimerHandle handle, void * arg)
 	switch (reinterpret_cast<uintptr>(arg))
 	{
 		case TIMEOUT_TICK:
-			this->handleMainTick();
+			{
+				ScopedMetricsTimer metricsTimer(pTickHistogram_);
+				ScopedFlightTick flightTick;
+				this->handleMainTick();
+			}
 			break;
 		default:
 			break;
@@ -96,6 +101,7 @@ void Loginapp::handleMainTick()
 	networkInterface().processChannels(&LoginappInterface::messageHandlers);
 	pendingLoginMgr_.process();
 	pendingCreateMgr_.process();
+	loginAdmission_.process();
 }
 
 //-------------------------------------------------------------------------------------
@@ -106,6 +112,9 @@ void Loginapp::onChannelDeregister(Network::Channel * pChannel)
 	{
 		const std::string& extra = pChannel->extra();
 
+		if(extra.size() > 0)
+			loginAdmission_.remove(extra, pChannel->addr());
+
 		// Tell dbmgr to clear his request from the queue, avoiding congestion
 		if(extra.size() > 0)
 		{
@@ -189,6 +198,21 @@ void Loginapp::onInstallPyModules()
 	}
 }
 
+//-------------------------------------------------------------------------------------
+bool Loginapp::initializeWatcher()
+{
+	WATCH_OBJECT("admission/rate", &loginAdmission_, &LoginAdmission::rate);
+	WATCH_OBJECT("admission/queueSize", &loginAdmission_, &LoginAdmission::queueSize);
+	WATCH_OBJECT("admission/reconnectQueueSize", &loginAdmission_, &LoginAdmission::reconnectQueueSize);
+	WATCH_OBJECT("admission/numPending", &loginAdmission_, &LoginAdmission::numPending);
+	WATCH_OBJECT("admission/dbmgrLatency", &loginAdmission_, &LoginAdmission::dbmgrLatency);
+	WATCH_OBJECT("admission/baseappLoad", &loginAdmission_, &LoginAdmission::baseappLoad);
+	WATCH_OBJECT("admission/numAdmitted", &loginAdmission_, &LoginAdmission::numAdmitted);
+	WATCH_OBJECT("admission/numQueued", &loginAdmission_, &LoginAdmission::numQueued);
+
+	return PythonApp::initializeWatcher();
+}
+
 //-------------------------------------------------------------------------------------
 void Loginapp::finalise()
 {
@@ -1075,6 +1099,15 @@ void Loginapp::login(Network::Channel* pChannel, MemoryStream& s)
 		return;
 	}
 
+	if(!loginAdmission_.isQueued(loginName) && loginAdmission_.isFull())
+	{
+		INFO_MSG(fmt::format("Loginapp::login: login queue is full, loginName={}.\n", loginName));
+
+		datas = "";
+		_loginFailed(pChannel, loginName, SERVER_ERR_SRV_OVERLOAD, datas, true);
+		return;
+	}
+
 	ptinfos = new PendingLoginMgr::PLInfos;
 	ptinfos->ctype = ctype;
 	ptinfos->datas = datas;
@@ -1082,22 +1115,53 @@ void Loginapp::login(Network::Channel* pChannel, MemoryStream& s)
 	ptinfos->password = password;
 	ptinfos->addr = pChannel->addr();
 	ptinfos->forceInternalLogin = forceInternalLogin;
-	pendingLoginMgr_.add(ptinfos);
 
+	pChannel->extra(loginName);
+
+	// Queued, loginAdmission_ hands it to _admitLogin once it is its turn
+	if(!loginAdmission_.acquire(pChannel, ptinfos))
+		return;
+
+	_admitLogin(pChannel, ptinfos);
+}
+
+//-------------------------------------------------------------------------------------
+void Loginapp::_admitLogin(Network::Channel* pChannel, PendingLoginMgr::PLInfos* ptinfos)
+{
+	Components::ComponentInfos* dbmgrinfos = Components::getSingleton().getDbmgr();
+	if(dbmgrinfos == NULL || dbmgrinfos->pChannel == NULL || dbmgrinfos->cid == 0)
+	{
+		std::string datas;
+		_loginFailed(pChannel, ptinfos->accountName, SERVER_ERR_SRV_NO_READY, datas, true);
+		SAFE_RELEASE(ptinfos);
+		return;
+	}
+
+	if(!pendingLoginMgr_.add(ptinfos))
+	{
+		std::string datas;
+		_loginFailed(pChannel, ptinfos->accountName, SERVER_ERR_BUSY, datas, true);
+		SAFE_RELEASE(ptinfos);
+		return;
+	}
+
+	COMPONENT_CLIENT_TYPE ctype = ptinfos->ctype;
 	if(ctype < UNKNOWN_CLIENT_COMPONENT_TYPE || ctype >= CLIENT_TYPE_END)
 		ctype = UNKNOWN_CLIENT_COMPONENT_TYPE;
 
 	INFO_MSG(fmt::format("Loginapp::login: new client[{0}], loginName={1}, datas={2}.\n",
-		COMPONENT_CLIENT_NAME[ctype], loginName, datas));
+		COMPONENT_CLIENT_NAME[ctype], ptinfos->accountName, ptinfos->datas));
 
-	pChannel->extra(loginName);
+	pChannel->extra(ptinfos->accountName);
 
 	// Query the legality of the user to dbmgr
 	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
 	(*pBundle).newMessage(DbmgrInterface::onAccountLogin);
-	(*pBundle) << loginName << password;
-	(*pBundle).appendBlob(datas);
+	(*pBundle) << ptinfos->accountName << ptinfos->password;
+	(*pBundle).appendBlob(ptinfos->datas);
 	dbmgrinfos->pChannel->send(pBundle);
+
+	loginAdmission_.onDbmgrRequest(ptinfos->accountName);
 }
 
 //-------------------------------------------------------------------------------------
@@ -1182,6 +1246,12 @@ void Loginapp::onLoginAccountQueryResultFromDbmgr(Network::Channel* pChannel, Me
 
 	s.readBlob(datas);
 
+	loginAdmission_.onDbmgrResult(loginName);
+
+	// Still in the entity log, its next login is a reconnect
+	if(componentID > 0)
+		loginAdmission_.onAccountOnline(loginName);
+
 	//DEBUG_MSG(fmt::format("Loginapp::onLoginAccountQueryResultFromDbmgr: loginName={}.\n",
 	//	loginName));
 
@@ -1331,6 +1401,8 @@ void Loginapp::onLoginAccountQueryBaseappAddrFromBaseappmgr(Network::Channel* pC
 	(*pBundle).appendBlob(infos->datas);
 	pClientChannel->send(pBundle);
 
+	loginAdmission_.onAccountOnline(loginName);
+
 	SAFE_RELEASE(infos);
 }
 
@@ -1620,6 +1692,15 @@ void Loginapp::onBaseappInitProgress(Network::Channel* pChannel, float progress)
 	initProgress_ = progress;
 }
 
+//-------------------------------------------------------------------------------------
+void Loginapp::onBaseappsLoad(Network::Channel* pChannel, float load)
+{
+	if(pChannel->isExternal())
+		return;
+
+	loginAdmission_.onBaseappsLoad(load);
+}
+
 //-------------------------------------------------------------------------------------
 
 }
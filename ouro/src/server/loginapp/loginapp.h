@@ -12,6 +12,7 @@
 #include "server/pendingLoginmgr.h"
 #include "server/python_app.h"
 #include "common/timer.h"
+#include "login_admission.h"
 #include "network/endpoint.h"
 	
 namespace Ouroboros{
@@ -48,6 +49,8 @@ public:
 	bool initializeEnd();
 	void finalise();
 	void onInstallPyModules();
+
+	virtual bool initializeWatcher();
 	
 	virtual void onShutdownBegin();
 	virtual void onShutdownEnd();
@@ -122,6 +125,11 @@ public:
 	*/
 	void login(Network::Channel* pChannel, MemoryStream& s);
 
+	/*
+		The login has passed the admission control, hands it to dbmgr
+	*/
+	void _admitLogin(Network::Channel* pChannel, PendingLoginMgr::PLInfos* ptinfos);
+
 	/*
 				Login failed
 		Failedcode: failed return code NETWORK_ERR_SRV_NO_READY: The server is not ready,
@@ -179,6 +187,11 @@ public:
 	*/
 	void onBaseappInitProgress(Network::Channel* pChannel, float progress);
 
+		/** Network Interface
+		Baseappmgr reports the average load of the baseapps
+	*/
+	void onBaseappsLoad(Network::Channel* pChannel, float load);
+
 protected:
 	TimerHandle							mainProcessTimer_;
 
@@ -188,6 +201,9 @@ protected:
 	// Record the account that was logged in to the server but has not been processed yet
 	PendingLoginMgr						pendingLoginMgr_;
 
+	// Rate limits the logins forwarded to dbmgr and queues the rest
+	LoginAdmission						loginAdmission_;
+
 	std::string							digest_;
 
 	HTTPCBHandler*						pHttpCBHandler;
@@ -59,6 +59,7 @@ NETWORK_INTERFACE_DECLARE_BEGIN(LoginappInterface)
 	
 	// request to create an account
 	LOGINAPP_MESSAGE_EXPOSED(reqCreateAccount)
+	LOGINAPP_MESSAGE_RATE_LIMIT(reqCreateAccount, 1, 5)
 	LOGINAPP_MESSAGE_DECLARE_STREAM(reqCreateAccount,								NETWORK_VARIABLE_MESSAGE)
 
 	LOGINAPP_MESSAGE_EXPOSED(reqCreateMailAccount)
@@ -77,6 +78,7 @@ NETWORK_INTERFACE_DECLARE_BEGIN(LoginappInterface)
 									std::string,									code)
 	// User login to the server
 	LOGINAPP_MESSAGE_EXPOSED(login)
+	LOGINAPP_MESSAGE_RATE_LIMIT(login, 1, 5)
 	LOGINAPP_MESSAGE_DECLARE_STREAM(login,											NETWORK_VARIABLE_MESSAGE)
 
 	// An app requests to get a callback for the entityID segment
@@ -146,6 +148,10 @@ NETWORK_INTERFACE_DECLARE_BEGIN(LoginappInterface)
 	// request to force kill the current app
 	LOGINAPP_MESSAGE_DECLARE_STREAM(reqKillServer,									NETWORK_VARIABLE_MESSAGE)
 
+	// baseappmgr reports the average load of the baseapps, used by the login admission control
+	LOGINAPP_MESSAGE_DECLARE_ARGS1(onBaseappsLoad,									NETWORK_FIXED_MESSAGE,
+									float,											load)
+
 NETWORK_INTERFACE_DECLARE_END()
 
 #ifdef DEFINE_IN_INTERFACE
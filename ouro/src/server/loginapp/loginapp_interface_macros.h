@@ -31,6 +31,9 @@ namespace Ouroboros{
 #define LOGINAPP_MESSAGE_EXPOSED(NAME)											\
 	NETWORK_MESSAGE_EXPOSED(Loginapp, NAME)										\
 
+#define LOGINAPP_MESSAGE_RATE_LIMIT(NAME, RATE, BURST)							\
+	NETWORK_MESSAGE_RATE_LIMIT(Loginapp, NAME, RATE, BURST)						\
+
 
 #if defined(DEFINE_IN_INTERFACE)
 #if defined(LOGINAPP)
@@ -645,6 +645,16 @@ void Bots::onLoginFailed(Network::Channel * pChannel, MemoryStream& s)
 	}
 }
 
+//-------------------------------------------------------------------------------------	
+void Bots::onLoginQueuePosition(Network::Channel * pChannel, uint32 position, uint32 waitSeconds)
+{
+	ClientObject* pClient = findClient(pChannel);
+	if(pClient)
+	{
+		pClient->onLoginQueuePosition(pChannel, position, waitSeconds);
+	}
+}
+
 //-------------------------------------------------------------------------------------	
 void Bots::onLoginBaseappFailed(Network::Channel * pChannel, SERVER_ERROR_CODE failedcode)
 {
@@ -170,6 +170,11 @@ public:
 	virtual void onLoginFailed(Network::Channel * pChannel, MemoryStream& s);
 
 		/** Network Interface
+	   The login waits in the loginapp queue
+	*/
+	virtual void onLoginQueuePosition(Network::Channel * pChannel, uint32 position, uint32 waitSeconds);
+
+		/** Network Interface
 	   	   login successful
 	   @ip: Server ip address
 	   @port: server port
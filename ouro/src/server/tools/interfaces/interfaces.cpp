@@ -99,7 +99,11 @@ void Interfaces::handleTimeout(TimerHandle handle, void * arg)
 	switch (reinterpret_cast<uintptr>(arg))
 	{
 		case TIMEOUT_TICK:
-			this->handleMainTick();
+			{
+				ScopedMetricsTimer metricsTimer(pTickHistogram_);
+				ScopedFlightTick flightTick;
+				this->handleMainTick();
+			}
 			break;
 		default:
 			break;
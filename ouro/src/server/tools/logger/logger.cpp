@@ -42,6 +42,7 @@ Logger::Logger(Network::EventDispatcher& dispatcher,
 logWatchers_(),
 buffered_logs_(),
 timer_(),
+binlogStore_(),
 pTelnetServer_(NULL)
 {
 	Ouroboros::Network::MessageHandlers::pMainMessageHandlers = &LoggerInterface::messageHandlers;
@@ -60,6 +61,8 @@ bool Logger::initializeWatcher()
 	WATCH_OBJECT("stats/totalNumlogs", &totalNumlogs);
 	WATCH_OBJECT("stats/secsNumlogs", &secsNumlogs);
 	WATCH_OBJECT("stats/bufferedLogsSize", this, &Logger::bufferedLogsSize);
+	WATCH_OBJECT("stats/binlog/segment", &binlogStore_, &BinLogStore::currSegment);
+	WATCH_OBJECT("stats/binlog/totalBlocks", &binlogStore_, &BinLogStore::totalBlocks);
 	return true;
 }
 
@@ -78,7 +81,11 @@ void Logger::handleTimeout(TimerHandle handle, void * arg)
 	switch (reinterpret_cast<uintptr>(arg))
 	{
 		case TIMEOUT_TICK:
-			this->handleTick();
+			{
+				ScopedMetricsTimer metricsTimer(pTickHistogram_);
+				ScopedFlightTick flightTick;
+				this->handleTick();
+			}
 			break;
 		default:
 			break;
@@ -97,6 +104,7 @@ void Logger::handleTick()
 
 	threadPool_.onMainThreadTick();
 	networkInterface().processChannels(&LoggerInterface::messageHandlers);
+	binlogStore_.flush();
 }
 
 //-------------------------------------------------------------------------------------
@@ -123,6 +131,15 @@ bool Logger::initializeEnd()
 	timer_ = this->dispatcher().addTimer(1000000 / 50, this,
 							reinterpret_cast<void *>(TIMEOUT_TICK));
 
+	if (g_ouroSrvConfig.binlogEnable())
+	{
+		if (!binlogStore_.open(g_ouroSrvConfig.binlogPath(), g_ouroSrvConfig.binlogSegmentSize()))
+			return false;
+
+		INFO_MSG(fmt::format("Logger::initializeEnd: binlog store={}, segment={}\n",
+			g_ouroSrvConfig.binlogPath(), binlogStore_.currSegment()));
+	}
+
 	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
 
 	// All scripts are loaded
@@ -166,6 +183,7 @@ void Logger::finalise()
 
 	buffered_logs_.clear();
 
+	binlogStore_.close();
 	timer_.cancel();
 	PythonApp::finalise();
 }
@@ -347,6 +365,85 @@ void Logger::writeLog(Network::Channel* pChannel, Ouroboros::MemoryStream& s)
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void Logger::writeBinLogs(Network::Channel* pChannel, Ouroboros::MemoryStream& s)
+{
+	if (!binlogStore_.isOpen())
+	{
+		s.done();
+		return;
+	}
+
+	BinLogRecord record;
+
+	s >> record.uid;
+	s >> record.componentType;
+	s >> record.componentID;
+	s >> record.componentGlobalOrder;
+	s >> record.componentGroupOrder;
+
+	binlogStore_.beginBlock(record.uid, record.componentType, record.componentID, 
+		record.componentGlobalOrder, record.componentGroupOrder);
+
+	// Records are stored as received, they are only decoded and rendered when someone is watching
+	bool hasWatchers = logWatchers_.size() > 0;
+
+	while (s.length() > 0)
+	{
+		uint8 entryType;
+		s >> entryType;
+
+		if (entryType == BINLOG_ENTRY_FORMAT)
+		{
+			std::string fmtstr;
+			s >> record.fmtID >> fmtstr;
+			binlogStore_.addFormat(record.fmtID, fmtstr);
+			continue;
+		}
+
+		size_t rpos = s.rpos();
+
+		uint8 argc = 0;
+		if (entryType == BINLOG_ENTRY_RECORD)
+			s >> record.logtype >> record.t >> record.fmtID >> argc;
+
+		if (entryType != BINLOG_ENTRY_RECORD || 
+			!(hasWatchers ? BinLog::readArgs(s, argc, record.args) : BinLog::skipArgs(s, argc)))
+		{
+			ERROR_MSG(fmt::format("Logger::writeBinLogs: invalid record from {}!\n", pChannel->c_str()));
+			s.done();
+			break;
+		}
+
+		++g_secsNumlogs;
+		++g_totalNumlogs;
+
+		binlogStore_.appendRecord(record.t, s.data() + rpos, s.rpos() - rpos);
+
+		if (!hasWatchers)
+			continue;
+
+		LOG_ITEM logItem;
+		logItem.uid = record.uid;
+		logItem.logtype = record.logtype;
+		logItem.componentType = record.componentType;
+		logItem.componentID = record.componentID;
+		logItem.componentGlobalOrder = record.componentGlobalOrder;
+		logItem.componentGroupOrder = record.componentGroupOrder;
+		logItem.t = record.t / 1000;
+		logItem.ourotime = (GAME_TIME)(record.t % 1000);
+		logItem.logstream << binlogStore_.renderLine(record);
+
+		LOG_WATCHERS::iterator iter = logWatchers_.begin();
+		for(; iter != logWatchers_.end(); ++iter)
+		{
+			iter->second.onMessage(&logItem);
+		}
+	}
+
+	binlogStore_.endBlock();
+}
+
 //-------------------------------------------------------------------------------------
 void Logger::sendInitLogs(LogWatcher& logWatcher)
 {
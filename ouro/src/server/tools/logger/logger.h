@@ -14,6 +14,7 @@
 #include "network/common.h"
 #include "network/address.h"
 #include "logwatcher.h"
+#include "helper/binlog_store.h"
 
 //#define NDEBUG
 #include <map>	
@@ -91,6 +92,13 @@ public:
 	*/
 	void writeLog(Network::Channel* pChannel, Ouroboros::MemoryStream& s);
 
+		/** Network Interface
+		Write a batch of binary structured logs
+	*/
+	void writeBinLogs(Network::Channel* pChannel, Ouroboros::MemoryStream& s);
+
+	BinLogStore& binlogStore(){ return binlogStore_; }
+
 		/** Network Interface
 		Registered log listener
 	*/
@@ -115,6 +123,8 @@ protected:
 	std::deque<LOG_ITEM*> buffered_logs_;
 	TimerHandle	timer_;
 
+	BinLogStore binlogStore_;
+
 	TelnetServer* pTelnetServer_;
 };
 
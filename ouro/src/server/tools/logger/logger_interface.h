@@ -56,6 +56,9 @@ NETWORK_INTERFACE_DECLARE_BEGIN(LoggerInterface)
 	// remotely write logs
 	LOGGER_MESSAGE_DECLARE_STREAM(writeLog,									NETWORK_VARIABLE_MESSAGE)
 
+	// remotely write a batch of binary structured logs
+	LOGGER_MESSAGE_DECLARE_STREAM(writeBinLogs,								NETWORK_VARIABLE_MESSAGE)
+
 	// Register the log listener
 	LOGGER_MESSAGE_DECLARE_STREAM(registerLogWatcher,						NETWORK_VARIABLE_MESSAGE)
 
@@ -8,6 +8,7 @@
 #include "entitydef/py_entitydef.h"
 #include "pyscript/py_compression.h"
 #include "pyscript/py_platform.h"
+#include "helper/binlog_store.h"
 
 #undef DEFINE_IN_INTERFACE
 #include "machine/machine_interface.h"
@@ -436,6 +437,99 @@ int process_getuid(int argc, char* argv[])
 	return getUserUID();
 }
 
+/**
+	Print the binlog records written by logger, times are "YYYY-MM-DD HH:MM:SS" or unix seconds
+*/
+class QueryLogsVisitor : public BinLogStore::Visitor
+{
+public:
+	QueryLogsVisitor(uint32 limit):
+	limit_(limit),
+	count_(0)
+	{
+	}
+
+	virtual bool onLog(const BinLogRecord& record, const std::string& text)
+	{
+		printf("%s", text.c_str());
+
+		if (text.size() == 0 || text[text.size() - 1] != '\n')
+			printf("\n");
+
+		return limit_ == 0 || ++count_ < limit_;
+	}
+
+private:
+	uint32 limit_;
+	uint32 count_;
+};
+
+static int64 parseQueryTime(const std::string& str)
+{
+	if (str.size() == 0)
+		return 0;
+
+	tm t;
+	memset(&t, 0, sizeof(t));
+
+	if (sscanf(str.c_str(), "%d-%d-%d %d:%d:%d", &t.tm_year, &t.tm_mon, &t.tm_mday, 
+		&t.tm_hour, &t.tm_min, &t.tm_sec) >= 3)
+	{
+		t.tm_year -= 1900;
+		t.tm_mon -= 1;
+		t.tm_isdst = -1;
+		return (int64)mktime(&t) * 1000;
+	}
+
+	return (int64)strtoll(str.c_str(), NULL, 10) * 1000;
+}
+
+int process_querylogs(int argc, char* argv[], const std::string path)
+{
+	BinLogQuery query;
+	std::string begin, end, component, cid, uid, logtypes, limit;
+
+	PARSE_COMMAND_ARG_BEGIN();
+	PARSE_COMMAND_ARG_GET_VALUE("--begin=", begin);
+	PARSE_COMMAND_ARG_GET_VALUE("--end=", end);
+	PARSE_COMMAND_ARG_GET_VALUE("--component=", component);
+	PARSE_COMMAND_ARG_GET_VALUE("--cid=", cid);
+	PARSE_COMMAND_ARG_GET_VALUE("--uid=", uid);
+	PARSE_COMMAND_ARG_GET_VALUE("--logtypes=", logtypes);
+	PARSE_COMMAND_ARG_GET_VALUE("--key=", query.keyStr);
+	PARSE_COMMAND_ARG_GET_VALUE("--limit=", limit);
+	PARSE_COMMAND_ARG_END();
+
+	query.beginTime = parseQueryTime(begin);
+	query.endTime = parseQueryTime(end);
+
+	if (component.size() > 0)
+	{
+		query.componentType = ComponentName2ComponentType(component.c_str());
+
+		if (query.componentType == UNKNOWN_COMPONENT_TYPE)
+		{
+			printf("querylogs: unknown component(%s)!\n", component.c_str());
+			return -1;
+		}
+	}
+
+	query.componentID = cid.size() > 0 ? strtoull(cid.c_str(), NULL, 10) : 0;
+	query.uid = uid.size() > 0 ? atoi(uid.c_str()) : 0;
+	query.logtypes = logtypes.size() > 0 ? (uint32)strtoul(logtypes.c_str(), NULL, 0) : 0;
+
+	BinLogStore store;
+	if (!store.openReadOnly(path))
+	{
+		printf("querylogs: can't open %s!\n", path.c_str());
+		return -1;
+	}
+
+	QueryLogsVisitor visitor(limit.size() > 0 ? (uint32)atoi(limit.c_str()) : 0);
+	store.query(query, visitor);
+	return 0;
+}
+
 int process_help(int argc, char* argv[])
 {
 	printf("Usage:\n");
@@ -453,6 +547,11 @@ int process_help(int argc, char* argv[])
 	printf("\tCreate a new server game asset library, contains the necessary files.\n");
 	printf("\tobcmd.exe --newassets=python --outpath=c:/xserver_assets\n");
 
+	printf("\n--querylogs\n");
+	printf("\tQuery the binary structured logs stored by logger, all filters are optional.\n");
+	printf("\tobcmd.exe --querylogs=logs/binlog --begin=\"2019-01-01 10:00:00\" --end=\"2019-01-01 11:00:00\"\n");
+	printf("\tobcmd.exe --querylogs=logs/binlog --component=cellapp --cid=1234 --uid=1 --logtypes=0x0c --key=\"keyword\" --limit=100\n");
+
 	printf("\n--help:\n");
 	printf("\tDisplay help information.\n");
 	return 0;
@@ -474,6 +573,7 @@ int main(int argc, char* argv[])
 	PARSE_COMMAND_ARG_DO_FUNC("--clientsdk=", process_make_client_sdk(argc, argv, cmd));
 	PARSE_COMMAND_ARG_DO_FUNC_RETURN("--getuid", process_getuid(argc, argv));
 	PARSE_COMMAND_ARG_DO_FUNC("--newassets=", process_newassets(argc, argv, cmd));
+	PARSE_COMMAND_ARG_DO_FUNC_RETURN("--querylogs=", process_querylogs(argc, argv, cmd));
 	PARSE_COMMAND_ARG_DO_FUNC("--help", process_help(argc, argv));
 	PARSE_COMMAND_ARG_END();
 